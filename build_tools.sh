@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+set -e
+
+echo "Compiling tools..."
+
+# Allow overriding compiler via CXX, default to g++, fall back to clang++ if needed.
+if [ -z "$CXX" ]; then
+  if command -v g++ >/dev/null 2>&1; then
+    CXX="g++"
+  elif command -v clang++ >/dev/null 2>&1; then
+    CXX="clang++"
+  else
+    echo "Error: No suitable C++ compiler found (g++ or clang++ required)." >&2
+    exit 1
+  fi
+fi
+
+# Optional: use ./build if it exists, otherwise current directory.
+OUT_DIR="."
+if [ -d "./build" ]; then
+  OUT_DIR="./build"
+fi
+
+"$CXX" -std=c++11 -O2 -Wall -Isrc -pthread -o "${OUT_DIR}/tapestry-render" src/tools/tapestry_render.cpp
+
+echo "Built ${OUT_DIR}/tapestry-render"
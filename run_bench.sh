@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+set -e
+
+echo "Compiling benchmarks..."
+
+# Allow overriding compiler via CXX, default to g++, fall back to clang++ if needed.
+if [ -z "$CXX" ]; then
+  if command -v g++ >/dev/null 2>&1; then
+    CXX="g++"
+  elif command -v clang++ >/dev/null 2>&1; then
+    CXX="clang++"
+  else
+    echo "Error: No suitable C++ compiler found (g++ or clang++ required)." >&2
+    exit 1
+  fi
+fi
+
+# Optional: use ./build if it exists, otherwise current directory.
+OUT_DIR="."
+if [ -d "./build" ]; then
+  OUT_DIR="./build"
+fi
+
+OUT_BIN="${OUT_DIR}/build_bench_tapestry"
+
+"$CXX" -std=c++11 -O2 -Wall -Isrc -o "$OUT_BIN" src/tests/bench_tapestry.cpp
+
+# Extra arguments go to the benchmark binary:
+#   ./run_bench.sh --json baseline.json          store results as a baseline
+#   ./run_bench.sh --baseline baseline.json      compare; exit 1 on regressions
+#   ./run_bench.sh --baseline b1.json --baseline b2.json --baseline b3.json
+#                                                baselines from 3 separate runs
+#                                                also cover run-to-run noise
+#   ./run_bench.sh --baseline baseline.json --threshold 5 --filter grain,wav
+echo "Running benchmarks..."
+"$OUT_BIN" "$@"
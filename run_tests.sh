@@ -23,10 +23,20 @@ fi
 
 OUT_BIN="${OUT_DIR}/build_test_tapestry"
 
-"$CXX" -std=c++17 -O2 -Wall -Isrc -DSHORTWAV_DSP_RUN_TESTS -o "$OUT_BIN" src/tests/test_tapestry.cpp
+# The real-time safety tests find pthread_mutex_lock with dlsym, which older
+# glibc keeps in libdl
+EXTRA_LIBS=""
+if [ "$(uname -s)" = "Linux" ]; then
+  EXTRA_LIBS="-ldl"
+fi
+
+"$CXX" -std=c++17 -O2 -Wall -Isrc -pthread -DSHORTWAV_DSP_RUN_TESTS -o "$OUT_BIN" src/tests/test_tapestry.cpp $EXTRA_LIBS
 
+# Arguments go to the test binary: --update-golden rewrites the golden
+# render references, --golden-bit-exact or --golden-tolerance-db <dB>
+# (default -100) set how closely renders must match them
 echo "Running tests..."
-if "$OUT_BIN"; then
+if "$OUT_BIN" "$@"; then
   echo "Tests passed."
   exit 0
 else
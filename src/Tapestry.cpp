@@ -1,4 +1,5 @@
 #include "Tapestry.hpp"
+#include "TapestryExpander.hpp"
 #include <osdialog.h>
 
 //------------------------------------------------------------------------------
@@ -7,6 +8,7 @@
 
 // Definition required for ODR-used static constexpr members (Windows linker requirement)
 constexpr int Tapestry::kSpliceCountOptions[];
+constexpr int Tapestry::kAnalysisIntervalMs;
 
 //------------------------------------------------------------------------------
 // Initialize/Reset Implementation
@@ -49,11 +51,55 @@ void Tapestry::onReset()
   // Reset waveform color to default
   waveformColor = WaveformColor::BabyBlue;
 
+  // Reset marker snapping to default
+  snapMarkersToZeroCrossings = true;
+
+  // Reset select order to reel position
+  selectOrder = ShortwavDSP::OrganizeSortMode::Position;
+
+  // Reset beat grid settings
+  tempoLock = false;
+  pendingBeatGridSplice.store(0);
+
+  // Reset playback mode
+  playbackMode = ShortwavDSP::PlaybackMode::Granular;
+  spectralStretch = 1.0f;
+  freezeOnStop = false;
+  interpolationQuality = ShortwavDSP::InterpolationQuality::Hermite;
+
+  // Reset control rate
+  controlRate = 32;
+  for (int p = 0; p < static_cast<int>(ShortwavDSP::ControlParam::NUM_PARAMS); p++)
+  {
+    audioRateCv[p] = false;
+  }
+
+  // Reset overdub feedback
+  overdubFeedback = 1.0f;
+  overdubSaturation = false;
+
+  // Reset telemetry overlay
+  showTelemetry = false;
+
+  // Reset read heads, staggered across the splice
+  readHeadCount = 0;
+  separateHeadOutputs = false;
+  for (int k = 0; k < ShortwavDSP::MultiTapHeads::kMaxHeads; k++)
+  {
+    readHeads[k] = ShortwavDSP::ReadHeadSettings();
+    readHeads[k].slide = static_cast<float>(k) / ShortwavDSP::MultiTapHeads::kMaxHeads;
+  }
+
   // Reset EOSG pulse
   eosgPulse.reset();
+  for (dsp::PulseGenerator &pulse : polyEosgPulses)
+  {
+    pulse.reset();
+  }
 
   // Reset expander tracking
   lastRightExpanderModuleId_ = -1;
+  expanderLink_.reset();
 
   // Update organize parameter range
   updateOrganizeParamRange();
@@ -65,8 +111,49 @@ void Tapestry::onReset()
 
 void Tapestry::process(const ProcessArgs& args)
 {
+  // Decaying filters and followers never reach the slow subnormal path
+  ShortwavDSP::ScopedFlushDenormals flushDenormals;
+
+  // Telemetry starts fresh each time the overlay is shown; while hidden the
+  // null pointer skips every probe
+  if (showTelemetry != telemetryActive)
+  {
+    telemetryActive = showTelemetry;
+    if (telemetryActive)
+      telemetry.reset();
+    dsp.setTelemetry(telemetryActive ? &telemetry : nullptr);
+  }
+  ShortwavDSP::Telemetry* probe = telemetryActive ? &telemetry : nullptr;
+  uint64_t processStart = ShortwavDSP::Telemetry::begin(probe);
+
   // Read overdub toggle FIRST (before button processing needs it)
   dsp.setOverdubMode(params[OVERDUB_TOGGLE].getValue() > 0.5f);
+  dsp.setOverdubFeedback(overdubFeedback);
+  dsp.setOverdubSaturation(overdubSaturation);
+
+  // Marker snapping must be set before buttons/gates can create markers
+  dsp.setZeroCrossingSnap(snapMarkersToZeroCrossings ?
+                          ShortwavDSP::TapestryDSP::kDefaultZeroCrossingSnapSeconds : 0.0f);
+
+  dsp.setOrganizeSortMode(selectOrder);
+  dsp.setTempoLock(tempoLock);
+  dsp.setPlaybackMode(playbackMode);
+  dsp.setSpectralStretch(spectralStretch);
+  dsp.setFreezeOnStop(freezeOnStop);
+  dsp.setInterpolationQuality(interpolationQuality);
+  dsp.setControlRate(controlRate);
+  dsp.setReadHeadCount(readHeadCount);
+  for (int k = 0; k < readHeadCount; k++)
+  {
+    dsp.setReadHead(k, readHeads[k]);
+  }
+
+  // Apply beat grid markers requested from the context menu
+  int beatsPerMarker = pendingBeatGridSplice.exchange(0);
+  if (beatsPerMarker > 0 && dsp.spliceToBeatGrid(beatsPerMarker))
+  {
+    updateOrganizeParamRange();
+  }
 
   // Apply pending splice markers from JSON deserialization (after file is loaded)
   if (!pendingSpliceMarkers_.empty() && !fileLoading.load())
@@ -97,83 +184,57 @@ void Tapestry::process(const ProcessArgs& args)
   // Process gate/trigger inputs
   processGateInputs(args);
 
-  // Read parameter values
-  dsp.setSos(params[SOS_PARAM].getValue());
-  dsp.setGeneSize(params[GENE_SIZE_PARAM].getValue());
-  dsp.setMorph(params[MORPH_PARAM].getValue());
-  dsp.setSlide(params[SLIDE_PARAM].getValue());
-  
-  // Organize parameter: normalize based on splice count
-  size_t numSplices = dsp.getSpliceManager().getNumSplices();
-  if (numSplices > 1)
-  {
-    // Normalize to 0.0-1.0 range: divide by (numSplices - 1) so max value maps to 1.0
-    dsp.setOrganize(params[ORGANIZE_PARAM].getValue() / static_cast<float>(numSplices - 1));
-  }
-  else
-  {
-    // With 0 or 1 splice, just use 0.0
-    dsp.setOrganize(0.0f);
-  }
-  
-  dsp.setVariSpeed(params[VARI_SPEED_PARAM].getValue());
-
-  // Read CV inputs
-  if (inputs[SOS_CV_INPUT].isConnected())
-  {
-    dsp.setSosCv(inputs[SOS_CV_INPUT].getVoltage());
-  }
-  else
-  {
-    dsp.setSosCv(0.0f);
-  }
-
-  if (inputs[GENE_SIZE_CV_INPUT].isConnected())
-  {
-    dsp.setGeneSizeCv(inputs[GENE_SIZE_CV_INPUT].getVoltage(),
-                      params[GENE_SIZE_CV_ATTEN].getValue());
-  }
-  else
+  // Knobs and CVs are read at control rate (the DSP ramps between updates);
+  // CV inputs set to audio rate are read every sample
+  bool controlTick = dsp.isControlTick();
+  if (controlTick)
   {
-    dsp.setGeneSizeCv(0.0f, 0.0f);
-  }
+    for (int p = 0; p < static_cast<int>(ShortwavDSP::ControlParam::NUM_PARAMS); p++)
+    {
+      dsp.setAudioRateCv(static_cast<ShortwavDSP::ControlParam>(p), audioRateCv[p]);
+    }
 
-  if (inputs[VARI_SPEED_CV_INPUT].isConnected())
-  {
-    dsp.setVariSpeedCv(inputs[VARI_SPEED_CV_INPUT].getVoltage(),
-                       params[VARI_SPEED_CV_ATTEN].getValue());
-  }
-  else
-  {
-    dsp.setVariSpeedCv(0.0f, 0.0f);
-  }
+    dsp.setSos(params[SOS_PARAM].getValue());
+    dsp.setGeneSize(params[GENE_SIZE_PARAM].getValue());
+    dsp.setMorph(params[MORPH_PARAM].getValue());
+    dsp.setSlide(params[SLIDE_PARAM].getValue());
 
-  if (inputs[MORPH_CV_INPUT].isConnected())
-  {
-    dsp.setMorphCv(inputs[MORPH_CV_INPUT].getVoltage());
-  }
-  else
-  {
-    dsp.setMorphCv(0.0f);
-  }
+    // Organize parameter: normalize based on splice count
+    size_t numSplices = dsp.getSpliceManager().getNumSplices();
+    if (numSplices > 1)
+    {
+      // Normalize to 0.0-1.0 range: divide by (numSplices - 1) so max value maps to 1.0
+      dsp.setOrganize(params[ORGANIZE_PARAM].getValue() / static_cast<float>(numSplices - 1));
+    }
+    else
+    {
+      // With 0 or 1 splice, just use 0.0
+      dsp.setOrganize(0.0f);
+    }
 
-  if (inputs[SLIDE_CV_INPUT].isConnected())
-  {
-    dsp.setSlideCv(inputs[SLIDE_CV_INPUT].getVoltage(),
-                   params[SLIDE_CV_ATTEN].getValue());
-  }
-  else
-  {
-    dsp.setSlideCv(0.0f, 0.0f);
+    dsp.setVariSpeed(params[VARI_SPEED_PARAM].getValue());
   }
+  processCvInputs(controlTick);
 
-  if (inputs[ORGANIZE_CV_INPUT].isConnected())
+  // Polyphony: a polyphonic Play gate gives one playhead per channel, with
+  // V/Oct and Scan CV per channel (mono cables apply to every channel).
+  // Polyphonic V/Oct or Scan CV alone only use their first channel, so they
+  // never start playback on their own.
+  int polyChannels = inputs[PLAY_INPUT].getChannels();
+  dsp.setPolyChannels(polyChannels);
+  if (polyChannels > 1)
   {
-    dsp.setOrganizeCv(inputs[ORGANIZE_CV_INPUT].getVoltage());
+    for (int c = 0; c < polyChannels; c++)
+    {
+      bool gate = inputs[PLAY_INPUT].getVoltage(c) >= ShortwavDSP::TapestryConfig::kGateTriggerThreshold;
+      dsp.setPolyVoice(c, gate, inputs[VOCT_INPUT].getPolyVoltage(c),
+                       inputs[SLIDE_CV_INPUT].getPolyVoltage(c));
+    }
+    dsp.setPitchCv(0.0f);
   }
-  else
+  else if (controlTick || audioRateCv[static_cast<int>(ShortwavDSP::ControlParam::Pitch)])
   {
-    dsp.setOrganizeCv(0.0f);
+    dsp.setPitchCv(inputs[VOCT_INPUT].getVoltage());
   }
 
   // Read audio inputs
@@ -199,43 +260,44 @@ void Tapestry::process(const ProcessArgs& args)
   // Start with Tapestry's output
   float finalOutL = result.audioOutL;
   float finalOutR = result.audioOutR;
+  bool expanderProcessed = false;
 
   // Check for TapestryExpander on the right
+  uint64_t expanderStart = ShortwavDSP::Telemetry::begin(probe);
   if (rightExpander.module && rightExpander.module->model == modelTapestryExpander)
   {
     if (rightExpander.moduleId != lastRightExpanderModuleId_)
     {
+      // A new expander starts from an empty pipeline; blocks still in our
+      // consumer buffer carry old sequence numbers and are ignored.
       lastRightExpanderModuleId_ = rightExpander.moduleId;
-      // When a new expander is connected, clear the state in its producer buffer
-      // rather than writing to our read-only consumer buffer.
-      if (rightExpander.module->leftExpander.producerMessage)
-      {
-        auto* initMsg = static_cast<TapestryExpanderMessage*>(rightExpander.module->leftExpander.producerMessage);
-        initMsg->processedL = 0.0f;
-        initMsg->processedR = 0.0f;
-        initMsg->expanderConnected = false;
-      }
+      expanderLink_.reset();
     }
 
-    // Send audio to the expander by writing into its leftExpander producer buffer.
-    // Messages are flipped by the engine, so this incurs 1-sample latency.
-    if (rightExpander.module->leftExpander.producerMessage)
+    // An expander in inline mode publishes its effect chain for us to run
+    // here, with no latency; otherwise fall back to the block messages.
+    TapestryExpanderInline* inlineChain = static_cast<TapestryExpander*>(rightExpander.module)->getInlineChain();
+    if (inlineChain)
     {
-      auto* toExpander = static_cast<TapestryExpanderMessage*>(rightExpander.module->leftExpander.producerMessage);
-      toExpander->audioL = result.audioOutL;
-      toExpander->audioR = result.audioOutR;
-      toExpander->sampleRate = args.sampleRate;
-      rightExpander.module->leftExpander.messageFlipRequested = true;
+      inlineChain->process(finalOutL, finalOutR);
+      expanderProcessed = true;
+      expanderLink_.reset();
     }
-
-    // Receive processed audio from the expander via our consumer buffer.
-    if (rightExpander.consumerMessage)
+    else
     {
-      auto* fromExpander = static_cast<TapestryExpanderMessage*>(rightExpander.consumerMessage);
-      if (fromExpander->expanderConnected)
+      // Play the processed block the expander returned, one frame per step.
+      expanderLink_.receive(static_cast<const TapestryExpanderMessage*>(rightExpander.consumerMessage));
+      expanderProcessed = expanderLink_.pull(finalOutL, finalOutR);
+
+      // Send audio to the expander by filling its leftExpander producer buffer;
+      // the flip is requested once per block.
+      if (rightExpander.module->leftExpander.producerMessage)
       {
-        finalOutL = fromExpander->processedL;
-        finalOutR = fromExpander->processedR;
+        auto* toExpander = static_cast<TapestryExpanderMessage*>(rightExpander.module->leftExpander.producerMessage);
+        if (expanderLink_.send(toExpander, result.audioOutL, result.audioOutR, args.sampleRate))
+        {
+          rightExpander.module->leftExpander.messageFlipRequested = true;
+        }
       }
     }
   }
@@ -243,23 +305,93 @@ void Tapestry::process(const ProcessArgs& args)
   {
     lastRightExpanderModuleId_ = -1;
   }
+  ShortwavDSP::Telemetry::end(probe, ShortwavDSP::TelemetryStage::Expander, expanderStart);
 
-  // Write audio outputs (always write both channels)
-  outputs[AUDIO_OUT_L].setVoltage(finalOutL * 5.0f);
-  outputs[AUDIO_OUT_R].setVoltage(finalOutR * 5.0f);
+  // Write audio outputs (always write both channels). Polyphonic playback
+  // and separate read head outputs use one channel per playhead unless an
+  // expander processes the mix.
+  if (result.polyChannels > 1 && !expanderProcessed)
+  {
+    outputs[AUDIO_OUT_L].setChannels(result.polyChannels);
+    outputs[AUDIO_OUT_R].setChannels(result.polyChannels);
+    for (int c = 0; c < result.polyChannels; c++)
+    {
+      outputs[AUDIO_OUT_L].setVoltage(result.polyOutL[c] * 5.0f, c);
+      outputs[AUDIO_OUT_R].setVoltage(result.polyOutR[c] * 5.0f, c);
+    }
+  }
+  else if (result.readHeads > 0 && separateHeadOutputs && !expanderProcessed)
+  {
+    // Main playhead on channel 1, read heads on channels 2-9
+    int channels = result.readHeads + 1;
+    outputs[AUDIO_OUT_L].setChannels(channels);
+    outputs[AUDIO_OUT_R].setChannels(channels);
+    outputs[AUDIO_OUT_L].setVoltage(result.mainOutL * 5.0f, 0);
+    outputs[AUDIO_OUT_R].setVoltage(result.mainOutR * 5.0f, 0);
+    for (int k = 0; k < result.readHeads; k++)
+    {
+      outputs[AUDIO_OUT_L].setVoltage(result.headOutL[k] * 5.0f, k + 1);
+      outputs[AUDIO_OUT_R].setVoltage(result.headOutR[k] * 5.0f, k + 1);
+    }
+  }
+  else
+  {
+    outputs[AUDIO_OUT_L].setChannels(1);
+    outputs[AUDIO_OUT_R].setChannels(1);
+    outputs[AUDIO_OUT_L].setVoltage(finalOutL * 5.0f);
+    outputs[AUDIO_OUT_R].setVoltage(finalOutR * 5.0f);
+  }
 
   // Write CV output
   outputs[CV_OUTPUT].setVoltage(result.cvOut);
 
-  // EOSG output
+  // EOSG output: the mono pulse (also drives the splice LED), or one pulse
+  // per voice when polyphonic
   if (result.endOfSpliceGene)
   {
     eosgPulse.trigger(kEosgPulseWidth);
   }
-  outputs[EOSG_OUTPUT].setVoltage(eosgPulse.process(args.sampleTime) ? 10.0f : 0.0f);
+  bool eosgHigh = eosgPulse.process(args.sampleTime);
+  if (result.polyChannels > 1)
+  {
+    outputs[EOSG_OUTPUT].setChannels(result.polyChannels);
+    for (int c = 0; c < result.polyChannels; c++)
+    {
+      if (result.polyEndOfGene & (1u << c))
+      {
+        polyEosgPulses[c].trigger(kEosgPulseWidth);
+      }
+      outputs[EOSG_OUTPUT].setVoltage(polyEosgPulses[c].process(args.sampleTime) ? 10.0f : 0.0f, c);
+    }
+  }
+  else
+  {
+    outputs[EOSG_OUTPUT].setChannels(1);
+    outputs[EOSG_OUTPUT].setVoltage(eosgHigh ? 10.0f : 0.0f);
+  }
 
   // Update lights
+  uint64_t lightsStart = ShortwavDSP::Telemetry::begin(probe);
   updateLights(args);
+  ShortwavDSP::Telemetry::end(probe, ShortwavDSP::TelemetryStage::Lights, lightsStart);
+
+  // Underruns: the engine falling behind the wall clock
+  if (++underrunCheckCounter >= kUnderrunCheckFrames)
+  {
+    underrunCheckCounter = 0;
+    double stall = underrunDetector.update(kUnderrunCheckFrames, args.sampleRate, ShortwavDSP::TraceRing::now());
+    if (stall > 0.0)
+    {
+      trace.instant(ShortwavDSP::TraceThread::Audio, ShortwavDSP::TraceEvent::Underrun,
+                    static_cast<int64_t>(stall * 1e6));
+    }
+  }
+
+  if (probe)
+  {
+    ShortwavDSP::Telemetry::end(probe, ShortwavDSP::TelemetryStage::Total, processStart);
+    probe->endSample();
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -563,6 +695,69 @@ void Tapestry::processGateInputs(const ProcessArgs& args)
   }
 }
 
+//------------------------------------------------------------------------------
+// CV Processing
+//------------------------------------------------------------------------------
+
+void Tapestry::processCvInputs(bool controlTick)
+{
+  using ShortwavDSP::ControlParam;
+
+  if (controlTick || audioRateCv[static_cast<int>(ControlParam::Sos)])
+  {
+    dsp.setSosCv(inputs[SOS_CV_INPUT].isConnected() ? inputs[SOS_CV_INPUT].getVoltage() : 0.0f);
+  }
+
+  if (controlTick || audioRateCv[static_cast<int>(ControlParam::GeneSize)])
+  {
+    if (inputs[GENE_SIZE_CV_INPUT].isConnected())
+    {
+      dsp.setGeneSizeCv(inputs[GENE_SIZE_CV_INPUT].getVoltage(),
+                        params[GENE_SIZE_CV_ATTEN].getValue());
+    }
+    else
+    {
+      dsp.setGeneSizeCv(0.0f, 0.0f);
+    }
+  }
+
+  if (controlTick || audioRateCv[static_cast<int>(ControlParam::VariSpeed)])
+  {
+    if (inputs[VARI_SPEED_CV_INPUT].isConnected())
+    {
+      dsp.setVariSpeedCv(inputs[VARI_SPEED_CV_INPUT].getVoltage(),
+                         params[VARI_SPEED_CV_ATTEN].getValue());
+    }
+    else
+    {
+      dsp.setVariSpeedCv(0.0f, 0.0f);
+    }
+  }
+
+  if (controlTick || audioRateCv[static_cast<int>(ControlParam::Morph)])
+  {
+    dsp.setMorphCv(inputs[MORPH_CV_INPUT].isConnected() ? inputs[MORPH_CV_INPUT].getVoltage() : 0.0f);
+  }
+
+  if (controlTick || audioRateCv[static_cast<int>(ControlParam::Slide)])
+  {
+    if (inputs[SLIDE_CV_INPUT].isConnected())
+    {
+      dsp.setSlideCv(inputs[SLIDE_CV_INPUT].getVoltage(),
+                     params[SLIDE_CV_ATTEN].getValue());
+    }
+    else
+    {
+      dsp.setSlideCv(0.0f, 0.0f);
+    }
+  }
+
+  if (controlTick || audioRateCv[static_cast<int>(ControlParam::Organize)])
+  {
+    dsp.setOrganizeCv(inputs[ORGANIZE_CV_INPUT].isConnected() ? inputs[ORGANIZE_CV_INPUT].getVoltage() : 0.0f);
+  }
+}
+
 //------------------------------------------------------------------------------
 // LED Updates
 //------------------------------------------------------------------------------
@@ -737,6 +932,45 @@ void Tapestry::updateLights(const ProcessArgs& args)
   lights[SPLICE_COUNT_LED].setBrightness(spliceCountBrightness);
 }
 
+//------------------------------------------------------------------------------
+// Background Analysis
+//------------------------------------------------------------------------------
+
+void Tapestry::startAnalysisThread()
+{
+  analysisRunning.store(true);
+  analysisThread = std::thread([this]() {
+    std::unique_lock<std::mutex> lock(analysisMutex);
+    while (analysisRunning.load())
+    {
+      // The reel is rewritten wholesale while a file loads; wait it out
+      if (!fileLoading.load())
+      {
+        uint64_t start = ShortwavDSP::TraceRing::now();
+        if (dsp.runAnalysis())
+        {
+          trace.complete(ShortwavDSP::TraceThread::Analysis, ShortwavDSP::TraceEvent::Analysis, start, 1);
+        }
+      }
+      analysisCv.wait_for(lock, std::chrono::milliseconds(kAnalysisIntervalMs),
+                          [this]() { return !analysisRunning.load(); });
+    }
+  });
+}
+
+void Tapestry::stopAnalysisThread()
+{
+  {
+    std::lock_guard<std::mutex> lock(analysisMutex);
+    analysisRunning.store(false);
+  }
+  analysisCv.notify_all();
+  if (analysisThread.joinable())
+  {
+    analysisThread.join();
+  }
+}
+
 //------------------------------------------------------------------------------
 // Splice Count Management
 //------------------------------------------------------------------------------
@@ -826,7 +1060,10 @@ void Tapestry::loadFileAsync(const std::string& path)
   fileLoading.store(true);
 
   std::thread([this, path]() {
+    using ShortwavDSP::TraceEvent;
+    using ShortwavDSP::TraceThread;
     std::lock_guard<std::mutex> lock(fileMutex);
+    trace.begin(TraceThread::FileIO, TraceEvent::FileLoad);
 
     // Load WAV file using a simple implementation
     // TODO: Implement proper WAV loading with marker support
@@ -846,15 +1083,22 @@ void Tapestry::loadFileAsync(const std::string& path)
       std::vector<float> tempBuffer(numFrames * 2);
       std::vector<int16_t> rawData(numSamples);
 
-      if (fread(rawData.data(), sizeof(int16_t), numSamples, file) == numSamples)
+      trace.begin(TraceThread::FileIO, TraceEvent::FileRead, static_cast<int64_t>(dataSize));
+      bool readOk = fread(rawData.data(), sizeof(int16_t), numSamples, file) == numSamples;
+      trace.end(TraceThread::FileIO, TraceEvent::FileRead);
+      if (readOk)
       {
         // Convert int16 to float
+        trace.begin(TraceThread::FileIO, TraceEvent::FileDecode, static_cast<int64_t>(numFrames));
         for (size_t i = 0; i < numSamples; i++)
         {
           tempBuffer[i] = rawData[i] / 32768.0f;
         }
+        trace.end(TraceThread::FileIO, TraceEvent::FileDecode);
 
+        trace.begin(TraceThread::FileIO, TraceEvent::ReelInstall);
         dsp.loadReel(tempBuffer.data(), numFrames);
+        trace.end(TraceThread::FileIO, TraceEvent::ReelInstall);
         currentFilePath = path;
 
         // Extract filename
@@ -866,6 +1110,7 @@ void Tapestry::loadFileAsync(const std::string& path)
       fclose(file);
     }
 
+    trace.end(TraceThread::FileIO, TraceEvent::FileLoad);
     fileLoading.store(false);
   }).detach();
 }
@@ -879,6 +1124,7 @@ void Tapestry::saveFileAsync(const std::string& path)
 
   std::thread([this, path]() {
     std::lock_guard<std::mutex> lock(fileMutex);
+    trace.begin(ShortwavDSP::TraceThread::FileIO, ShortwavDSP::TraceEvent::FileSave);
 
     const auto& buffer = dsp.getBuffer();
     size_t numFrames = buffer.getUsedFrames();
@@ -933,10 +1179,21 @@ void Tapestry::saveFileAsync(const std::string& path)
       }
     }
 
+    trace.end(ShortwavDSP::TraceThread::FileIO, ShortwavDSP::TraceEvent::FileSave);
     fileSaving.store(false);
   }).detach();
 }
 
+bool Tapestry::exportTrace(const std::string& path) const
+{
+  std::string json = trace.toChromeJson();
+  FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+  return (std::fclose(file) == 0) && ok;
+}
+
 //------------------------------------------------------------------------------
 // JSON Serialization
 //------------------------------------------------------------------------------
@@ -978,6 +1235,54 @@ json_t* Tapestry::dataToJson()
   // Save waveform color
   json_object_set_new(rootJ, "waveformColor", json_integer(static_cast<int>(waveformColor)));
 
+  // Save marker snapping
+  json_object_set_new(rootJ, "snapMarkersToZeroCrossings", json_boolean(snapMarkersToZeroCrossings));
+
+  // Save select order
+  json_object_set_new(rootJ, "organizeSortMode", json_integer(static_cast<int>(selectOrder)));
+
+  // Save tempo lock
+  json_object_set_new(rootJ, "tempoLock", json_boolean(tempoLock));
+
+  // Save playback mode
+  json_object_set_new(rootJ, "playbackMode", json_integer(static_cast<int>(playbackMode)));
+  json_object_set_new(rootJ, "spectralStretch", json_real(spectralStretch));
+  json_object_set_new(rootJ, "freezeOnStop", json_boolean(freezeOnStop));
+
+  // Save interpolation quality
+  json_object_set_new(rootJ, "interpolationQuality", json_integer(static_cast<int>(interpolationQuality)));
+
+  // Save read heads
+  json_object_set_new(rootJ, "readHeadCount", json_integer(readHeadCount));
+  json_object_set_new(rootJ, "separateHeadOutputs", json_boolean(separateHeadOutputs));
+  json_t* readHeadsJ = json_array();
+  for (int k = 0; k < ShortwavDSP::MultiTapHeads::kMaxHeads; k++)
+  {
+    json_t* headJ = json_object();
+    json_object_set_new(headJ, "splice", json_integer(readHeads[k].splice));
+    json_object_set_new(headJ, "slide", json_real(readHeads[k].slide));
+    json_object_set_new(headJ, "speed", json_real(readHeads[k].speed));
+    json_object_set_new(headJ, "gain", json_real(readHeads[k].gain));
+    json_array_append_new(readHeadsJ, headJ);
+  }
+  json_object_set_new(rootJ, "readHeads", readHeadsJ);
+
+  // Save control rate and audio-rate CV inputs
+  json_object_set_new(rootJ, "controlRate", json_integer(controlRate));
+  json_t* audioRateCvJ = json_array();
+  for (int p = 0; p < static_cast<int>(ShortwavDSP::ControlParam::NUM_PARAMS); p++)
+  {
+    json_array_append_new(audioRateCvJ, json_boolean(audioRateCv[p]));
+  }
+  json_object_set_new(rootJ, "audioRateCv", audioRateCvJ);
+
+  // Save overdub feedback
+  json_object_set_new(rootJ, "overdubFeedback", json_real(overdubFeedback));
+  json_object_set_new(rootJ, "overdubSaturation", json_boolean(overdubSaturation));
+
+  // Save telemetry overlay
+  json_object_set_new(rootJ, "showTelemetry", json_boolean(showTelemetry));
+
   return rootJ;
 }
 
@@ -1046,6 +1351,144 @@ void Tapestry::dataFromJson(json_t* rootJ)
       waveformColor = static_cast<WaveformColor>(colorInt);
     }
   }
+
+  // Load marker snapping
+  json_t* snapJ = json_object_get(rootJ, "snapMarkersToZeroCrossings");
+  if (snapJ)
+  {
+    snapMarkersToZeroCrossings = json_boolean_value(snapJ);
+  }
+
+  // Load select order
+  json_t* sortModeJ = json_object_get(rootJ, "organizeSortMode");
+  if (sortModeJ)
+  {
+    int mode = json_integer_value(sortModeJ);
+    if (mode >= 0 && mode < static_cast<int>(ShortwavDSP::OrganizeSortMode::NUM_MODES))
+    {
+      selectOrder = static_cast<ShortwavDSP::OrganizeSortMode>(mode);
+    }
+  }
+
+  // Load tempo lock
+  json_t* tempoLockJ = json_object_get(rootJ, "tempoLock");
+  if (tempoLockJ)
+  {
+    tempoLock = json_boolean_value(tempoLockJ);
+  }
+
+  // Load playback mode
+  json_t* playbackModeJ = json_object_get(rootJ, "playbackMode");
+  if (playbackModeJ)
+  {
+    int mode = json_integer_value(playbackModeJ);
+    if (mode >= 0 && mode < static_cast<int>(ShortwavDSP::PlaybackMode::NUM_MODES))
+    {
+      playbackMode = static_cast<ShortwavDSP::PlaybackMode>(mode);
+    }
+  }
+
+  json_t* spectralStretchJ = json_object_get(rootJ, "spectralStretch");
+  if (spectralStretchJ)
+  {
+    spectralStretch = clamp(static_cast<float>(json_number_value(spectralStretchJ)), 1.0f,
+                            ShortwavDSP::GrainEngine::kMaxSpectralStretch);
+  }
+
+  json_t* freezeOnStopJ = json_object_get(rootJ, "freezeOnStop");
+  if (freezeOnStopJ)
+  {
+    freezeOnStop = json_boolean_value(freezeOnStopJ);
+  }
+
+  // Load interpolation quality
+  json_t* interpolationQualityJ = json_object_get(rootJ, "interpolationQuality");
+  if (interpolationQualityJ)
+  {
+    int quality = json_integer_value(interpolationQualityJ);
+    if (quality >= 0 && quality < static_cast<int>(ShortwavDSP::InterpolationQuality::NUM_QUALITIES))
+    {
+      interpolationQuality = static_cast<ShortwavDSP::InterpolationQuality>(quality);
+    }
+  }
+
+  // Load read heads
+  json_t* readHeadCountJ = json_object_get(rootJ, "readHeadCount");
+  if (readHeadCountJ)
+  {
+    int count = json_integer_value(readHeadCountJ);
+    readHeadCount = (count >= 2 && count <= ShortwavDSP::MultiTapHeads::kMaxHeads) ? count : 0;
+  }
+
+  json_t* separateHeadOutputsJ = json_object_get(rootJ, "separateHeadOutputs");
+  if (separateHeadOutputsJ)
+  {
+    separateHeadOutputs = json_boolean_value(separateHeadOutputsJ);
+  }
+
+  json_t* readHeadsJ = json_object_get(rootJ, "readHeads");
+  if (readHeadsJ && json_is_array(readHeadsJ))
+  {
+    size_t count = std::min(json_array_size(readHeadsJ),
+                            static_cast<size_t>(ShortwavDSP::MultiTapHeads::kMaxHeads));
+    for (size_t k = 0; k < count; k++)
+    {
+      json_t* headJ = json_array_get(readHeadsJ, k);
+      if (!json_is_object(headJ))
+        continue;
+      json_t* spliceJ = json_object_get(headJ, "splice");
+      if (spliceJ)
+        readHeads[k].splice = std::max(-1, static_cast<int>(json_integer_value(spliceJ)));
+      json_t* slideJ = json_object_get(headJ, "slide");
+      if (slideJ)
+        readHeads[k].slide = clamp(static_cast<float>(json_number_value(slideJ)), 0.0f, 1.0f);
+      json_t* speedJ = json_object_get(headJ, "speed");
+      if (speedJ)
+        readHeads[k].speed = clamp(static_cast<float>(json_number_value(speedJ)), -4.0f, 4.0f);
+      json_t* gainJ = json_object_get(headJ, "gain");
+      if (gainJ)
+        readHeads[k].gain = clamp(static_cast<float>(json_number_value(gainJ)), 0.0f, 2.0f);
+    }
+  }
+
+  // Load control rate and audio-rate CV inputs
+  json_t* controlRateJ = json_object_get(rootJ, "controlRate");
+  if (controlRateJ)
+  {
+    controlRate = clamp(static_cast<int>(json_integer_value(controlRateJ)), 1,
+                        ShortwavDSP::TapestryDSP::kMaxControlRate);
+  }
+
+  json_t* audioRateCvJ = json_object_get(rootJ, "audioRateCv");
+  if (audioRateCvJ && json_is_array(audioRateCvJ))
+  {
+    size_t count = std::min(json_array_size(audioRateCvJ),
+                            static_cast<size_t>(ShortwavDSP::ControlParam::NUM_PARAMS));
+    for (size_t p = 0; p < count; p++)
+    {
+      audioRateCv[p] = json_boolean_value(json_array_get(audioRateCvJ, p));
+    }
+  }
+
+  // Load overdub feedback
+  json_t* overdubFeedbackJ = json_object_get(rootJ, "overdubFeedback");
+  if (overdubFeedbackJ)
+  {
+    overdubFeedback = clamp(static_cast<float>(json_number_value(overdubFeedbackJ)), 0.0f, 1.0f);
+  }
+
+  json_t* overdubSaturationJ = json_object_get(rootJ, "overdubSaturation");
+  if (overdubSaturationJ)
+  {
+    overdubSaturation = json_boolean_value(overdubSaturationJ);
+  }
+
+  // Load telemetry overlay
+  json_t* showTelemetryJ = json_object_get(rootJ, "showTelemetry");
+  if (showTelemetryJ)
+  {
+    showTelemetry = json_boolean_value(showTelemetryJ);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -1073,6 +1516,8 @@ void ReelDisplay::draw(const DrawArgs& args)
   drawGeneWindow(args);
   drawPlayhead(args);
   drawHoverIndicator(args);
+  if (module->showTelemetry)
+    drawTelemetry(args);
 }
 
 void ReelDisplay::drawWaveform(const DrawArgs& args)
@@ -1321,6 +1766,52 @@ void ReelDisplay::drawHoverIndicator(const DrawArgs& args)
   nvgFill(args.vg);
 }
 
+void ReelDisplay::drawTelemetry(const DrawArgs& args)
+{
+  using ShortwavDSP::Telemetry;
+  using ShortwavDSP::TelemetryStage;
+
+  std::shared_ptr<window::Font> font = APP->window->loadFont(asset::system("res/fonts/ShareTechMono-Regular.ttf"));
+  if (!font)
+    return;
+
+  // Panel behind the text so it stays readable over the waveform
+  const float lineHeight = 9.5f;
+  const int numLines = Telemetry::kNumStages + 1;
+  nvgBeginPath(args.vg);
+  nvgRoundedRect(args.vg, 3.0f, 3.0f, 160.0f, numLines * lineHeight + 4.0f, 2.0f);
+  nvgFillColor(args.vg, nvgRGBA(0, 0, 0, 170));
+  nvgFill(args.vg);
+
+  nvgFontFaceId(args.vg, font->handle);
+  nvgFontSize(args.vg, 9.0f);
+  nvgTextAlign(args.vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+  nvgFillColor(args.vg, nvgRGBA(220, 220, 220, 230));
+
+  float y = 5.0f;
+  nvgText(args.vg, 6.0f, y, "us/block  mean   p99   max", nullptr);
+
+  // Stage lines appear once the tick rate is calibrated (50 ms after showing)
+  double ticksPerSecond = module->telemetry.getTicksPerSecond();
+  double budget = Telemetry::blockMicros(APP->engine->getSampleRate());
+  for (int s = 0; s < Telemetry::kNumStages; s++)
+  {
+    TelemetryStage stage = static_cast<TelemetryStage>(s);
+    Telemetry::Stats stats = module->telemetry.getStats(stage, ticksPerSecond);
+    y += lineHeight;
+    if (stats.blocks == 0)
+      continue;
+
+    std::string line = string::f("%-8s %6.1f %5.1f %5.1f", Telemetry::stageName(stage),
+                                 stats.meanMicros, stats.p99Micros, stats.maxMicros);
+    if (stage == TelemetryStage::Total && budget > 0.0)
+    {
+      line += string::f(" %4.1f%%", 100.0 * stats.meanMicros / budget);
+    }
+    nvgText(args.vg, 6.0f, y, line.c_str(), nullptr);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Mouse Event Handlers
 //------------------------------------------------------------------------------
@@ -1561,6 +2052,9 @@ TapestryWidget::TapestryWidget(Tapestry* module)
   addParam(createParamCentered<Trimpot>(Vec(xCenter - 30, speedPos + 40), module, Tapestry::VARI_SPEED_CV_ATTEN));
   addInput(createInputCentered<PJ301MPort>(Vec(xCenter + 30, speedPos + 40), module, Tapestry::VARI_SPEED_CV_INPUT));
 
+  // V/Oct (between the Speed CV attenuverter and jack)
+  addInput(createInputCentered<PJ301MPort>(Vec(xCenter, speedPos + 42), module, Tapestry::VOCT_INPUT));
+
    // Activity windows (RGB LEDs)
   addChild(createLightCentered<LargeLight<RedGreenBlueLight>>(
       Vec(55, speedPos), module, Tapestry::VARI_SPEED_LEFT_LIGHT));
@@ -1668,13 +2162,35 @@ void TapestryWidget::appendContextMenu(Menu* menu)
   saveItem->module = module;
   menu->addChild(saveItem);
 
-  // Clear reel
-  struct ClearReelItem : MenuItem
+  // Export the event trace for chrome://tracing or Perfetto
+  struct ExportTraceItem : MenuItem
   {
     Tapestry* module;
     void onAction(const event::Action& e) override
     {
-      module->dsp.clearReel();
+      osdialog_filters* filters = osdialog_filters_parse("Trace files:json");
+      char* path = osdialog_file(OSDIALOG_SAVE, NULL, "tapestry_trace.json", filters);
+      if (path)
+      {
+        module->exportTrace(path);
+        std::free(path);
+      }
+      osdialog_filters_free(filters);
+    }
+  };
+
+  ExportTraceItem* traceItem = new ExportTraceItem();
+  traceItem->text = "Export Event Trace...";
+  traceItem->module = module;
+  menu->addChild(traceItem);
+
+  // Clear reel
+  struct ClearReelItem : MenuItem
+  {
+    Tapestry* module;
+    void onAction(const event::Action& e) override
+    {
+      module->dsp.clearReel();
     }
   };
 
@@ -1702,6 +2218,583 @@ void TapestryWidget::appendContextMenu(Menu* menu)
   spliceCountItem->module = module;
   menu->addChild(spliceCountItem);
 
+  // Marker snapping toggle
+  struct SnapMarkersItem : MenuItem
+  {
+    Tapestry* module;
+    void onAction(const event::Action& e) override
+    {
+      module->snapMarkersToZeroCrossings = !module->snapMarkersToZeroCrossings;
+    }
+  };
+
+  SnapMarkersItem* snapItem = new SnapMarkersItem();
+  snapItem->text = "Snap Markers to Zero Crossings";
+  snapItem->rightText = module->snapMarkersToZeroCrossings ? "✓" : "";
+  snapItem->module = module;
+  menu->addChild(snapItem);
+
+  // Select order submenu
+  struct SelectOrderItem : MenuItem
+  {
+    Tapestry* module;
+    ShortwavDSP::OrganizeSortMode mode;
+
+    void onAction(const event::Action& e) override
+    {
+      module->selectOrder = mode;
+    }
+  };
+
+  struct SelectOrderMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const char* orderNames[] = {"Position", "Loudness", "Peak", "Brightness", "Length"};
+      for (int i = 0; i < static_cast<int>(ShortwavDSP::OrganizeSortMode::NUM_MODES); i++)
+      {
+        SelectOrderItem* orderItem = new SelectOrderItem();
+        orderItem->text = orderNames[i];
+        orderItem->module = module;
+        orderItem->mode = static_cast<ShortwavDSP::OrganizeSortMode>(i);
+        orderItem->rightText = (module->selectOrder == orderItem->mode) ? "✓" : "";
+        submenu->addChild(orderItem);
+      }
+
+      return submenu;
+    }
+  };
+
+  SelectOrderMenu* orderMenu = new SelectOrderMenu();
+  orderMenu->text = "Select Order";
+  orderMenu->rightText = RIGHT_ARROW;
+  orderMenu->module = module;
+  menu->addChild(orderMenu);
+
+  // Beat grid submenu
+  struct BeatGridSpliceItem : MenuItem
+  {
+    Tapestry* module;
+    int beatsPerMarker;
+
+    void onAction(const event::Action& e) override
+    {
+      module->pendingBeatGridSplice.store(beatsPerMarker);
+    }
+  };
+
+  struct BeatGridMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const ShortwavDSP::BeatGrid grid = module->dsp.getPublishedBeatGrid();
+      if (grid.valid)
+        submenu->addChild(createMenuLabel(string::f("Tempo: %.1f BPM", grid.bpm)));
+      else
+        submenu->addChild(createMenuLabel("Tempo: not detected"));
+
+      const int beatOptions[] = {1, 2, 4};
+      const char* beatNames[] = {"Markers Every Beat", "Markers Every 2 Beats", "Markers Every 4 Beats"};
+      for (int i = 0; i < 3; i++)
+      {
+        BeatGridSpliceItem* spliceItem = new BeatGridSpliceItem();
+        spliceItem->text = beatNames[i];
+        spliceItem->module = module;
+        spliceItem->beatsPerMarker = beatOptions[i];
+        spliceItem->disabled = !grid.valid;
+        submenu->addChild(spliceItem);
+      }
+
+      return submenu;
+    }
+  };
+
+  BeatGridMenu* beatGridMenu = new BeatGridMenu();
+  beatGridMenu->text = "Beat Grid";
+  beatGridMenu->rightText = RIGHT_ARROW;
+  beatGridMenu->module = module;
+  menu->addChild(beatGridMenu);
+
+  // Tempo lock toggle
+  struct TempoLockItem : MenuItem
+  {
+    Tapestry* module;
+    void onAction(const event::Action& e) override
+    {
+      module->tempoLock = !module->tempoLock;
+    }
+  };
+
+  TempoLockItem* tempoLockItem = new TempoLockItem();
+  tempoLockItem->text = "Lock Speed to Clock";
+  tempoLockItem->rightText = module->tempoLock ? "✓" : "";
+  tempoLockItem->module = module;
+  menu->addChild(tempoLockItem);
+
+  // Playback mode submenu
+  struct PlaybackModeItem : MenuItem
+  {
+    Tapestry* module;
+    ShortwavDSP::PlaybackMode mode;
+
+    void onAction(const event::Action& e) override
+    {
+      module->playbackMode = mode;
+    }
+  };
+
+  struct PlaybackModeMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const char* modeNames[] = {"Granular (Speed Shifts Pitch)", "Pitch-Preserving (WSOLA)",
+                                 "Spectral (Phase Vocoder)"};
+      for (int i = 0; i < static_cast<int>(ShortwavDSP::PlaybackMode::NUM_MODES); i++)
+      {
+        PlaybackModeItem* modeItem = new PlaybackModeItem();
+        modeItem->text = modeNames[i];
+        modeItem->module = module;
+        modeItem->mode = static_cast<ShortwavDSP::PlaybackMode>(i);
+        modeItem->rightText = (module->playbackMode == modeItem->mode) ? "✓" : "";
+        submenu->addChild(modeItem);
+      }
+
+      return submenu;
+    }
+  };
+
+  PlaybackModeMenu* playbackModeMenu = new PlaybackModeMenu();
+  playbackModeMenu->text = "Playback Mode";
+  playbackModeMenu->rightText = RIGHT_ARROW;
+  playbackModeMenu->module = module;
+  menu->addChild(playbackModeMenu);
+
+  // Spectral stretch submenu
+  struct SpectralStretchItem : MenuItem
+  {
+    Tapestry* module;
+    float factor;
+
+    void onAction(const event::Action& e) override
+    {
+      module->spectralStretch = factor;
+    }
+  };
+
+  struct SpectralStretchMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const float factors[] = {1.0f, 4.0f, 16.0f, 100.0f};
+      const char* factorNames[] = {"1x", "4x", "16x", "100x"};
+      for (int i = 0; i < 4; i++)
+      {
+        SpectralStretchItem* stretchItem = new SpectralStretchItem();
+        stretchItem->text = factorNames[i];
+        stretchItem->module = module;
+        stretchItem->factor = factors[i];
+        stretchItem->rightText = (module->spectralStretch == factors[i]) ? "✓" : "";
+        submenu->addChild(stretchItem);
+      }
+
+      return submenu;
+    }
+  };
+
+  SpectralStretchMenu* spectralStretchMenu = new SpectralStretchMenu();
+  spectralStretchMenu->text = "Spectral Stretch";
+  spectralStretchMenu->rightText = RIGHT_ARROW;
+  spectralStretchMenu->module = module;
+  menu->addChild(spectralStretchMenu);
+
+  // Freeze when stopped toggle
+  struct FreezeOnStopItem : MenuItem
+  {
+    Tapestry* module;
+    void onAction(const event::Action& e) override
+    {
+      module->freezeOnStop = !module->freezeOnStop;
+    }
+  };
+
+  FreezeOnStopItem* freezeOnStopItem = new FreezeOnStopItem();
+  freezeOnStopItem->text = "Freeze When Stopped";
+  freezeOnStopItem->rightText = module->freezeOnStop ? "✓" : "";
+  freezeOnStopItem->module = module;
+  menu->addChild(freezeOnStopItem);
+
+  // Interpolation quality submenu
+  struct InterpolationQualityItem : MenuItem
+  {
+    Tapestry* module;
+    ShortwavDSP::InterpolationQuality quality;
+
+    void onAction(const event::Action& e) override
+    {
+      module->interpolationQuality = quality;
+    }
+  };
+
+  struct InterpolationQualityMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const char* qualityNames[] = {"None (Draft)", "Linear", "Hermite (Standard)", "Lagrange 6-Point",
+                                    "Sinc 8 Taps", "Sinc 16 Taps", "Sinc 32 Taps (Best)"};
+      for (int i = 0; i < static_cast<int>(ShortwavDSP::InterpolationQuality::NUM_QUALITIES); i++)
+      {
+        InterpolationQualityItem* qualityItem = new InterpolationQualityItem();
+        qualityItem->text = qualityNames[i];
+        qualityItem->module = module;
+        qualityItem->quality = static_cast<ShortwavDSP::InterpolationQuality>(i);
+        qualityItem->rightText = (module->interpolationQuality == qualityItem->quality) ? "✓" : "";
+        submenu->addChild(qualityItem);
+      }
+
+      return submenu;
+    }
+  };
+
+  InterpolationQualityMenu* interpolationQualityMenu = new InterpolationQualityMenu();
+  interpolationQualityMenu->text = "Interpolation Quality";
+  interpolationQualityMenu->rightText = RIGHT_ARROW;
+  interpolationQualityMenu->module = module;
+  menu->addChild(interpolationQualityMenu);
+
+  // Multi-tap read heads submenu
+  struct ReadHeadCountItem : MenuItem
+  {
+    Tapestry* module;
+    int count;
+
+    void onAction(const event::Action& e) override
+    {
+      module->readHeadCount = count;
+    }
+  };
+
+  struct ReadHeadValueItem : MenuItem
+  {
+    Tapestry* module;
+    int head;
+    int field;  // 0 = splice, 1 = slide, 2 = speed, 3 = gain
+    float value;
+
+    void onAction(const event::Action& e) override
+    {
+      ShortwavDSP::ReadHeadSettings& settings = module->readHeads[head];
+      switch (field)
+      {
+      case 0: settings.splice = static_cast<int>(value); break;
+      case 1: settings.slide = value; break;
+      case 2: settings.speed = value; break;
+      default: settings.gain = value; break;
+      }
+    }
+  };
+
+  struct ReadHeadFieldMenu : MenuItem
+  {
+    Tapestry* module;
+    int head;
+    int field;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+      const ShortwavDSP::ReadHeadSettings& settings = module->readHeads[head];
+
+      std::vector<float> values;
+      std::vector<std::string> names;
+      float current = 0.0f;
+      switch (field)
+      {
+      case 0:
+        values.push_back(-1.0f);
+        names.push_back("Follow Current");
+        for (int i = 0; i < 8; i++)
+        {
+          values.push_back(static_cast<float>(i));
+          names.push_back(string::f("Marker %d", i + 1));
+        }
+        current = static_cast<float>(settings.splice);
+        break;
+      case 1:
+        for (int i = 0; i < 8; i++)
+        {
+          values.push_back(i / 8.0f);
+          names.push_back(string::f("%g%%", i * 12.5f));
+        }
+        current = settings.slide;
+        break;
+      case 2:
+      {
+        const float speeds[] = {-2.0f, -1.0f, -0.5f, 0.5f, 1.0f, 1.5f, 2.0f};
+        for (float v : speeds)
+        {
+          values.push_back(v);
+          names.push_back(string::f("%gx", v));
+        }
+        current = settings.speed;
+        break;
+      }
+      default:
+      {
+        const float gains[] = {0.0f, 0.25f, 0.5f, 1.0f};
+        const char* gainNames[] = {"Muted", "-12 dB", "-6 dB", "0 dB"};
+        for (int i = 0; i < 4; i++)
+        {
+          values.push_back(gains[i]);
+          names.push_back(gainNames[i]);
+        }
+        current = settings.gain;
+        break;
+      }
+      }
+
+      for (size_t i = 0; i < values.size(); i++)
+      {
+        ReadHeadValueItem* valueItem = new ReadHeadValueItem();
+        valueItem->text = names[i];
+        valueItem->module = module;
+        valueItem->head = head;
+        valueItem->field = field;
+        valueItem->value = values[i];
+        valueItem->rightText = (current == values[i]) ? "✓" : "";
+        submenu->addChild(valueItem);
+      }
+
+      return submenu;
+    }
+  };
+
+  struct ReadHeadMenu : MenuItem
+  {
+    Tapestry* module;
+    int head;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const char* fieldNames[] = {"Marker", "Slide", "Speed", "Gain"};
+      for (int field = 0; field < 4; field++)
+      {
+        ReadHeadFieldMenu* fieldMenu = new ReadHeadFieldMenu();
+        fieldMenu->text = fieldNames[field];
+        fieldMenu->rightText = RIGHT_ARROW;
+        fieldMenu->module = module;
+        fieldMenu->head = head;
+        fieldMenu->field = field;
+        submenu->addChild(fieldMenu);
+      }
+
+      return submenu;
+    }
+  };
+
+  struct SeparateHeadOutputsItem : MenuItem
+  {
+    Tapestry* module;
+    void onAction(const event::Action& e) override
+    {
+      module->separateHeadOutputs = !module->separateHeadOutputs;
+    }
+  };
+
+  struct ReadHeadsMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const int counts[] = {0, 2, 3, 4, 5, 6, 7, 8};
+      for (int count : counts)
+      {
+        ReadHeadCountItem* countItem = new ReadHeadCountItem();
+        countItem->text = (count == 0) ? "Off" : string::f("%d Heads", count);
+        countItem->module = module;
+        countItem->count = count;
+        countItem->rightText = (module->readHeadCount == count) ? "✓" : "";
+        submenu->addChild(countItem);
+      }
+
+      SeparateHeadOutputsItem* separateItem = new SeparateHeadOutputsItem();
+      separateItem->text = "Separate Outputs (Poly)";
+      separateItem->rightText = module->separateHeadOutputs ? "✓" : "";
+      separateItem->module = module;
+      submenu->addChild(separateItem);
+
+      for (int head = 0; head < module->readHeadCount; head++)
+      {
+        ReadHeadMenu* headMenu = new ReadHeadMenu();
+        headMenu->text = string::f("Head %d", head + 1);
+        headMenu->rightText = RIGHT_ARROW;
+        headMenu->module = module;
+        headMenu->head = head;
+        submenu->addChild(headMenu);
+      }
+
+      return submenu;
+    }
+  };
+
+  ReadHeadsMenu* readHeadsMenu = new ReadHeadsMenu();
+  readHeadsMenu->text = "Read Heads";
+  readHeadsMenu->rightText = RIGHT_ARROW;
+  readHeadsMenu->module = module;
+  menu->addChild(readHeadsMenu);
+
+  // Control rate submenu
+  struct ControlRateItem : MenuItem
+  {
+    Tapestry* module;
+    int rate;
+
+    void onAction(const event::Action& e) override
+    {
+      module->controlRate = rate;
+    }
+  };
+
+  struct AudioRateCvItem : MenuItem
+  {
+    Tapestry* module;
+    int param;
+
+    void onAction(const event::Action& e) override
+    {
+      module->audioRateCv[param] = !module->audioRateCv[param];
+    }
+  };
+
+  struct ControlRateMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      const int rates[] = {1, 16, 32, 64};
+      const char* rateNames[] = {"Every Sample", "Every 16 Samples", "Every 32 Samples (Standard)",
+                                 "Every 64 Samples (Lowest CPU)"};
+      for (int i = 0; i < 4; i++)
+      {
+        ControlRateItem* rateItem = new ControlRateItem();
+        rateItem->text = rateNames[i];
+        rateItem->module = module;
+        rateItem->rate = rates[i];
+        rateItem->rightText = (module->controlRate == rates[i]) ? "✓" : "";
+        submenu->addChild(rateItem);
+      }
+
+      submenu->addChild(new MenuEntry);
+      submenu->addChild(createMenuLabel("Audio-Rate CV Inputs"));
+
+      const char* inputNames[] = {"S.O.S.", "Gene Size", "Vari-Speed", "Morph", "Scan", "Organize", "V/Oct"};
+      for (int p = 0; p < static_cast<int>(ShortwavDSP::ControlParam::NUM_PARAMS); p++)
+      {
+        AudioRateCvItem* cvItem = new AudioRateCvItem();
+        cvItem->text = inputNames[p];
+        cvItem->module = module;
+        cvItem->param = p;
+        cvItem->rightText = module->audioRateCv[p] ? "✓" : "";
+        submenu->addChild(cvItem);
+      }
+
+      return submenu;
+    }
+  };
+
+  ControlRateMenu* controlRateMenu = new ControlRateMenu();
+  controlRateMenu->text = "Control Rate";
+  controlRateMenu->rightText = RIGHT_ARROW;
+  controlRateMenu->module = module;
+  menu->addChild(controlRateMenu);
+
+  // Overdub feedback submenu
+  struct OverdubFeedbackItem : MenuItem
+  {
+    Tapestry* module;
+    float feedback;
+
+    void onAction(const event::Action& e) override
+    {
+      module->overdubFeedback = feedback;
+    }
+  };
+
+  struct OverdubSaturationItem : MenuItem
+  {
+    Tapestry* module;
+
+    void onAction(const event::Action& e) override
+    {
+      module->overdubSaturation = !module->overdubSaturation;
+    }
+  };
+
+  struct OverdubMenu : MenuItem
+  {
+    Tapestry* module;
+
+    Menu* createChildMenu() override
+    {
+      Menu* submenu = new Menu;
+
+      submenu->addChild(createMenuLabel("Layer Feedback"));
+      const float feedbacks[] = {1.0f, 0.95f, 0.9f, 0.8f, 0.7f, 0.5f};
+      const char* feedbackNames[] = {"100% (Sum, Standard)", "95%", "90%", "80%", "70%", "50%"};
+      for (int i = 0; i < 6; i++)
+      {
+        OverdubFeedbackItem* feedbackItem = new OverdubFeedbackItem();
+        feedbackItem->text = feedbackNames[i];
+        feedbackItem->module = module;
+        feedbackItem->feedback = feedbacks[i];
+        feedbackItem->rightText = (std::fabs(module->overdubFeedback - feedbacks[i]) < 1e-4f) ? "✓" : "";
+        submenu->addChild(feedbackItem);
+      }
+
+      submenu->addChild(new MenuEntry);
+      OverdubSaturationItem* saturationItem = new OverdubSaturationItem();
+      saturationItem->text = "Soft Saturation";
+      saturationItem->module = module;
+      saturationItem->rightText = module->overdubSaturation ? "✓" : "";
+      submenu->addChild(saturationItem);
+
+      return submenu;
+    }
+  };
+
+  OverdubMenu* overdubMenu = new OverdubMenu();
+  overdubMenu->text = "Overdub";
+  overdubMenu->rightText = RIGHT_ARROW;
+  overdubMenu->module = module;
+  menu->addChild(overdubMenu);
+
   // Waveform color selection submenu
   menu->addChild(new MenuEntry);
   
@@ -1745,6 +2838,23 @@ void TapestryWidget::appendContextMenu(Menu* menu)
   colorMenu->module = module;
   menu->addChild(colorMenu);
 
+  // CPU telemetry overlay on the reel display
+  struct ShowTelemetryItem : MenuItem
+  {
+    Tapestry* module;
+
+    void onAction(const event::Action& e) override
+    {
+      module->showTelemetry = !module->showTelemetry;
+    }
+  };
+
+  ShowTelemetryItem* telemetryItem = new ShowTelemetryItem();
+  telemetryItem->text = "Show CPU Telemetry";
+  telemetryItem->module = module;
+  telemetryItem->rightText = module->showTelemetry ? "✓" : "";
+  menu->addChild(telemetryItem);
+
   // Show current file info
   if (!module->currentFileName.empty())
   {
@@ -6,6 +6,7 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 
 // Forward declarations for UI components
 struct ReelDisplay;
@@ -24,6 +25,9 @@ struct TapestryWidget;
  * - Vari-Speed: Bipolar speed/direction control
  * - Mix: Crossfade recording
  * - Time Stretch: Clock-synced granular playback
+ * - Select Order: Step through splices by loudness, peak, brightness or length
+ * - Beat Grid: Reel tempo detection, beat-aligned markers, clock-locked speed
+ * - Pitch-preserving playback: Speed changes tempo without changing pitch
  */
 
 struct Tapestry : Module
@@ -101,6 +105,9 @@ struct Tapestry : Module
     CLEAR_SPLICES_INPUT,
     SPLICE_COUNT_TOGGLE_INPUT,
 
+    // Pitch input (polyphonic with PLAY and Scan CV)
+    VOCT_INPUT,
+
     NUM_INPUTS
   };
 
@@ -197,6 +204,19 @@ struct Tapestry : Module
   std::string currentFileName;
   std::mutex fileMutex;
 
+  //--------------------------------------------------------------------------
+  // Background Analysis
+  //--------------------------------------------------------------------------
+
+  std::thread analysisThread;
+  std::atomic<bool> analysisRunning{false};
+  std::mutex analysisMutex;
+  std::condition_variable analysisCv;
+  static constexpr int kAnalysisIntervalMs = 100;
+
+  void startAnalysisThread();
+  void stopAnalysisThread();
+
   // Pending splice data from JSON deserialization
   std::vector<size_t> pendingSpliceMarkers_;
   int pendingSpliceIndex_ = -1;
@@ -219,17 +239,98 @@ struct Tapestry : Module
   //--------------------------------------------------------------------------
 
   dsp::PulseGenerator eosgPulse;
+  dsp::PulseGenerator polyEosgPulses[ShortwavDSP::PolyPlayheads::kMaxChannels];  // One per poly voice
   static constexpr float kEosgPulseWidth = 0.001f; // 1ms pulse
 
   // Track expander changes to avoid consuming stale processed audio
   int64_t lastRightExpanderModuleId_ = -1;
 
+  // Block transport to the expander (fixed latency of kLatencyFrames)
+  TapestryExpanderLink expanderLink_;
+
   //--------------------------------------------------------------------------
   // Waveform Display Settings
   //--------------------------------------------------------------------------
 
   WaveformColor waveformColor = WaveformColor::BabyBlue;
 
+  //--------------------------------------------------------------------------
+  // Marker Placement Settings
+  //--------------------------------------------------------------------------
+
+  // Snap new markers to the nearest zero crossing to avoid clicks
+  bool snapMarkersToZeroCrossings = true;
+
+  // Order in which the Select knob steps through splices
+  ShortwavDSP::OrganizeSortMode selectOrder = ShortwavDSP::OrganizeSortMode::Position;
+
+  //--------------------------------------------------------------------------
+  // Beat Grid Settings
+  //--------------------------------------------------------------------------
+
+  // Lock Speed to the clock input using the detected reel tempo
+  bool tempoLock = false;
+
+  // Beats per marker requested from the context menu (0 = none pending)
+  std::atomic<int> pendingBeatGridSplice{0};
+
+  //--------------------------------------------------------------------------
+  // Playback Settings
+  //--------------------------------------------------------------------------
+
+  ShortwavDSP::PlaybackMode playbackMode = ShortwavDSP::PlaybackMode::Granular;
+
+  // Spectral mode tempo divisor
+  float spectralStretch = 1.0f;
+
+  // Hold a spectral freeze instead of silence when Speed is stopped
+  bool freezeOnStop = false;
+
+  // Grain read quality (CPU vs. aliasing at high Speed)
+  ShortwavDSP::InterpolationQuality interpolationQuality = ShortwavDSP::InterpolationQuality::Hermite;
+
+  // Multi-tap read heads (0 = off, 2-8) and their settings
+  int readHeadCount = 0;
+  ShortwavDSP::ReadHeadSettings readHeads[ShortwavDSP::MultiTapHeads::kMaxHeads];
+
+  // Output each read head on its own channel (channel 1 = main playhead)
+  bool separateHeadOutputs = false;
+
+  // Samples between knob/CV reads (the DSP ramps in between)
+  int controlRate = 32;
+
+  // CV inputs read every sample instead of at control rate
+  bool audioRateCv[static_cast<int>(ShortwavDSP::ControlParam::NUM_PARAMS)] = {};
+
+  // Overdub layer decay (1 = plain sum) and soft saturation of the layers
+  float overdubFeedback = 1.0f;
+  bool overdubSaturation = false;
+
+  //--------------------------------------------------------------------------
+  // Telemetry
+  //--------------------------------------------------------------------------
+
+  // Per-stage CPU overlay on the reel display; stages are only timed while
+  // it is shown
+  bool showTelemetry = false;
+
+  // Filled by the audio thread, read by the reel display
+  ShortwavDSP::Telemetry telemetry;
+  bool telemetryActive = false;  // Audio thread copy of showTelemetry
+
+  //--------------------------------------------------------------------------
+  // Event Trace
+  //--------------------------------------------------------------------------
+
+  // Always recording (a few atomic stores per event); exported from the
+  // context menu as Chrome trace JSON
+  ShortwavDSP::TraceRing trace;
+  ShortwavDSP::UnderrunDetector underrunDetector;
+  int underrunCheckCounter = 0;
+  static constexpr int kUnderrunCheckFrames = 256;
+
+  bool exportTrace(const std::string& path) const;
+
   // Get RGB values for current waveform color (0-255 range)
   void getWaveformColorRGB(int& r, int& g, int& b) const
   {
@@ -330,6 +431,7 @@ struct Tapestry : Module
     configInput(SHIFT_INPUT, "Next Gate");
     configInput(CLEAR_SPLICES_INPUT, "Clear Markers Gate");
     configInput(SPLICE_COUNT_TOGGLE_INPUT, "Auto Markers Gate");
+    configInput(VOCT_INPUT, "V/Oct");
 
     // Outputs
     configOutput(AUDIO_OUT_L, "Audio L");
@@ -345,10 +447,13 @@ struct Tapestry : Module
     rightExpander.producerMessage = new TapestryExpanderMessage();
     rightExpander.consumerMessage = new TapestryExpanderMessage();
 
+    dsp.setTrace(&trace);
     onSampleRateChange();
+    startAnalysisThread();
   }
 
   ~Tapestry() {
+    stopAnalysisThread();
     delete static_cast<TapestryExpanderMessage*>(rightExpander.producerMessage);
     delete static_cast<TapestryExpanderMessage*>(rightExpander.consumerMessage);
     rightExpander.producerMessage = nullptr;
@@ -363,6 +468,7 @@ struct Tapestry : Module
   {
     float sr = APP->engine->getSampleRate();
     dsp.setSampleRate(sr);
+    underrunDetector.reset();
   }
 
   //--------------------------------------------------------------------------
@@ -390,6 +496,13 @@ struct Tapestry : Module
 
   void processGateInputs(const ProcessArgs& args);
 
+  //--------------------------------------------------------------------------
+  // CV Processing
+  //--------------------------------------------------------------------------
+
+  // Read CV inputs due this sample (all of them on a control tick)
+  void processCvInputs(bool controlTick);
+
   //--------------------------------------------------------------------------
   // LED Updates
   //--------------------------------------------------------------------------
@@ -468,6 +581,7 @@ struct ReelDisplay : OpaqueWidget
   void drawPlayhead(const DrawArgs& args);
   void drawGeneWindow(const DrawArgs& args);
   void drawHoverIndicator(const DrawArgs& args);
+  void drawTelemetry(const DrawArgs& args);
   
   // Mouse event handlers
   void onButton(const ButtonEvent& e) override;
@@ -50,31 +50,22 @@ TapestryExpander::~TapestryExpander() {
 
 void TapestryExpander::onSampleRateChange()
 {
-    sampleRate_ = APP->engine->getSampleRate();
-    
-    // Initialize parameter smoothers (5ms smoothing time)
-    float smoothTimeMs = 5.0f;
-    smoothBits_.setSmoothTime(smoothTimeMs, sampleRate_);
-    smoothRate_.setSmoothTime(smoothTimeMs, sampleRate_);
-    smoothCrushMix_.setSmoothTime(smoothTimeMs, sampleRate_);
-    smoothCutoff_.setSmoothTime(smoothTimeMs, sampleRate_);
-    smoothReso_.setSmoothTime(smoothTimeMs, sampleRate_);
-    smoothFilterMix_.setSmoothTime(smoothTimeMs, sampleRate_);
-    smoothOutputLevel_.setSmoothTime(smoothTimeMs, sampleRate_);
+    // Recalculates the 5ms smoothing and the 20Hz DC blocker
+    chain_.setSampleRate(APP->engine->getSampleRate());
     
     // Initialize with current param values
-    smoothBits_.setImmediate(params[CRUSH_BITS_PARAM].getValue());
-    smoothRate_.setImmediate(params[CRUSH_RATE_PARAM].getValue());
-    smoothCrushMix_.setImmediate(params[CRUSH_MIX_PARAM].getValue());
-    smoothCutoff_.setImmediate(params[FILTER_CUTOFF_PARAM].getValue());
-    smoothReso_.setImmediate(params[FILTER_RESO_PARAM].getValue());
-    smoothFilterMix_.setImmediate(params[FILTER_MIX_PARAM].getValue());
-    smoothOutputLevel_.setImmediate(params[OUTPUT_LEVEL_PARAM].getValue());
-    
-    // Calculate DC blocking coefficient for 20Hz cutoff
-    // Using the formula: coeff = exp(-2π * cutoffHz / sampleRate)
-    const float dcCutoffHz = 20.0f;
-    dcBlockCoeff_ = std::exp(-2.0f * M_PI * dcCutoffHz / sampleRate_);
+    ExpanderEffectChain::Params current;
+    current.bits = params[CRUSH_BITS_PARAM].getValue();
+    current.rate = params[CRUSH_RATE_PARAM].getValue();
+    current.crushMix = params[CRUSH_MIX_PARAM].getValue();
+    current.cutoff = params[FILTER_CUTOFF_PARAM].getValue();
+    current.resonance = params[FILTER_RESO_PARAM].getValue();
+    current.filterMix = params[FILTER_MIX_PARAM].getValue();
+    current.outputLevel = params[OUTPUT_LEVEL_PARAM].getValue();
+    chain_.setImmediate(current);
+    inline_.chain.setSampleRate(APP->engine->getSampleRate());
+    inline_.chain.setImmediate(current);
+    inline_.publish(current);
 }
 
 //------------------------------------------------------------------------------
@@ -83,22 +74,56 @@ void TapestryExpander::onSampleRateChange()
 
 void TapestryExpander::onReset()
 {
-    bitCrusher_.reset();
-    moogFilterL_.reset();
-    moogFilterR_.reset();
-    
-    // Reset DC blockers
-    dcBlockerInL_ = dcBlockerInR_ = 0.0f;
-    dcBlockerOutL_ = dcBlockerOutR_ = 0.0f;
-    
-    // Reset smoothers to default values
-    smoothBits_.setImmediate(16.0f);
-    smoothRate_.setImmediate(0.0f);
-    smoothCrushMix_.setImmediate(0.0f);
-    smoothCutoff_.setImmediate(1.0f);
-    smoothReso_.setImmediate(0.0f);
-    smoothFilterMix_.setImmediate(0.0f);
-    smoothOutputLevel_.setImmediate(1.0f);
+    // Reset DSP state and smoothers to default values
+    chain_.reset();
+    chain_.setImmediate(ExpanderEffectChain::Params());
+    inline_.chain.reset();
+    inline_.chain.setImmediate(ExpanderEffectChain::Params());
+    inline_.publish(ExpanderEffectChain::Params());
+    inlineMode = true;
+    
+    // Republished by the next process() if still connected
+    published_.clear();
+}
+
+//------------------------------------------------------------------------------
+// Bypass / Removal
+//------------------------------------------------------------------------------
+
+// Bypassed, Rack calls this instead of process(). Withdraw the inline chain
+// so Tapestry's output stays dry; in message mode Tapestry's blocks simply
+// go unanswered and it falls back to the dry signal.
+void TapestryExpander::processBypass(const ProcessArgs& args)
+{
+    published_.clear();
+    lastSequence_ = 0;
+    lights[CONNECTED_LIGHT].setBrightness(0.0f);
+    Module::processBypass(args);
+}
+
+void TapestryExpander::onRemove(const RemoveEvent& e)
+{
+    published_.clear();
+    Module::onRemove(e);
+}
+
+//------------------------------------------------------------------------------
+// Serialization
+//------------------------------------------------------------------------------
+
+json_t* TapestryExpander::dataToJson()
+{
+    json_t* rootJ = json_object();
+    json_object_set_new(rootJ, "inlineMode", json_boolean(inlineMode));
+    return rootJ;
+}
+
+void TapestryExpander::dataFromJson(json_t* rootJ)
+{
+    json_t* inlineModeJ = json_object_get(rootJ, "inlineMode");
+    if (inlineModeJ) {
+        inlineMode = json_boolean_value(inlineModeJ);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -117,141 +142,87 @@ float TapestryExpander::getModulatedParam(int paramId, int cvId, float cvScale)
     return value;
 }
 
+//------------------------------------------------------------------------------
+// Get Control Targets
+//------------------------------------------------------------------------------
+
+// Knobs plus CV, clamped to range
+ExpanderEffectChain::Params TapestryExpander::getTargets()
+{
+    ExpanderEffectChain::Params targets;
+    
+    // Bit Crusher parameters
+    targets.bits = clamp(getModulatedParam(CRUSH_BITS_PARAM, CRUSH_BITS_CV_INPUT, 1.5f), 1.0f, 16.0f);
+    targets.rate = clamp(getModulatedParam(CRUSH_RATE_PARAM, CRUSH_RATE_CV_INPUT, 0.1f), 0.0f, 1.0f);
+    targets.crushMix = clamp(getModulatedParam(CRUSH_MIX_PARAM, CRUSH_MIX_CV_INPUT, 0.1f), 0.0f, 1.0f);
+    
+    // Filter parameters
+    targets.cutoff = clamp(getModulatedParam(FILTER_CUTOFF_PARAM, FILTER_CUTOFF_CV_INPUT, 0.1f), 0.0f, 1.0f);
+    targets.resonance = clamp(getModulatedParam(FILTER_RESO_PARAM, FILTER_RESO_CV_INPUT, 0.1f), 0.0f, 1.0f);
+    targets.filterMix = clamp(getModulatedParam(FILTER_MIX_PARAM, FILTER_MIX_CV_INPUT, 0.1f), 0.0f, 1.0f);
+    
+    targets.outputLevel = clamp(params[OUTPUT_LEVEL_PARAM].getValue(), 0.0f, 2.0f);
+    return targets;
+}
+
 //------------------------------------------------------------------------------
 // Main Process
 //------------------------------------------------------------------------------
 
 void TapestryExpander::process(const ProcessArgs& args)
 {
+    ShortwavDSP::ScopedFlushDenormals flushDenormals;
+
     // Check for Tapestry connection on the left
-    bool connected = false;
-    float inputL = 0.0f;
-    float inputR = 0.0f;
-    
     Module* tapestryModule = leftExpander.module;
-    const TapestryExpanderMessage* fromTapestry = nullptr;
-    
-    // Check if left module is Tapestry and read from our consumer buffer.
-    if (tapestryModule && tapestryModule->model == modelTapestry && leftExpander.consumerMessage) {
-        fromTapestry = static_cast<const TapestryExpanderMessage*>(leftExpander.consumerMessage);
-        connected = true;
-        inputL = fromTapestry->audioL;
-        inputR = fromTapestry->audioR;
-        sampleRate_ = fromTapestry->sampleRate;
-    }
+    bool connected = tapestryModule && tapestryModule->model == modelTapestry && leftExpander.consumerMessage;
     
     // Update connection LED
     lights[CONNECTED_LIGHT].setBrightness(connected ? 1.0f : 0.0f);
     
     // If not connected, nothing to do
     if (!connected) {
+        published_.clear();
+        lastSequence_ = 0;
         return;
     }
     
-    //--------------------------------------------------------------------------
-    // Read and smooth parameters with CV modulation
-    //--------------------------------------------------------------------------
-    
-    // Bit Crusher parameters
-    float bitsTarget = getModulatedParam(CRUSH_BITS_PARAM, CRUSH_BITS_CV_INPUT, 1.5f);
-    float rateTarget = getModulatedParam(CRUSH_RATE_PARAM, CRUSH_RATE_CV_INPUT, 0.1f);
-    float crushMixTarget = getModulatedParam(CRUSH_MIX_PARAM, CRUSH_MIX_CV_INPUT, 0.1f);
-    
-    // Filter parameters
-    float cutoffTarget = getModulatedParam(FILTER_CUTOFF_PARAM, FILTER_CUTOFF_CV_INPUT, 0.1f);
-    float resoTarget = getModulatedParam(FILTER_RESO_PARAM, FILTER_RESO_CV_INPUT, 0.1f);
-    float filterMixTarget = getModulatedParam(FILTER_MIX_PARAM, FILTER_MIX_CV_INPUT, 0.1f);
-
-    float outputLevelTarget = params[OUTPUT_LEVEL_PARAM].getValue();
-    
-    // Clamp targets
-    bitsTarget = clamp(bitsTarget, 1.0f, 16.0f);
-    rateTarget = clamp(rateTarget, 0.0f, 1.0f);
-    crushMixTarget = clamp(crushMixTarget, 0.0f, 1.0f);
-    cutoffTarget = clamp(cutoffTarget, 0.0f, 1.0f);
-    resoTarget = clamp(resoTarget, 0.0f, 1.0f);
-    filterMixTarget = clamp(filterMixTarget, 0.0f, 1.0f);
-    outputLevelTarget = clamp(outputLevelTarget, 0.0f, 2.0f);
-    
-    // Set targets for smoothing
-    smoothBits_.setTarget(bitsTarget);
-    smoothRate_.setTarget(rateTarget);
-    smoothCrushMix_.setTarget(crushMixTarget);
-    smoothCutoff_.setTarget(cutoffTarget);
-    smoothReso_.setTarget(resoTarget);
-    smoothFilterMix_.setTarget(filterMixTarget);
-    smoothOutputLevel_.setTarget(outputLevelTarget);
-    
-    // Get smoothed values
-    float bits = smoothBits_.process();
-    float rate = smoothRate_.process();
-    float crushMix = smoothCrushMix_.process();
-    float cutoff = smoothCutoff_.process();
-    float reso = smoothReso_.process();
-    float filterMix = smoothFilterMix_.process();
-    float outputLevel = smoothOutputLevel_.process();
-    
-    //--------------------------------------------------------------------------
-    // Update DSP parameters
-    //--------------------------------------------------------------------------
-    
-    bitCrusher_.setParams(bits, rate);
-    moogFilterL_.setParams(cutoff, reso, sampleRate_);
-    moogFilterR_.setParams(cutoff, reso, sampleRate_);
-    
-    //--------------------------------------------------------------------------
-    // DC Blocking on input (high-pass at ~20Hz to remove DC offset)
-    //--------------------------------------------------------------------------
-    
-    float blockedInL = inputL - dcBlockerInL_ + dcBlockCoeff_ * dcBlockerOutL_;
-    float blockedInR = inputR - dcBlockerInR_ + dcBlockCoeff_ * dcBlockerOutR_;
-    dcBlockerInL_ = inputL;
-    dcBlockerInR_ = inputR;
-    dcBlockerOutL_ = blockedInL;
-    dcBlockerOutR_ = blockedInR;
-    
-    //--------------------------------------------------------------------------
-    // Stage 1: Bit Crusher
-    //--------------------------------------------------------------------------
-    
-    float crushedL, crushedR;
-    bitCrusher_.processStereo(blockedInL, blockedInR, crushedL, crushedR);
-    
-    // Dry/Wet mix for bit crusher (use DC-blocked input for consistency)
-    float stage1L = blockedInL * (1.0f - crushMix) + crushedL * crushMix;
-    float stage1R = blockedInR * (1.0f - crushMix) + crushedR * crushMix;
-    
-    //--------------------------------------------------------------------------
-    // Stage 2: Moog VCF
-    //--------------------------------------------------------------------------
-    
-    float filteredL = moogFilterL_.process(stage1L);
-    float filteredR = moogFilterR_.process(stage1R);
+    // Inline mode: Tapestry runs inline_ itself; only the controls go across
+    if (inlineMode) {
+        inline_.publish(getTargets());
+        published_.publish(&inline_);
+        lastSequence_ = 0;
+        return;
+    }
+    published_.clear();
     
-    // Dry/Wet mix for filter
-    float outputL = stage1L * (1.0f - filterMix) + filteredL * filterMix;
-    float outputR = stage1R * (1.0f - filterMix) + filteredR * filterMix;
-
-    // Post-effects output gain (to compensate for perceived level loss)
-    outputL *= outputLevel;
-    outputR *= outputLevel;
+    // Tapestry flips our consumer buffer once per block; between blocks
+    // there is nothing to process.
+    const auto* fromTapestry = static_cast<const TapestryExpanderMessage*>(leftExpander.consumerMessage);
+    if (fromTapestry->sequence == 0 || fromTapestry->sequence == lastSequence_) {
+        return;
+    }
+    lastSequence_ = fromTapestry->sequence;
     
-    // Gentle soft clipping (tanh for smooth saturation)
-    outputL = std::tanh(outputL * 0.5f) * 2.0f;
-    outputR = std::tanh(outputR * 0.5f) * 2.0f;
+    if (fromTapestry->sampleRate != chain_.getSampleRate()) {
+        chain_.setSampleRate(fromTapestry->sampleRate);
+    }
     
-    // Hard limit to prevent any extreme spikes
-    outputL = clamp(outputL, -1.5f, 1.5f);
-    outputR = clamp(outputR, -1.5f, 1.5f);
+    // Controls are read once per block and smoothed per sample
+    chain_.setTargets(getTargets());
     
     //--------------------------------------------------------------------------
-    // Write processed audio back to Tapestry by writing into its rightExpander producer buffer.
+    // Process the block and write it back to Tapestry by writing into its
+    // rightExpander producer buffer.
     //--------------------------------------------------------------------------
 
-    if (tapestryModule && tapestryModule->rightExpander.producerMessage) {
+    if (tapestryModule->rightExpander.producerMessage) {
         auto* toTapestry = static_cast<TapestryExpanderMessage*>(tapestryModule->rightExpander.producerMessage);
-        toTapestry->processedL = outputL;
-        toTapestry->processedR = outputR;
+        const int frames = TapestryExpanderMessage::kBlockFrames;
+        std::copy(fromTapestry->audioL, fromTapestry->audioL + frames, toTapestry->processedL);
+        std::copy(fromTapestry->audioR, fromTapestry->audioR + frames, toTapestry->processedR);
+        chain_.process(toTapestry->processedL, toTapestry->processedR, frames);
+        toTapestry->sequence = fromTapestry->sequence;
         toTapestry->expanderConnected = true;
         tapestryModule->rightExpander.messageFlipRequested = true;
     }
@@ -355,6 +326,39 @@ TapestryExpanderWidget::TapestryExpanderWidget(TapestryExpander* module)
         Vec(colCenter, yPos), module, TapestryExpander::OUTPUT_LEVEL_PARAM));
 }
 
+//------------------------------------------------------------------------------
+// Context Menu
+//------------------------------------------------------------------------------
+
+void TapestryExpanderWidget::appendContextMenu(Menu* menu)
+{
+    TapestryExpander* module = dynamic_cast<TapestryExpander*>(this->module);
+    if (!module) {
+        return;
+    }
+    
+    menu->addChild(new MenuEntry);
+    
+    struct InlineModeItem : MenuItem {
+        TapestryExpander* module;
+        
+        void onAction(const event::Action& e) override {
+            module->inlineMode = !module->inlineMode;
+        }
+    };
+    
+    InlineModeItem* inlineItem = new InlineModeItem();
+    inlineItem->text = "Process Inline (Zero Latency)";
+    inlineItem->module = module;
+    inlineItem->rightText = module->inlineMode ? "✓" : "";
+    menu->addChild(inlineItem);
+    
+    // Inline processing has no latency; messages make a block round trip
+    int frames = module->inlineMode ? 0 : TapestryExpanderMessage::kLatencyFrames;
+    float ms = 1000.0f * frames / module->chain_.getSampleRate();
+    menu->addChild(createMenuLabel(string::f("Latency: %d samples (%.2f ms)", frames, ms)));
+}
+
 //------------------------------------------------------------------------------
 // Model Registration
 //------------------------------------------------------------------------------
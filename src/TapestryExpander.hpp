@@ -15,36 +15,13 @@
  * 2. Moog VCF Low-Pass Filter - 24dB/octave resonant lowpass filter
  *
  * Each effect includes individual Dry/Wet mixing controls.
+ *
+ * In inline mode (the default) Tapestry runs the effect chain in its own
+ * process() with no latency. Otherwise audio arrives from Tapestry in blocks
+ * of TapestryExpanderMessage::kBlockFrames and goes back processed, with a
+ * fixed round-trip latency of kLatencyFrames.
  */
 
-//------------------------------------------------------------------------------
-// Parameter Smoother for zipper-free control changes
-//------------------------------------------------------------------------------
-
-class SmoothParam {
-public:
-    void setTarget(float target) { target_ = target; }
-    float getTarget() const { return target_; }
-    
-    float process() {
-        current_ += smoothCoeff_ * (target_ - current_);
-        return current_;
-    }
-    
-    void setSmoothTime(float timeMs, float sampleRate) {
-        smoothCoeff_ = 1.0f - std::exp(-1.0f / (sampleRate * timeMs * 0.001f));
-    }
-    
-    void setImmediate(float value) {
-        current_ = target_ = value;
-    }
-    
-private:
-    float current_ = 0.0f;
-    float target_ = 0.0f;
-    float smoothCoeff_ = 0.001f;
-};
-
 //------------------------------------------------------------------------------
 // Tapestry Expander Module
 //------------------------------------------------------------------------------
@@ -91,37 +68,22 @@ struct TapestryExpander : Module {
     };
     
     //--------------------------------------------------------------------------
-    // DSP Processors
-    //--------------------------------------------------------------------------
-    
-    BitCrusherDSP bitCrusher_;
-    MoogVCFDSP moogFilterL_;
-    MoogVCFDSP moogFilterR_;
-    
-    //--------------------------------------------------------------------------
-    // Parameter Smoothers
+    // DSP
     //--------------------------------------------------------------------------
     
-    SmoothParam smoothBits_;
-    SmoothParam smoothRate_;
-    SmoothParam smoothCrushMix_;
-    SmoothParam smoothCutoff_;
-    SmoothParam smoothReso_;
-    SmoothParam smoothFilterMix_;
-    SmoothParam smoothOutputLevel_;
+    // Bit crusher and Moog VCF with smoothing and DC blocking, run once per
+    // block received from Tapestry
+    ExpanderEffectChain chain_;
     
-    //--------------------------------------------------------------------------
-    // State
-    //--------------------------------------------------------------------------
+    // Sequence number of the last block processed
+    uint32_t lastSequence_ = 0;
     
-    float sampleRate_ = 48000.0f;
-    
-    // DC blocking filters (to prevent pops from DC offset)
-    float dcBlockerInL_ = 0.0f;
-    float dcBlockerInR_ = 0.0f;
-    float dcBlockerOutL_ = 0.0f;
-    float dcBlockerOutR_ = 0.0f;
-    float dcBlockCoeff_ = 0.995f;  // Calculated based on sample rate
+    // Inline mode: Tapestry runs inline_ in its own process() (no latency)
+    // while published_ holds it; otherwise audio goes through the block
+    // messages and chain_.
+    bool inlineMode = true;
+    TapestryExpanderInline inline_;
+    TapestryExpanderInlineSlot published_;
     
     //--------------------------------------------------------------------------
     // Constructor
@@ -137,12 +99,22 @@ struct TapestryExpander : Module {
     void onSampleRateChange() override;
     void onReset() override;
     void process(const ProcessArgs& args) override;
+    void processBypass(const ProcessArgs& args) override;
+    void onRemove(const RemoveEvent& e) override;
+    json_t* dataToJson() override;
+    void dataFromJson(json_t* rootJ) override;
+    
+    // Chain Tapestry should run inline, or null for message mode
+    TapestryExpanderInline* getInlineChain() const {
+        return published_.get();
+    }
     
     //--------------------------------------------------------------------------
     // Helpers
     //--------------------------------------------------------------------------
     
     float getModulatedParam(int paramId, int cvId, float cvScale);
+    ExpanderEffectChain::Params getTargets();
 };
 
 //------------------------------------------------------------------------------
@@ -151,4 +123,5 @@ struct TapestryExpander : Module {
 
 struct TapestryExpanderWidget : ModuleWidget {
     TapestryExpanderWidget(TapestryExpander* module);
+    void appendContextMenu(Menu* menu) override;
 };
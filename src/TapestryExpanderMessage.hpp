@@ -1,16 +1,38 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
+#include "dsp/tapestry-effects.h"
+
 // Message payload exchanged between Tapestry (left) and TapestryExpander (right).
 // VCV Rack expander messaging is double-buffered and flipped by the engine.
 // Producer buffers are write-only; consumer buffers are read-only.
+//
+// Audio travels in blocks of kBlockFrames: Tapestry fills the expander's
+// producer buffer one frame per step and requests a flip only when a block
+// is complete, the expander processes the whole block in the step after the
+// flip and sends it back with the same sequence number. The round trip is a
+// fixed kLatencyFrames.
+//
+// In inline mode the expander skips the messages entirely and publishes a
+// TapestryExpanderInline instead, which Tapestry runs in its own process().
 struct TapestryExpanderMessage {
+    static constexpr int kBlockFrames = 32;
+
+    // Two flips (there and back) after the block's last frame
+    static constexpr int kLatencyFrames = kBlockFrames + 1;
+
+    // Block number, 0 = no block yet
+    uint32_t sequence = 0;
+
     // Audio from Tapestry to Expander (pre-output)
-    float audioL = 0.0f;
-    float audioR = 0.0f;
+    float audioL[kBlockFrames] = {};
+    float audioR[kBlockFrames] = {};
 
     // Processed audio from Expander back to Tapestry
-    float processedL = 0.0f;
-    float processedR = 0.0f;
+    float processedL[kBlockFrames] = {};
+    float processedR[kBlockFrames] = {};
 
     // Flag indicating expander has written valid processed audio
     bool expanderConnected = false;
@@ -18,3 +40,139 @@ struct TapestryExpanderMessage {
     // Sample rate for DSP coefficient calculation
     float sampleRate = 48000.0f;
 };
+
+// Tapestry's end of the block transport. Each step: receive() the consumer
+// buffer, pull() one processed frame, then send() one dry frame into the
+// expander's producer buffer.
+class TapestryExpanderLink {
+public:
+    // Forget blocks in flight (on expander change); sequence numbers keep
+    // counting so stale blocks from a previous expander are never played
+    void reset() {
+        sendFrames_ = 0;
+        playFrame_ = TapestryExpanderMessage::kBlockFrames;
+        playing_ = nullptr;
+        played_ = sent_;
+    }
+
+    // Start playing a returned block when it answers the last one sent
+    void receive(const TapestryExpanderMessage* fromExpander) {
+        if (fromExpander && fromExpander->expanderConnected && sent_ != 0 &&
+            fromExpander->sequence == sent_ && fromExpander->sequence != played_) {
+            played_ = fromExpander->sequence;
+            playing_ = fromExpander;
+            playFrame_ = 0;
+        }
+    }
+
+    // Next processed frame, or false before the first block has returned or
+    // when the expander has stopped answering. The consumer buffer holding
+    // the block is stable until the expander's next flip, which only comes
+    // with the next block.
+    bool pull(float& left, float& right) {
+        if (!playing_ || playFrame_ >= TapestryExpanderMessage::kBlockFrames) {
+            return false;
+        }
+        left = playing_->processedL[playFrame_];
+        right = playing_->processedR[playFrame_];
+        playFrame_++;
+        return true;
+    }
+
+    // Append a dry frame; returns true when the block is complete and the
+    // caller must request the flip
+    bool send(TapestryExpanderMessage* toExpander, float left, float right, float sampleRate) {
+        toExpander->audioL[sendFrames_] = left;
+        toExpander->audioR[sendFrames_] = right;
+        if (++sendFrames_ < TapestryExpanderMessage::kBlockFrames) {
+            return false;
+        }
+        sendFrames_ = 0;
+        if (++sent_ == 0) {
+            sent_ = 1;  // 0 means no block
+        }
+        toExpander->sequence = sent_;
+        toExpander->sampleRate = sampleRate;
+        return true;
+    }
+
+private:
+    int sendFrames_ = 0;
+    uint32_t sent_ = 0;
+    uint32_t played_ = 0;
+    const TapestryExpanderMessage* playing_ = nullptr;
+    int playFrame_ = TapestryExpanderMessage::kBlockFrames;
+};
+
+// Effect chain an expander lends to Tapestry in inline mode. Tapestry runs it
+// in place in its own process() with no latency; the expander only
+// publishes control targets. The two modes use separate chains, so a mode
+// switch never runs one chain on two threads.
+class TapestryExpanderInline {
+public:
+    // Expander thread: publish the latest control targets (each field is
+    // atomic; a mix of two updates is harmless since they are smoothed)
+    void publish(const ExpanderEffectChain::Params& params) {
+        bits_.store(params.bits, std::memory_order_relaxed);
+        rate_.store(params.rate, std::memory_order_relaxed);
+        crushMix_.store(params.crushMix, std::memory_order_relaxed);
+        cutoff_.store(params.cutoff, std::memory_order_relaxed);
+        resonance_.store(params.resonance, std::memory_order_relaxed);
+        filterMix_.store(params.filterMix, std::memory_order_relaxed);
+        outputLevel_.store(params.outputLevel, std::memory_order_relaxed);
+    }
+
+    ExpanderEffectChain::Params load() const {
+        ExpanderEffectChain::Params params;
+        params.bits = bits_.load(std::memory_order_relaxed);
+        params.rate = rate_.load(std::memory_order_relaxed);
+        params.crushMix = crushMix_.load(std::memory_order_relaxed);
+        params.cutoff = cutoff_.load(std::memory_order_relaxed);
+        params.resonance = resonance_.load(std::memory_order_relaxed);
+        params.filterMix = filterMix_.load(std::memory_order_relaxed);
+        params.outputLevel = outputLevel_.load(std::memory_order_relaxed);
+        return params;
+    }
+
+    // Tapestry thread: process one frame in place
+    void process(float& left, float& right) {
+        chain.setTargets(load());
+        chain.process(&left, &right, 1);
+    }
+
+    // Used by Tapestry's thread only, except while the engine is paused
+    // (reset, sample rate change)
+    ExpanderEffectChain chain;
+
+private:
+    std::atomic<float> bits_{16.0f};
+    std::atomic<float> rate_{0.0f};
+    std::atomic<float> crushMix_{0.0f};
+    std::atomic<float> cutoff_{1.0f};
+    std::atomic<float> resonance_{0.0f};
+    std::atomic<float> filterMix_{0.0f};
+    std::atomic<float> outputLevel_{1.0f};
+};
+
+// Where an expander publishes its inline chain. Tapestry reads it every step
+// through its rightExpander.module, so a removed expander is never used; the
+// expander clears it whenever Tapestry must stop running the chain (not
+// connected, message mode, bypassed, reset, removed).
+class TapestryExpanderInlineSlot {
+public:
+    void publish(TapestryExpanderInline* chain) {
+        chain_.store(chain, std::memory_order_release);
+    }
+
+    void clear() {
+        publish(nullptr);
+    }
+
+    // Chain to run inline, or null for message mode
+    TapestryExpanderInline* get() const {
+        return chain_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<TapestryExpanderInline*> chain_{nullptr};
+};
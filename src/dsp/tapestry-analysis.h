@@ -0,0 +1,333 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include "tapestry-splice.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+/*
+ * Tapestry Offline Analysis
+ *
+ * Content analysis of the reel that runs on a worker thread and is
+ * published to the audio thread without locks.
+ *
+ * Features:
+ * - Lock-free triple buffer for worker -> audio thread publication
+ * - Per-splice feature vectors (RMS, peak, brightness, duration)
+ * - Rank tables so Organize can select splices by content in O(1)
+ * - Cache keyed on splice layout and buffer version counters
+ *
+ * Threading model:
+ * - The audio thread publishes the splice layout together with a snapshot
+ *   of the reel (version, used frames) and reads rank tables (acquire).
+ *   Nothing is published while recording, so a growing reel is analyzed
+ *   once when recording stops rather than on every poll.
+ * - A single worker thread calls update(), which only recomputes when a
+ *   new snapshot arrives. It never reads the buffer's non-atomic state, and
+ *   drops a pass if the reel was written while it ran.
+ */
+
+namespace ShortwavDSP
+{
+
+//------------------------------------------------------------------------------
+// Triple Buffer (single producer, single consumer, lock-free)
+//------------------------------------------------------------------------------
+
+template <typename T>
+class TripleBuffer
+{
+public:
+  TripleBuffer() = default;
+
+  // Producer: slot to fill before publish()
+  T &back() noexcept { return slots_[backIndex_]; }
+
+  // Producer: make the back slot visible to the consumer
+  void publish() noexcept
+  {
+    uint8_t prev = middle_.exchange(static_cast<uint8_t>(backIndex_ | kNewFlag),
+                                    std::memory_order_acq_rel);
+    backIndex_ = prev & kIndexMask;
+  }
+
+  // Consumer: switch to the latest published slot if there is one.
+  // Returns true if the front slot changed.
+  bool update() noexcept
+  {
+    if (!(middle_.load(std::memory_order_relaxed) & kNewFlag))
+      return false;
+    uint8_t prev = middle_.exchange(static_cast<uint8_t>(frontIndex_),
+                                    std::memory_order_acq_rel);
+    frontIndex_ = prev & kIndexMask;
+    hasFront_ = true;
+    return true;
+  }
+
+  // Consumer: latest slot received by update() (nullptr before the first one)
+  const T *front() const noexcept
+  {
+    return hasFront_ ? &slots_[frontIndex_] : nullptr;
+  }
+
+private:
+  static constexpr uint8_t kNewFlag = 0x4;
+  static constexpr uint8_t kIndexMask = 0x3;
+
+  std::array<T, 3> slots_{};
+  std::atomic<uint8_t> middle_{1};
+  uint8_t backIndex_ = 0;
+  uint8_t frontIndex_ = 2;
+  bool hasFront_ = false;
+};
+
+//------------------------------------------------------------------------------
+// Organize Sort Modes
+//------------------------------------------------------------------------------
+
+enum class OrganizeSortMode
+{
+  Position = 0,  // Reel order (default)
+  Rms,           // Quietest to loudest
+  Peak,          // Lowest to highest peak
+  Centroid,      // Darkest to brightest
+  Duration,      // Shortest to longest
+  NUM_MODES
+};
+
+struct SpliceFeatures
+{
+  float rms = 0.0f;
+  float peak = 0.0f;
+  float centroidHz = 0.0f;   // Brightness estimate
+  float durationSec = 0.0f;
+};
+
+//------------------------------------------------------------------------------
+// Splice Feature Cache
+//------------------------------------------------------------------------------
+
+class SpliceFeatureCache
+{
+public:
+  static constexpr size_t kMaxSplices = TapestryConfig::kMaxSplices;
+  static constexpr int kNumSortModes = static_cast<int>(OrganizeSortMode::NUM_MODES);
+
+  struct SpliceLayout
+  {
+    uint32_t spliceVersion = 0;
+    uint32_t bufferVersion = 0;   // Reel the layout was taken against
+    size_t usedFrames = 0;
+    size_t count = 0;
+    std::array<SpliceMarker, kMaxSplices> splices;
+  };
+
+  struct FeatureTable
+  {
+    uint32_t spliceVersion = 0;
+    uint32_t bufferVersion = 0;
+    size_t count = 0;
+    std::array<SpliceFeatures, kMaxSplices> features;
+    // order[mode][rank] = splice index (Position mode is the identity)
+    std::array<std::array<uint16_t, kMaxSplices>, kNumSortModes> order;
+
+    const uint16_t *getOrder(OrganizeSortMode mode) const noexcept
+    {
+      int m = static_cast<int>(mode);
+      return (m > 0 && m < kNumSortModes) ? order[m].data() : nullptr;
+    }
+  };
+
+  //--------------------------------------------------------------------------
+  // Audio Thread
+  //--------------------------------------------------------------------------
+
+  // Publish the splice layout and reel snapshot if either changed since the
+  // last call. Deferred while recording: the worker would otherwise chase
+  // the record head and read frames as they are written.
+  void publishSplices(const SpliceManager &splices, const TapestryBuffer &buffer,
+                      bool recording) noexcept
+  {
+    if (recording)
+      return;
+
+    uint32_t version = splices.getVersion();
+    uint32_t bufferVersion = buffer.getVersion();
+    if (hasPublishedLayout_ && version == publishedSpliceVersion_ &&
+        bufferVersion == publishedBufferVersion_)
+    {
+      return;
+    }
+
+    SpliceLayout &layout = layouts_.back();
+    const auto &all = splices.getAllSplices();
+    layout.spliceVersion = version;
+    layout.bufferVersion = bufferVersion;
+    layout.usedFrames = buffer.getUsedFrames();
+    layout.count = all.size() < kMaxSplices ? all.size() : kMaxSplices;
+    std::copy(all.begin(), all.begin() + layout.count, layout.splices.begin());
+    layouts_.publish();
+
+    publishedSpliceVersion_ = version;
+    publishedBufferVersion_ = bufferVersion;
+    hasPublishedLayout_ = true;
+  }
+
+  // Latest feature table, or nullptr if none matches this splice layout.
+  // The pointer stays valid until the next call.
+  const FeatureTable *acquire(uint32_t spliceVersion) noexcept
+  {
+    tables_.update();
+    const FeatureTable *table = tables_.front();
+    if (!table || table->spliceVersion != spliceVersion)
+      return nullptr;
+    return table;
+  }
+
+  //--------------------------------------------------------------------------
+  // Worker Thread
+  //--------------------------------------------------------------------------
+
+  // Recompute features if a new layout or reel snapshot was published.
+  // Returns true if a new table was published.
+  bool update(const TapestryBuffer &buffer, float sampleRate = TapestryConfig::kInternalSampleRate) noexcept
+  {
+    layouts_.update();
+    const SpliceLayout *layout = layouts_.front();
+    if (!layout)
+      return false;
+
+    if (hasAnalyzed_ && layout->spliceVersion == lastSpliceVersion_ &&
+        layout->bufferVersion == lastBufferVersion_)
+    {
+      return false;
+    }
+
+    FeatureTable &table = tables_.back();
+    table.spliceVersion = layout->spliceVersion;
+    table.bufferVersion = layout->bufferVersion;
+    table.count = layout->count;
+
+    for (size_t i = 0; i < layout->count; i++)
+    {
+      table.features[i] = analyzeSplice(buffer, layout->usedFrames, layout->splices[i], sampleRate);
+    }
+
+    lastSpliceVersion_ = layout->spliceVersion;
+    lastBufferVersion_ = layout->bufferVersion;
+    hasAnalyzed_ = true;
+
+    // Recording started mid-pass: drop it, the next snapshot comes when it stops
+    if (buffer.getVersion() != layout->bufferVersion)
+      return false;
+
+    buildOrder(table);
+    tables_.publish();
+    return true;
+  }
+
+  // Latest layout received by update() (nullptr before the first one)
+  const SpliceLayout *getLayout() const noexcept { return layouts_.front(); }
+
+  // Feature extraction for one splice (mono sum, single pass) over the
+  // first used frames of the reel
+  static SpliceFeatures analyzeSplice(const TapestryBuffer &buffer, size_t used,
+                                      const SpliceMarker &splice, float sampleRate) noexcept
+  {
+    SpliceFeatures f;
+    size_t start = std::min(splice.startFrame, used);
+    size_t end = std::min(splice.endFrame, used);
+    f.durationSec = static_cast<float>(splice.length()) / sampleRate;
+    if (end <= start)
+      return f;
+
+    const float *data = buffer.data();
+    double sumSq = 0.0;
+    double sumDiffSq = 0.0;
+    float peak = 0.0f;
+    float prev = 0.5f * (data[start * 2] + data[start * 2 + 1]);
+
+    for (size_t i = start; i < end; i++)
+    {
+      float x = 0.5f * (data[i * 2] + data[i * 2 + 1]);
+      float d = x - prev;
+      sumSq += static_cast<double>(x) * x;
+      sumDiffSq += static_cast<double>(d) * d;
+      peak = std::max(peak, std::fabs(x));
+      prev = x;
+    }
+
+    double n = static_cast<double>(end - start);
+    f.rms = static_cast<float>(std::sqrt(sumSq / n));
+    f.peak = peak;
+
+    // Brightness: the energy ratio of the first difference to the signal
+    // is 4 sin^2(pi f / fs) for a sinusoid, which inverts to the RMS
+    // frequency of the spectrum - a cheap stand-in for the centroid.
+    if (sumSq > 1e-12)
+    {
+      double ratio = std::min(4.0, sumDiffSq / sumSq);
+      f.centroidHz = static_cast<float>(sampleRate / 3.14159265358979 *
+                                        std::asin(std::sqrt(ratio) * 0.5));
+    }
+    return f;
+  }
+
+private:
+  static float featureValue(const SpliceFeatures &f, OrganizeSortMode mode) noexcept
+  {
+    switch (mode)
+    {
+    case OrganizeSortMode::Rms: return f.rms;
+    case OrganizeSortMode::Peak: return f.peak;
+    case OrganizeSortMode::Centroid: return f.centroidHz;
+    case OrganizeSortMode::Duration: return f.durationSec;
+    default: return 0.0f;
+    }
+  }
+
+  static void buildOrder(FeatureTable &table) noexcept
+  {
+    for (int m = 0; m < kNumSortModes; m++)
+    {
+      auto &order = table.order[m];
+      for (size_t i = 0; i < table.count; i++)
+      {
+        order[i] = static_cast<uint16_t>(i);
+      }
+      if (m == 0)
+        continue;
+
+      OrganizeSortMode mode = static_cast<OrganizeSortMode>(m);
+      std::stable_sort(order.begin(), order.begin() + table.count,
+                       [&table, mode](uint16_t a, uint16_t b)
+                       {
+                         return featureValue(table.features[a], mode) <
+                                featureValue(table.features[b], mode);
+                       });
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // State
+  //--------------------------------------------------------------------------
+
+  TripleBuffer<SpliceLayout> layouts_;   // Audio -> worker
+  TripleBuffer<FeatureTable> tables_;    // Worker -> audio
+
+  // Audio thread
+  uint32_t publishedSpliceVersion_ = 0;
+  uint32_t publishedBufferVersion_ = 0;
+  bool hasPublishedLayout_ = false;
+
+  // Worker thread
+  uint32_t lastSpliceVersion_ = 0;
+  uint32_t lastBufferVersion_ = 0;
+  bool hasAnalyzed_ = false;
+};
+
+} // namespace ShortwavDSP
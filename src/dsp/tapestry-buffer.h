@@ -1,8 +1,12 @@
 #pragma once
 
 #include "tapestry-core.h"
+#include "tapestry-simd.h"
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <memory>
 #include <vector>
 
 /*
@@ -13,9 +17,15 @@
  *
  * Features:
  * - Pre-allocated maximum size for real-time safety
+ * - Constant-time clear: stale frames are zeroed as writes grow the used
+ *   region again, so clearing a full reel never stalls the audio thread
  * - Interleaved stereo storage [L0, R0, L1, R1, ...]
  * - Cubic interpolation for high-quality playback
  * - Lock-free read/write operations
+ * - Block writes over contiguous spans (replace, overdub, Sound-on-Sound)
+ * - Read-only reel sharing between instances (offline batch rendering);
+ *   a shared buffer takes a private copy on its first write
+ * - Version counter for invalidating derived analysis data
  */
 
 namespace ShortwavDSP
@@ -30,28 +40,55 @@ public:
   TapestryBuffer()
   {
     // Pre-allocate maximum size
-    data_.resize(kMaxFrames * kChannels, 0.0f);
+    storage_.resize(kMaxFrames * kChannels, 0.0f);
+    data_ = storage_.data();
     clear();
   }
 
+  // Storage for shareReel: the frames padded to the full reel size, so reads
+  // behave exactly as on a private buffer
+  static std::shared_ptr<const std::vector<float>> makeSharedReel(const float *src, size_t numFrames)
+  {
+    std::shared_ptr<std::vector<float>> reel =
+        std::make_shared<std::vector<float>>(kMaxFrames * kChannels, 0.0f);
+    const size_t maxFrames = kMaxFrames;  // Local copy: std::min would ODR-use the member
+    numFrames = std::min(numFrames, maxFrames);
+    if (src != nullptr)
+    {
+      std::copy(src, src + numFrames * kChannels, reel->begin());
+    }
+    return reel;
+  }
+
   //--------------------------------------------------------------------------
   // Buffer Management
   //--------------------------------------------------------------------------
 
   void clear() noexcept
   {
-    std::fill(data_.begin(), data_.end(), 0.0f);
+    if (shared_)
+    {
+      detach(false);  // Fresh zeroed storage
+    }
+    else
+    {
+      staleEnd_ = std::max(staleEnd_, usedFrames_);
+    }
     usedFrames_ = 0;
+    bumpVersion();
   }
 
   void clearRange(size_t startFrame, size_t endFrame) noexcept
   {
-    startFrame = std::min(startFrame, kMaxFrames);
-    endFrame = std::min(endFrame, kMaxFrames);
+    const size_t maxFrames = kMaxFrames;
+    startFrame = std::min(startFrame, maxFrames);
+    endFrame = std::min(endFrame, maxFrames);
     if (startFrame < endFrame)
     {
-      std::fill(data_.begin() + startFrame * kChannels,
-                data_.begin() + endFrame * kChannels, 0.0f);
+      makeWritable();
+      std::fill(data_ + startFrame * kChannels,
+                data_ + endFrame * kChannels, 0.0f);
+      bumpVersion();
     }
   }
 
@@ -65,6 +102,12 @@ public:
     return static_cast<float>(usedFrames_) / sampleRate;
   }
 
+  // Incremented on every modification (safe to poll from other threads)
+  uint32_t getVersion() const noexcept
+  {
+    return version_.load(std::memory_order_acquire);
+  }
+
   //--------------------------------------------------------------------------
   // Sample Access (Non-interpolated)
   //--------------------------------------------------------------------------
@@ -75,6 +118,8 @@ public:
     if (frame >= kMaxFrames)
       return false;
 
+    makeWritable();
+    reclaimStale(frame, frame + 1, true);
     data_[frame * kChannels] = left;
     data_[frame * kChannels + 1] = right;
 
@@ -83,6 +128,7 @@ public:
     {
       usedFrames_ = frame + 1;
     }
+    bumpVersion();
     return true;
   }
 
@@ -100,8 +146,34 @@ public:
   }
 
   // Direct pointer access (for bulk operations)
-  float *data() noexcept { return data_.data(); }
-  const float *data() const noexcept { return data_.data(); }
+  float *data() noexcept
+  {
+    makeWritable();
+    return data_;
+  }
+  const float *data() const noexcept { return data_; }
+
+  //--------------------------------------------------------------------------
+  // Shared Reels
+  //--------------------------------------------------------------------------
+
+  // Read from a reel made by makeSharedReel instead of private storage, which
+  // is released. Not real-time safe (it frees, and the first write after it
+  // allocates); meant for offline tools running many instances on one reel.
+  void shareReel(std::shared_ptr<const std::vector<float>> reel, size_t numFrames)
+  {
+    if (!reel || reel->size() < kMaxFrames * kChannels)
+      return;
+    shared_ = std::move(reel);
+    std::vector<float>().swap(storage_);
+    data_ = const_cast<float *>(shared_->data());  // Never written while shared
+    const size_t maxFrames = kMaxFrames;
+    usedFrames_ = std::min(numFrames, maxFrames);
+    staleEnd_ = 0;
+    bumpVersion();
+  }
+
+  bool isShared() const noexcept { return shared_ != nullptr; }
 
   //--------------------------------------------------------------------------
   // Interpolated Read (Cubic)
@@ -228,6 +300,8 @@ public:
     if (frame >= kMaxFrames)
       return;
 
+    makeWritable();
+    reclaimStale(frame, frame + 1, false);
     // sosAmount: 0 = live only, 1 = loop only
     float loopL = data_[frame * kChannels];
     float loopR = data_[frame * kChannels + 1];
@@ -242,6 +316,56 @@ public:
     {
       usedFrames_ = frame + 1;
     }
+    bumpVersion();
+  }
+
+  //--------------------------------------------------------------------------
+  // Block Write
+  //--------------------------------------------------------------------------
+
+  enum class BlockMode
+  {
+    Replace,      // Live input replaces existing content
+    Overdub,      // existing * feedback + live, optionally soft clipped
+    SoundOnSound  // live * (1 - sos) + existing * sos, as mixAndWrite
+  };
+
+  // Write numFrames interleaved live frames starting at frame, with one
+  // bounds check, usedFrames update and version bump for the whole span.
+  // sos holds an interleaved amount per sample (SoundOnSound mode only);
+  // feedback and saturate apply to Overdub mode.
+  // Returns the number of frames written (the span is clamped at kMaxFrames).
+  size_t writeBlock(size_t frame, const float *live, const float *sos,
+                    size_t numFrames, BlockMode mode,
+                    float feedback = 1.0f, bool saturate = false) noexcept
+  {
+    if (frame >= kMaxFrames || numFrames == 0)
+      return 0;
+    numFrames = std::min(numFrames, kMaxFrames - frame);
+
+    makeWritable();
+    reclaimStale(frame, frame + numFrames, mode != BlockMode::SoundOnSound);
+    float *dest = data_ + frame * kChannels;
+    size_t count = numFrames * kChannels;
+    if (mode == BlockMode::Overdub)
+    {
+      // Frames past the used region count as silence, as in readStereo
+      size_t existing = (frame < usedFrames_) ? std::min(numFrames, usedFrames_ - frame) * kChannels : 0;
+      std::fill(dest + existing, dest + count, 0.0f);
+      Simd::feedbackAccumulate(dest, live, feedback, saturate, count);
+    }
+    else if (mode == BlockMode::SoundOnSound)
+    {
+      Simd::crossfade(dest, live, sos, count);
+    }
+    else
+    {
+      std::memcpy(dest, live, count * sizeof(float));
+    }
+
+    usedFrames_ = std::max(usedFrames_, frame + numFrames);
+    bumpVersion();
+    return numFrames;
   }
 
   //--------------------------------------------------------------------------
@@ -254,9 +378,12 @@ public:
     size_t framesToCopy = std::min(numFrames, kMaxFrames - destOffset);
     if (framesToCopy > 0 && src != nullptr)
     {
-      std::memcpy(data_.data() + destOffset * kChannels,
+      makeWritable();
+      reclaimStale(destOffset, destOffset + framesToCopy, true);
+      std::memcpy(data_ + destOffset * kChannels,
                   src, framesToCopy * kChannels * sizeof(float));
       usedFrames_ = std::max(usedFrames_, destOffset + framesToCopy);
+      bumpVersion();
     }
   }
 
@@ -266,7 +393,7 @@ public:
     size_t framesToCopy = std::min(numFrames, usedFrames_ - srcOffset);
     if (framesToCopy > 0 && dest != nullptr && srcOffset < usedFrames_)
     {
-      std::memcpy(dest, data_.data() + srcOffset * kChannels,
+      std::memcpy(dest, data_ + srcOffset * kChannels,
                   framesToCopy * kChannels * sizeof(float));
     }
   }
@@ -274,12 +401,70 @@ public:
   // Set used frames (for loading external data)
   void setUsedFrames(size_t frames) noexcept
   {
-    usedFrames_ = std::min(frames, kMaxFrames);
+    const size_t maxFrames = kMaxFrames;
+    frames = std::min(frames, maxFrames);
+    if (frames > usedFrames_ && !shared_)
+    {
+      reclaimStale(usedFrames_, frames, false);
+    }
+    staleEnd_ = std::max(staleEnd_, usedFrames_);
+    usedFrames_ = frames;
+    bumpVersion();
   }
 
 private:
-  std::vector<float> data_;
+  void makeWritable()
+  {
+    if (shared_)
+      detach(true);
+  }
+
+  // Back to private storage, keeping the shared frames if requested
+  void detach(bool keepFrames)
+  {
+    std::vector<float> storage(kMaxFrames * kChannels, 0.0f);
+    if (keepFrames)
+    {
+      std::copy(shared_->begin(), shared_->begin() + usedFrames_ * kChannels, storage.begin());
+    }
+    storage_.swap(storage);
+    shared_.reset();
+    data_ = storage_.data();
+    staleEnd_ = 0;
+  }
+
+  // Frames in [usedFrames_, staleEnd_) may still hold audio from before a
+  // clear(); everything from staleEnd_ on is zero. Called before a write to
+  // [start, end) that may grow the used region: zeroes the stale frames that
+  // become used, except those the write replaces outright.
+  void reclaimStale(size_t start, size_t end, bool overwrites) noexcept
+  {
+    size_t staleEnd = std::min(end, staleEnd_);
+    if (staleEnd <= usedFrames_)
+      return;
+    size_t zeroEnd = overwrites ? std::min(start, staleEnd) : staleEnd;
+    if (zeroEnd > usedFrames_)
+    {
+      std::fill(data_ + usedFrames_ * kChannels, data_ + zeroEnd * kChannels, 0.0f);
+    }
+    if (end >= staleEnd_)
+    {
+      staleEnd_ = 0;  // Nothing stale past the write
+    }
+  }
+
+  // Single writer (the audio thread), so no read-modify-write is needed
+  void bumpVersion() noexcept
+  {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  std::vector<float> storage_;
+  std::shared_ptr<const std::vector<float>> shared_;
+  float *data_ = nullptr;  // storage_ or the shared reel
   size_t usedFrames_ = 0;
+  size_t staleEnd_ = 0;    // See reclaimStale()
+  std::atomic<uint32_t> version_{0};
 };
 
 } // namespace ShortwavDSP
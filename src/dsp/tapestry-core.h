@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <vector>
+#include "tapestry-lut.h"
 
 /*
  * Tapestry Core Types and Configuration
@@ -90,6 +91,32 @@ struct SpliceMarker
   }
 };
 
+//------------------------------------------------------------------------------
+// Beat Grid (detected reel tempo)
+//------------------------------------------------------------------------------
+
+struct BeatGrid
+{
+  bool valid = false;          // True when a tempo was detected
+  double periodFrames = 0.0;   // Frames per beat
+  double offsetFrames = 0.0;   // First beat position (0 <= offset < period)
+  size_t reelFrames = 0;       // Reel length the grid was computed for
+  float bpm = 0.0f;            // Tempo at the internal sample rate
+  float confidence = 0.0f;     // Normalized autocorrelation peak (0-1)
+
+  size_t getNumBeats() const noexcept
+  {
+    if (!valid || periodFrames <= 0.0 || offsetFrames >= static_cast<double>(reelFrames))
+      return 0;
+    return static_cast<size_t>((reelFrames - offsetFrames) / periodFrames) + 1;
+  }
+
+  double getBeatFrame(size_t beat) const noexcept
+  {
+    return offsetFrames + static_cast<double>(beat) * periodFrames;
+  }
+};
+
 //------------------------------------------------------------------------------
 // Grain Voice State
 //------------------------------------------------------------------------------
@@ -209,6 +236,35 @@ enum class ModuleMode
   SdBusy            // Writing to storage (flash Shift LED)
 };
 
+//------------------------------------------------------------------------------
+// Playback Mode
+//------------------------------------------------------------------------------
+
+enum class PlaybackMode
+{
+  Granular = 0,  // Gene/Morph grain voices (Vari-Speed changes pitch)
+  Wsola,         // Pitch-preserving overlap-add (Vari-Speed changes tempo only)
+  Spectral,      // Phase vocoder (tempo divided by the stretch factor; freezes when stopped)
+  NUM_MODES
+};
+
+//------------------------------------------------------------------------------
+// Control Parameters
+//------------------------------------------------------------------------------
+
+// Knob/CV pairs evaluated by the control-rate stage
+enum class ControlParam
+{
+  Sos = 0,
+  GeneSize,
+  VariSpeed,
+  Morph,
+  Slide,
+  Organize,
+  Pitch,  // V/Oct
+  NUM_PARAMS
+};
+
 //------------------------------------------------------------------------------
 // Reel Color Cycle (for LED indicators)
 //------------------------------------------------------------------------------
@@ -304,9 +360,8 @@ inline float calculateGeneSizeSamples(float param, float spliceLengthSamples) no
   // Invert: 0 = small (param=1), 1 = full (param=0)
   float normalized = 1.0f - clamp01(param);
 
-  // Exponential curve for musical response
-  const float exponent = 4.0f;
-  return minGene + std::pow(normalized, exponent) * (maxGene - minGene);
+  // Exponential curve for musical response (normalized^4)
+  return minGene + Lut::powInt<4>(normalized) * (maxGene - minGene);
 }
 
 // Calculate morph state from parameter (0-1)
@@ -391,7 +446,7 @@ inline VariSpeedState calculateVariSpeed(float param, float cvInput, float cvAtt
     semitones = absParam * TapestryConfig::kVariSpeedDownSemitones;
   }
 
-  state.speedRatio = std::pow(2.0f, semitones / 12.0f);
+  state.speedRatio = Lut::semitonesToRatio(semitones);
   if (!state.isForward)
   {
     state.speedRatio = -state.speedRatio;
@@ -404,6 +459,68 @@ inline VariSpeedState calculateVariSpeed(float param, float cvInput, float cvAtt
   return state;
 }
 
+// Speed ratio that plays one beat of the reel per clock period.
+// The result is folded by octaves into [0.707, 1.414] so an eighth-note
+// clock doesn't double the speed of a quarter-note reel. sampleRateRatio is
+// the internal/engine rate ratio applied by the grain engine.
+inline float calculateTempoLockRatio(double beatPeriodFrames, float clockPeriodSamples,
+                                     float sampleRateRatio) noexcept
+{
+  if (beatPeriodFrames <= 0.0 || clockPeriodSamples <= 0.0f || sampleRateRatio <= 0.0f)
+    return 1.0f;
+
+  double ratio = beatPeriodFrames / (static_cast<double>(clockPeriodSamples) * sampleRateRatio);
+  const double kSqrt2 = 1.4142135623730951;
+  while (ratio > kSqrt2)
+    ratio *= 0.5;
+  while (ratio < 1.0 / kSqrt2)
+    ratio *= 2.0;
+  return static_cast<float>(ratio);
+}
+
+// Linear ramp from the current value to a target over a number of samples
+class LinearRamp
+{
+public:
+  void snap(float value) noexcept
+  {
+    value_ = target_ = value;
+    step_ = 0.0f;
+    remaining_ = 0;
+  }
+
+  void setTarget(float target, int samples) noexcept
+  {
+    target_ = target;
+    if (samples <= 1)
+    {
+      snap(target);
+      return;
+    }
+    step_ = (target - value_) / static_cast<float>(samples);
+    remaining_ = samples;
+  }
+
+  // Advance one sample and return the new value
+  float process() noexcept
+  {
+    if (remaining_ > 0)
+    {
+      value_ = (--remaining_ == 0) ? target_ : value_ + step_;
+    }
+    return value_;
+  }
+
+  float getValue() const noexcept { return value_; }
+  float getTarget() const noexcept { return target_; }
+
+private:
+  float value_ = 0.0f;
+  float target_ = 0.0f;
+  float step_ = 0.0f;
+  int remaining_ = 0;
+};
+
 // Simple deterministic LCG random number generator
 class FastRandom
 {
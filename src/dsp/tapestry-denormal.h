@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TAPESTRY_DENORMALS_SSE 1
+#elif defined(__aarch64__)
+#define TAPESTRY_DENORMALS_ARM64 1
+#endif
+
+/*
+ * Tapestry Denormal Handling
+ *
+ * Exponential decays (filters, envelope followers, parameter smoothing) end
+ * in subnormal floats, which many CPUs process through a slow microcode
+ * path. Flushing them to zero in hardware removes the stall without any
+ * per-sample checks in the DSP code.
+ *
+ * Features:
+ * - ScopedFlushDenormals sets flush-to-zero and denormals-are-zero for the
+ *   current thread and restores the previous mode on exit (MXCSR FTZ/DAZ on
+ *   x86 SSE, FPCR.FZ on arm64)
+ * - Only writes the control register when the mode actually changes; hosts
+ *   that already run with FTZ (such as the Rack engine) pay one register read
+ * - Portable fallback: flushDenormal() zeroes tiny values in software on
+ *   targets without FTZ control and is a no-op elsewhere; use it on
+ *   recursive state only
+ */
+
+namespace ShortwavDSP
+{
+
+class ScopedFlushDenormals
+{
+public:
+#if defined(TAPESTRY_DENORMALS_SSE) || defined(TAPESTRY_DENORMALS_ARM64)
+  static constexpr bool kHardware = true;
+#else
+  static constexpr bool kHardware = false;
+#endif
+
+  ScopedFlushDenormals() noexcept
+  {
+#if defined(TAPESTRY_DENORMALS_SSE)
+    saved_ = _mm_getcsr();
+    uint32_t wanted = saved_ | kSseFlushBits;
+    if (wanted != saved_)
+      _mm_setcsr(wanted);
+#elif defined(TAPESTRY_DENORMALS_ARM64)
+    uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    saved_ = fpcr;
+    if ((fpcr & kArmFlushBit) == 0)
+      __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | kArmFlushBit));
+#endif
+  }
+
+  ~ScopedFlushDenormals()
+  {
+#if defined(TAPESTRY_DENORMALS_SSE)
+    if ((saved_ & kSseFlushBits) != kSseFlushBits)
+      _mm_setcsr(saved_);
+#elif defined(TAPESTRY_DENORMALS_ARM64)
+    if ((saved_ & kArmFlushBit) == 0)
+      __asm__ __volatile__("msr fpcr, %0" : : "r"(saved_));
+#endif
+  }
+
+  ScopedFlushDenormals(const ScopedFlushDenormals &) = delete;
+  ScopedFlushDenormals &operator=(const ScopedFlushDenormals &) = delete;
+
+private:
+#if defined(TAPESTRY_DENORMALS_SSE)
+  static constexpr uint32_t kSseFlushBits = 0x8040;  // FTZ | DAZ
+  uint32_t saved_;
+#elif defined(TAPESTRY_DENORMALS_ARM64)
+  static constexpr uint64_t kArmFlushBit = 1ull << 24;  // FZ
+  uint64_t saved_;
+#endif
+};
+
+// Software flush for recursive state, only where the hardware cannot
+inline float flushDenormal(float x) noexcept
+{
+#if defined(TAPESTRY_DENORMALS_SSE) || defined(TAPESTRY_DENORMALS_ARM64)
+  return x;
+#else
+  return (std::fabs(x) < 1e-30f) ? 0.0f : x;
+#endif
+}
+
+} // namespace ShortwavDSP
@@ -4,6 +4,14 @@
 #include "tapestry-buffer.h"
 #include "tapestry-splice.h"
 #include "tapestry-grain.h"
+#include "tapestry-zerocross.h"
+#include "tapestry-analysis.h"
+#include "tapestry-tempo.h"
+#include "tapestry-poly.h"
+#include "tapestry-multitap.h"
+#include "tapestry-telemetry.h"
+#include "tapestry-trace.h"
+#include "tapestry-denormal.h"
 #include <cmath>
 
 /*
@@ -13,8 +21,19 @@
  * - Audio buffer management
  * - Splice management
  * - Granular synthesis
- * - Recording with Sound-On-Sound
+ * - Recording with Sound-On-Sound, written to the reel in SIMD blocks
+ * - Overdub feedback decay and soft saturation for time-lag accumulation
  * - Envelope follower for CV output
+ * - Zero-crossing snapping for click-free splice markers
+ * - Content-aware Organize (splice features analyzed on a worker thread)
+ * - Reel tempo detection for beat-aligned markers and clock-locked speed
+ * - Polyphonic playheads (up to 16) with per-channel gate, pitch and Slide
+ * - Multi-tap read heads (2-8) with their own splice, Slide, speed and gain
+ * - Control-rate parameter stage with audio-rate linear ramps; CV inputs
+ *   can opt into per-sample evaluation
+ * - Read-only reels shared between instances for offline batch rendering
+ * - Optional per-stage CPU telemetry (grain and record stages)
+ * - Optional event trace of splice changes, EOSG, clock edges and recording
  *
  * This is the top-level DSP class used by the VCV Rack module.
  */
@@ -25,6 +44,12 @@ namespace ShortwavDSP
 class TapestryDSP
 {
 public:
+  // Default snap window for new markers
+  static constexpr float kDefaultZeroCrossingSnapSeconds = 0.010f;
+
+  // Longest recording span staged before it is written to the reel
+  static constexpr size_t kRecordBlockFrames = 32;
+
   TapestryDSP()
   {
     setSampleRate(48000.0f);
@@ -49,13 +74,30 @@ public:
     // Auto-level attack/release
     autoLevelAttack_ = 1.0f - std::exp(-1.0f / (sampleRate_ * 0.1f));
     autoLevelRelease_ = 1.0f - std::exp(-1.0f / (sampleRate_ * 0.5f));
+
+    // The snap window is a time, so it covers the same span at any rate
+    updateZeroCrossingSnapFrames();
   }
 
   void reset() noexcept
   {
     buffer_.clear();
+    zeroCrossings_.clear();
+    resetState();
+  }
+
+  // Everything reset() restores except the reel contents
+  void resetState() noexcept
+  {
     spliceManager_.clear();
     grainEngine_.reset();
+    poly_.reset();
+    polyChannels_ = 1;
+    multiTap_.reset();
+    controlCounter_ = 0;
+    rampsPrimed_ = false;
+    recordStaged_ = 0;
+    setPitchCv(0.0f);
 
     playbackState_ = PlaybackState();
     recordState_ = RecordState();
@@ -72,7 +114,11 @@ public:
     slideParam_ = 0.0f;
     organizeParam_ = 0.0f;
     variSpeedParam_ = 0.5f;
+    sosCv_ = geneSizeCv_ = morphCv_ = slideCv_ = organizeCv_ = variSpeedCv_ = 0.0f;
+    geneSizeCvAtten_ = slideCvAtten_ = variSpeedCvAtten_ = 0.0f;
     overdubMode_ = false;  // Reset to default (replace mode)
+    overdubFeedback_ = 1.0f;
+    overdubSaturation_ = false;
   }
 
   //--------------------------------------------------------------------------
@@ -106,6 +152,91 @@ public:
     return overdubMode_;
   }
 
+  // Overdub layers: existing * feedback + live. Below 1 each pass decays
+  // the older layers; saturation soft clips the sum toward +-1.
+  void setOverdubFeedback(float feedback) noexcept
+  {
+    overdubFeedback_ = TapestryUtil::clamp01(feedback);
+  }
+
+  float getOverdubFeedback() const noexcept { return overdubFeedback_; }
+
+  void setOverdubSaturation(bool saturate) noexcept { overdubSaturation_ = saturate; }
+  bool getOverdubSaturation() const noexcept { return overdubSaturation_; }
+
+  // Snap new markers to the nearest zero crossing within this many seconds
+  // (0 = place markers exactly where requested)
+  void setZeroCrossingSnap(float seconds) noexcept
+  {
+    zeroCrossingSnapSeconds_ = std::max(0.0f, seconds);
+    updateZeroCrossingSnapFrames();
+  }
+
+  // Snap window in frames at the current sample rate
+  size_t getZeroCrossingSnap() const noexcept
+  {
+    return zeroCrossingSnapFrames_;
+  }
+
+  // Order in which Organize steps through splices. Non-position modes take
+  // effect once runAnalysis() has produced features for the current layout.
+  void setOrganizeSortMode(OrganizeSortMode mode) noexcept
+  {
+    organizeSortMode_ = mode;
+  }
+
+  OrganizeSortMode getOrganizeSortMode() const noexcept
+  {
+    return organizeSortMode_;
+  }
+
+  // Tempo lock: with a clock connected and a detected reel tempo, Vari-Speed
+  // plays one reel beat per clock period (the knob still sets direction)
+  void setTempoLock(bool enabled) noexcept
+  {
+    tempoLock_ = enabled;
+  }
+
+  bool getTempoLock() const noexcept
+  {
+    return tempoLock_;
+  }
+
+  // Granular (Vari-Speed shifts pitch), WSOLA (Vari-Speed sets tempo only)
+  // or Spectral (phase vocoder)
+  void setPlaybackMode(PlaybackMode mode) noexcept
+  {
+    grainEngine_.setPlaybackMode(mode);
+  }
+
+  PlaybackMode getPlaybackMode() const noexcept
+  {
+    return grainEngine_.getPlaybackMode();
+  }
+
+  // Read quality for grain voices (drop-sample up to 32-tap sinc)
+  void setInterpolationQuality(InterpolationQuality quality) noexcept
+  {
+    grainEngine_.setInterpolationQuality(quality);
+  }
+
+  InterpolationQuality getInterpolationQuality() const noexcept
+  {
+    return grainEngine_.getInterpolationQuality();
+  }
+
+  // Spectral mode tempo divisor (1-100)
+  void setSpectralStretch(float factor) noexcept
+  {
+    grainEngine_.setSpectralStretch(factor);
+  }
+
+  // Spectral freeze in the Vari-Speed dead zone for the other modes
+  void setFreezeOnStop(bool enabled) noexcept
+  {
+    grainEngine_.setFreezeOnStop(enabled);
+  }
+
   // CV inputs with attenuverters
   void setGeneSizeCv(float cv, float atten) noexcept
   {
@@ -125,10 +256,117 @@ public:
     slideCvAtten_ = TapestryUtil::clamp(atten, -1.0f, 1.0f);
   }
 
+  // V/Oct pitch for the main playhead (multiplies the Vari-Speed rate)
+  void setPitchCv(float volts) noexcept
+  {
+    if (volts != pitchCv_)
+    {
+      pitchCv_ = volts;
+      pitchRatio_ = Lut::exp2(volts);
+    }
+  }
+
   void setSosCv(float cv) noexcept { sosCv_ = cv; }
   void setMorphCv(float cv) noexcept { morphCv_ = cv; }
   void setOrganizeCv(float cv) noexcept { organizeCv_ = cv; }
 
+  //--------------------------------------------------------------------------
+  // Polyphony
+  //--------------------------------------------------------------------------
+
+  // More than one channel replaces the main playhead with per-channel
+  // playheads on the same reel and splice. They are lighter than the grain
+  // engine; see tapestry-poly.h for the features they leave out.
+  void setPolyChannels(int channels) noexcept
+  {
+    poly_.setChannels(channels);
+    int previous = polyChannels_;
+    polyChannels_ = poly_.getChannels();
+
+    // New voices start from the current Slide instead of sweeping from
+    // their last value on the next control tick
+    for (int ch = (previous > 1 ? previous : 0); ch < polyChannels_; ch++)
+    {
+      polySlideRamps_[ch].snap(slideRamp_.getValue());
+    }
+  }
+
+  int getPolyChannels() const noexcept { return polyChannels_; }
+
+  // Per-channel Play gate, V/Oct and Slide CV (added to the Slide knob
+  // through the Slide CV attenuverter)
+  void setPolyVoice(int ch, bool gate, float pitchVolts, float slideCv) noexcept
+  {
+    if (ch < 0 || ch >= PolyPlayheads::kMaxChannels)
+      return;
+    poly_.setGate(ch, gate);
+    poly_.setPitch(ch, pitchVolts);
+    polySlideCv_[ch] = slideCv;
+  }
+
+  const PolyPlayheads &getPolyPlayheads() const noexcept { return poly_; }
+
+  //--------------------------------------------------------------------------
+  // Multi-Tap Read Heads
+  //--------------------------------------------------------------------------
+
+  // Extra heads play with the main playhead (0 = off, 2-8 heads). Ignored
+  // while polyphonic.
+  void setReadHeadCount(int count) noexcept { multiTap_.setHeadCount(count); }
+  int getReadHeadCount() const noexcept { return multiTap_.getHeadCount(); }
+
+  void setReadHead(int k, const ReadHeadSettings &settings) noexcept
+  {
+    multiTap_.setHead(k, settings);
+  }
+
+  const MultiTapHeads &getMultiTapHeads() const noexcept { return multiTap_; }
+
+  //--------------------------------------------------------------------------
+  // Control Rate
+  //--------------------------------------------------------------------------
+
+  static constexpr int kMaxControlRate = 64;
+
+  // Knobs and CVs are combined every `samples` samples (1 = every sample);
+  // continuous values ramp linearly between updates
+  void setControlRate(int samples) noexcept
+  {
+    samples = (samples < 1) ? 1 : (samples > kMaxControlRate ? kMaxControlRate : samples);
+    if (samples != controlRate_)
+    {
+      controlRate_ = samples;
+      controlCounter_ = 0;
+    }
+  }
+
+  int getControlRate() const noexcept { return controlRate_; }
+
+  // True when the next process() call runs a control update; hosts can read
+  // knobs and control-rate CVs only then
+  bool isControlTick() const noexcept { return controlCounter_ == 0; }
+
+  // Opt an input into per-sample evaluation (no ramp, no control delay)
+  void setAudioRateCv(ControlParam param, bool enabled) noexcept
+  {
+    uint32_t bit = 1u << static_cast<int>(param);
+    audioRateMask_ = enabled ? (audioRateMask_ | bit) : (audioRateMask_ & ~bit);
+  }
+
+  bool getAudioRateCv(ControlParam param) const noexcept { return isAudioRate(param); }
+
+  //--------------------------------------------------------------------------
+  // Telemetry
+  //--------------------------------------------------------------------------
+
+  // Times the grain and record stages into the owner's telemetry (null =
+  // off). The owner calls endSample() after each process().
+  void setTelemetry(Telemetry *telemetry) noexcept { telemetry_ = telemetry; }
+
+  // Audio thread events (splice changes, EOSG, clock edges, recording) go to
+  // the owner's trace ring (null = off)
+  void setTrace(TraceRing *trace) noexcept { trace_ = trace; }
+
   //--------------------------------------------------------------------------
   // Gate/Trigger Inputs
   //--------------------------------------------------------------------------
@@ -153,6 +391,7 @@ public:
 
   void onClockRising() noexcept
   {
+    traceInstant(TraceEvent::ClockRising);
     grainEngine_.onClockRising();
 
     // If recording and waiting for clock sync
@@ -185,6 +424,7 @@ public:
       // Shift immediately to next splice
       // Playhead continues from current position - does not reset
       spliceManager_.shiftImmediate();
+      traceInstant(TraceEvent::SpliceChange, spliceManager_.getCurrentIndex());
 
       // Retrigger the grain engine at new splice position
       // This also works when stopped - it sets up the position for when playback resumes
@@ -203,10 +443,16 @@ public:
   {
     if (moduleMode_ == ModuleMode::Normal && !isRecording())
     {
-      spliceManager_.addMarkerAtPosition(currentFrame);
+      spliceManager_.addMarkerAtPosition(snapToZeroCrossing(currentFrame));
     }
   }
 
+  // Nearest zero crossing within the snap window, or frame itself
+  size_t snapToZeroCrossing(size_t frame) const noexcept
+  {
+    return zeroCrossings_.snap(frame, zeroCrossingSnapFrames_);
+  }
+
   //--------------------------------------------------------------------------
   // Recording Control
   //--------------------------------------------------------------------------
@@ -228,8 +474,11 @@ public:
   {
     if (!overdubMode_)
     {      // Replace mode: Clear existing buffer and splices
+      recordStaged_ = 0;  // Anything still staged belongs to the old reel
       buffer_.clear();
+      zeroCrossings_.clear();
       spliceManager_.clear();
+      beatGrid_ = BeatGrid();
       currentPosition = 0; // Always start from 0 in replace mode
     }
     // If overdub mode is on and buffer has content, start recording at current position
@@ -342,6 +591,7 @@ public:
       if (spliceManager_.deleteCurrentSpliceAudio(start, end))
       {
         buffer_.clearRange(start, end);
+        zeroCrossings_.updateRange(buffer_, start, end);
         // TODO: Shift remaining audio if splice was deleted (not just cleared)
       }
     }
@@ -351,9 +601,14 @@ public:
   {
     stopRecording();
     buffer_.clear();
+    zeroCrossings_.clear();
     spliceManager_.clear();
     grainEngine_.reset();
+    poly_.reset();
+    poly_.setChannels(polyChannels_);
+    multiTap_.reset();
     playbackState_ = PlaybackState();
+    beatGrid_ = BeatGrid();  // Stale until the new reel is analyzed
   }
 
   //--------------------------------------------------------------------------
@@ -366,6 +621,20 @@ public:
     float audioOutR = 0.0f;
     float cvOut = 0.0f;
     bool endOfSpliceGene = false;
+
+    // Per-channel outputs when polyphonic (audioOut holds their mix)
+    int polyChannels = 1;
+    uint32_t polyEndOfGene = 0;  // Bit per channel that reached its end of gene
+    float polyOutL[PolyPlayheads::kMaxChannels] = {};
+    float polyOutR[PolyPlayheads::kMaxChannels] = {};
+
+    // Per-head outputs of the multi-tap read heads (audioOut holds their mix
+    // with the main playhead, mainOut the main playhead alone)
+    int readHeads = 0;
+    float mainOutL = 0.0f;
+    float mainOutR = 0.0f;
+    float headOutL[MultiTapHeads::kMaxHeads] = {};
+    float headOutR[MultiTapHeads::kMaxHeads] = {};
   };
 
   ProcessResult process(float audioInL, float audioInR) noexcept
@@ -384,65 +653,35 @@ public:
       {
         autoLevelPeak_ += autoLevelRelease_ * (peak - autoLevelPeak_);
       }
+      autoLevelPeak_ = flushDenormal(autoLevelPeak_);
     }
 
     audioInL *= autoLevelGain_;
     audioInR *= autoLevelGain_;
 
-    // Calculate effective parameters with CV modulation
-    float effectiveSos = sosParam_;
-    if (sosCv_ != 0.0f)
+    // Control-rate stage: effective parameters and derived states are
+    // recomputed every controlRate_ samples (audio-rate CVs every sample)
+    bool controlTick = (controlCounter_ == 0);
+    if (controlTick || audioRateMask_ != 0)
     {
-      effectiveSos += sosCv_ / TapestryConfig::kSosCvMax;
-      effectiveSos = TapestryUtil::clamp01(effectiveSos);
+      updateControl(controlTick);
     }
-
-    float effectiveGeneSize = geneSizeParam_;
-    effectiveGeneSize += (geneSizeCv_ / TapestryConfig::kGeneSizeCvMax) * geneSizeCvAtten_;
-    effectiveGeneSize = TapestryUtil::clamp01(effectiveGeneSize);
-
-    float effectiveMorph = morphParam_;
-    if (morphCv_ != 0.0f)
+    if (++controlCounter_ >= controlRate_)
     {
-      effectiveMorph += morphCv_ / TapestryConfig::kMorphCvMax;
-      effectiveMorph = TapestryUtil::clamp01(effectiveMorph);
+      controlCounter_ = 0;
     }
 
-    float effectiveSlide = slideParam_;
-    effectiveSlide += (slideCv_ / TapestryConfig::kSlideCvMax) * slideCvAtten_;
-    effectiveSlide = TapestryUtil::clamp01(effectiveSlide);
-
-    float effectiveOrganize = organizeParam_;
-    if (organizeCv_ != 0.0f)
-    {
-      effectiveOrganize += organizeCv_ / TapestryConfig::kOrganizeCvMax;
-      effectiveOrganize = TapestryUtil::clamp01(effectiveOrganize);
-      spliceManager_.setOrganize(effectiveOrganize);
-    }
-
-    // Vari-speed: convert 0-1 to -1 to +1
-    float variSpeedBipolar = (variSpeedParam_ - 0.5f) * 2.0f;
-    variSpeedState_ = TapestryUtil::calculateVariSpeed(
-        variSpeedBipolar, variSpeedCv_, variSpeedCvAtten_);
-
-    // Update morph state
-    morphState_ = TapestryUtil::calculateMorphState(effectiveMorph);
+    // Audio-rate ramps toward the control targets
+    float effectiveSos = sosRamp_.process();
+    float effectiveSlide = slideRamp_.process();
+    float geneSizeSamples = geneSizeRamp_.process();
+    variSpeedState_ = controlVariSpeed_;
+    variSpeedState_.speedRatio = speedRamp_.process();
 
     // Get current splice bounds
-    const SpliceMarker *currentSplice = spliceManager_.getCurrentSplice();
     size_t spliceStart = 0;
-    size_t spliceEnd = buffer_.getUsedFrames();
-
-    if (currentSplice && currentSplice->isValid())
-    {
-      spliceStart = currentSplice->startFrame;
-      spliceEnd = std::min(currentSplice->endFrame, buffer_.getUsedFrames());
-    }
-
-    // Calculate gene size in samples
-    float spliceLengthSamples = static_cast<float>(spliceEnd - spliceStart);
-    float geneSizeSamples = TapestryUtil::calculateGeneSizeSamples(
-        effectiveGeneSize, spliceLengthSamples);
+    size_t spliceEnd = 0;
+    getCurrentSpliceBounds(spliceStart, spliceEnd);
 
     // Update grain engine parameters
     grainEngine_.setGeneSize(geneSizeSamples);
@@ -451,11 +690,56 @@ public:
     grainEngine_.setVariSpeed(variSpeedState_);
 
     // Process playback
+    uint64_t grainStart = Telemetry::begin(telemetry_);
     float playbackL = 0.0f;
     float playbackR = 0.0f;
     bool endOfGene = false;
 
-    if (playbackState_.isPlaying && !buffer_.isEmpty())
+    if (polyChannels_ > 1)
+    {
+      result.polyChannels = polyChannels_;
+      for (int ch = 0; ch < polyChannels_; ch++)
+      {
+        poly_.setSlide(ch, polySlideRamps_[ch].process());
+      }
+      if (!buffer_.isEmpty() && !variSpeedState_.isStopped)
+      {
+        float speed = variSpeedState_.speedRatio * TapestryConfig::kInternalSampleRate / sampleRate_;
+        uint32_t ended = poly_.process(buffer_, spliceStart, spliceEnd, geneSizeSamples, speed,
+                                       result.polyOutL, result.polyOutR);
+        if (ended != 0)
+        {
+          // Pending splice changes apply at the first voice's end of gene;
+          // every voice moves to the new splice at its own
+          result.endOfSpliceGene = true;
+          result.polyEndOfGene = ended;
+          traceInstant(TraceEvent::EndOfGene, spliceManager_.getCurrentIndex());
+          if (spliceManager_.onEndOfSplice())
+          {
+            traceInstant(TraceEvent::SpliceChange, spliceManager_.getCurrentIndex());
+            getCurrentSpliceBounds(spliceStart, spliceEnd);
+          }
+          for (int ch = 0; ch < polyChannels_; ch++)
+          {
+            if (ended & (1u << ch))
+              poly_.beginGene(ch, spliceStart, spliceEnd);
+          }
+        }
+      }
+
+      // Mix feeds Sound-on-Sound and the mono outputs
+      for (int ch = 0; ch < polyChannels_; ch++)
+      {
+        playbackL += result.polyOutL[ch];
+        playbackR += result.polyOutR[ch];
+        result.polyOutL[ch] = audioInL * (1.0f - effectiveSos) + result.polyOutL[ch] * effectiveSos;
+        result.polyOutR[ch] = audioInR * (1.0f - effectiveSos) + result.polyOutR[ch] * effectiveSos;
+      }
+      float mixGain = 1.0f / std::sqrt(static_cast<float>(polyChannels_));
+      playbackL *= mixGain;
+      playbackR *= mixGain;
+    }
+    else if (playbackState_.isPlaying && !buffer_.isEmpty())
     {
       grainEngine_.process(buffer_, spliceStart, spliceEnd,
                            playbackL, playbackR, endOfGene);
@@ -464,10 +748,13 @@ public:
       if (endOfGene)
       {
         result.endOfSpliceGene = true;
+        traceInstant(TraceEvent::EndOfGene, spliceManager_.getCurrentIndex());
 
         // Apply pending splice change
         if (spliceManager_.onEndOfSplice())
         {
+          traceInstant(TraceEvent::SpliceChange, spliceManager_.getCurrentIndex());
+
           // Splice changed - retrigger if gate is high
           if (playbackState_.playGateHigh)
           {
@@ -481,12 +768,43 @@ public:
           playbackState_.isPlaying = false;
         }
       }
+
+      // Multi-tap heads run alongside the main playhead and share its gate
+      int heads = multiTap_.getHeadCount();
+      if (heads > 0)
+      {
+        result.readHeads = heads;
+        result.mainOutL = audioInL * (1.0f - effectiveSos) + playbackL * effectiveSos;
+        result.mainOutR = audioInR * (1.0f - effectiveSos) + playbackR * effectiveSos;
+        if (!variSpeedState_.isStopped)
+        {
+          float speed = variSpeedState_.speedRatio * TapestryConfig::kInternalSampleRate / sampleRate_;
+          multiTap_.process(buffer_, spliceManager_, spliceStart, spliceEnd, speed,
+                            grainEngine_.getInterpolationQuality(),
+                            result.headOutL, result.headOutR);
+        }
+
+        float mixGain = 1.0f / std::sqrt(static_cast<float>(heads + 1));
+        for (int k = 0; k < heads; k++)
+        {
+          playbackL += result.headOutL[k];
+          playbackR += result.headOutR[k];
+          result.headOutL[k] = audioInL * (1.0f - effectiveSos) + result.headOutL[k] * effectiveSos;
+          result.headOutR[k] = audioInR * (1.0f - effectiveSos) + result.headOutR[k] * effectiveSos;
+        }
+        playbackL *= mixGain;
+        playbackR *= mixGain;
+      }
     }
 
+    Telemetry::end(telemetry_, TelemetryStage::Grain, grainStart);
+
     // Process recording
     if (recordState_.mode != RecordState::Mode::Idle)
     {
+      uint64_t recordStart = Telemetry::begin(telemetry_);
       processRecording(audioInL, audioInR, playbackL, playbackR, effectiveSos);
+      Telemetry::end(telemetry_, TelemetryStage::Record, recordStart);
     }
 
     // Mix output based on S.O.S. setting
@@ -506,6 +824,7 @@ public:
     {
       envelopeValue_ += envReleaseCoeff_ * (outputPeak - envelopeValue_);
     }
+    envelopeValue_ = flushDenormal(envelopeValue_);
     result.cvOut = envelopeValue_ * TapestryConfig::kCvOutMax;
 
     return result;
@@ -523,6 +842,45 @@ public:
 
   const GrainEngine &getGrainEngine() const noexcept { return grainEngine_; }
 
+  const ZeroCrossingIndex &getZeroCrossingIndex() const noexcept { return zeroCrossings_; }
+
+  //--------------------------------------------------------------------------
+  // Background Analysis
+  //--------------------------------------------------------------------------
+
+  // Recompute splice features and tempo for the latest reel snapshot that
+  // process() published (none while recording). Call periodically from a
+  // single worker thread, never from process().
+  // Returns true if new features were published.
+  bool runAnalysis() noexcept
+  {
+    bool featuresChanged = featureCache_.update(buffer_, TapestryConfig::kInternalSampleRate);
+    const SpliceFeatureCache::SpliceLayout *snapshot = featureCache_.getLayout();
+    bool tempoChanged = snapshot && tempo_.update(buffer_, snapshot->bufferVersion, snapshot->usedFrames);
+    return featuresChanged || tempoChanged;
+  }
+
+  // Latest detected tempo (invalid until the reel has been analyzed).
+  // Audio thread only: process() rewrites it.
+  const BeatGrid &getBeatGrid() const noexcept { return beatGrid_; }
+
+  // Copy of the grid process() last published, for a single UI thread
+  BeatGrid getPublishedBeatGrid() noexcept
+  {
+    uiBeatGrid_.update();
+    const BeatGrid *grid = uiBeatGrid_.front();
+    return grid ? *grid : BeatGrid();
+  }
+
+  // Replace all markers with markers every beatsPerSplice detected beats.
+  // Returns false if no tempo has been detected for the reel.
+  bool spliceToBeatGrid(int beatsPerSplice) noexcept
+  {
+    if (!spliceManager_.setFromBeatGrid(beatGrid_, beatsPerSplice, buffer_.getUsedFrames()))
+      return false;
+    return true;
+  }
+
   const PlaybackState &getPlaybackState() const noexcept { return playbackState_; }
   const RecordState &getRecordState() const noexcept { return recordState_; }
   const VariSpeedState &getVariSpeedState() const noexcept { return variSpeedState_; }
@@ -564,9 +922,11 @@ public:
   {
     clearReel();
 
-    size_t framesToLoad = std::min(numFrames, TapestryBuffer::kMaxFrames);
+    const size_t maxFrames = TapestryBuffer::kMaxFrames;
+    size_t framesToLoad = std::min(numFrames, maxFrames);
     buffer_.copyFrom(data, framesToLoad);
     buffer_.setUsedFrames(framesToLoad);
+    zeroCrossings_.rebuild(buffer_);
 
     if (markers.empty())
     {
@@ -581,6 +941,30 @@ public:
     grainEngine_.retrigger(0.0f);
   }
 
+  // reset() state, playing a reel shared with other instances (see
+  // TapestryBuffer::shareReel). For offline tools: not real-time safe, and
+  // recording into the reel gives this instance a private copy.
+  void loadSharedReel(std::shared_ptr<const std::vector<float>> reel, size_t numFrames,
+                      const std::vector<size_t> &markers = {})
+  {
+    resetState();
+    buffer_.shareReel(std::move(reel), numFrames);
+    zeroCrossings_.rebuild(buffer_);
+
+    size_t frames = buffer_.getUsedFrames();
+    if (markers.empty())
+    {
+      spliceManager_.initialize(frames);
+    }
+    else
+    {
+      spliceManager_.setFromMarkerPositions(markers, frames);
+    }
+
+    playbackState_.isPlaying = true;
+    grainEngine_.retrigger(0.0f);
+  }
+
   // Get data for saving
   size_t getReelData(float *dest, size_t maxFrames) const noexcept
   {
@@ -595,6 +979,163 @@ public:
   }
 
 private:
+  //--------------------------------------------------------------------------
+  // Control-Rate Stage
+  //--------------------------------------------------------------------------
+
+  bool isAudioRate(ControlParam param) const noexcept
+  {
+    return (audioRateMask_ & (1u << static_cast<int>(param))) != 0;
+  }
+
+  // Ramp to a new control value over one control period, or jump to it for
+  // audio-rate inputs, per-sample control and the first update
+  void rampTo(TapestryUtil::LinearRamp &ramp, float target, bool audioRate) noexcept
+  {
+    if (!rampsPrimed_ || audioRate || controlRate_ <= 1)
+      ramp.snap(target);
+    else
+      ramp.setTarget(target, controlRate_);
+  }
+
+  void updateZeroCrossingSnapFrames() noexcept
+  {
+    zeroCrossingSnapFrames_ = static_cast<size_t>(zeroCrossingSnapSeconds_ * sampleRate_ + 0.5f);
+  }
+
+  // Republishes beatGrid_ for the UI when it changed, including when a
+  // reel clear reset it
+  void publishBeatGrid() noexcept
+  {
+    if (beatGrid_.valid == uiBeatGridSent_.valid &&
+        beatGrid_.periodFrames == uiBeatGridSent_.periodFrames &&
+        beatGrid_.offsetFrames == uiBeatGridSent_.offsetFrames &&
+        beatGrid_.reelFrames == uiBeatGridSent_.reelFrames)
+      return;
+    uiBeatGridSent_ = beatGrid_;
+    uiBeatGrid_.back() = beatGrid_;
+    uiBeatGrid_.publish();
+  }
+
+  void getCurrentSpliceBounds(size_t &start, size_t &end) const noexcept
+  {
+    const SpliceMarker *currentSplice = spliceManager_.getCurrentSplice();
+    start = 0;
+    end = buffer_.getUsedFrames();
+    if (currentSplice && currentSplice->isValid())
+    {
+      start = currentSplice->startFrame;
+      end = std::min(currentSplice->endFrame, buffer_.getUsedFrames());
+    }
+  }
+
+  // Recompute effective parameters from knobs and CVs. A control tick
+  // updates everything; otherwise only the audio-rate inputs.
+  void updateControl(bool tick) noexcept
+  {
+    if (tick || isAudioRate(ControlParam::Sos))
+    {
+      float effectiveSos = sosParam_;
+      if (sosCv_ != 0.0f)
+      {
+        effectiveSos += sosCv_ / TapestryConfig::kSosCvMax;
+        effectiveSos = TapestryUtil::clamp01(effectiveSos);
+      }
+      rampTo(sosRamp_, effectiveSos, isAudioRate(ControlParam::Sos));
+    }
+
+    if (tick || isAudioRate(ControlParam::Morph))
+    {
+      float effectiveMorph = morphParam_;
+      if (morphCv_ != 0.0f)
+      {
+        effectiveMorph += morphCv_ / TapestryConfig::kMorphCvMax;
+        effectiveMorph = TapestryUtil::clamp01(effectiveMorph);
+      }
+      morphState_ = TapestryUtil::calculateMorphState(effectiveMorph);
+    }
+
+    if (tick || isAudioRate(ControlParam::Slide))
+    {
+      float effectiveSlide = slideParam_;
+      effectiveSlide += (slideCv_ / TapestryConfig::kSlideCvMax) * slideCvAtten_;
+      effectiveSlide = TapestryUtil::clamp01(effectiveSlide);
+      rampTo(slideRamp_, effectiveSlide, isAudioRate(ControlParam::Slide));
+
+      // Poly voices: the same Slide knob and attenuverter, CV per channel
+      for (int ch = 0; ch < polyChannels_; ch++)
+      {
+        float slide = slideParam_ + (polySlideCv_[ch] / TapestryConfig::kSlideCvMax) * slideCvAtten_;
+        rampTo(polySlideRamps_[ch], TapestryUtil::clamp01(slide), isAudioRate(ControlParam::Slide));
+      }
+    }
+
+    if (tick)
+    {
+      // Content-aware Organize: pick up the latest rank table for this layout
+      featureCache_.publishSplices(spliceManager_, buffer_, isRecording());
+      const SpliceFeatureCache::FeatureTable *features = nullptr;
+      if (organizeSortMode_ != OrganizeSortMode::Position)
+      {
+        features = featureCache_.acquire(spliceManager_.getVersion());
+      }
+      if (features)
+        spliceManager_.setOrganizeOrder(features->getOrder(organizeSortMode_), features->count);
+      else
+        spliceManager_.setOrganizeOrder(nullptr, 0);
+
+      tempo_.fetch(beatGrid_);
+      publishBeatGrid();
+    }
+
+    if ((tick || isAudioRate(ControlParam::Organize)) && organizeCv_ != 0.0f)
+    {
+      float effectiveOrganize = organizeParam_ + organizeCv_ / TapestryConfig::kOrganizeCvMax;
+      spliceManager_.setOrganize(TapestryUtil::clamp01(effectiveOrganize));
+    }
+
+    bool audioRateSpeed = isAudioRate(ControlParam::VariSpeed) || isAudioRate(ControlParam::Pitch);
+    if (tick || audioRateSpeed)
+    {
+      // Vari-speed: convert 0-1 to -1 to +1
+      float variSpeedBipolar = (variSpeedParam_ - 0.5f) * 2.0f;
+      controlVariSpeed_ = TapestryUtil::calculateVariSpeed(
+          variSpeedBipolar, variSpeedCv_, variSpeedCvAtten_);
+
+      float clockPeriod = grainEngine_.getClockPeriodSamples();
+      if (tempoLock_ && beatGrid_.valid && grainEngine_.isClockSynced() &&
+          clockPeriod > 0.0f && !controlVariSpeed_.isStopped)
+      {
+        float ratio = TapestryUtil::calculateTempoLockRatio(
+            beatGrid_.periodFrames, clockPeriod, TapestryConfig::kInternalSampleRate / sampleRate_);
+        controlVariSpeed_.speedRatio = controlVariSpeed_.isForward ? ratio : -ratio;
+        controlVariSpeed_.isAtUnity = std::fabs(ratio - 1.0f) < 0.03f;
+        controlVariSpeed_.octaveShift = 0;
+      }
+      if (polyChannels_ == 1)
+      {
+        controlVariSpeed_.speedRatio *= pitchRatio_;
+      }
+      rampTo(speedRamp_, controlVariSpeed_.speedRatio, audioRateSpeed);
+    }
+
+    if (tick || isAudioRate(ControlParam::GeneSize))
+    {
+      float effectiveGeneSize = geneSizeParam_;
+      effectiveGeneSize += (geneSizeCv_ / TapestryConfig::kGeneSizeCvMax) * geneSizeCvAtten_;
+      effectiveGeneSize = TapestryUtil::clamp01(effectiveGeneSize);
+
+      size_t spliceStart = 0;
+      size_t spliceEnd = 0;
+      getCurrentSpliceBounds(spliceStart, spliceEnd);
+      float spliceLengthSamples = static_cast<float>(spliceEnd - spliceStart);
+      rampTo(geneSizeRamp_, TapestryUtil::calculateGeneSizeSamples(effectiveGeneSize, spliceLengthSamples),
+             isAudioRate(ControlParam::GeneSize));
+    }
+
+    rampsPrimed_ = true;
+  }
+
   //--------------------------------------------------------------------------
   // Recording Implementation
   //--------------------------------------------------------------------------
@@ -606,6 +1147,8 @@ private:
 
   void startRecording(RecordState::Mode mode, size_t overdubPosition) noexcept
   {
+    flushRecording();
+
     // Track if this is a new recording into a freshly created splice
     recordState_.isInitialRecording = false;
     
@@ -670,23 +1213,42 @@ private:
       }
     }
 
+    if (trace_ && recordState_.mode == RecordState::Mode::Idle)
+    {
+      trace_->begin(TraceThread::Audio, TraceEvent::Recording, static_cast<int64_t>(mode));
+    }
     recordState_.mode = mode;
     recordState_.waitingForClock = false;
   }
 
   void stopRecording() noexcept
   {
+    flushRecording();
+
     // Finalize splice when stopping an initial recording (extending mode)
     if (recordState_.isInitialRecording)
     {
       spliceManager_.extendLastSplice(recordState_.recordPosition);
     }
 
+    if (trace_ && recordState_.mode != RecordState::Mode::Idle)
+    {
+      trace_->end(TraceThread::Audio, TraceEvent::Recording);
+    }
     recordState_.mode = RecordState::Mode::Idle;
     recordState_.waitingForClock = false;
     recordState_.isInitialRecording = false;
   }
 
+  void traceInstant(TraceEvent event, int64_t arg = 0) noexcept
+  {
+    if (trace_)
+      trace_->instant(TraceThread::Audio, event, arg);
+  }
+
+  // Recording is staged per sample and written to the reel one span at a
+  // time: when the staging block fills, at the splice loop point, and when
+  // recording starts or stops.
   void processRecording(float liveL, float liveR,
                         float playbackL, float playbackR,
                         float sosAmount) noexcept
@@ -701,60 +1263,70 @@ private:
       return;
     }
 
-    if (recordState_.mode == RecordState::Mode::SameSplice)
+    // Initial and new-splice recording write live input directly (ignore
+    // SOS, which only makes sense with existing content to blend with).
+    // Overdub mode adds to the existing content (scaled by the overdub
+    // feedback, optionally saturated); otherwise SOS blends:
+    // 0 = replace, 1 = keep existing loop content, 0.5 = 50/50.
+    TapestryBuffer::BlockMode blend = TapestryBuffer::BlockMode::Replace;
+    if (recordState_.mode == RecordState::Mode::SameSplice && !recordState_.isInitialRecording)
     {
-      // Check if we need to loop or extend based on recording mode
-      if (recordState_.isInitialRecording)
+      blend = overdubMode_ ? TapestryBuffer::BlockMode::Overdub
+                           : TapestryBuffer::BlockMode::SoundOnSound;
+    }
+    if (blend != recordBlend_)
+    {
+      flushRecording();
+      recordBlend_ = blend;
+    }
+
+    if (recordStaged_ == 0)
+    {
+      recordSpanStart_ = recordState_.recordPosition;
+    }
+    size_t i = recordStaged_ * TapestryBuffer::kChannels;
+    recordLive_[i] = liveL;
+    recordLive_[i + 1] = liveR;
+    recordSos_[i] = recordSos_[i + 1] = sosAmount;
+    recordStaged_++;
+    recordState_.recordPosition++;
+
+    if (blend != TapestryBuffer::BlockMode::Replace)
+    {
+      // Loop within current splice bounds; the span ends at the loop point
+      const SpliceMarker *splice = spliceManager_.getCurrentSplice();
+      if (splice && splice->isValid() && recordState_.recordPosition >= splice->endFrame)
       {
-        // Initial recording mode: write live input directly (ignore SOS)
-        // SOS only makes sense when there's existing content to blend with
-        buffer_.writeStereo(recordState_.recordPosition, liveL, liveR);
-        recordState_.recordPosition++;
-        
-        // Extend the splice as we record
-        spliceManager_.extendLastSplice(recordState_.recordPosition);
-      }
-      else
-      {
-        // Overdub mode: Sound-on-Sound recording into current splice
-        if (overdubMode_)
-        {
-          // True overdub: ADD new audio to existing (ignore SOS parameter)
-          float existingL, existingR;
-          buffer_.readStereo(recordState_.recordPosition, existingL, existingR);
-          buffer_.writeStereo(recordState_.recordPosition, 
-                            existingL + liveL, 
-                            existingR + liveR);
-        }
-        else
-        {
-          // Traditional SOS: blend based on sosAmount parameter
-          // sosAmount controls wet/dry of what we're recording:
-          // 0 = record live input over existing (replace)
-          // 1 = keep existing loop content (no new recording)
-          // 0.5 = blend 50/50
-          buffer_.mixAndWrite(recordState_.recordPosition, liveL, liveR, sosAmount);
-        }
-        recordState_.recordPosition++;
-        
-        // Loop within current splice bounds
-        const SpliceMarker *splice = spliceManager_.getCurrentSplice();
-        if (splice && splice->isValid() && recordState_.recordPosition >= splice->endFrame)
-        {
-          // Loop back to start of splice
-          recordState_.recordPosition = splice->startFrame;
-        }
+        flushRecording();
+        recordState_.recordPosition = splice->startFrame;
+        return;
       }
     }
-    else if (recordState_.mode == RecordState::Mode::NewSplice)
+
+    if (recordStaged_ == kRecordBlockFrames)
     {
-      // New splice: Write live input
-      // This is always "initial recording" mode - extending the splice
-      buffer_.writeStereo(recordState_.recordPosition, liveL, liveR);
-      recordState_.recordPosition++;
+      flushRecording();
+    }
+  }
 
-      // Update splice end
-      spliceManager_.extendLastSplice(recordState_.recordPosition);
+  // Write the staged span, then update the zero-crossing index and (when
+  // extending) the splice end once for the whole span
+  void flushRecording() noexcept
+  {
+    if (recordStaged_ == 0)
+      return;
+
+    size_t written = buffer_.writeBlock(recordSpanStart_, recordLive_, recordSos_,
+                                        recordStaged_, recordBlend_,
+                                        overdubFeedback_, overdubSaturation_);
+    recordStaged_ = 0;
+    if (written == 0)
+      return;
+
+    zeroCrossings_.updateRange(buffer_, recordSpanStart_, recordSpanStart_ + written);
+    if (recordState_.isInitialRecording)
+    {
+      spliceManager_.extendLastSplice(recordSpanStart_ + written);
     }
   }
 
@@ -765,8 +1337,18 @@ private:
   float sampleRate_ = 48000.0f;
 
   TapestryBuffer buffer_;
+  ZeroCrossingIndex zeroCrossings_;
   SpliceManager spliceManager_;
   GrainEngine grainEngine_;
+  PolyPlayheads poly_;
+  MultiTapHeads multiTap_;
+  SpliceFeatureCache featureCache_;
+  Telemetry *telemetry_ = nullptr;
+  TraceRing *trace_ = nullptr;
+  TempoAnalyzer tempo_;
+  BeatGrid beatGrid_;  // Audio thread copy of the latest published grid
+  TripleBuffer<BeatGrid> uiBeatGrid_;  // beatGrid_ republished for the UI
+  BeatGrid uiBeatGridSent_;            // Last grid published to uiBeatGrid_
 
   PlaybackState playbackState_;
   RecordState recordState_;
@@ -795,6 +1377,13 @@ private:
   float organizeCv_ = 0.0f;
   float variSpeedCv_ = 0.0f;
   float variSpeedCvAtten_ = 0.0f;
+  float pitchCv_ = 0.0f;
+  float pitchRatio_ = 1.0f;
+
+  // Polyphony
+  int polyChannels_ = 1;
+  float polySlideCv_[PolyPlayheads::kMaxChannels] = {};
+  TapestryUtil::LinearRamp polySlideRamps_[PolyPlayheads::kMaxChannels];
 
   // Envelope follower
   float envelopeValue_ = 0.0f;
@@ -810,6 +1399,36 @@ private:
 
   // Overdub mode
   bool overdubMode_ = false;  // Default OFF: replace existing content
+  float overdubFeedback_ = 1.0f;
+  bool overdubSaturation_ = false;
+
+  // Marker snapping
+  float zeroCrossingSnapSeconds_ = kDefaultZeroCrossingSnapSeconds;
+  size_t zeroCrossingSnapFrames_ = 0;  // From the seconds at sampleRate_
+
+  // Content-aware Organize
+  OrganizeSortMode organizeSortMode_ = OrganizeSortMode::Position;
+
+  // Tempo lock
+  bool tempoLock_ = false;
+
+  // Control-rate stage
+  int controlRate_ = 1;
+  int controlCounter_ = 0;
+  uint32_t audioRateMask_ = 0;
+  bool rampsPrimed_ = false;
+  VariSpeedState controlVariSpeed_;
+  TapestryUtil::LinearRamp sosRamp_;
+  TapestryUtil::LinearRamp slideRamp_;
+  TapestryUtil::LinearRamp geneSizeRamp_;
+  TapestryUtil::LinearRamp speedRamp_;
+
+  // Recording span staged for the next block write
+  float recordLive_[kRecordBlockFrames * TapestryBuffer::kChannels];
+  float recordSos_[kRecordBlockFrames * TapestryBuffer::kChannels];
+  size_t recordStaged_ = 0;
+  size_t recordSpanStart_ = 0;
+  TapestryBuffer::BlockMode recordBlend_ = TapestryBuffer::BlockMode::Replace;
 };
 
 } // namespace ShortwavDSP
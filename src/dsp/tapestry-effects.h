@@ -2,12 +2,43 @@
 
 #include <cmath>
 #include <algorithm>
+#include "tapestry-lut.h"
+#include "tapestry-denormal.h"
+#include "tapestry-simd.h"
 
 // Define M_PI for Windows (not part of C++ standard)
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+//------------------------------------------------------------------------------
+// Parameter Smoother for zipper-free control changes
+//------------------------------------------------------------------------------
+
+class SmoothParam {
+public:
+    void setTarget(float target) { target_ = target; }
+    float getTarget() const { return target_; }
+    
+    float process() {
+        current_ = ShortwavDSP::flushDenormal(current_ + smoothCoeff_ * (target_ - current_));
+        return current_;
+    }
+    
+    void setSmoothTime(float timeMs, float sampleRate) {
+        smoothCoeff_ = 1.0f - std::exp(-1.0f / (sampleRate * timeMs * 0.001f));
+    }
+    
+    void setImmediate(float value) {
+        current_ = target_ = value;
+    }
+    
+private:
+    float current_ = 0.0f;
+    float target_ = 0.0f;
+    float smoothCoeff_ = 0.001f;
+};
+
 //------------------------------------------------------------------------------
 // Bit Crusher DSP
 // Based on musicdsp.org Decimator by tobybear + Lo-Fi Crusher by David Lowenfels
@@ -30,7 +61,7 @@ public:
         // Calculate quantization step size
         // At 16 bits: step = 1/32768 = 0.00003
         // At 1 bit: step = 1 (full range quantization)
-        float levels = std::pow(2.0f, bits_);
+        float levels = ShortwavDSP::Lut::exp2(bits_);
         quantStep_ = 2.0f / levels;  // Range is -1 to 1, so 2.0 total
         
         // Calculate rate reduction: how many samples to hold
@@ -88,10 +119,14 @@ public:
         // cutoffNorm: 0.0 to 1.0 (maps to 20Hz - 20kHz logarithmically)
         // resonance: 0.0 to 1.0
         
-        // Logarithmic frequency mapping
-        float minFreq = 20.0f;
-        float maxFreq = std::min(20000.0f, sampleRate * 0.45f);  // Stay below Nyquist
-        float freq = minFreq * std::pow(maxFreq / minFreq, cutoffNorm);
+        // Logarithmic frequency mapping (octave span cached per sample rate)
+        const float minFreq = 20.0f;
+        if (sampleRate != spanSampleRate_) {
+            float maxFreq = std::min(20000.0f, sampleRate * 0.45f);  // Stay below Nyquist
+            octaveSpan_ = std::log2(maxFreq / minFreq);
+            spanSampleRate_ = sampleRate;
+        }
+        float freq = minFreq * ShortwavDSP::Lut::exp2(cutoffNorm * octaveSpan_);
         
         // Calculate normalized frequency (0 to 1, where 1 = Nyquist)
         float wc = 2.0f * M_PI * freq / sampleRate;
@@ -122,20 +157,204 @@ public:
         stage_[2] += cutoff_ * (stage_[1] - stage_[2]);
         stage_[3] += cutoff_ * (stage_[2] - stage_[3]);
         
-        // Denormal protection
+        // Denormals are flushed by the caller's ScopedFlushDenormals (in
+        // software only where the CPU has no flush-to-zero mode)
         for (int i = 0; i < 4; i++) {
-            if (!std::isfinite(stage_[i]) || std::fabs(stage_[i]) < 1e-30f) {
-                stage_[i] = 0.0f;
-            }
+            stage_[i] = ShortwavDSP::flushDenormal(stage_[i]);
         }
         
         return stage_[3];
     }
     
+    // A NaN or Inf input latches in all four poles. Callers check this once
+    // per block (rather than per sample) and reset() to recover.
+    bool isFinite() const {
+        return std::isfinite(stage_[3]);
+    }
+    
 private:
     float cutoff_ = 0.5f;      // Filter coefficient
     float resonance_ = 0.0f;   // Feedback amount (0-4)
+    float spanSampleRate_ = 0.0f;  // Sample rate octaveSpan_ was computed for
+    float octaveSpan_ = 0.0f;      // log2(maxFreq / minFreq)
     
     // Filter state (4 poles)
     float stage_[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+//------------------------------------------------------------------------------
+// Expander Effect Chain
+// DC blocker -> Bit Crusher -> Moog VCF -> output level -> soft clip, run over
+// blocks of stereo frames. Parameters are smoothed per sample; the crusher
+// and filter coefficients are updated once per block, and the filter dry/wet
+// mix runs four frames at a time.
+//------------------------------------------------------------------------------
+
+class ExpanderEffectChain {
+public:
+    static constexpr int kMaxBlockFrames = 64;
+
+    // Control targets, already clamped to their ranges
+    struct Params {
+        float bits = 16.0f;        // 1-16
+        float rate = 0.0f;         // Rate reduction, 0-1
+        float crushMix = 0.0f;     // 0-1
+        float cutoff = 1.0f;       // Normalized, 0-1
+        float resonance = 0.0f;    // 0-1
+        float filterMix = 0.0f;    // 0-1
+        float outputLevel = 1.0f;  // 0-2
+    };
+
+    ExpanderEffectChain() { setSampleRate(48000.0f); }
+
+    void setSampleRate(float sampleRate) {
+        sampleRate_ = sampleRate;
+
+        // 5ms parameter smoothing
+        const float smoothTimeMs = 5.0f;
+        smoothBits_.setSmoothTime(smoothTimeMs, sampleRate_);
+        smoothRate_.setSmoothTime(smoothTimeMs, sampleRate_);
+        smoothCrushMix_.setSmoothTime(smoothTimeMs, sampleRate_);
+        smoothCutoff_.setSmoothTime(smoothTimeMs, sampleRate_);
+        smoothReso_.setSmoothTime(smoothTimeMs, sampleRate_);
+        smoothFilterMix_.setSmoothTime(smoothTimeMs, sampleRate_);
+        smoothOutputLevel_.setSmoothTime(smoothTimeMs, sampleRate_);
+
+        // DC blocking coefficient for a 20Hz cutoff: exp(-2π * cutoffHz / sampleRate)
+        const float dcCutoffHz = 20.0f;
+        dcBlockCoeff_ = std::exp(-2.0f * M_PI * dcCutoffHz / sampleRate_);
+    }
+
+    float getSampleRate() const { return sampleRate_; }
+
+    // Clear the filter, crusher and DC blocker state
+    void reset() {
+        bitCrusher_.reset();
+        moogFilterL_.reset();
+        moogFilterR_.reset();
+        dcBlockerInL_ = dcBlockerInR_ = 0.0f;
+        dcBlockerOutL_ = dcBlockerOutR_ = 0.0f;
+    }
+
+    void setTargets(const Params& params) {
+        smoothBits_.setTarget(params.bits);
+        smoothRate_.setTarget(params.rate);
+        smoothCrushMix_.setTarget(params.crushMix);
+        smoothCutoff_.setTarget(params.cutoff);
+        smoothReso_.setTarget(params.resonance);
+        smoothFilterMix_.setTarget(params.filterMix);
+        smoothOutputLevel_.setTarget(params.outputLevel);
+    }
+
+    // Jump to the targets without smoothing
+    void setImmediate(const Params& params) {
+        smoothBits_.setImmediate(params.bits);
+        smoothRate_.setImmediate(params.rate);
+        smoothCrushMix_.setImmediate(params.crushMix);
+        smoothCutoff_.setImmediate(params.cutoff);
+        smoothReso_.setImmediate(params.resonance);
+        smoothFilterMix_.setImmediate(params.filterMix);
+        smoothOutputLevel_.setImmediate(params.outputLevel);
+    }
+
+    // Process frames in place (any count; split into blocks internally)
+    void process(float* left, float* right, int frames) {
+        while (frames > 0) {
+            int n = (frames < kMaxBlockFrames) ? frames : kMaxBlockFrames;
+            processBlock(left, right, n);
+            left += n;
+            right += n;
+            frames -= n;
+        }
+    }
+
+private:
+    void processBlock(float* left, float* right, int n) {
+        float crushMix[kMaxBlockFrames];
+        float filterMix[kMaxBlockFrames];
+        float outputLevel[kMaxBlockFrames];
+        float dryL[kMaxBlockFrames], dryR[kMaxBlockFrames];
+        float wetL[kMaxBlockFrames], wetR[kMaxBlockFrames];
+
+        // Smoothed controls: mixes and level per sample, coefficients per block
+        float bits = 0.0f, rate = 0.0f, cutoff = 0.0f, reso = 0.0f;
+        for (int i = 0; i < n; i++) {
+            bits = smoothBits_.process();
+            rate = smoothRate_.process();
+            cutoff = smoothCutoff_.process();
+            reso = smoothReso_.process();
+            crushMix[i] = smoothCrushMix_.process();
+            filterMix[i] = smoothFilterMix_.process();
+            outputLevel[i] = smoothOutputLevel_.process();
+        }
+        bitCrusher_.setParams(bits, rate);
+        moogFilterL_.setParams(cutoff, reso, sampleRate_);
+        moogFilterR_.setParams(cutoff, reso, sampleRate_);
+
+        // DC blocking on input (high-pass at ~20Hz), then the bit crusher
+        // with its dry/wet mix (use DC-blocked input for consistency)
+        for (int i = 0; i < n; i++) {
+            float inL = left[i];
+            float inR = right[i];
+            float blockedL = inL - dcBlockerInL_ + dcBlockCoeff_ * dcBlockerOutL_;
+            float blockedR = inR - dcBlockerInR_ + dcBlockCoeff_ * dcBlockerOutR_;
+            dcBlockerInL_ = inL;
+            dcBlockerInR_ = inR;
+            dcBlockerOutL_ = ShortwavDSP::flushDenormal(blockedL);
+            dcBlockerOutR_ = ShortwavDSP::flushDenormal(blockedR);
+            float crushedL, crushedR;
+            bitCrusher_.processStereo(blockedL, blockedR, crushedL, crushedR);
+            wetL[i] = blockedL * (1.0f - crushMix[i]) + crushedL * crushMix[i];
+            wetR[i] = blockedR * (1.0f - crushMix[i]) + crushedR * crushMix[i];
+        }
+
+        // Moog VCF on the crusher output
+        for (int i = 0; i < n; i++) {
+            dryL[i] = moogFilterL_.process(wetL[i]);
+            dryR[i] = moogFilterR_.process(wetR[i]);
+        }
+
+        // Non-finite input would otherwise stay in the recursive state (DC
+        // blocker, filter poles) until reset; drop this block and recover
+        if (!moogFilterL_.isFinite() || !moogFilterR_.isFinite() ||
+            !std::isfinite(dcBlockerOutL_) || !std::isfinite(dcBlockerOutR_)) {
+            reset();
+            std::fill(left, left + n, 0.0f);
+            std::fill(right, right + n, 0.0f);
+            return;
+        }
+
+        // Filter dry/wet, written back into the filter output
+        ShortwavDSP::Simd::crossfade(dryL, wetL, filterMix, n);
+        ShortwavDSP::Simd::crossfade(dryR, wetR, filterMix, n);
+
+        // Output gain, gentle tanh saturation and a hard limit against spikes
+        for (int i = 0; i < n; i++) {
+            float outL = std::tanh(dryL[i] * outputLevel[i] * 0.5f) * 2.0f;
+            float outR = std::tanh(dryR[i] * outputLevel[i] * 0.5f) * 2.0f;
+            left[i] = std::max(-1.5f, std::min(1.5f, outL));
+            right[i] = std::max(-1.5f, std::min(1.5f, outR));
+        }
+    }
+
+    BitCrusherDSP bitCrusher_;
+    MoogVCFDSP moogFilterL_;
+    MoogVCFDSP moogFilterR_;
+
+    SmoothParam smoothBits_;
+    SmoothParam smoothRate_;
+    SmoothParam smoothCrushMix_;
+    SmoothParam smoothCutoff_;
+    SmoothParam smoothReso_;
+    SmoothParam smoothFilterMix_;
+    SmoothParam smoothOutputLevel_;
+
+    float sampleRate_ = 48000.0f;
+
+    // DC blocking filters (to prevent pops from DC offset)
+    float dcBlockerInL_ = 0.0f;
+    float dcBlockerInR_ = 0.0f;
+    float dcBlockerOutL_ = 0.0f;
+    float dcBlockerOutR_ = 0.0f;
+    float dcBlockCoeff_ = 0.995f;
 };
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "tapestry-core.h"
 #include "tapestry-buffer.h"
+#include "tapestry-wsola.h"
+#include "tapestry-spectral.h"
+#include "tapestry-resample.h"
 #include <array>
 
 /*
@@ -14,7 +17,14 @@
  * - Up to 4 overlapping grain voices
  * - Hann windowing for smooth transitions
  * - Clock-synced granulation (Gene Shift / Time Stretch)
+ * - Time Stretch: splice spans a whole number of clocks, independent of pitch,
+ *   with grains scheduled by an integer countdown on clock subdivisions
+ * - Optional pitch-preserving WSOLA playback (Vari-Speed sets tempo only)
+ * - Optional phase-vocoder playback with up to 100x stretch, and spectral
+ *   freeze in the Vari-Speed dead zone
  * - Pitch randomization and stereo panning for high Morph values
+ * - Read quality tiers from drop-sample to band-limited sinc (cutoff follows
+ *   each voice's read increment); the voice loop is compiled per kernel
  */
 
 namespace ShortwavDSP
@@ -24,9 +34,12 @@ class GrainEngine
 {
 public:
   static constexpr int kMaxVoices = TapestryConfig::kMaxGrainVoices;
+  static constexpr int kMaxStretchSubdivisions = 64;  // Grains per clock (upper bound)
+  static constexpr float kMaxSpectralStretch = 100.0f;
 
   GrainEngine()
   {
+    Resample::prepare();
     reset();
   }
 
@@ -48,11 +61,23 @@ public:
     }
     currentVoice_ = 0;
     grainPhase_ = 0.0f;
-    lastClockTime_ = 0.0f;
+    lastClockTime_ = -1.0;
     clockPeriodSamples_ = 0.0f;
     isClockSynced_ = false;
     timeStretchMode_ = false;
     totalSamplesProcessed_ = 0;
+    rng_.seed(0);  // Same grain pitches and pans after every reset
+    resetTimeStretch();
+    wsola_.reset(0.0);
+    spectral_.reset(0.0);
+    spectralActive_ = playbackMode_ == PlaybackMode::Spectral;
+
+    // Defaults until the owner sets them again (a retrigger before the next
+    // process call would otherwise use the previous reel's values)
+    geneSizeSamples_ = 48000.0f;
+    slide_ = 0.0f;
+    morphState_ = MorphState();
+    variSpeedState_ = VariSpeedState();
   }
 
   //--------------------------------------------------------------------------
@@ -61,7 +86,8 @@ public:
 
   void setGeneSize(float geneSizeSamples) noexcept
   {
-    geneSizeSamples_ = std::max(TapestryConfig::kMinGeneSamples, geneSizeSamples);
+    const float minGene = TapestryConfig::kMinGeneSamples;
+    geneSizeSamples_ = std::max(minGene, geneSizeSamples);
   }
 
   void setMorphState(const MorphState &state) noexcept
@@ -79,16 +105,69 @@ public:
     variSpeedState_ = state;
   }
 
+  void setPlaybackMode(PlaybackMode mode) noexcept
+  {
+    if (mode == playbackMode_)
+      return;
+
+    // Continue from the current playhead in the new mode
+    double position = getPlayheadPositionRelative();
+    playbackMode_ = mode;
+    spectralActive_ = mode == PlaybackMode::Spectral;
+    if (mode == PlaybackMode::Wsola)
+    {
+      wsola_.reset(position);
+    }
+    else if (mode == PlaybackMode::Spectral)
+    {
+      spectral_.reset(position);
+    }
+    else
+    {
+      grainStartPosition_ = position;
+      for (auto &voice : voices_)
+      {
+        voice.reset();
+      }
+      triggerVoice(0, 0.0f);
+      currentVoice_ = 0;
+    }
+  }
+
+  PlaybackMode getPlaybackMode() const noexcept { return playbackMode_; }
+
+  void setInterpolationQuality(InterpolationQuality quality) noexcept
+  {
+    interpolationQuality_ = quality;
+  }
+
+  InterpolationQuality getInterpolationQuality() const noexcept { return interpolationQuality_; }
+
+  // Spectral mode: Vari-Speed tempo is divided by this factor (1-100)
+  void setSpectralStretch(float factor) noexcept
+  {
+    factor = (factor > kMaxSpectralStretch) ? kMaxSpectralStretch : factor;
+    spectralStretch_ = (factor < 1.0f) ? 1.0f : factor;
+  }
+
+  float getSpectralStretch() const noexcept { return spectralStretch_; }
+
+  // Other modes: hold the playhead as a spectral freeze in the Vari-Speed
+  // dead zone instead of going silent
+  void setFreezeOnStop(bool enabled) noexcept { freezeOnStop_ = enabled; }
+
+  bool getFreezeOnStop() const noexcept { return freezeOnStop_; }
+
   //--------------------------------------------------------------------------
   // Clock Sync
   //--------------------------------------------------------------------------
 
   void onClockRising() noexcept
   {
-    float currentTime = static_cast<float>(totalSamplesProcessed_);
-    if (lastClockTime_ > 0.0f)
+    double currentTime = static_cast<double>(totalSamplesProcessed_);
+    if (lastClockTime_ >= 0.0)
     {
-      clockPeriodSamples_ = currentTime - lastClockTime_;
+      clockPeriodSamples_ = static_cast<float>(currentTime - lastClockTime_);
     }
     lastClockTime_ = currentTime;
     isClockSynced_ = true;
@@ -96,6 +175,7 @@ public:
     // Determine mode based on Morph setting
     // Time Stretch: Morph > ~0.5 (2/1 overlap)
     // Gene Shift: Morph < ~0.5
+    bool wasTimeStretch = timeStretchMode_;
     timeStretchMode_ = morphState_.overlap > 2.0f;
 
     if (!timeStretchMode_)
@@ -103,17 +183,32 @@ public:
       // Gene Shift: advance to next gene immediately on clock
       triggerNextGene();
     }
+    else
+    {
+      // Time Stretch: resync in process(), where the splice bounds are known
+      if (!wasTimeStretch)
+        resetTimeStretch();
+      stretchClockPending_ = true;
+    }
   }
 
   void setClockDisconnected() noexcept
   {
     isClockSynced_ = false;
     timeStretchMode_ = false;
+    resetTimeStretch();
   }
 
   bool isTimeStretchMode() const noexcept { return timeStretchMode_; }
+
+  // Time-stretch layout (valid once a clock period has been measured)
+  int getStretchClocksPerSplice() const noexcept { return stretchClocksPerSplice_; }
+  double getStretchGrainHop() const noexcept { return stretchHop_; }
   bool isClockSynced() const noexcept { return isClockSynced_; }
 
+  // Samples between the last two clock edges (0 until two edges were seen)
+  float getClockPeriodSamples() const noexcept { return clockPeriodSamples_; }
+
   //--------------------------------------------------------------------------
   // Main Processing
   //--------------------------------------------------------------------------
@@ -146,81 +241,51 @@ public:
     
     if (variSpeedState_.isStopped)
     {
-      // When stopped, update position based on slide but output silence
+      // When stopped, update position based on slide but output silence,
+      // or freeze the spectrum at the playhead
+      if (playbackMode_ != PlaybackMode::Spectral && !freezeOnStop_)
+        return false;
+      if (!spectralActive_)
+      {
+        spectral_.reset(getPlayheadPositionRelative());
+        spectralActive_ = true;
+      }
+      spectral_.process(buffer, spliceStart, spliceLength, slideOffset,
+                        0.0f, sampleRateRatio_, outL, outR);
+      totalSamplesProcessed_++;
       return false;
     }
 
-    // Process each active voice
-    int numVoices = morphState_.activeVoices;
-    float voiceGain = 1.0f / std::sqrt(static_cast<float>(numVoices)); // Normalize
-
-    for (int v = 0; v < numVoices && v < kMaxVoices; v++)
+    if (playbackMode_ == PlaybackMode::Spectral)
     {
-      GrainVoice &voice = voices_[v];
-
-      if (!voice.active)
-        continue;
-
-      // Calculate window amplitude
-      float window = TapestryUtil::hannWindow(voice.phase);
-      voice.amplitude = window;
-
-      // Read from buffer at voice position
-      float sampleL, sampleR;
-      double readPos = static_cast<double>(spliceStart) + slideOffset + voice.position;
-
-      // Wrap within splice bounds
-      double relPos = readPos - static_cast<double>(spliceStart);
-      while (relPos < 0.0)
-        relPos += static_cast<double>(spliceLength);
-      while (relPos >= static_cast<double>(spliceLength))
-        relPos -= static_cast<double>(spliceLength);
-      readPos = static_cast<double>(spliceStart) + relPos;
-
-      buffer.readStereoInterpolatedBounded(readPos, spliceStart, spliceEnd, sampleL, sampleR);
-
-      // Apply pitch modulation (for high Morph)
-      float pitchMod = voice.pitchMod;
-
-      // Apply window and gain
-      sampleL *= window * voiceGain;
-      sampleR *= window * voiceGain;
-
-      // Apply panning (for high Morph)
-      if (morphState_.enablePanning && numVoices > 2)
-      {
-        float pan = voice.pan;
-        float panL = std::cos((pan + 1.0f) * 0.25f * 3.14159265359f);
-        float panR = std::sin((pan + 1.0f) * 0.25f * 3.14159265359f);
-        float mono = (sampleL + sampleR) * 0.5f;
-        sampleL = mono * panL;
-        sampleR = mono * panR;
-      }
-
-      outL += sampleL;
-      outR += sampleR;
-
-      // Advance voice position (speed can be negative for reverse playback)
-      voice.position += speed * pitchMod;
-      voice.phase += std::fabs(speed) / geneSamples;
-
-      // Wrap voice.position to prevent unbounded growth
-      // This keeps it synchronized with the actual read position
-      while (voice.position < 0.0)
-        voice.position += static_cast<double>(spliceLength);
-      while (voice.position >= static_cast<double>(spliceLength))
-        voice.position -= static_cast<double>(spliceLength);
+      // Frames read at unity pitch; analysis advances at speed / stretch
+      endOfGene = spectral_.process(buffer, spliceStart, spliceLength, slideOffset,
+                                    speed / spectralStretch_, sampleRateRatio_, outL, outR);
+      totalSamplesProcessed_++;
+      return endOfGene;
+    }
+    spectralActive_ = false;
 
-      // Check if voice reached end of gene
-      if (voice.phase >= 1.0f)
-      {
-        voice.active = false;
-        endOfGene = true;
-      }
+    if (playbackMode_ == PlaybackMode::Wsola)
+    {
+      // Frames read at unity pitch; Vari-Speed only moves the frame positions
+      endOfGene = wsola_.process(buffer, spliceStart, spliceLength, slideOffset,
+                                 speed, sampleRateRatio_, outL, outR);
+      totalSamplesProcessed_++;
+      return endOfGene;
     }
 
-    // Trigger new grains based on Morph overlap
-    updateGrainTriggers(geneSamples, speed);
+    // Process each active voice with the selected read kernel
+    VoicePass pass = {*this, buffer, spliceStart, spliceLength, slideOffset, speed, geneSamples,
+                      outL, outR, endOfGene};
+    Resample::dispatch(interpolationQuality_, pass);
+
+    // Trigger new grains: clock-locked schedule in Time Stretch, Morph
+    // overlap otherwise
+    if (timeStretchMode_ && clockPeriodSamples_ > 0.0f)
+      updateTimeStretch(spliceLength, geneSamples, speed);
+    else
+      updateGrainTriggers(geneSamples, speed);
 
     totalSamplesProcessed_++;
     return endOfGene;
@@ -233,6 +298,11 @@ public:
   // Get current playhead position (relative to splice, for internal use)
   double getPlayheadPositionRelative() const noexcept
   {
+    if (playbackMode_ == PlaybackMode::Wsola)
+      return wsola_.getPosition();
+    if (playbackMode_ == PlaybackMode::Spectral)
+      return spectral_.getPosition();
+
     // Return position of most recent voice
     for (int i = 0; i < kMaxVoices; i++)
     {
@@ -261,6 +331,8 @@ public:
     {
       voice.position = 0.0;
     }
+    wsola_.reset(0.0);
+    spectral_.reset(0.0);
   }
 
   // Update the last known absolute position (call from process when we know splice bounds)
@@ -291,6 +363,10 @@ public:
     currentVoice_ = 0;
     grainPhase_ = 0.0f;
     grainStartPosition_ = 0.0;
+    stretchScanPos_ = 0.0;
+    stretchClockIndex_ = -1;
+    wsola_.reset(0.0);
+    spectral_.reset(0.0);
 
     // Start first voice
     triggerVoice(0, slideOffset);
@@ -308,6 +384,109 @@ public:
   }
 
 private:
+  //--------------------------------------------------------------------------
+  // Voice Processing
+  //--------------------------------------------------------------------------
+
+  // Binds process() arguments for Resample::dispatch
+  struct VoicePass
+  {
+    GrainEngine &engine;
+    const TapestryBuffer &buffer;
+    size_t spliceStart;
+    size_t spliceLength;
+    float slideOffset;
+    float speed;
+    float geneSamples;
+    float &outL;
+    float &outR;
+    bool &endOfGene;
+
+    template <class Kernel>
+    void run() noexcept
+    {
+      engine.processVoices<Kernel>(buffer, spliceStart, spliceLength, slideOffset, speed,
+                                   geneSamples, outL, outR, endOfGene);
+    }
+  };
+
+  // Mix all active voices for one sample, reading with Kernel
+  template <class Kernel>
+  void processVoices(const TapestryBuffer &buffer, size_t spliceStart, size_t spliceLength,
+                     float slideOffset, float speed, float geneSamples,
+                     float &outL, float &outR, bool &endOfGene) noexcept
+  {
+    size_t spliceEnd = spliceStart + spliceLength;
+    int numVoices = morphState_.activeVoices;
+    float voiceGain = 1.0f / std::sqrt(static_cast<float>(numVoices)); // Normalize
+
+    for (int v = 0; v < numVoices && v < kMaxVoices; v++)
+    {
+      GrainVoice &voice = voices_[v];
+
+      if (!voice.active)
+        continue;
+
+      // Calculate window amplitude
+      float window = TapestryUtil::hannWindow(voice.phase);
+      voice.amplitude = window;
+
+      // Read from buffer at voice position
+      float sampleL, sampleR;
+      double readPos = static_cast<double>(spliceStart) + slideOffset + voice.position;
+
+      // Wrap within splice bounds
+      double relPos = readPos - static_cast<double>(spliceStart);
+      while (relPos < 0.0)
+        relPos += static_cast<double>(spliceLength);
+      while (relPos >= static_cast<double>(spliceLength))
+        relPos -= static_cast<double>(spliceLength);
+      readPos = static_cast<double>(spliceStart) + relPos;
+
+      // Apply pitch modulation (for high Morph)
+      float pitchMod = voice.pitchMod;
+
+      Resample::readStereo<Kernel>(buffer, readPos, spliceStart, spliceEnd,
+                                   std::fabs(speed * pitchMod), sampleL, sampleR);
+
+      // Apply window and gain
+      sampleL *= window * voiceGain;
+      sampleR *= window * voiceGain;
+
+      // Apply panning (for high Morph)
+      if (morphState_.enablePanning && numVoices > 2)
+      {
+        float pan = voice.pan;
+        float panL = std::cos((pan + 1.0f) * 0.25f * 3.14159265359f);
+        float panR = std::sin((pan + 1.0f) * 0.25f * 3.14159265359f);
+        float mono = (sampleL + sampleR) * 0.5f;
+        sampleL = mono * panL;
+        sampleR = mono * panR;
+      }
+
+      outL += sampleL;
+      outR += sampleR;
+
+      // Advance voice position (speed can be negative for reverse playback)
+      voice.position += speed * pitchMod;
+      voice.phase += std::fabs(speed) / geneSamples;
+
+      // Wrap voice.position to prevent unbounded growth
+      // This keeps it synchronized with the actual read position
+      while (voice.position < 0.0)
+        voice.position += static_cast<double>(spliceLength);
+      while (voice.position >= static_cast<double>(spliceLength))
+        voice.position -= static_cast<double>(spliceLength);
+
+      // Check if voice reached end of gene
+      if (voice.phase >= 1.0f)
+      {
+        voice.active = false;
+        endOfGene = true;
+      }
+    }
+  }
+
   //--------------------------------------------------------------------------
   // Internal Methods
   //--------------------------------------------------------------------------
@@ -409,6 +588,112 @@ private:
     }
   }
 
+  //--------------------------------------------------------------------------
+  // Time Stretch
+  //--------------------------------------------------------------------------
+
+  void resetTimeStretch() noexcept
+  {
+    stretchScanPos_ = 0.0;
+    stretchScanRate_ = 0.0;
+    stretchHop_ = 0.0;
+    stretchCarry_ = 0.0;
+    stretchCountdown_ = 1;
+    stretchClocksPerSplice_ = 1;
+    stretchClockIndex_ = -1;
+    stretchSpliceLength_ = 0;
+    stretchClockPending_ = false;
+  }
+
+  // Fit the splice to a whole number of clocks and split each clock into
+  // grain hops close to the Morph overlap
+  void configureTimeStretch(size_t spliceLength, float geneSamples, float speed) noexcept
+  {
+    double clock = static_cast<double>(clockPeriodSamples_);
+    double length = static_cast<double>(spliceLength);
+
+    // Clocks per splice from the splice's natural (unity speed) duration
+    double natural = length / static_cast<double>(sampleRateRatio_);
+    int clocks = static_cast<int>(natural / clock + 0.5);
+    stretchClocksPerSplice_ = std::max(1, clocks);
+    stretchScanRate_ = length / (static_cast<double>(stretchClocksPerSplice_) * clock);
+
+    // Grain hop: an integer subdivision of the clock
+    double grainDuration = geneSamples / std::max(std::fabs(speed), 1e-3f);
+    double targetHop = grainDuration / std::max(morphState_.overlap, 1.0f);
+    int subdivisions = static_cast<int>(clock / targetHop + 0.5);
+    subdivisions = std::max(1, std::min(subdivisions, static_cast<int>(kMaxStretchSubdivisions)));
+    stretchHop_ = clock / static_cast<double>(subdivisions);
+
+    stretchSpliceLength_ = spliceLength;
+  }
+
+  void updateTimeStretch(size_t spliceLength, float geneSamples, float speed) noexcept
+  {
+    double length = static_cast<double>(spliceLength);
+    bool clockEdge = stretchClockPending_;
+
+    if (clockEdge || spliceLength != stretchSpliceLength_)
+    {
+      stretchClockPending_ = false;
+      configureTimeStretch(spliceLength, geneSamples, speed);
+    }
+
+    if (clockEdge)
+    {
+      // Hard sync: each clock lands on a fixed point of the splice
+      stretchClockIndex_ = (stretchClockIndex_ + 1) % stretchClocksPerSplice_;
+      double pos = length * stretchClockIndex_ / stretchClocksPerSplice_;
+      stretchScanPos_ = (speed >= 0.0f || pos == 0.0) ? pos : length - pos;
+      stretchCarry_ = 0.0;
+      triggerStretchGrain();
+      return;
+    }
+
+    // Scan through the splice at the clock-derived rate (direction follows
+    // Vari-Speed, pitch doesn't affect it)
+    stretchScanPos_ += (speed >= 0.0f) ? stretchScanRate_ : -stretchScanRate_;
+    if (stretchScanPos_ >= length)
+      stretchScanPos_ -= length;
+    else if (stretchScanPos_ < 0.0)
+      stretchScanPos_ += length;
+
+    if (--stretchCountdown_ == 0)
+      triggerStretchGrain();
+  }
+
+  void triggerStretchGrain() noexcept
+  {
+    // Free voice within the active count, otherwise the most advanced one
+    int numVoices = std::max(1, std::min(morphState_.activeVoices, static_cast<int>(kMaxVoices)));
+    int idx = 0;
+    float oldestPhase = -1.0f;
+    for (int v = 0; v < numVoices; v++)
+    {
+      if (!voices_[v].active)
+      {
+        idx = v;
+        break;
+      }
+      if (voices_[v].phase > oldestPhase)
+      {
+        oldestPhase = voices_[v].phase;
+        idx = v;
+      }
+    }
+
+    grainStartPosition_ = stretchScanPos_;
+    triggerVoice(idx, 0.0f);
+    currentVoice_ = idx;
+
+    // Whole-sample countdown; the fractional remainder carries over so the
+    // grains stay locked to the clock
+    double exact = stretchHop_ + stretchCarry_;
+    double whole = std::max(1.0, std::floor(exact + 0.5));
+    stretchCarry_ = exact - whole;
+    stretchCountdown_ = static_cast<uint32_t>(whole);
+  }
+
   //--------------------------------------------------------------------------
   // State
   //--------------------------------------------------------------------------
@@ -429,13 +714,33 @@ private:
   double lastAbsolutePosition_ = 0.0;  // Absolute buffer position for splice creation
 
   // Clock sync state
-  float lastClockTime_ = 0.0f;
+  double lastClockTime_ = -1.0;  // -1 = no clock yet; double keeps whole samples on long runs
   float clockPeriodSamples_ = 0.0f;
   bool isClockSynced_ = false;
   bool timeStretchMode_ = false;
 
   size_t totalSamplesProcessed_ = 0;
 
+  // Pitch-preserving playback
+  PlaybackMode playbackMode_ = PlaybackMode::Granular;
+  WsolaStream wsola_;
+  SpectralStream spectral_;
+  InterpolationQuality interpolationQuality_ = InterpolationQuality::Hermite;
+  float spectralStretch_ = 1.0f;
+  bool freezeOnStop_ = false;
+  bool spectralActive_ = false;  // Spectral stream holds the current playhead
+
+  // Time stretch state
+  double stretchScanPos_ = 0.0;    // Grain start within the splice (frames)
+  double stretchScanRate_ = 0.0;   // Frames per sample (splice spans whole clocks)
+  double stretchHop_ = 0.0;        // Samples between grains (clock / subdivisions)
+  double stretchCarry_ = 0.0;      // Fractional part of the grain schedule
+  uint32_t stretchCountdown_ = 1;  // Whole samples until the next grain
+  int stretchClocksPerSplice_ = 1;
+  int stretchClockIndex_ = -1;     // Clock within the splice (-1 = before first)
+  size_t stretchSpliceLength_ = 0;
+  bool stretchClockPending_ = false;
+
   TapestryUtil::FastRandom rng_;
 };
 
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Tapestry Lookup Tables
+ *
+ * Cheap replacements for the std::pow calls in per-sample parameter
+ * mappings (Vari-Speed ratio, gene size curve, filter cutoff).
+ *
+ * Features:
+ * - exp2 table generated at compile time (constexpr series, no static
+ *   initialization), 512 segments per octave with linear interpolation
+ * - Documented error bound: relative error below 5e-7 over the full float
+ *   exponent range (interpolation error (ln2/512)^2/8 = 2.3e-7 plus
+ *   float rounding of the table entries and the blend)
+ * - Octave scaling through the float exponent bits, so the table only
+ *   covers [0, 1]
+ * - Integer power curves as unrolled multiplies (exact to a few ulp,
+ *   faster than any table)
+ * - Header-only and allocation-free; safe on the audio thread
+ */
+
+namespace ShortwavDSP
+{
+
+namespace Lut
+{
+
+//------------------------------------------------------------------------------
+// Compile-Time Table Generation
+//------------------------------------------------------------------------------
+
+namespace detail
+{
+
+// e^y by its Taylor series (single-return constexpr for C++11)
+constexpr double expSeries(double y, int n, double term, double sum)
+{
+  return (n > 30) ? sum : expSeries(y, n + 1, term * y / n, sum + term * y / n);
+}
+
+constexpr double exp2Const(double x)
+{
+  return expSeries(x * 0.69314718055994530942, 1, 1.0, 1.0);
+}
+
+template <int... I>
+struct IndexList
+{
+};
+
+template <int N, int... I>
+struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...>
+{
+};
+
+template <int... I>
+struct MakeIndexList<0, I...>
+{
+  typedef IndexList<I...> type;
+};
+
+template <class Indices>
+struct Exp2Table;
+
+// 2^(i / (size - 1)) for i in [0, size)
+template <int... I>
+struct Exp2Table<IndexList<I...>>
+{
+  static constexpr int kSize = sizeof...(I);
+  static constexpr float kValues[kSize] = {
+      static_cast<float>(exp2Const(static_cast<double>(I) / (kSize - 1)))...};
+};
+
+template <int... I>
+constexpr float Exp2Table<IndexList<I...>>::kValues[Exp2Table<IndexList<I...>>::kSize];
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// exp2
+//------------------------------------------------------------------------------
+
+constexpr int kExp2Segments = 512;  // Per octave
+
+typedef detail::Exp2Table<detail::MakeIndexList<kExp2Segments + 1>::type> Exp2Table;
+
+// 2^x, relative error < 5e-7. x is clamped to [-126, 127.99] (normal floats).
+inline float exp2(float x) noexcept
+{
+  x = (x < -126.0f) ? -126.0f : x;
+  x = (x > 127.99f) ? 127.99f : x;
+
+  // One float-to-int conversion gives both the octave and the table index
+  // (kExp2Segments is a power of two)
+  float scaled = x * kExp2Segments;
+  int fixed = static_cast<int>(scaled);
+  fixed -= (static_cast<float>(fixed) > scaled) ? 1 : 0;  // Floor for negative x
+  float t = scaled - static_cast<float>(fixed);
+  int octave = (fixed - (fixed & (kExp2Segments - 1))) / kExp2Segments;
+  int index = fixed & (kExp2Segments - 1);
+
+  const float *table = Exp2Table::kValues;
+  float mantissa = table[index] + t * (table[index + 1] - table[index]);
+
+  // 2^octave straight from the exponent bits
+  uint32_t bits = static_cast<uint32_t>(octave + 127) << 23;
+  float scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return mantissa * scale;
+}
+
+// Frequency ratio for a pitch offset in semitones
+inline float semitonesToRatio(float semitones) noexcept
+{
+  return exp2(semitones * (1.0f / 12.0f));
+}
+
+//------------------------------------------------------------------------------
+// Power Curves
+//------------------------------------------------------------------------------
+
+// x^N for a compile-time integer N >= 0 (the loop unrolls to N - 1 multiplies)
+template <int N>
+inline float powInt(float x) noexcept
+{
+  float result = 1.0f;
+  for (int i = 0; i < N; i++)
+  {
+    result *= x;
+  }
+  return result;
+}
+
+} // namespace Lut
+
+} // namespace ShortwavDSP
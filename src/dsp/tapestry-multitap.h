@@ -0,0 +1,193 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include "tapestry-splice.h"
+#include "tapestry-resample.h"
+#include <cmath>
+
+/*
+ * Tapestry Multi-Tap Read Heads
+ *
+ * Up to 8 extra read heads looping over the shared reel alongside the main
+ * playhead, each with its own splice, Slide, speed ratio and gain.
+ *
+ * Features:
+ * - Each head loops its splice with a short crossfade at the loop point
+ *   instead of running a full grain engine
+ * - All heads read through one interpolation kernel, selected once per
+ *   sample for every head, using the module's interpolation quality
+ * - Head state is kept in flat arrays and walked in one pass
+ * - Heads either follow the current splice or stay on a fixed one
+ * - Fixed-size state, no allocation
+ */
+
+namespace ShortwavDSP
+{
+
+struct ReadHeadSettings
+{
+  int splice = -1;     // Splice index, -1 = follow the current splice
+  float slide = 0.0f;  // Start offset within the splice (0-1)
+  float speed = 1.0f;  // Ratio to the Vari-Speed rate (negative = reverse)
+  float gain = 1.0f;
+};
+
+class MultiTapHeads
+{
+public:
+  static constexpr int kMaxHeads = 8;
+  static constexpr size_t kLoopFadeFrames = 240;  // 5ms @ 48kHz
+
+  MultiTapHeads()
+  {
+    for (int k = 0; k < kMaxHeads; k++)
+    {
+      settings_[k].slide = static_cast<float>(k) / kMaxHeads;
+    }
+    reset();
+  }
+
+  void reset() noexcept
+  {
+    for (int k = 0; k < kMaxHeads; k++)
+    {
+      phase_[k] = 0.0;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // Configuration
+  //--------------------------------------------------------------------------
+
+  // 0 disables the heads; otherwise 2-8 heads play
+  void setHeadCount(int count) noexcept
+  {
+    count = (count < 2) ? 0 : (count > kMaxHeads ? kMaxHeads : count);
+    // Newly enabled heads start from their Slide position
+    for (int k = 0; k < kMaxHeads; k++)
+    {
+      if (k >= headCount_ && k < count)
+        phase_[k] = 0.0;
+    }
+    headCount_ = count;
+  }
+
+  int getHeadCount() const noexcept { return headCount_; }
+
+  void setHead(int k, const ReadHeadSettings &settings) noexcept
+  {
+    if (k < 0 || k >= kMaxHeads)
+      return;
+    settings_[k] = settings;
+    settings_[k].slide = TapestryUtil::clamp01(settings.slide);
+  }
+
+  const ReadHeadSettings &getHead(int k) const noexcept
+  {
+    return settings_[(k < 0) ? 0 : (k >= kMaxHeads ? kMaxHeads - 1 : k)];
+  }
+
+  // Read offset of head k relative to its Slide position, in frames
+  double getPhase(int k) const noexcept { return phase_[k]; }
+
+  //--------------------------------------------------------------------------
+  // Processing
+  //--------------------------------------------------------------------------
+
+  // Render one sample for every head into outL/outR (kMaxHeads each, after
+  // gain). speed: signed buffer frames per sample for a speed ratio of 1.
+  void process(const TapestryBuffer &buffer, const SpliceManager &splices,
+               size_t currentStart, size_t currentEnd, float speed,
+               InterpolationQuality quality, float *outL, float *outR) noexcept
+  {
+    HeadPass pass = {*this, buffer, splices, currentStart, currentEnd, speed, outL, outR};
+    Resample::dispatch(quality, pass);
+  }
+
+private:
+  struct HeadPass
+  {
+    MultiTapHeads &heads;
+    const TapestryBuffer &buffer;
+    const SpliceManager &splices;
+    size_t currentStart;
+    size_t currentEnd;
+    float speed;
+    float *outL;
+    float *outR;
+
+    template <class Kernel>
+    void run() noexcept
+    {
+      heads.processHeads<Kernel>(buffer, splices, currentStart, currentEnd, speed, outL, outR);
+    }
+  };
+
+  template <class Kernel>
+  void processHeads(const TapestryBuffer &buffer, const SpliceManager &splices,
+                    size_t currentStart, size_t currentEnd, float speed,
+                    float *outL, float *outR) noexcept
+  {
+    size_t used = buffer.getUsedFrames();
+    for (int k = 0; k < headCount_; k++)
+    {
+      const ReadHeadSettings &head = settings_[k];
+      outL[k] = outR[k] = 0.0f;
+
+      size_t start = currentStart;
+      size_t end = currentEnd;
+      const SpliceMarker *marker = (head.splice >= 0) ? splices.getSplice(head.splice) : nullptr;
+      if (marker)
+      {
+        start = marker->startFrame;
+        end = marker->endFrame;
+      }
+      end = (end < used) ? end : used;
+      if (end <= start + 1)
+        continue;
+
+      // Loop over length - fade; the first fade frames blend in the tail
+      size_t length = end - start;
+      size_t fade = (kLoopFadeFrames < length / 4) ? kLoopFadeFrames : length / 4;
+      double loop = static_cast<double>(length - fade);
+
+      double pos = phase_[k] + static_cast<double>(head.slide) * loop;
+      if (pos >= loop)
+        pos = std::fmod(pos, loop);  // Also covers a switch to a shorter splice
+
+      float increment = speed * head.speed;
+      float absIncrement = std::fabs(increment);
+      float l, r;
+      Resample::readStereo<Kernel>(buffer, static_cast<double>(start) + pos, start, end,
+                                   absIncrement, l, r);
+      if (pos < static_cast<double>(fade))
+      {
+        float tailL, tailR;
+        Resample::readStereo<Kernel>(buffer, static_cast<double>(start) + pos + loop, start, end,
+                                     absIncrement, tailL, tailR);
+        float w = static_cast<float>(pos) / static_cast<float>(fade);
+        l = tailL + w * (l - tailL);
+        r = tailR + w * (r - tailR);
+      }
+      outL[k] = l * head.gain;
+      outR[k] = r * head.gain;
+
+      // Advance, keeping the phase within the current loop
+      double phase = phase_[k] + static_cast<double>(increment);
+      if (phase >= loop || phase < 0.0)
+      {
+        phase = std::fmod(phase, loop);
+        if (phase < 0.0)
+          phase += loop;
+      }
+      phase_[k] = phase;
+    }
+  }
+
+  ReadHeadSettings settings_[kMaxHeads];
+  double phase_[kMaxHeads];
+  int headCount_ = 0;
+};
+
+} // namespace ShortwavDSP
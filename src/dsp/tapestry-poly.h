@@ -0,0 +1,389 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include "tapestry-simd.h"
+#include <cmath>
+#include <cstdint>
+
+/*
+ * Tapestry Polyphonic Playheads
+ *
+ * Up to 16 independent playheads on the shared reel, one per polyphony
+ * channel, each with its own gate, pitch (V/Oct) and Slide.
+ *
+ * Features:
+ * - Structure-of-arrays state, processed 4 channels at a time with Vec4
+ * - Two grains per channel half a gene apart; the smoothstep-triangle
+ *   window sums to exactly one, so playback is seamless at any gene size
+ * - Reads share the reel memory and the splice; only the 4-frame gather is
+ *   per channel, interpolation and mixing run on 4 lanes at once
+ * - A rising gate restarts its channel; while the gate is low the channel
+ *   finishes its current grains and then falls silent
+ * - End of gene per channel: each channel keeps its splice until its own
+ *   gene ends, so a splice change reaches every voice on its own boundary
+ * - Fixed-size state, no allocation
+ *
+ * Each channel is a plain two-grain playhead, not a GrainEngine. In poly
+ * mode the following are not applied (the mono playhead keeps them):
+ * - Morph overlap tiers, per-grain pitch shift and stereo spread
+ * - Gene Shift and clock-synced Time Stretch (Gene Size is still used)
+ * - Pitch-Preserving (WSOLA) and Spectral playback modes, Freeze When Stopped
+ * - Interpolation Quality (reads are always 4-point Hermite)
+ * - Multi-tap Read Heads
+ */
+
+namespace ShortwavDSP
+{
+
+class PolyPlayheads
+{
+public:
+  static constexpr int kMaxChannels = 16;
+  static constexpr int kLanes = 4;
+  static constexpr int kGroups = kMaxChannels / kLanes;
+  static constexpr int kGrains = 2;
+
+  PolyPlayheads()
+  {
+    reset();
+  }
+
+  void reset() noexcept
+  {
+    for (int ch = 0; ch < kMaxChannels; ch++)
+    {
+      pitchVolts_[ch] = 0.0f;
+      pitch_[ch] = 1.0f;
+      slide_[ch] = 0.0f;
+      gate_[ch] = false;
+      stop(ch);
+    }
+    channels_ = 1;
+  }
+
+  //--------------------------------------------------------------------------
+  // Per-Channel Control
+  //--------------------------------------------------------------------------
+
+  void setChannels(int channels) noexcept
+  {
+    channels_ = (channels < 1) ? 1 : (channels > kMaxChannels ? kMaxChannels : channels);
+  }
+
+  int getChannels() const noexcept { return channels_; }
+
+  // A rising gate restarts the channel at its Slide position
+  void setGate(int ch, bool high) noexcept
+  {
+    if (high && !gate_[ch])
+      retrigger(ch);
+    gate_[ch] = high;
+  }
+
+  // Pitch in volts (1V/oct, multiplies the Vari-Speed rate)
+  void setPitch(int ch, float volts) noexcept
+  {
+    if (volts != pitchVolts_[ch])
+    {
+      pitchVolts_[ch] = volts;
+      pitch_[ch] = Lut::exp2(volts);
+    }
+  }
+
+  void setSlide(int ch, float slide) noexcept
+  {
+    slide_[ch] = TapestryUtil::clamp01(slide);
+  }
+
+  float getSlide(int ch) const noexcept { return slide_[ch]; }
+
+  bool isPlaying(int ch) const noexcept
+  {
+    return active_[0][ch] > 0.0f || active_[1][ch] > 0.0f;
+  }
+
+  // Newest grain's read position relative to the splice (before Slide)
+  double getPosition(int ch) const noexcept
+  {
+    int g = (phase_[0][ch] < phase_[1][ch]) ? 0 : 1;
+    return static_cast<double>(index_[g][ch]) + frac_[g][ch];
+  }
+
+  // Start frame of the splice the channel's current gene plays
+  size_t getSpliceStart(int ch) const noexcept { return spliceStart_[ch]; }
+
+  // Restarts the channel on the splice passed to the next process() call
+  void retrigger(int ch) noexcept
+  {
+    for (int g = 0; g < kGrains; g++)
+    {
+      index_[g][ch] = 0;
+      frac_[g][ch] = 0.0f;
+    }
+    // Second grain joins half a gene later, so the first one fades in alone
+    phase_[0][ch] = 0.0f;
+    phase_[1][ch] = 0.5f;
+    active_[0][ch] = 1.0f;
+    active_[1][ch] = 0.0f;
+    needsSplice_[ch] = true;
+  }
+
+  // Call for each channel whose gene just ended (see process()): a changed
+  // splice starts the new gene at its beginning, while the grain still
+  // fading out finishes on the old one
+  void beginGene(int ch, size_t spliceStart, size_t spliceEnd) noexcept
+  {
+    size_t length = (spliceEnd > spliceStart) ? spliceEnd - spliceStart : 0;
+    if (spliceStart == spliceStart_[ch] && length == spliceLength_[ch])
+      return;
+    spliceStart_[ch] = grainStart_[0][ch] = spliceStart;
+    spliceLength_[ch] = grainLength_[0][ch] = length;
+    index_[0][ch] = 0;
+    frac_[0][ch] = 0.0f;
+  }
+
+  //--------------------------------------------------------------------------
+  // Processing
+  //--------------------------------------------------------------------------
+
+  // Render one sample for every channel (outL/outR hold kMaxChannels).
+  // spliceStart/End: the current splice, taken up by retriggered channels.
+  // speed: signed buffer frames per sample at 0V (Vari-Speed x rate ratio)
+  // Returns a bit per channel whose gene ended on this sample.
+  uint32_t process(const TapestryBuffer &buffer, size_t spliceStart, size_t spliceEnd,
+                   float geneSamples, float speed, float *outL, float *outR) noexcept
+  {
+    for (int ch = 0; ch < channels_; ch++)
+    {
+      outL[ch] = outR[ch] = 0.0f;
+      if (needsSplice_[ch])
+      {
+        needsSplice_[ch] = false;
+        size_t length = (spliceEnd > spliceStart) ? spliceEnd - spliceStart : 0;
+        spliceStart_[ch] = spliceStart;
+        spliceLength_[ch] = length;
+        for (int g = 0; g < kGrains; g++)
+        {
+          grainStart_[g][ch] = spliceStart;
+          grainLength_[g][ch] = length;
+        }
+      }
+    }
+    const size_t used = buffer.getUsedFrames();
+
+    typedef Simd::Vec4 Vec4;
+    const Vec4 kOne = Vec4::set(1.0f);
+    const Vec4 kTwo = Vec4::set(2.0f);
+    const Vec4 kThree = Vec4::set(3.0f);
+    const Vec4 kHalf = Vec4::set(0.5f);
+    const Vec4 kOneHalf = Vec4::set(1.5f);
+    const Vec4 kTwoHalf = Vec4::set(2.5f);
+    const Vec4 speedV = Vec4::set(speed);
+
+    uint32_t geneEnded = 0;
+    int groups = (channels_ + kLanes - 1) / kLanes;
+    for (int group = 0; group < groups; group++)
+    {
+      const int base = group * kLanes;
+      Vec4 inc = speedV * Vec4::load(pitch_ + base);
+      Vec4 absInc = Vec4::abs(inc);
+      Vec4 sumL = Vec4::set(0.0f);
+      Vec4 sumR = Vec4::set(0.0f);
+
+      for (int g = 0; g < kGrains; g++)
+      {
+        // Gather 4 frames around each lane's read position in its grain's
+        // splice (clamped to the recorded part of the reel)
+        alignas(16) float y[4][2][kLanes];  // [tap][channel][lane]
+        alignas(16) float t[kLanes];
+        alignas(16) float invGene[kLanes];
+        alignas(16) float audible[kLanes];
+        size_t lengths[kLanes];
+        for (int lane = 0; lane < kLanes; lane++)
+        {
+          int ch = base + lane;
+          size_t start = grainStart_[g][ch];
+          size_t length = grainLength_[g][ch];
+          if (start + length > used)
+            length = (start < used) ? used - start : 0;
+          lengths[lane] = length;
+          if (length == 0)
+          {
+            for (int k = 0; k < 4; k++)
+            {
+              y[k][0][lane] = y[k][1][lane] = 0.0f;
+            }
+            t[lane] = 0.0f;
+            invGene[lane] = 0.0f;
+            audible[lane] = 0.0f;
+            continue;
+          }
+
+          float gene = (geneSamples < static_cast<float>(length)) ? geneSamples : static_cast<float>(length);
+          gene = (gene < 1.0f) ? 1.0f : gene;
+          invGene[lane] = 1.0f / gene;
+          audible[lane] = active_[g][ch];
+
+          double pos = static_cast<double>(index_[g][ch] % length) + frac_[g][ch] +
+                       static_cast<double>(slide_[ch] * (static_cast<float>(length) - gene));
+          if (pos >= static_cast<double>(length))
+            pos -= static_cast<double>(length);
+          size_t i = static_cast<size_t>(pos);
+          if (i >= length)
+            i = length - 1;
+          t[lane] = static_cast<float>(pos - static_cast<double>(i));
+          gather(buffer.data(), start, length, i, y, lane);
+        }
+
+        // Hermite interpolation on 4 lanes (TapestryUtil::cubicInterpolate)
+        Vec4 tv = Vec4::load(t);
+        Vec4 frame[2];
+        for (int c = 0; c < 2; c++)
+        {
+          Vec4 y0 = Vec4::load(y[0][c]);
+          Vec4 y1 = Vec4::load(y[1][c]);
+          Vec4 y2 = Vec4::load(y[2][c]);
+          Vec4 y3 = Vec4::load(y[3][c]);
+          Vec4 a0 = kOneHalf * (y1 - y2) + kHalf * (y3 - y0);
+          Vec4 a1 = y0 - kTwoHalf * y1 + kTwo * y2 - kHalf * y3;
+          Vec4 a2 = kHalf * (y2 - y0);
+          frame[c] = ((a0 * tv + a1) * tv + a2) * tv + y1;
+        }
+
+        // Smoothstep of a triangle: w(p) + w(p + 0.5) == 1
+        Vec4 phase = Vec4::load(phase_[g] + base);
+        Vec4 tri = kOne - Vec4::abs(kTwo * phase - kOne);
+        Vec4 window = tri * tri * (kThree - kTwo * tri) * Vec4::load(audible);
+        sumL = sumL + frame[0] * window;
+        sumR = sumR + frame[1] * window;
+
+        // Advance: fractional part on 4 lanes, integer carry per lane
+        Vec4 frac = Vec4::load(frac_[g] + base) + inc;
+        Vec4 carry = Vec4::floor(frac);
+        (frac - carry).store(frac_[g] + base);
+        (phase + absInc * Vec4::load(invGene)).store(phase_[g] + base);
+
+        alignas(16) float carries[kLanes];
+        carry.store(carries);
+        for (int lane = 0; lane < kLanes; lane++)
+        {
+          int ch = base + lane;
+          int64_t len = static_cast<int64_t>(lengths[lane]);
+          if (len == 0)
+            continue;
+          int64_t idx = static_cast<int64_t>(index_[g][ch] % lengths[lane]) + static_cast<int64_t>(carries[lane]);
+          while (idx >= len)
+            idx -= len;
+          while (idx < 0)
+            idx += len;
+          index_[g][ch] = static_cast<uint32_t>(idx);
+        }
+      }
+
+      sumL.store(outL + base);
+      sumR.store(outR + base);
+
+      // Grain ends (rare): restart from the other grain while the gate is
+      // high. The first grain's end marks the channel's end of gene.
+      for (int lane = 0; lane < kLanes; lane++)
+      {
+        int ch = base + lane;
+        for (int g = 0; g < kGrains; g++)
+        {
+          if (phase_[g][ch] < 1.0f)
+            continue;
+          phase_[g][ch] -= 1.0f;
+          if (g == 0 && active_[g][ch] > 0.0f && ch < channels_)
+            geneEnded |= 1u << ch;
+
+          int other = 1 - g;
+          if (gate_[ch])
+          {
+            if (active_[other][ch] > 0.0f)
+            {
+              index_[g][ch] = index_[other][ch];
+              frac_[g][ch] = frac_[other][ch];
+            }
+            grainStart_[g][ch] = spliceStart_[ch];
+            grainLength_[g][ch] = spliceLength_[ch];
+            active_[g][ch] = 1.0f;
+          }
+          else
+          {
+            active_[g][ch] = 0.0f;
+          }
+        }
+      }
+    }
+
+    return geneEnded;
+  }
+
+private:
+  //--------------------------------------------------------------------------
+  // Internal Methods
+  //--------------------------------------------------------------------------
+
+  void stop(int ch) noexcept
+  {
+    for (int g = 0; g < kGrains; g++)
+    {
+      index_[g][ch] = 0;
+      frac_[g][ch] = 0.0f;
+      phase_[g][ch] = 0.5f * g;
+      active_[g][ch] = 0.0f;
+      grainStart_[g][ch] = 0;
+      grainLength_[g][ch] = 0;
+    }
+    spliceStart_[ch] = 0;
+    spliceLength_[ch] = 0;
+    needsSplice_[ch] = true;
+  }
+
+  // Frames i-1..i+2 (wrapped within the splice) into one lane
+  static void gather(const float *data, size_t spliceStart, size_t length, size_t i,
+                     float (&y)[4][2][kLanes], int lane) noexcept
+  {
+    if (i >= 1 && i + 2 < length)
+    {
+      const float *src = data + (spliceStart + i - 1) * 2;
+      for (int k = 0; k < 4; k++)
+      {
+        y[k][0][lane] = src[k * 2];
+        y[k][1][lane] = src[k * 2 + 1];
+      }
+      return;
+    }
+    size_t rel = (i + length - 1) % length;
+    for (int k = 0; k < 4; k++)
+    {
+      const float *src = data + (spliceStart + rel) * 2;
+      y[k][0][lane] = src[0];
+      y[k][1][lane] = src[1];
+      if (++rel >= length)
+        rel = 0;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // State (structure of arrays)
+  //--------------------------------------------------------------------------
+
+  alignas(16) uint32_t index_[kGrains][kMaxChannels];  // Integer read frame
+  alignas(16) float frac_[kGrains][kMaxChannels];      // Fractional read frame
+  alignas(16) float phase_[kGrains][kMaxChannels];     // Position within grain
+  alignas(16) float active_[kGrains][kMaxChannels];    // 1 = sounding
+  size_t grainStart_[kGrains][kMaxChannels];           // Splice each grain reads
+  size_t grainLength_[kGrains][kMaxChannels];
+  size_t spliceStart_[kMaxChannels];                   // Splice of the current gene
+  size_t spliceLength_[kMaxChannels];
+  bool needsSplice_[kMaxChannels];                     // Retriggered, splice not set yet
+  alignas(16) float pitch_[kMaxChannels];              // Rate multiplier
+  alignas(16) float slide_[kMaxChannels];
+  float pitchVolts_[kMaxChannels];
+  bool gate_[kMaxChannels];
+  int channels_ = 1;
+};
+
+} // namespace ShortwavDSP
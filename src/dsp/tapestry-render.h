@@ -0,0 +1,293 @@
+#pragma once
+
+#include "tapestry-dsp.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/*
+ * Tapestry Offline Rendering
+ *
+ * Drives TapestryDSP without Rack: a timeline of parameter, CV and gate
+ * events is applied sample-accurately while the DSP renders into memory.
+ * Used by the headless render tools.
+ *
+ * Features:
+ * - CSV timeline: "time,target,value" per line, time in seconds, '#'
+ *   comments and an optional header row
+ * - Targets cover the knobs (0-1), CV inputs (volts, as the module passes
+ *   them), CV attenuverters, V/Oct pitch and the Play/Clock/Shift/Splice
+ *   gates
+ * - Events apply on the first sample at or after their time; events at the
+ *   same time apply in file order
+ * - Renders in chunks of any size with identical results
+ * - Runs with denormals flushed to zero, as the module does
+ */
+
+namespace ShortwavDSP
+{
+
+enum class RenderTarget
+{
+  Sos,
+  GeneSize,
+  Morph,
+  Slide,
+  Organize,
+  VariSpeed,
+  SosCv,
+  GeneSizeCv,
+  MorphCv,
+  SlideCv,
+  OrganizeCv,
+  VariSpeedCv,
+  GeneSizeAtten,
+  SlideAtten,
+  VariSpeedAtten,
+  Pitch,
+  Play,    // Gate level (> 0.5 = high)
+  Clock,   // Trigger on any value > 0.5
+  Shift,   // Trigger
+  Splice,  // Trigger: marker at the playhead
+  NUM_TARGETS
+};
+
+struct TimelineEvent
+{
+  double time = 0.0;  // Seconds
+  RenderTarget target = RenderTarget::Sos;
+  float value = 0.0f;
+};
+
+//------------------------------------------------------------------------------
+// Timeline
+//------------------------------------------------------------------------------
+
+class Timeline
+{
+public:
+  static const char *targetName(RenderTarget target) noexcept
+  {
+    static const char *const kNames[] = {
+        "sos", "gene_size", "morph", "slide", "organize", "vari_speed",
+        "sos_cv", "gene_size_cv", "morph_cv", "slide_cv", "organize_cv", "vari_speed_cv",
+        "gene_size_atten", "slide_atten", "vari_speed_atten",
+        "pitch", "play", "clock", "shift", "splice"};
+    static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<size_t>(RenderTarget::NUM_TARGETS),
+                  "every render target needs a name");
+    return kNames[static_cast<int>(target)];
+  }
+
+  static bool targetFromName(const std::string &name, RenderTarget &target) noexcept
+  {
+    for (int t = 0; t < static_cast<int>(RenderTarget::NUM_TARGETS); t++)
+    {
+      if (name == targetName(static_cast<RenderTarget>(t)))
+      {
+        target = static_cast<RenderTarget>(t);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Insert keeping time order (stable for equal times)
+  void add(double time, RenderTarget target, float value)
+  {
+    TimelineEvent event;
+    event.time = time;
+    event.target = target;
+    event.value = value;
+    auto pos = std::upper_bound(events_.begin(), events_.end(), event,
+                                [](const TimelineEvent &a, const TimelineEvent &b) { return a.time < b.time; });
+    events_.insert(pos, event);
+  }
+
+  // Parse "time,target,value" lines, appending to the timeline
+  bool parseCsv(const std::string &text, std::string &error)
+  {
+    size_t lineStart = 0;
+    int lineNumber = 0;
+    while (lineStart < text.size())
+    {
+      size_t lineEnd = text.find('\n', lineStart);
+      if (lineEnd == std::string::npos)
+        lineEnd = text.size();
+      std::string line = text.substr(lineStart, lineEnd - lineStart);
+      lineStart = lineEnd + 1;
+      lineNumber++;
+
+      size_t comment = line.find('#');
+      if (comment != std::string::npos)
+        line.erase(comment);
+
+      std::vector<std::string> fields;
+      size_t fieldStart = 0;
+      while (true)
+      {
+        size_t comma = line.find(',', fieldStart);
+        fields.push_back(trim(line.substr(fieldStart, comma - fieldStart)));
+        if (comma == std::string::npos)
+          break;
+        fieldStart = comma + 1;
+      }
+      if (fields.size() == 1 && fields[0].empty())
+        continue;  // Blank line
+      if (fields[0] == "time")
+        continue;  // Header row
+
+      RenderTarget target = RenderTarget::Sos;
+      double time;
+      double value;
+      if (fields.size() != 3)
+      {
+        error = "line " + std::to_string(lineNumber) + ": expected time,target,value";
+        return false;
+      }
+      if (!parseNumber(fields[0], time) || time < 0.0)
+      {
+        error = "line " + std::to_string(lineNumber) + ": bad time '" + fields[0] + "'";
+        return false;
+      }
+      if (!targetFromName(fields[1], target))
+      {
+        error = "line " + std::to_string(lineNumber) + ": unknown target '" + fields[1] + "'";
+        return false;
+      }
+      if (!parseNumber(fields[2], value))
+      {
+        error = "line " + std::to_string(lineNumber) + ": bad value '" + fields[2] + "'";
+        return false;
+      }
+      add(time, target, static_cast<float>(value));
+    }
+    return true;
+  }
+
+  const std::vector<TimelineEvent> &getEvents() const noexcept { return events_; }
+  bool isEmpty() const noexcept { return events_.empty(); }
+
+private:
+  static std::string trim(const std::string &s)
+  {
+    size_t start = s.find_first_not_of(" \t\r");
+    if (start == std::string::npos)
+      return std::string();
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+  }
+
+  static bool parseNumber(const std::string &s, double &value) noexcept
+  {
+    if (s.empty())
+      return false;
+    char *end = nullptr;
+    value = std::strtod(s.c_str(), &end);
+    return end == s.c_str() + s.size() && std::isfinite(value);
+  }
+
+  std::vector<TimelineEvent> events_;
+};
+
+//------------------------------------------------------------------------------
+// Timeline Renderer
+//------------------------------------------------------------------------------
+
+class TimelineRenderer
+{
+public:
+  // The timeline must outlive the renderer
+  TimelineRenderer(const Timeline &timeline, float sampleRate) noexcept
+      : timeline_(timeline), sampleRate_(sampleRate)
+  {
+  }
+
+  // Render the next `frames` frames as interleaved stereo into out
+  void render(TapestryDSP &dsp, float *out, size_t frames) noexcept
+  {
+    ScopedFlushDenormals flushDenormals;
+    const std::vector<TimelineEvent> &events = timeline_.getEvents();
+    for (size_t i = 0; i < frames; i++)
+    {
+      while (nextEvent_ < events.size() && eventFrame(events[nextEvent_]) <= position_)
+      {
+        apply(dsp, events[nextEvent_]);
+        nextEvent_++;
+      }
+
+      TapestryDSP::ProcessResult result = dsp.process(0.0f, 0.0f);
+      out[i * 2] = result.audioOutL;
+      out[i * 2 + 1] = result.audioOutR;
+      position_++;
+    }
+  }
+
+  size_t getPosition() const noexcept { return position_; }
+
+private:
+  size_t eventFrame(const TimelineEvent &event) const noexcept
+  {
+    return static_cast<size_t>(std::ceil(event.time * static_cast<double>(sampleRate_) - 1e-9));
+  }
+
+  void apply(TapestryDSP &dsp, const TimelineEvent &event) noexcept
+  {
+    float v = event.value;
+    bool high = v > 0.5f;
+    switch (event.target)
+    {
+    case RenderTarget::Sos: dsp.setSos(v); break;
+    case RenderTarget::GeneSize: dsp.setGeneSize(v); break;
+    case RenderTarget::Morph: dsp.setMorph(v); break;
+    case RenderTarget::Slide: dsp.setSlide(v); break;
+    case RenderTarget::Organize: dsp.setOrganize(v); break;
+    case RenderTarget::VariSpeed: dsp.setVariSpeed(v); break;
+    case RenderTarget::SosCv: dsp.setSosCv(v); break;
+    case RenderTarget::MorphCv: dsp.setMorphCv(v); break;
+    case RenderTarget::OrganizeCv: dsp.setOrganizeCv(v); break;
+    case RenderTarget::GeneSizeCv: geneSizeCv_ = v; break;
+    case RenderTarget::SlideCv: slideCv_ = v; break;
+    case RenderTarget::VariSpeedCv: variSpeedCv_ = v; break;
+    case RenderTarget::GeneSizeAtten: geneSizeAtten_ = v; break;
+    case RenderTarget::SlideAtten: slideAtten_ = v; break;
+    case RenderTarget::VariSpeedAtten: variSpeedAtten_ = v; break;
+    case RenderTarget::Pitch: dsp.setPitchCv(v); break;
+    case RenderTarget::Play: dsp.onPlayGate(high); break;
+    case RenderTarget::Clock:
+      if (high)
+        dsp.onClockRising();
+      break;
+    case RenderTarget::Shift:
+      if (high)
+        dsp.onShiftTrigger();
+      break;
+    case RenderTarget::Splice:
+      if (high)
+        dsp.onSpliceTrigger(static_cast<size_t>(dsp.getGrainEngine().getPlayheadPosition()));
+      break;
+    default:
+      break;
+    }
+
+    // Attenuated CVs are set as pairs, as the module does
+    dsp.setGeneSizeCv(geneSizeCv_, geneSizeAtten_);
+    dsp.setSlideCv(slideCv_, slideAtten_);
+    dsp.setVariSpeedCv(variSpeedCv_, variSpeedAtten_);
+  }
+
+  const Timeline &timeline_;
+  float sampleRate_;
+  size_t nextEvent_ = 0;
+  size_t position_ = 0;
+
+  float geneSizeCv_ = 0.0f;
+  float slideCv_ = 0.0f;
+  float variSpeedCv_ = 0.0f;
+  float geneSizeAtten_ = 1.0f;
+  float slideAtten_ = 1.0f;
+  float variSpeedAtten_ = 1.0f;
+};
+
+} // namespace ShortwavDSP
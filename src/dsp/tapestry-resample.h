@@ -0,0 +1,445 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include "tapestry-simd.h"
+#include <cmath>
+#include <vector>
+
+/*
+ * Tapestry Resampling
+ *
+ * Interpolated buffer reads in quality tiers, from drop-sample to
+ * polyphase windowed sinc for playback above unity speed, where the
+ * 4-point Hermite read aliases.
+ *
+ * Features:
+ * - Compile-time kernels (drop-sample, linear, Hermite, 6-point Lagrange,
+ *   8/16/32-tap sinc) sharing one splice-wrapping gather; callers pick a
+ *   kernel once per block or loop via template dispatch
+ * - Kaiser-windowed sinc kernels with 8, 16 or 32 taps at unity speed
+ * - 64 phases per kernel, linearly interpolated between neighbouring phases
+ * - Cutoff tracks the read increment: tables are precomputed for 17
+ *   quarter-octave bands from 1x to 16x, and each read picks the band at or
+ *   above its increment
+ * - Kernel length grows with the band (Taps x ratio, rounded up to 4), so
+ *   every band keeps the same number of zero crossings and stopband
+ *   rejection; reads above 16x use the 16x kernel
+ * - Each phase is normalized to unity DC gain
+ * - Taps evaluated with the shared SIMD dot product
+ * - Tables are built once and shared by every instance (call prepare() off
+ *   the audio thread)
+ */
+
+namespace ShortwavDSP
+{
+
+//------------------------------------------------------------------------------
+// Interpolation Quality
+//------------------------------------------------------------------------------
+
+enum class InterpolationQuality
+{
+  None = 0,   // Drop-sample (cheapest)
+  Linear,     // 2-point
+  Hermite,    // 4-point cubic (default)
+  Lagrange6,  // 6-point Lagrange
+  Sinc8,      // Band-limited, 8 taps
+  Sinc16,     // Band-limited, 16 taps
+  Sinc32,     // Band-limited, 32 taps
+  NUM_QUALITIES
+};
+
+//------------------------------------------------------------------------------
+// Polyphase Sinc Table
+//------------------------------------------------------------------------------
+
+template <int Taps>
+class SincTable
+{
+public:
+  static constexpr int kTaps = Taps;  // At unity speed (band 0)
+  static constexpr int kPhases = 64;
+  static constexpr int kBands = 17;   // Quarter octaves, 1x..16x
+  static constexpr int kMaxTaps = Taps * 16;
+
+  static const SincTable &instance()
+  {
+    static SincTable table;
+    return table;
+  }
+
+  // Band whose upper ratio is at or above the read increment
+  static int bandForIncrement(float increment) noexcept
+  {
+    if (!(increment > 1.0f))
+      return 0;
+    int band = static_cast<int>(std::ceil(std::log2(increment) * 4.0f - 1e-4f));
+    return (band < kBands - 1) ? band : kBands - 1;
+  }
+
+  // Kernel length for a band (a multiple of 4, at most kMaxTaps)
+  int taps(int band) const noexcept { return taps_[band]; }
+
+  // Coefficients for a band and phase (phase 0..kPhases inclusive)
+  const float *coefficients(int band, int phase) const noexcept
+  {
+    return table_.data() + offsets_[band] + static_cast<size_t>(phase) * taps_[band];
+  }
+
+private:
+  SincTable()
+  {
+    const double kPi = 3.14159265358979323846;
+    const double beta = (Taps <= 8) ? 5.0 : (Taps <= 16 ? 6.5 : 8.0);
+    const double rolloff = 1.0 - 2.0 / Taps;
+
+    // Stretching the kernel with the band keeps the transition band and
+    // window the same relative to the output rate
+    size_t size = 0;
+    for (int band = 0; band < kBands; band++)
+    {
+      double ratio = std::pow(2.0, band / 4.0);
+      int taps = static_cast<int>(std::ceil(Taps * ratio - 1e-6));
+      taps = (taps + 3) & ~3;
+      taps_[band] = (taps < kMaxTaps) ? taps : kMaxTaps;
+      offsets_[band] = size;
+      size += static_cast<size_t>(kPhases + 1) * taps_[band];
+    }
+
+    table_.resize(size);
+    for (int band = 0; band < kBands; band++)
+    {
+      double ratio = std::pow(2.0, band / 4.0);
+      double cutoff = 0.5 * rolloff / ratio;  // Cycles per input frame
+      const int taps = taps_[band];
+      const double halfWidth = taps / 2.0;
+
+      for (int phase = 0; phase <= kPhases; phase++)
+      {
+        double frac = static_cast<double>(phase) / kPhases;
+        float *coef = table_.data() + offsets_[band] + static_cast<size_t>(phase) * taps;
+        double sum = 0.0;
+        for (int j = 0; j < taps; j++)
+        {
+          // Tap j sits at frame idx - (taps/2 - 1) + j
+          double x = static_cast<double>(j - (taps / 2 - 1)) - frac;
+          double arg = 2.0 * cutoff * x;
+          double sinc = (std::fabs(arg) < 1e-9) ? 1.0 : std::sin(kPi * arg) / (kPi * arg);
+          double w = x / halfWidth;
+          double window = (std::fabs(w) >= 1.0) ? 0.0 : besselI0(beta * std::sqrt(1.0 - w * w)) /
+                                                       besselI0(beta);
+          double h = sinc * window;
+          coef[j] = static_cast<float>(h);
+          sum += h;
+        }
+        for (int j = 0; j < taps; j++)
+        {
+          coef[j] = static_cast<float>(coef[j] / sum);
+        }
+      }
+    }
+  }
+
+  static double besselI0(double x) noexcept
+  {
+    double sum = 1.0;
+    double term = 1.0;
+    double q = x * x / 4.0;
+    for (int k = 1; k < 50; k++)
+    {
+      term *= q / (static_cast<double>(k) * k);
+      sum += term;
+      if (term < sum * 1e-12)
+        break;
+    }
+    return sum;
+  }
+
+  int taps_[kBands];
+  size_t offsets_[kBands];    // Start of each band in table_
+  std::vector<float> table_;  // [band][phase][tap], taps_[band] per phase
+};
+
+//------------------------------------------------------------------------------
+// Read Kernels
+//------------------------------------------------------------------------------
+// Each kernel picks a band for the read increment, reads taps(band) frames
+// (kTaps at band 0, at most kMaxTaps) centred like its kTaps/kBack layout,
+// and combines them for a fractional offset in [0, 1).
+
+namespace Resample
+{
+
+struct DropKernel
+{
+  static constexpr int kTaps = 1;
+  static constexpr int kMaxTaps = 1;
+  static constexpr int kBack = 0;
+
+  static void prepare() {}
+  static int band(float) noexcept { return 0; }
+  static int taps(int) noexcept { return kTaps; }
+
+  static void apply(const float *left, const float *right, int band, float frac,
+                    float &outL, float &outR) noexcept
+  {
+    (void)band;
+    (void)frac;
+    outL = left[0];
+    outR = right[0];
+  }
+};
+
+struct LinearKernel
+{
+  static constexpr int kTaps = 2;
+  static constexpr int kMaxTaps = 2;
+  static constexpr int kBack = 0;
+
+  static void prepare() {}
+  static int band(float) noexcept { return 0; }
+  static int taps(int) noexcept { return kTaps; }
+
+  static void apply(const float *left, const float *right, int band, float frac,
+                    float &outL, float &outR) noexcept
+  {
+    (void)band;
+    outL = TapestryUtil::lerp(left[0], left[1], frac);
+    outR = TapestryUtil::lerp(right[0], right[1], frac);
+  }
+};
+
+struct HermiteKernel
+{
+  static constexpr int kTaps = 4;
+  static constexpr int kMaxTaps = 4;
+  static constexpr int kBack = 1;
+
+  static void prepare() {}
+  static int band(float) noexcept { return 0; }
+  static int taps(int) noexcept { return kTaps; }
+
+  static void apply(const float *left, const float *right, int band, float frac,
+                    float &outL, float &outR) noexcept
+  {
+    (void)band;
+    outL = TapestryUtil::cubicInterpolate(left[0], left[1], left[2], left[3], frac);
+    outR = TapestryUtil::cubicInterpolate(right[0], right[1], right[2], right[3], frac);
+  }
+};
+
+struct Lagrange6Kernel
+{
+  static constexpr int kTaps = 6;
+  static constexpr int kMaxTaps = 6;
+  static constexpr int kBack = 2;
+
+  static void prepare() {}
+  static int band(float) noexcept { return 0; }
+  static int taps(int) noexcept { return kTaps; }
+
+  // Taps at -2..3 relative to the integer position
+  static void apply(const float *left, const float *right, int band, float frac,
+                    float &outL, float &outR) noexcept
+  {
+    (void)band;
+    float d[6];
+    for (int j = 0; j < 6; j++)
+    {
+      d[j] = frac - static_cast<float>(j - 2);
+    }
+    // Denominators prod(j - m), m != j, for nodes -2..3
+    const float kInvDenom[6] = {-1.0f / 120.0f, 1.0f / 24.0f, -1.0f / 12.0f,
+                                1.0f / 12.0f, -1.0f / 24.0f, 1.0f / 120.0f};
+    float w[6];
+    for (int j = 0; j < 6; j++)
+    {
+      float p = kInvDenom[j];
+      for (int m = 0; m < 6; m++)
+      {
+        if (m != j)
+          p *= d[m];
+      }
+      w[j] = p;
+    }
+    outL = 0.0f;
+    outR = 0.0f;
+    for (int j = 0; j < 6; j++)
+    {
+      outL += w[j] * left[j];
+      outR += w[j] * right[j];
+    }
+  }
+};
+
+template <int Taps>
+struct SincKernel
+{
+  static constexpr int kTaps = Taps;
+  static constexpr int kMaxTaps = SincTable<Taps>::kMaxTaps;
+  static constexpr int kBack = Taps / 2 - 1;
+
+  static void prepare() { SincTable<Taps>::instance(); }
+  static int band(float increment) noexcept { return SincTable<Taps>::bandForIncrement(increment); }
+  static int taps(int band) noexcept { return SincTable<Taps>::instance().taps(band); }
+
+  // Interpolate between neighbouring phases (dot products are linear)
+  static void apply(const float *left, const float *right, int band, float frac,
+                    float &outL, float &outR) noexcept
+  {
+    typedef SincTable<Taps> Table;
+    const Table &table = Table::instance();
+    const int taps = table.taps(band);
+    float phasePos = frac * Table::kPhases;
+    int phase = static_cast<int>(phasePos);
+    float t = phasePos - static_cast<float>(phase);
+    if (phase >= Table::kPhases)
+    {
+      phase = Table::kPhases - 1;
+      t = 1.0f;
+    }
+    const float *c0 = table.coefficients(band, phase);
+    const float *c1 = table.coefficients(band, phase + 1);
+
+    float l0 = Simd::dot(c0, left, taps);
+    float r0 = Simd::dot(c0, right, taps);
+    float l1 = Simd::dot(c1, left, taps);
+    float r1 = Simd::dot(c1, right, taps);
+    outL = l0 + t * (l1 - l0);
+    outR = r0 + t * (r1 - r0);
+  }
+};
+
+//------------------------------------------------------------------------------
+// Resampled Reads
+//------------------------------------------------------------------------------
+
+// Build all kernel tables (allocates; call off the audio thread)
+inline void prepare()
+{
+  SincKernel<8>::prepare();
+  SincKernel<16>::prepare();
+  SincKernel<32>::prepare();
+}
+
+// Stereo read within splice bounds (wraps like
+// TapestryBuffer::readStereoInterpolatedBounded). increment is the absolute
+// read step in frames per output sample.
+template <class Kernel>
+inline void readStereo(const TapestryBuffer &buffer, double position, size_t startFrame,
+                       size_t endFrame, float increment, float &outL, float &outR) noexcept
+{
+  size_t used = buffer.getUsedFrames();
+  if (endFrame > used)
+    endFrame = used;
+  if (used == 0 || startFrame >= endFrame)
+  {
+    outL = outR = 0.0f;
+    return;
+  }
+
+  size_t length = endFrame - startFrame;
+  double relPos = std::fmod(position - static_cast<double>(startFrame), static_cast<double>(length));
+  if (relPos < 0.0)
+    relPos += static_cast<double>(length);
+
+  size_t idx = static_cast<size_t>(relPos);
+  float frac = static_cast<float>(relPos - static_cast<double>(idx));
+  if (idx >= length)
+    idx = length - 1;
+
+  // Gather the taps, wrapping within the splice. Wider bands add taps on
+  // both sides of the kTaps layout.
+  const int band = Kernel::band(increment);
+  const int taps = Kernel::taps(band);
+  const size_t back = static_cast<size_t>(Kernel::kBack + (taps - Kernel::kTaps) / 2);
+  float left[Kernel::kMaxTaps];
+  float right[Kernel::kMaxTaps];
+  const float *data = buffer.data();
+  size_t first = (idx + length - back % length) % length;
+  if (first + taps <= length)
+  {
+    const float *src = data + (startFrame + first) * 2;
+    for (int j = 0; j < taps; j++)
+    {
+      left[j] = src[j * 2];
+      right[j] = src[j * 2 + 1];
+    }
+  }
+  else
+  {
+    size_t rel = first;
+    for (int j = 0; j < taps; j++)
+    {
+      const float *src = data + (startFrame + rel) * 2;
+      left[j] = src[0];
+      right[j] = src[1];
+      if (++rel >= length)
+        rel = 0;
+    }
+  }
+
+  Kernel::apply(left, right, band, frac, outL, outR);
+}
+
+// Calls f.run<Kernel>() for the kernel matching quality, so a loop inside
+// run() is compiled once per kernel with no per-sample branch
+template <class Functor>
+inline void dispatch(InterpolationQuality quality, Functor &f) noexcept
+{
+  switch (quality)
+  {
+  case InterpolationQuality::None:
+    f.template run<DropKernel>();
+    break;
+  case InterpolationQuality::Linear:
+    f.template run<LinearKernel>();
+    break;
+  case InterpolationQuality::Lagrange6:
+    f.template run<Lagrange6Kernel>();
+    break;
+  case InterpolationQuality::Sinc8:
+    f.template run<SincKernel<8>>();
+    break;
+  case InterpolationQuality::Sinc16:
+    f.template run<SincKernel<16>>();
+    break;
+  case InterpolationQuality::Sinc32:
+    f.template run<SincKernel<32>>();
+    break;
+  default:
+    f.template run<HermiteKernel>();
+    break;
+  }
+}
+
+struct StereoRead
+{
+  const TapestryBuffer &buffer;
+  double position;
+  size_t startFrame;
+  size_t endFrame;
+  float increment;
+  float &outL;
+  float &outR;
+
+  template <class Kernel>
+  void run() noexcept
+  {
+    readStereo<Kernel>(buffer, position, startFrame, endFrame, increment, outL, outR);
+  }
+};
+
+// Single stereo read at a runtime quality (use dispatch() for loops)
+inline void readStereo(const TapestryBuffer &buffer, double position, size_t startFrame,
+                       size_t endFrame, float increment, InterpolationQuality quality,
+                       float &outL, float &outR) noexcept
+{
+  StereoRead read = {buffer, position, startFrame, endFrame, increment, outL, outR};
+  dispatch(quality, read);
+}
+
+} // namespace Resample
+
+} // namespace ShortwavDSP
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHORTWAV_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SHORTWAV_SIMD_NEON 1
+#endif
+
+/*
+ * Tapestry SIMD Kernels
+ *
+ * Small vectorized kernels shared by the analysis and playback engines.
+ *
+ * Features:
+ * - SSE2 (x86-64) and NEON (ARM64) implementations, 4 floats per step
+ * - Vec4: 4-lane float type for structure-of-arrays processing
+ * - Block mixing kernels (feedback accumulate with optional soft clip,
+ *   crossfade) for recording spans
+ * - Scalar fallback for other targets (and for the tail of each call)
+ * - Unaligned loads, so callers can pass any offset into a buffer
+ */
+
+namespace ShortwavDSP
+{
+namespace Simd
+{
+
+// Sum of a[i] * b[i]
+inline float dot(const float *a, const float *b, size_t n) noexcept
+{
+  size_t i = 0;
+  const size_t blockEnd = n - n % 8;
+  float sum = 0.0f;
+
+#if defined(SHORTWAV_SIMD_SSE2)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (; i < blockEnd; i += 8)
+  {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(SHORTWAV_SIMD_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (; i < blockEnd; i += 8)
+  {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  float lanes[4];
+  vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+  sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+  for (; i < n; i++)
+  {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+// Sum of a[i]^2
+inline float sumSquares(const float *a, size_t n) noexcept
+{
+  return dot(a, a, n);
+}
+
+//------------------------------------------------------------------------------
+// Vec4
+//------------------------------------------------------------------------------
+
+struct Vec4
+{
+#if defined(SHORTWAV_SIMD_SSE2)
+  __m128 v;
+
+  static Vec4 load(const float *p) noexcept { return {_mm_loadu_ps(p)}; }
+  static Vec4 set(float x) noexcept { return {_mm_set1_ps(x)}; }
+  void store(float *p) const noexcept { _mm_storeu_ps(p, v); }
+
+  friend Vec4 operator+(Vec4 a, Vec4 b) noexcept { return {_mm_add_ps(a.v, b.v)}; }
+  friend Vec4 operator-(Vec4 a, Vec4 b) noexcept { return {_mm_sub_ps(a.v, b.v)}; }
+  friend Vec4 operator*(Vec4 a, Vec4 b) noexcept { return {_mm_mul_ps(a.v, b.v)}; }
+
+  static Vec4 min(Vec4 a, Vec4 b) noexcept { return {_mm_min_ps(a.v, b.v)}; }
+  static Vec4 max(Vec4 a, Vec4 b) noexcept { return {_mm_max_ps(a.v, b.v)}; }
+  static Vec4 abs(Vec4 a) noexcept
+  {
+    return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+  }
+  static Vec4 floor(Vec4 a) noexcept
+  {
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    return {_mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)))};
+  }
+  // 1 where a >= b, else 0
+  static Vec4 stepGE(Vec4 a, Vec4 b) noexcept
+  {
+    return {_mm_and_ps(_mm_cmpge_ps(a.v, b.v), _mm_set1_ps(1.0f))};
+  }
+#elif defined(SHORTWAV_SIMD_NEON)
+  float32x4_t v;
+
+  static Vec4 load(const float *p) noexcept { return {vld1q_f32(p)}; }
+  static Vec4 set(float x) noexcept { return {vdupq_n_f32(x)}; }
+  void store(float *p) const noexcept { vst1q_f32(p, v); }
+
+  friend Vec4 operator+(Vec4 a, Vec4 b) noexcept { return {vaddq_f32(a.v, b.v)}; }
+  friend Vec4 operator-(Vec4 a, Vec4 b) noexcept { return {vsubq_f32(a.v, b.v)}; }
+  friend Vec4 operator*(Vec4 a, Vec4 b) noexcept { return {vmulq_f32(a.v, b.v)}; }
+
+  static Vec4 min(Vec4 a, Vec4 b) noexcept { return {vminq_f32(a.v, b.v)}; }
+  static Vec4 max(Vec4 a, Vec4 b) noexcept { return {vmaxq_f32(a.v, b.v)}; }
+  static Vec4 abs(Vec4 a) noexcept { return {vabsq_f32(a.v)}; }
+  static Vec4 floor(Vec4 a) noexcept
+  {
+    float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(a.v));
+    uint32x4_t gt = vcgtq_f32(t, a.v);
+    return {vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(gt, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))))};
+  }
+  static Vec4 stepGE(Vec4 a, Vec4 b) noexcept
+  {
+    uint32x4_t ge = vcgeq_f32(a.v, b.v);
+    return {vreinterpretq_f32_u32(vandq_u32(ge, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))))};
+  }
+#else
+  float v[4];
+
+  static Vec4 load(const float *p) noexcept { return {{p[0], p[1], p[2], p[3]}}; }
+  static Vec4 set(float x) noexcept { return {{x, x, x, x}}; }
+  void store(float *p) const noexcept
+  {
+    for (int i = 0; i < 4; i++)
+      p[i] = v[i];
+  }
+
+  template <class F>
+  static Vec4 map(Vec4 a, Vec4 b, F f) noexcept
+  {
+    return {{f(a.v[0], b.v[0]), f(a.v[1], b.v[1]), f(a.v[2], b.v[2]), f(a.v[3], b.v[3])}};
+  }
+
+  friend Vec4 operator+(Vec4 a, Vec4 b) noexcept
+  {
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+  }
+  friend Vec4 operator-(Vec4 a, Vec4 b) noexcept
+  {
+    return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+  }
+  friend Vec4 operator*(Vec4 a, Vec4 b) noexcept
+  {
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+  }
+
+  static Vec4 min(Vec4 a, Vec4 b) noexcept
+  {
+    return map(a, b, [](float x, float y) { return x < y ? x : y; });
+  }
+  static Vec4 max(Vec4 a, Vec4 b) noexcept
+  {
+    return map(a, b, [](float x, float y) { return x > y ? x : y; });
+  }
+  static Vec4 abs(Vec4 a) noexcept
+  {
+    return map(a, a, [](float x, float) { return x < 0.0f ? -x : x; });
+  }
+  static Vec4 floor(Vec4 a) noexcept
+  {
+    return map(a, a, [](float x, float) {
+      float t = static_cast<float>(static_cast<int>(x));
+      return t > x ? t - 1.0f : t;
+    });
+  }
+  static Vec4 stepGE(Vec4 a, Vec4 b) noexcept
+  {
+    return map(a, b, [](float x, float y) { return x >= y ? 1.0f : 0.0f; });
+  }
+#endif
+};
+
+//------------------------------------------------------------------------------
+// Block Mixing
+//------------------------------------------------------------------------------
+
+// Cubic soft clip: x - 4/27 x^3 on [-1.5, 1.5] (reaching +-1 with zero
+// slope), +-1 beyond
+inline float softClip(float x) noexcept
+{
+  x = (x < -1.5f) ? -1.5f : (x > 1.5f ? 1.5f : x);
+  return x - (4.0f / 27.0f) * x * x * x;
+}
+
+inline Vec4 softClip(Vec4 x) noexcept
+{
+  x = Vec4::min(Vec4::max(x, Vec4::set(-1.5f)), Vec4::set(1.5f));
+  return x - Vec4::set(4.0f / 27.0f) * x * x * x;
+}
+
+template <bool Saturate>
+inline void feedbackAccumulate(float *dest, const float *src, float feedback, size_t n) noexcept
+{
+  size_t i = 0;
+  const Vec4 fb = Vec4::set(feedback);
+  for (; i + 4 <= n; i += 4)
+  {
+    Vec4 sum = Vec4::load(dest + i) * fb + Vec4::load(src + i);
+    (Saturate ? softClip(sum) : sum).store(dest + i);
+  }
+  for (; i < n; i++)
+  {
+    float sum = dest[i] * feedback + src[i];
+    dest[i] = Saturate ? softClip(sum) : sum;
+  }
+}
+
+// dest[i] = dest[i] * feedback + src[i], optionally soft clipped
+inline void feedbackAccumulate(float *dest, const float *src, float feedback, bool saturate,
+                               size_t n) noexcept
+{
+  if (saturate)
+    feedbackAccumulate<true>(dest, src, feedback, n);
+  else
+    feedbackAccumulate<false>(dest, src, feedback, n);
+}
+
+// dest[i] = src[i] * (1 - amount[i]) + dest[i] * amount[i]
+inline void crossfade(float *dest, const float *src, const float *amount, size_t n) noexcept
+{
+  size_t i = 0;
+  const Vec4 one = Vec4::set(1.0f);
+  for (; i + 4 <= n; i += 4)
+  {
+    Vec4 a = Vec4::load(amount + i);
+    (Vec4::load(src + i) * (one - a) + Vec4::load(dest + i) * a).store(dest + i);
+  }
+  for (; i < n; i++)
+  {
+    dest[i] = src[i] * (1.0f - amount[i]) + dest[i] * amount[i];
+  }
+}
+
+} // namespace Simd
+} // namespace ShortwavDSP
@@ -0,0 +1,608 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Tapestry Spectral Engine
+ *
+ * Phase-vocoder playback for freezing a splice or stretching it far beyond
+ * what grains can do without artifacts.
+ *
+ * Features:
+ * - Real FFT (2048 points) via a 1024-point complex FFT with precomputed
+ *   twiddle and bit-reversal tables
+ * - 75% overlap-add with Hann analysis and synthesis windows
+ * - Instantaneous frequency from a second analysis frame a fixed 256
+ *   samples later, so any analysis rate works (0 = freeze, reverse, 100x)
+ * - Identity phase locking around spectral peaks
+ * - Work for each hop (frame loads, FFT stages, phase locking, overlap-add)
+ *   is split into ~70 steps spread over the previous hop; nothing but a
+ *   counter reset runs at the hop boundary, so no single sample carries a
+ *   whole frame's work
+ *
+ * Positions follow the same convention as WsolaStream: relative to the
+ * splice start plus an origin offset (Slide), wrapped within the splice.
+ */
+
+namespace ShortwavDSP
+{
+
+//------------------------------------------------------------------------------
+// Real FFT
+//------------------------------------------------------------------------------
+
+class RealFft
+{
+public:
+  static constexpr int kSize = 2048;          // Real points
+  static constexpr int kHalf = kSize / 2;     // Complex FFT size
+  static constexpr int kBins = kHalf + 1;     // DC..Nyquist
+  static constexpr int kStages = 10;          // log2(kHalf)
+
+  RealFft()
+  {
+    const double kTwoPi = 6.283185307179586;
+    twiddleRe_.resize(kHalf / 2);
+    twiddleIm_.resize(kHalf / 2);
+    for (int k = 0; k < kHalf / 2; k++)
+    {
+      twiddleRe_[k] = static_cast<float>(std::cos(kTwoPi * k / kHalf));
+      twiddleIm_[k] = static_cast<float>(-std::sin(kTwoPi * k / kHalf));
+    }
+    splitRe_.resize(kHalf);
+    splitIm_.resize(kHalf);
+    for (int k = 0; k < kHalf; k++)
+    {
+      splitRe_[k] = static_cast<float>(std::cos(kTwoPi * k / kSize));
+      splitIm_[k] = static_cast<float>(-std::sin(kTwoPi * k / kSize));
+    }
+    bitReverse_.resize(kHalf);
+    for (int i = 0; i < kHalf; i++)
+    {
+      int r = 0;
+      for (int b = 0; b < kStages; b++)
+      {
+        r |= ((i >> b) & 1) << (kStages - 1 - b);
+      }
+      bitReverse_[i] = static_cast<uint16_t>(r);
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // Stepwise API (z: kHalf interleaved complex values)
+  //--------------------------------------------------------------------------
+
+  // Pack real input as z[n] = x[2n] + i x[2n+1], in bit-reversed order
+  void packReal(const float *x, float *z) const noexcept
+  {
+    for (int n = 0; n < kHalf; n++)
+    {
+      int r = bitReverse_[n];
+      z[r * 2] = x[n * 2];
+      z[r * 2 + 1] = x[n * 2 + 1];
+    }
+  }
+
+  // One radix-2 butterfly stage (0..kStages-1); inverse uses conjugate twiddles
+  void stage(float *z, int s, bool inverse) const noexcept
+  {
+    int half = 1 << s;
+    int stride = kHalf / (2 * half);
+    float sign = inverse ? -1.0f : 1.0f;
+    for (int start = 0; start < kHalf; start += 2 * half)
+    {
+      for (int j = 0; j < half; j++)
+      {
+        float wr = twiddleRe_[j * stride];
+        float wi = sign * twiddleIm_[j * stride];
+        float *a = z + (start + j) * 2;
+        float *b = z + (start + j + half) * 2;
+        float br = b[0] * wr - b[1] * wi;
+        float bi = b[0] * wi + b[1] * wr;
+        b[0] = a[0] - br;
+        b[1] = a[1] - bi;
+        a[0] += br;
+        a[1] += bi;
+      }
+    }
+  }
+
+  // Split the complex FFT of the packed signal into bins [k0, k1) of the
+  // real spectrum
+  void unpackForward(const float *z, float *re, float *im, int k0, int k1) const noexcept
+  {
+    for (int k = k0; k < k1; k++)
+    {
+      int a = (k == kHalf) ? 0 : k;
+      int b = (k == 0) ? 0 : kHalf - k;
+      float zr = z[a * 2], zi = z[a * 2 + 1];
+      float cr = z[b * 2], ci = -z[b * 2 + 1];  // conj(Z[M-k])
+      float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+      // O = (Z - conj) / 2i
+      float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+      float wr = (k == kHalf) ? -1.0f : splitRe_[k];
+      float wi = (k == kHalf) ? 0.0f : splitIm_[k];
+      re[k] = er + (or_ * wr - oi * wi);
+      im[k] = ei + (or_ * wi + oi * wr);
+    }
+  }
+
+  // Combine real-spectrum bins back into the packed complex spectrum,
+  // written in bit-reversed order ready for the inverse stages
+  void packInverse(const float *re, const float *im, float *z) const noexcept
+  {
+    for (int k = 0; k < kHalf; k++)
+    {
+      float xr = re[k], xi = im[k];
+      float cr = re[kHalf - k], ci = -im[kHalf - k];  // conj(X[M-k])
+      float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+      float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+      // O = D * exp(+2 pi i k / N)
+      float wr = splitRe_[k], wi = -splitIm_[k];
+      float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+      // Z = E + i O
+      int r = bitReverse_[k];
+      z[r * 2] = er - oi;
+      z[r * 2 + 1] = ei + or_;
+    }
+  }
+
+  // Unpack the inverse result into real samples [n0, n1) (scaled by 1/kHalf)
+  void unpackInverse(const float *z, float *x, int n0, int n1) const noexcept
+  {
+    const float scale = 1.0f / kHalf;
+    for (int n = n0; n < n1; n++)
+    {
+      x[n] = z[(n >> 1) * 2 + (n & 1)] * scale;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // One-shot API
+  //--------------------------------------------------------------------------
+
+  void forward(const float *x, float *z, float *re, float *im) const noexcept
+  {
+    packReal(x, z);
+    for (int s = 0; s < kStages; s++)
+      stage(z, s, false);
+    unpackForward(z, re, im, 0, kBins);
+  }
+
+  void inverse(const float *re, const float *im, float *z, float *x) const noexcept
+  {
+    packInverse(re, im, z);
+    for (int s = 0; s < kStages; s++)
+      stage(z, s, true);
+    unpackInverse(z, x, 0, kSize);
+  }
+
+private:
+  std::vector<float> twiddleRe_, twiddleIm_;  // exp(-2 pi i k / kHalf)
+  std::vector<float> splitRe_, splitIm_;      // exp(-2 pi i k / kSize)
+  std::vector<uint16_t> bitReverse_;
+};
+
+//------------------------------------------------------------------------------
+// Spectral Stream (phase vocoder)
+//------------------------------------------------------------------------------
+
+class SpectralStream
+{
+public:
+  static constexpr int kFrameSize = RealFft::kSize;
+  static constexpr int kBins = RealFft::kBins;
+  static constexpr int kHop = kFrameSize / 4;        // Synthesis hop (75% overlap)
+  static constexpr int kPhaseDelta = kFrameSize / 8; // Offset of the second analysis frame
+  static constexpr int kChannels = 2;
+  static constexpr int kChunks = 4;                  // Per-bin/per-sample work split
+  static constexpr int kOlaSize = kFrameSize + kHop; // Frame being added + hop being read
+
+  SpectralStream()
+  {
+    window_.resize(kFrameSize);
+    for (int i = 0; i < kFrameSize; i++)
+    {
+      window_[i] = 0.5f - 0.5f * std::cos(6.283185307179586f * i / kFrameSize);
+    }
+    for (auto &ch : channels_)
+    {
+      ch.frame.assign(kFrameSize, 0.0f);
+      ch.z.assign(RealFft::kHalf * 2, 0.0f);
+      ch.re.assign(kBins, 0.0f);
+      ch.im.assign(kBins, 0.0f);
+      ch.magnitude.assign(kBins, 0.0f);
+      ch.phase.assign(kBins, 0.0f);
+      ch.instFreq.assign(kBins, 0.0f);
+      ch.synthPhase.assign(kBins, 0.0f);
+      ch.synth.assign(kFrameSize, 0.0f);
+      ch.ola.assign(kOlaSize, 0.0f);
+      ch.peakOf.assign(kBins, 0);
+    }
+    reset(0.0);
+  }
+
+  // Restart at a position (output fades in after one frame)
+  void reset(double position) noexcept
+  {
+    analysisPos_ = position;
+    hopIndex_ = 0;
+    step_ = 0;
+    olaPos_ = 0;
+    hasAnalysis_ = false;
+    frozen_ = false;
+    for (auto &ch : channels_)
+    {
+      std::fill(ch.ola.begin(), ch.ola.end(), 0.0f);
+      std::fill(ch.synthPhase.begin(), ch.synthPhase.end(), 0.0f);
+      std::fill(ch.synth.begin(), ch.synth.end(), 0.0f);
+    }
+    beginHop(0.0f);
+  }
+
+  double getPosition() const noexcept { return analysisPos_; }
+
+  // Render one output sample.
+  // speed: signed analysis advance in buffer frames per output sample (0 = freeze)
+  // readRate: buffer frames per output sample at unity pitch
+  // Returns true when the analysis position wrapped around the splice.
+  bool process(const TapestryBuffer &buffer, size_t spliceStart, size_t spliceLength,
+               double origin, float speed, float readRate,
+               float &outL, float &outR) noexcept
+  {
+    outL = outR = 0.0f;
+    if (spliceLength == 0)
+      return false;
+
+    source_.buffer = &buffer;
+    source_.spliceStart = spliceStart;
+    source_.spliceLength = spliceLength;
+    source_.origin = origin;
+    source_.readRate = readRate;
+
+    // Output: the overlap-add ring, cleared behind the read position
+    outL = channels_[0].ola[olaPos_];
+    outR = channels_[1].ola[olaPos_];
+    channels_[0].ola[olaPos_] = 0.0f;
+    channels_[1].ola[olaPos_] = 0.0f;
+    olaPos_ = (olaPos_ + 1) % kOlaSize;
+
+    // Spread the next frame's work evenly across this hop
+    int target = ((hopIndex_ + 1) * kNumSteps + kHop - 1) / kHop;
+    while (step_ < target)
+    {
+      runStep(step_++);
+    }
+
+    // The finished frame is already in the overlap-add ring (last synthesis
+    // steps); start on the next one
+    bool wrapped = false;
+    if (++hopIndex_ == kHop)
+    {
+      wrapped = advance(speed, static_cast<double>(spliceLength));
+      beginHop(speed);
+    }
+    return wrapped;
+  }
+
+private:
+  //--------------------------------------------------------------------------
+  // Step Schedule
+  //--------------------------------------------------------------------------
+
+  // Analysis A (magnitude + phase), analysis B (phase only), phase locking
+  // (peak scan, peak advance, lock), synthesis and overlap-add. Analysis
+  // steps are skipped while frozen.
+  static constexpr int kAnalysisSteps = kChunks + 1 + RealFft::kStages + kChunks;
+  static constexpr int kStepAnalysisA = 0;
+  static constexpr int kStepAnalysisB = kStepAnalysisA + kAnalysisSteps;
+  static constexpr int kStepLock = kStepAnalysisB + kAnalysisSteps;
+  static constexpr int kLockSteps = 3 * kChunks;
+  static constexpr int kStepSynth = kStepLock + kLockSteps;
+  static constexpr int kSynthSteps = kChunks + 1 + RealFft::kStages + kChunks;
+  static constexpr int kNumSteps = kStepSynth + kSynthSteps;
+
+  struct Channel
+  {
+    std::vector<float> frame;       // Windowed time-domain frame
+    std::vector<float> z;           // Packed complex FFT workspace
+    std::vector<float> re, im;      // Real spectrum
+    std::vector<float> magnitude;   // Frame A magnitude
+    std::vector<float> phase;       // Frame A phase
+    std::vector<float> instFreq;    // Radians per output sample
+    std::vector<float> synthPhase;  // Running synthesis phase
+    std::vector<float> synth;       // Windowed output frame
+    std::vector<float> ola;         // Overlap-add ring
+    std::vector<int> peakOf;        // Nearest spectral peak for each bin
+    int lastPeak = -1;              // Peak scan state between lock steps
+    int numPeaks = 0;
+  };
+
+  struct Source
+  {
+    const TapestryBuffer *buffer = nullptr;
+    size_t spliceStart = 0;
+    size_t spliceLength = 0;
+    double origin = 0.0;
+    float readRate = 1.0f;
+  };
+
+  void beginHop(float speed) noexcept
+  {
+    hopIndex_ = 0;
+    step_ = 0;
+    framePos_ = (olaPos_ + kHop) % kOlaSize;  // Where this hop's frame starts
+    // Re-analyze unless frozen on an already analyzed position
+    frozen_ = hasAnalysis_ && speed == 0.0f;
+  }
+
+  bool advance(float speed, double length) noexcept
+  {
+    double next = analysisPos_ + static_cast<double>(speed) * kHop;
+    bool wrapped = next >= length || next < 0.0;
+    next = std::fmod(next, length);
+    analysisPos_ = (next < 0.0) ? next + length : next;
+    return wrapped;
+  }
+
+  void runStep(int step) noexcept
+  {
+    if (step < kStepLock)
+    {
+      if (frozen_ || !source_.buffer)
+        return;
+      bool isB = step >= kStepAnalysisB;
+      runAnalysisStep(step - (isB ? kStepAnalysisB : kStepAnalysisA), isB);
+    }
+    else if (step < kStepSynth)
+    {
+      if (step == kStepLock && !frozen_ && source_.buffer)
+        hasAnalysis_ = true;
+      if (hasAnalysis_)
+        runLockStep(step - kStepLock);
+    }
+    else
+    {
+      runSynthStep(step - kStepSynth);
+    }
+  }
+
+  void runAnalysisStep(int s, bool isB) noexcept
+  {
+    if (s < kChunks)
+    {
+      loadFrame(isB ? static_cast<double>(kPhaseDelta) : 0.0, s);
+    }
+    else if (s == kChunks)
+    {
+      for (auto &ch : channels_)
+        fft_.packReal(ch.frame.data(), ch.z.data());
+    }
+    else if (s < kChunks + 1 + RealFft::kStages)
+    {
+      for (auto &ch : channels_)
+        fft_.stage(ch.z.data(), s - kChunks - 1, false);
+    }
+    else
+    {
+      int chunk = s - kChunks - 1 - RealFft::kStages;
+      int k0 = chunk * kBins / kChunks;
+      int k1 = (chunk + 1) * kBins / kChunks;
+      for (auto &ch : channels_)
+      {
+        fft_.unpackForward(ch.z.data(), ch.re.data(), ch.im.data(), k0, k1);
+        if (!isB)
+        {
+          for (int k = k0; k < k1; k++)
+          {
+            ch.magnitude[k] = std::sqrt(ch.re[k] * ch.re[k] + ch.im[k] * ch.im[k]);
+            ch.phase[k] = std::atan2(ch.im[k], ch.re[k]);
+          }
+        }
+        else
+        {
+          // Instantaneous frequency from the phase advance over kPhaseDelta
+          for (int k = k0; k < k1; k++)
+          {
+            float binFreq = kTwoPi * k / kFrameSize;
+            float delta = std::atan2(ch.im[k], ch.re[k]) - ch.phase[k] - binFreq * kPhaseDelta;
+            ch.instFreq[k] = binFreq + wrapPhase(delta) / kPhaseDelta;
+          }
+        }
+      }
+    }
+  }
+
+  // Load and window part of a frame starting offset samples after the
+  // analysis position
+  void loadFrame(double offset, int chunk) noexcept
+  {
+    int i0 = chunk * kFrameSize / kChunks;
+    int i1 = (chunk + 1) * kFrameSize / kChunks;
+    const TapestryBuffer &buffer = *source_.buffer;
+    size_t spliceEnd = source_.spliceStart + source_.spliceLength;
+    double base = static_cast<double>(source_.spliceStart) + source_.origin + analysisPos_ +
+                  offset * source_.readRate;
+    for (int i = i0; i < i1; i++)
+    {
+      float l, r;
+      buffer.readStereoInterpolatedBounded(base + i * static_cast<double>(source_.readRate),
+                                           source_.spliceStart, spliceEnd, l, r);
+      channels_[0].frame[i] = l * window_[i];
+      channels_[1].frame[i] = r * window_[i];
+    }
+  }
+
+  // Identity phase locking, a chunk of bins per step: find the nearest
+  // peak for every bin, advance peak phases by their instantaneous
+  // frequency, then lock the surrounding bins to their peak
+  void runLockStep(int s) noexcept
+  {
+    int chunk = s % kChunks;
+    int k0 = chunk * kBins / kChunks;
+    int k1 = (chunk + 1) * kBins / kChunks;
+    for (auto &ch : channels_)
+    {
+      if (s < kChunks)
+      {
+        scanPeaks(ch, k0, k1, chunk == kChunks - 1);
+      }
+      else if (ch.numPeaks == 0)
+      {
+        continue;
+      }
+      else if (s < 2 * kChunks)
+      {
+        for (int k = k0; k < k1; k++)
+        {
+          if (ch.peakOf[k] == k)
+            ch.synthPhase[k] = wrapPhase(ch.synthPhase[k] + ch.instFreq[k] * kHop);
+        }
+      }
+      else
+      {
+        for (int k = k0; k < k1; k++)
+        {
+          int p = ch.peakOf[k];
+          if (p != k)
+            ch.synthPhase[k] = ch.synthPhase[p] + (ch.phase[k] - ch.phase[p]);
+        }
+      }
+    }
+  }
+
+  // Nearest peak for bins [k0, k1) (boundaries at the magnitude minimum);
+  // bins after the last peak are assigned once the scan is complete
+  void scanPeaks(Channel &ch, int k0, int k1, bool last) noexcept
+  {
+    const std::vector<float> &mag = ch.magnitude;
+    if (k0 == 0)
+    {
+      ch.lastPeak = -1;
+      ch.numPeaks = 0;
+    }
+    for (int k = k0; k < k1; k++)
+    {
+      bool isPeak = mag[k] > 0.0f;
+      for (int d = 1; d <= 2 && isPeak; d++)
+      {
+        if (k - d >= 0 && mag[k - d] >= mag[k])
+          isPeak = false;
+        if (k + d < kBins && mag[k + d] > mag[k])
+          isPeak = false;
+      }
+      if (!isPeak)
+        continue;
+
+      if (ch.lastPeak < 0)
+      {
+        for (int j = 0; j < k; j++)
+          ch.peakOf[j] = k;
+      }
+      else
+      {
+        int valley = ch.lastPeak;
+        for (int j = ch.lastPeak + 1; j < k; j++)
+        {
+          if (mag[j] < mag[valley])
+            valley = j;
+        }
+        for (int j = ch.lastPeak + 1; j < k; j++)
+          ch.peakOf[j] = (j <= valley) ? ch.lastPeak : k;
+      }
+      ch.peakOf[k] = k;
+      ch.lastPeak = k;
+      ch.numPeaks++;
+    }
+    if (!last)
+      return;
+    if (ch.numPeaks == 0)
+    {
+      std::fill(ch.synthPhase.begin(), ch.synthPhase.end(), 0.0f);
+      return;
+    }
+    for (int j = ch.lastPeak + 1; j < kBins; j++)
+      ch.peakOf[j] = ch.lastPeak;
+  }
+
+  void runSynthStep(int s) noexcept
+  {
+    if (s < kChunks)
+    {
+      int k0 = s * kBins / kChunks;
+      int k1 = (s + 1) * kBins / kChunks;
+      for (auto &ch : channels_)
+      {
+        for (int k = k0; k < k1; k++)
+        {
+          float m = hasAnalysis_ ? ch.magnitude[k] : 0.0f;
+          ch.re[k] = m * std::cos(ch.synthPhase[k]);
+          ch.im[k] = m * std::sin(ch.synthPhase[k]);
+        }
+      }
+    }
+    else if (s == kChunks)
+    {
+      for (auto &ch : channels_)
+      {
+        ch.im[0] = 0.0f;
+        ch.im[kBins - 1] = 0.0f;
+        fft_.packInverse(ch.re.data(), ch.im.data(), ch.z.data());
+      }
+    }
+    else if (s < kChunks + 1 + RealFft::kStages)
+    {
+      for (auto &ch : channels_)
+        fft_.stage(ch.z.data(), s - kChunks - 1, true);
+    }
+    else
+    {
+      // Synthesis window (Hann^2 at 75% overlap sums to 1.5), then
+      // overlap-add into the ring ahead of the hop being read
+      int chunk = s - kChunks - 1 - RealFft::kStages;
+      int n0 = chunk * kFrameSize / kChunks;
+      int n1 = (chunk + 1) * kFrameSize / kChunks;
+      const float kOlaGain = 1.0f / 1.5f;
+      for (auto &ch : channels_)
+      {
+        fft_.unpackInverse(ch.z.data(), ch.synth.data(), n0, n1);
+        for (int n = n0; n < n1; n++)
+        {
+          ch.synth[n] *= window_[n] * kOlaGain;
+          ch.ola[(framePos_ + n) % kOlaSize] += ch.synth[n];
+        }
+      }
+    }
+  }
+
+  static float wrapPhase(float phase) noexcept
+  {
+    return phase - kTwoPi * std::floor((phase + kPi) / kTwoPi);
+  }
+
+  static constexpr float kPi = 3.14159265358979f;
+  static constexpr float kTwoPi = 6.28318530717959f;
+
+  //--------------------------------------------------------------------------
+  // State
+  //--------------------------------------------------------------------------
+
+  RealFft fft_;
+  std::vector<float> window_;
+  Channel channels_[kChannels];
+  Source source_;
+
+  double analysisPos_ = 0.0;
+  int hopIndex_ = 0;
+  int step_ = 0;
+  int olaPos_ = 0;
+  int framePos_ = 0;  // Overlap-add ring position of the frame in progress
+  bool hasAnalysis_ = false;
+  bool frozen_ = false;
+};
+
+} // namespace ShortwavDSP
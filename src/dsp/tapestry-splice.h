@@ -2,6 +2,7 @@
 
 #include "tapestry-core.h"
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 
 /*
@@ -15,6 +16,10 @@
  * - Organize parameter mapping to splice selection
  * - Pending splice system (change at end of current)
  * - Shift button/gate increment
+ * - Optional rank order for content-aware Organize
+ * - Marker placement on a detected beat grid
+ * - Layout version counter for invalidating derived analysis data
+ * - Storage reserved for kMaxSplices; marker edits never allocate
  */
 
 namespace ShortwavDSP
@@ -25,7 +30,9 @@ class SpliceManager
 public:
   static constexpr size_t kMaxSplices = TapestryConfig::kMaxSplices;
 
-  SpliceManager() = default;
+  // Capacity for every splice up front, so marker edits on the audio thread
+  // never reallocate
+  SpliceManager() { splices_.reserve(kMaxSplices); }
 
   //--------------------------------------------------------------------------
   // Initialization
@@ -34,6 +41,7 @@ public:
   // Initialize with a single splice covering the entire buffer
   void initialize(size_t totalFrames) noexcept
   {
+    version_++;
     splices_.clear();
     if (totalFrames > 0)
     {
@@ -47,6 +55,7 @@ public:
   // Clear all splices
   void clear() noexcept
   {
+    version_++;
     splices_.clear();
     currentIndex_ = 0;
     pendingIndex_ = -1;
@@ -61,6 +70,9 @@ public:
   bool isEmpty() const noexcept { return splices_.empty(); }
   bool isFull() const noexcept { return splices_.size() >= kMaxSplices; }
 
+  // Incremented whenever splice boundaries change (not on navigation)
+  uint32_t getVersion() const noexcept { return version_; }
+
   int getCurrentIndex() const noexcept { return currentIndex_; }
   int getPendingIndex() const noexcept { return pendingIndex_; }
   bool hasPending() const noexcept { return pendingIndex_ >= 0; }
@@ -128,6 +140,7 @@ public:
     // Insert new splice after current
     SpliceMarker newSplice = {framePosition, oldEnd};
     splices_.insert(splices_.begin() + spliceIdx + 1, newSplice);
+    version_++;
 
     return true;
   }
@@ -160,6 +173,7 @@ public:
     
     // Remove the splice at index
     splices_.erase(splices_.begin() + index);
+    version_++;
 
     // Adjust current index if needed
     if (currentIndex_ >= static_cast<int>(splices_.size()))
@@ -199,6 +213,7 @@ public:
       splices_[currentIndex_].endFrame = splices_[nextIdx].endFrame;
       splices_.erase(splices_.begin() + nextIdx);
     }
+    version_++;
 
     // Clamp current index
     if (currentIndex_ >= static_cast<int>(splices_.size()))
@@ -219,6 +234,7 @@ public:
     size_t totalEnd = splices_.back().endFrame;
     splices_.clear();
     splices_.push_back({0, totalEnd});
+    version_++;
     currentIndex_ = 0;
     pendingIndex_ = -1;
   }
@@ -241,6 +257,7 @@ public:
 
     // Remove the splice
     splices_.erase(splices_.begin() + currentIndex_);
+    version_++;
 
     // Adjust remaining splice positions
     size_t deletedLength = deletedEnd - deletedStart;
@@ -285,6 +302,12 @@ public:
       int index = static_cast<int>(param * (splices_.size() - 1) + 0.5f);
       index = std::min(index, static_cast<int>(splices_.size()) - 1);
 
+      // Content-aware mode: the knob selects a rank, not a reel position
+      if (organizeOrder_ && organizeOrderCount_ == splices_.size())
+      {
+        index = organizeOrder_[index];
+      }
+
       organizeTarget_ = index;
       lastOrganizeParam_ = param;
       
@@ -297,6 +320,15 @@ public:
     }
   }
 
+  // Rank order used by setOrganize (order[rank] = splice index).
+  // nullptr restores reel-position order. The table must outlive its use
+  // and is ignored unless it covers exactly the current splices.
+  void setOrganizeOrder(const uint16_t *order, size_t count) noexcept
+  {
+    organizeOrder_ = order;
+    organizeOrderCount_ = count;
+  }
+
   // Apply organize target as pending (called at end of splice if no manual pending)
   void applyOrganizeIfNoManualPending() noexcept
   {
@@ -368,9 +400,10 @@ public:
   // Extend the last splice (for recording into new splice)
   void extendLastSplice(size_t newEndFrame) noexcept
   {
-    if (!splices_.empty())
+    if (!splices_.empty() && splices_.back().endFrame != newEndFrame)
     {
       splices_.back().endFrame = newEndFrame;
+      version_++;
     }
   }
 
@@ -383,6 +416,7 @@ public:
       return false;
 
     splices_.push_back({startFrame, endFrame});
+    version_++;
     return true;
   }
 
@@ -409,52 +443,73 @@ public:
     return positions;
   }
 
-  // Set markers from WAV file import
-  void setFromMarkerPositions(const std::vector<size_t> &positions, size_t totalFrames)
+  // Set markers from WAV file import. Positions may be unsorted and contain
+  // duplicates; those at or past totalFrames are ignored. Builds the splices
+  // by repeated minimum search instead of sorting a copy, so it does not
+  // allocate and is safe on the audio thread.
+  void setFromMarkerPositions(const std::vector<size_t> &positions, size_t totalFrames) noexcept
   {
+    version_++;
     splices_.clear();
-    if (positions.empty() || totalFrames == 0)
+    currentIndex_ = 0;
+    pendingIndex_ = -1;
+    organizeTarget_ = -1;
+    if (totalFrames == 0)
+      return;
+
+    // Each splice runs to the next marker after its start; the first starts
+    // at 0 whether or not a marker is there
+    size_t start = 0;
+    while (splices_.size() < kMaxSplices)
     {
-      if (totalFrames > 0)
+      size_t end = totalFrames;
+      for (size_t position : positions)
       {
-        splices_.push_back({0, totalFrames});
+        if (position > start && position < end)
+          end = position;
       }
-      currentIndex_ = 0;
-      pendingIndex_ = -1;
-      return;
+      splices_.push_back({start, end});
+      if (end == totalFrames)
+        break;
+      start = end;
     }
+  }
 
-    // Sort positions
-    std::vector<size_t> sorted = positions;
-    std::sort(sorted.begin(), sorted.end());
-
-    // Remove duplicates and out-of-range
-    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
-    sorted.erase(std::remove_if(sorted.begin(), sorted.end(),
-                                [totalFrames](size_t p)
-                                { return p >= totalFrames; }),
-                 sorted.end());
+  // Set markers on a beat grid, one splice every beatsPerSplice beats.
+  // Audio before the first beat becomes its own splice, and the spacing is
+  // doubled as needed to stay within kMaxSplices.
+  // Returns false (markers unchanged) if the grid is unusable.
+  bool setFromBeatGrid(const BeatGrid &grid, int beatsPerSplice, size_t totalFrames) noexcept
+  {
+    if (!grid.valid || totalFrames == 0 || beatsPerSplice < 1)
+      return false;
 
-    // Ensure starts at 0
-    if (sorted.empty() || sorted[0] != 0)
+    double spacing = grid.periodFrames * beatsPerSplice;
+    if (spacing < 1.0)
+      return false;
+    while (static_cast<double>(totalFrames) / spacing + 2.0 > static_cast<double>(kMaxSplices))
     {
-      sorted.insert(sorted.begin(), 0);
+      spacing *= 2.0;
     }
 
-    // Create splices from marker positions
-    for (size_t i = 0; i < sorted.size() && i < kMaxSplices; i++)
+    version_++;
+    splices_.clear();
+    size_t start = 0;
+    for (double beat = grid.offsetFrames; beat < static_cast<double>(totalFrames); beat += spacing)
     {
-      size_t start = sorted[i];
-      size_t end = (i + 1 < sorted.size()) ? sorted[i + 1] : totalFrames;
-      if (end > start)
+      size_t position = static_cast<size_t>(beat + 0.5);
+      if (position > start && position < totalFrames)
       {
-        splices_.push_back({start, end});
+        splices_.push_back({start, position});
+        start = position;
       }
     }
+    splices_.push_back({start, totalFrames});
 
     currentIndex_ = 0;
     pendingIndex_ = -1;
     organizeTarget_ = -1;
+    return true;
   }
 
 private:
@@ -463,6 +518,9 @@ private:
   int pendingIndex_ = -1;    // -1 = no pending change (from shift or organize)
   int organizeTarget_ = -1;  // Target splice from organize knob
   float lastOrganizeParam_ = -1.0f;  // Last organize parameter value (to detect actual movement)
+  const uint16_t *organizeOrder_ = nullptr;  // Optional rank -> splice index map
+  size_t organizeOrderCount_ = 0;
+  uint32_t version_ = 0;
 };
 
 } // namespace ShortwavDSP
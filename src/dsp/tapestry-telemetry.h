@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+/*
+ * Tapestry Telemetry
+ *
+ * Per-instance CPU cost of the stages of one module process() call, for
+ * finding the expensive Tapestry in a large patch.
+ *
+ * Features:
+ * - Cycle counter timestamps (TSC on x86, the virtual counter on arm64,
+ *   steady_clock elsewhere); ticks are converted to time by calibrating
+ *   against steady_clock since the last reset()
+ * - The audio thread sums ticks per stage over blocks of kBlockSamples and
+ *   publishes each block to a per-stage history ring of atomics; no locks,
+ *   no allocation
+ * - Any thread can read mean, p99 and max per block over the history
+ * - Disabled by passing a null Telemetry: one branch per stage
+ */
+
+namespace ShortwavDSP
+{
+
+enum class TelemetryStage
+{
+  Grain,     // Playback: grain engine, poly voices, read heads
+  Record,    // Recording and overdub
+  Expander,  // Expander message exchange
+  Lights,    // LED updates
+  Total,     // The whole module process() call
+  NUM_STAGES
+};
+
+class Telemetry
+{
+public:
+  static constexpr int kNumStages = static_cast<int>(TelemetryStage::NUM_STAGES);
+  static constexpr int kBlockSamples = 256;
+  static constexpr int kHistoryBlocks = 512;  // ~2.7 s at 48 kHz
+
+  struct Stats
+  {
+    int blocks = 0;           // Blocks the stats cover
+    double meanMicros = 0.0;  // Per block
+    double p99Micros = 0.0;
+    double maxMicros = 0.0;
+  };
+
+  Telemetry() noexcept { reset(); }
+
+  static const char *stageName(TelemetryStage stage) noexcept
+  {
+    static const char *const kNames[] = {"Grain", "Record", "Expander", "Lights", "Total"};
+    static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<size_t>(TelemetryStage::NUM_STAGES),
+                  "every telemetry stage needs a name");
+    return kNames[static_cast<int>(stage)];
+  }
+
+  // Raw timestamp in counter ticks
+  static uint64_t now() noexcept
+  {
+#if defined(__x86_64__) || defined(__i386__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+  }
+
+  // Clear the history and restart calibration. Call from the thread that
+  // adds the stages (or before it starts).
+  void reset() noexcept
+  {
+    for (int s = 0; s < kNumStages; s++)
+    {
+      blockTicks_[s] = 0;
+      for (int b = 0; b < kHistoryBlocks; b++)
+      {
+        history_[s][b].store(0, std::memory_order_relaxed);
+      }
+    }
+    blockSamples_ = 0;
+    calibrationTicks_.store(now(), std::memory_order_relaxed);
+    calibrationNanos_.store(steadyNanos(), std::memory_order_relaxed);
+    blocksWritten_.store(0, std::memory_order_release);
+  }
+
+  //--------------------------------------------------------------------------
+  // Audio Thread
+  //--------------------------------------------------------------------------
+
+  void add(TelemetryStage stage, uint64_t ticks) noexcept
+  {
+    blockTicks_[static_cast<int>(stage)] += ticks;
+  }
+
+  // Null-safe probes around a stage: with no telemetry they cost one branch
+  static uint64_t begin(const Telemetry *telemetry) noexcept { return telemetry ? now() : 0; }
+  static void end(Telemetry *telemetry, TelemetryStage stage, uint64_t start) noexcept
+  {
+    if (telemetry)
+      telemetry->add(stage, now() - start);
+  }
+
+  // Call once per sample, after the stages have been added
+  void endSample() noexcept
+  {
+    if (++blockSamples_ < kBlockSamples)
+      return;
+    blockSamples_ = 0;
+
+    uint32_t written = blocksWritten_.load(std::memory_order_relaxed);
+    int slot = static_cast<int>(written % kHistoryBlocks);
+    for (int s = 0; s < kNumStages; s++)
+    {
+      uint64_t ticks = std::min<uint64_t>(blockTicks_[s], UINT32_MAX);
+      history_[s][slot].store(static_cast<uint32_t>(ticks), std::memory_order_relaxed);
+      blockTicks_[s] = 0;
+    }
+    blocksWritten_.store(written + 1, std::memory_order_release);
+  }
+
+  //--------------------------------------------------------------------------
+  // Readers
+  //--------------------------------------------------------------------------
+
+  // Blocks published since the last reset()
+  uint32_t getBlockCount() const noexcept { return blocksWritten_.load(std::memory_order_acquire); }
+
+  // Counter ticks per second measured since reset(), or 0 until enough time
+  // has passed to be meaningful
+  double getTicksPerSecond() const noexcept
+  {
+    int64_t nanos = steadyNanos() - calibrationNanos_.load(std::memory_order_relaxed);
+    uint64_t ticks = now() - calibrationTicks_.load(std::memory_order_relaxed);
+    if (nanos < 50000000)
+      return 0.0;
+    return static_cast<double>(ticks) * 1e9 / static_cast<double>(nanos);
+  }
+
+  // Per-block stats of one stage over the history. A block overwritten
+  // while it is read shows either value; the stats stay approximate.
+  Stats getStats(TelemetryStage stage, double ticksPerSecond) const noexcept
+  {
+    Stats stats;
+    uint32_t written = getBlockCount();
+    int count = static_cast<int>(std::min(written, static_cast<uint32_t>(kHistoryBlocks)));
+    if (count == 0 || ticksPerSecond <= 0.0)
+      return stats;
+
+    uint32_t values[kHistoryBlocks];
+    const std::atomic<uint32_t> *ring = history_[static_cast<int>(stage)];
+    uint64_t sum = 0;
+    uint32_t maxTicks = 0;
+    for (int b = 0; b < count; b++)
+    {
+      values[b] = ring[b].load(std::memory_order_relaxed);
+      sum += values[b];
+      maxTicks = std::max(maxTicks, values[b]);
+    }
+
+    // Nearest-rank 99th percentile
+    int rank = (count * 99 + 99) / 100 - 1;
+    std::nth_element(values, values + rank, values + count);
+
+    double microsPerTick = 1e6 / ticksPerSecond;
+    stats.blocks = count;
+    stats.meanMicros = static_cast<double>(sum) / count * microsPerTick;
+    stats.p99Micros = values[rank] * microsPerTick;
+    stats.maxMicros = maxTicks * microsPerTick;
+    return stats;
+  }
+
+  // Real time one block represents, for expressing stats as a CPU share
+  static double blockMicros(float sampleRate) noexcept
+  {
+    return (sampleRate > 0.0f) ? kBlockSamples * 1e6 / sampleRate : 0.0;
+  }
+
+private:
+  static int64_t steadyNanos() noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // Audio thread only
+  uint64_t blockTicks_[kNumStages];
+  int blockSamples_ = 0;
+
+  std::atomic<uint32_t> history_[kNumStages][kHistoryBlocks];
+  std::atomic<uint32_t> blocksWritten_{0};
+  std::atomic<uint64_t> calibrationTicks_{0};
+  std::atomic<int64_t> calibrationNanos_{0};
+};
+
+} // namespace ShortwavDSP
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include "tapestry-analysis.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Tapestry Tempo Analysis
+ *
+ * Offline tempo and beat tracker for the reel. Runs on a worker thread and
+ * publishes a BeatGrid to the audio thread, where it is used to place
+ * markers on beats and to lock Vari-Speed to an incoming clock.
+ *
+ * Features:
+ * - Onset envelope from the log energy of the first difference (512-frame hops)
+ * - Autocorrelation tempo estimate (60-200 BPM) with a 120 BPM prior
+ * - Sub-hop period refinement from higher autocorrelation multiples
+ * - Comb-filter beat phase, refined to the sample on the strongest onset
+ * - Linear in reel length; a full reel costs roughly one pass over the audio
+ * - Pre-allocated scratch buffers, lock-free publication
+ *
+ * The worker analyzes the reel snapshots the audio thread publishes with the
+ * splice layout (SpliceFeatureCache), which are held back while recording,
+ * so it doesn't re-run continuously while the reel grows.
+ */
+
+namespace ShortwavDSP
+{
+
+class TempoAnalyzer
+{
+public:
+  static constexpr size_t kHopFrames = 512;
+  static constexpr size_t kMaxHops = TapestryConfig::kMaxReelFrames / kHopFrames + 1;
+  static constexpr float kMinBpm = 60.0f;
+  static constexpr float kMaxBpm = 200.0f;
+  static constexpr float kPriorBpm = 120.0f;
+  static constexpr float kMinConfidence = 0.1f;
+  static constexpr size_t kMinBeats = 4;  // Beats needed at the slowest tempo
+
+  TempoAnalyzer()
+  {
+    logEnergy_.resize(kMaxHops, 0.0f);
+    onsets_.resize(kMaxHops, 0.0f);
+  }
+
+  //--------------------------------------------------------------------------
+  // Audio Thread
+  //--------------------------------------------------------------------------
+
+  // Copy the latest grid into out if a new one was published since the
+  // last call. Returns true if out was updated.
+  bool fetch(BeatGrid &out) noexcept
+  {
+    if (!grids_.update())
+      return false;
+    out = *grids_.front();
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  // Worker Thread
+  //--------------------------------------------------------------------------
+
+  // Analyze a reel snapshot (buffer version and used frames, as published
+  // by the audio thread) unless it was already analyzed.
+  // Returns true if a new grid was published.
+  bool update(const TapestryBuffer &buffer, uint32_t version, size_t used) noexcept
+  {
+    if (hasAnalyzed_ && version == analyzedVersion_)
+      return false;
+
+    BeatGrid grid = analyze(buffer, used);
+    analyzedVersion_ = version;
+    hasAnalyzed_ = true;
+
+    // Recording started mid-pass: drop it, the next snapshot comes when it stops
+    if (buffer.getVersion() != version)
+      return false;
+
+    grids_.back() = grid;
+    grids_.publish();
+    return true;
+  }
+
+  // Full analysis of the used part of the buffer (offline, no concurrent writer)
+  BeatGrid analyze(const TapestryBuffer &buffer) noexcept
+  {
+    return analyze(buffer, buffer.getUsedFrames());
+  }
+
+  // Full analysis of the first used frames of the buffer
+  BeatGrid analyze(const TapestryBuffer &buffer, size_t used) noexcept
+  {
+    BeatGrid grid;
+    grid.reelFrames = used;
+
+    const double sr = TapestryConfig::kInternalSampleRate;
+    const double hop = static_cast<double>(kHopFrames);
+    size_t lagMin = static_cast<size_t>(std::floor(sr * 60.0 / kMaxBpm / hop));
+    size_t lagMax = static_cast<size_t>(std::ceil(sr * 60.0 / kMinBpm / hop));
+
+    size_t numHops = used / kHopFrames;
+    if (numHops > kMaxHops)
+      numHops = kMaxHops;
+    if (numHops < lagMax * kMinBeats)
+      return grid;
+
+    computeOnsetEnvelope(buffer, numHops);
+
+    double energy = autocorrelation(0, numHops);
+    if (energy <= 0.0)
+      return grid;
+
+    // Strongest tempo-weighted autocorrelation peak
+    double priorLag = sr * 60.0 / kPriorBpm / hop;
+    size_t bestLag = 0;
+    double bestScore = 0.0;
+    for (size_t lag = lagMin; lag <= lagMax; lag++)
+    {
+      double octaves = std::log2(static_cast<double>(lag) / priorLag);
+      double score = autocorrelation(lag, numHops) * std::exp(-0.5 * octaves * octaves);
+      if (score > bestScore)
+      {
+        bestScore = score;
+        bestLag = lag;
+      }
+    }
+    if (bestLag == 0)
+      return grid;
+
+    double confidence = autocorrelation(bestLag, numHops) / energy;
+    if (confidence < kMinConfidence)
+      return grid;
+
+    double periodHops = refinePeak(bestLag, numHops);
+
+    // Higher multiples of the period give finer resolution on long reels
+    for (size_t k = 8; k >= 2; k /= 2)
+    {
+      double multiple = periodHops * static_cast<double>(k);
+      if (multiple + 3.0 < static_cast<double>(numHops) / 2.0)
+      {
+        periodHops = refineMultiple(multiple, numHops) / static_cast<double>(k);
+        break;
+      }
+    }
+
+    double periodFrames = periodHops * hop;
+    double onsetFrame = refineOnset(buffer, used, findBeatPhase(periodHops, numHops));
+
+    grid.valid = true;
+    grid.periodFrames = periodFrames;
+    grid.offsetFrames = std::fmod(onsetFrame, periodFrames);
+    grid.bpm = static_cast<float>(sr * 60.0 / periodFrames);
+    grid.confidence = static_cast<float>(std::min(confidence, 1.0));
+    return grid;
+  }
+
+private:
+  //--------------------------------------------------------------------------
+  // Internal Methods
+  //--------------------------------------------------------------------------
+
+  // Half-wave rectified rise in log high-frequency energy per hop, with the
+  // local mean removed so sustained material doesn't mask onsets
+  void computeOnsetEnvelope(const TapestryBuffer &buffer, size_t numHops) noexcept
+  {
+    const float *data = buffer.data();
+    float prev = 0.0f;
+    for (size_t h = 0; h < numHops; h++)
+    {
+      const float *frame = data + h * kHopFrames * 2;
+      double sum = 0.0;
+      for (size_t i = 0; i < kHopFrames; i++)
+      {
+        float x = frame[i * 2] + frame[i * 2 + 1];
+        float d = x - prev;
+        sum += static_cast<double>(d) * d;
+        prev = x;
+      }
+      logEnergy_[h] = static_cast<float>(std::log(sum + 1e-9));
+    }
+
+    onsets_[0] = 0.0f;
+    for (size_t h = 1; h < numHops; h++)
+    {
+      onsets_[h] = std::max(0.0f, logEnergy_[h] - logEnergy_[h - 1]);
+    }
+
+    // Subtract a moving average (reusing logEnergy_ as scratch)
+    const size_t kRadius = 8;
+    double window = 0.0;
+    size_t lo = 0;
+    size_t hi = 0;
+    for (size_t h = 0; h < numHops; h++)
+    {
+      size_t newHi = std::min(numHops, h + kRadius + 1);
+      size_t newLo = (h > kRadius) ? h - kRadius : 0;
+      while (hi < newHi)
+        window += onsets_[hi++];
+      while (lo < newLo)
+        window -= onsets_[lo++];
+      float mean = static_cast<float>(window / static_cast<double>(hi - lo));
+      logEnergy_[h] = std::max(0.0f, onsets_[h] - mean);
+    }
+    std::copy(logEnergy_.begin(), logEnergy_.begin() + numHops, onsets_.begin());
+  }
+
+  // Unbiased autocorrelation of the onset envelope at an integer lag
+  double autocorrelation(size_t lag, size_t numHops) const noexcept
+  {
+    if (lag >= numHops)
+      return 0.0;
+    const float *e = onsets_.data();
+    double sum = 0.0;
+    for (size_t h = 0; h + lag < numHops; h++)
+    {
+      sum += static_cast<double>(e[h]) * e[h + lag];
+    }
+    return sum / static_cast<double>(numHops - lag);
+  }
+
+  // Parabolic interpolation of the autocorrelation around an integer peak
+  double refinePeak(size_t lag, size_t numHops) const noexcept
+  {
+    if (lag == 0)
+      return 0.0;
+    double a = autocorrelation(lag - 1, numHops);
+    double b = autocorrelation(lag, numHops);
+    double c = autocorrelation(lag + 1, numHops);
+    double denom = a - 2.0 * b + c;
+    double delta = (denom < 0.0) ? 0.5 * (a - c) / denom : 0.0;
+    return static_cast<double>(lag) + std::max(-0.5, std::min(0.5, delta));
+  }
+
+  // Autocorrelation peak near an estimated lag (+-2 hops)
+  double refineMultiple(double estimate, size_t numHops) const noexcept
+  {
+    size_t center = static_cast<size_t>(estimate + 0.5);
+    size_t bestLag = center;
+    double best = -1.0;
+    for (size_t lag = center - 2; lag <= center + 2; lag++)
+    {
+      double r = autocorrelation(lag, numHops);
+      if (r > best)
+      {
+        best = r;
+        bestLag = lag;
+      }
+    }
+    return refinePeak(bestLag, numHops);
+  }
+
+  // Comb filter over the onset envelope: hop offset of the strongest beat train
+  size_t findBeatPhase(double periodHops, size_t numHops) const noexcept
+  {
+    size_t numOffsets = static_cast<size_t>(std::ceil(periodHops));
+    size_t bestOffset = 0;
+    double bestScore = -1.0;
+    for (size_t offset = 0; offset < numOffsets; offset++)
+    {
+      double score = 0.0;
+      for (double pos = static_cast<double>(offset); pos < static_cast<double>(numHops);
+           pos += periodHops)
+      {
+        size_t h = static_cast<size_t>(pos + 0.5);
+        if (h >= numHops)
+          break;
+        score += onsets_[h];
+      }
+      if (score > bestScore)
+      {
+        bestScore = score;
+        bestOffset = offset;
+      }
+    }
+    return bestOffset;
+  }
+
+  // Sample-accurate onset: first frame near the onset hop that reaches half
+  // of the local peak level
+  static double refineOnset(const TapestryBuffer &buffer, size_t used, size_t onsetHop) noexcept
+  {
+    size_t start = (onsetHop > 0) ? (onsetHop - 1) * kHopFrames : 0;
+    size_t end = std::min(used, (onsetHop + 1) * kHopFrames);
+    if (end <= start)
+      return static_cast<double>(onsetHop * kHopFrames);
+
+    const float *data = buffer.data();
+    float peak = 0.0f;
+    for (size_t i = start; i < end; i++)
+    {
+      peak = std::max(peak, std::fabs(data[i * 2] + data[i * 2 + 1]));
+    }
+    for (size_t i = start; i < end; i++)
+    {
+      if (std::fabs(data[i * 2] + data[i * 2 + 1]) >= 0.5f * peak)
+        return static_cast<double>(i);
+    }
+    return static_cast<double>(start);
+  }
+
+  //--------------------------------------------------------------------------
+  // State
+  //--------------------------------------------------------------------------
+
+  TripleBuffer<BeatGrid> grids_;  // Worker -> audio
+
+  // Worker thread
+  std::vector<float> logEnergy_;
+  std::vector<float> onsets_;
+  uint32_t analyzedVersion_ = 0;
+  bool hasAnalyzed_ = false;
+};
+
+} // namespace ShortwavDSP
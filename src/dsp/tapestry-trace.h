@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+ * Tapestry Event Trace
+ *
+ * Timestamped DSP and module events (splice changes, EOSG, clock edges,
+ * recording, file I/O, analysis, underruns) kept in a fixed-size ring, for
+ * correlating dropouts with what the module was doing.
+ *
+ * Features:
+ * - Lock-free and wait-free for writers: any thread claims a slot with one
+ *   fetch_add and publishes it with a per-slot sequence number; no
+ *   allocation, safe on the audio thread
+ * - The oldest events are overwritten once the ring is full
+ * - Readers on any other thread take a consistent snapshot (slots being
+ *   rewritten during the read are skipped)
+ * - Export as Chrome trace_event JSON (chrome://tracing, Perfetto):
+ *   instants, begin/end pairs and complete events, one track per thread
+ * - Underrun detector comparing the wall clock with the audio clock
+ */
+
+namespace ShortwavDSP
+{
+
+enum class TraceEvent : uint8_t
+{
+  SpliceChange,  // arg: new splice index
+  EndOfGene,     // EOSG pulse; arg: splice index
+  ClockRising,
+  Recording,     // Begin/End; arg: record mode
+  FileLoad,      // Begin/End around the phases below
+  FileRead,
+  FileDecode,
+  ReelInstall,
+  FileSave,
+  Analysis,      // Complete; arg: 1 when new features were published
+  Underrun,      // arg: stall in microseconds
+  NUM_EVENTS
+};
+
+enum class TracePhase : uint8_t
+{
+  Instant,
+  Begin,
+  End,
+  Complete  // Has a duration
+};
+
+enum class TraceThread : uint8_t
+{
+  Audio,
+  Analysis,
+  FileIO,
+  NUM_THREADS
+};
+
+struct TraceRecord
+{
+  uint64_t timeNanos = 0;
+  uint64_t durationNanos = 0;
+  int64_t arg = 0;
+  TraceEvent event = TraceEvent::SpliceChange;
+  TracePhase phase = TracePhase::Instant;
+  TraceThread thread = TraceThread::Audio;
+};
+
+//------------------------------------------------------------------------------
+// Trace Ring
+//------------------------------------------------------------------------------
+
+class TraceRing
+{
+public:
+  static constexpr size_t kCapacity = 4096;  // Power of two
+
+  static const char *eventName(TraceEvent event) noexcept
+  {
+    static const char *const kNames[] = {"SpliceChange", "EndOfGene", "ClockRising", "Recording",
+                                         "FileLoad", "FileRead", "FileDecode", "ReelInstall",
+                                         "FileSave", "Analysis", "Underrun"};
+    static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<size_t>(TraceEvent::NUM_EVENTS),
+                  "every trace event needs a name");
+    return kNames[static_cast<int>(event)];
+  }
+
+  static const char *threadName(TraceThread thread) noexcept
+  {
+    static const char *const kNames[] = {"Audio", "Analysis", "File I/O"};
+    static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<size_t>(TraceThread::NUM_THREADS),
+                  "every trace thread needs a name");
+    return kNames[static_cast<int>(thread)];
+  }
+
+  // Monotonic timestamp used for all events
+  static uint64_t now() noexcept
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+  }
+
+  TraceRing() noexcept : originNanos_(now())
+  {
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+      slots_[i].sequence.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // Writers (any thread)
+  //--------------------------------------------------------------------------
+
+  void write(const TraceRecord &record) noexcept
+  {
+    uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[index & (kCapacity - 1)];
+
+    // Odd while writing, 2 * (index + 1) once published
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timeNanos.store(record.timeNanos, std::memory_order_relaxed);
+    slot.durationNanos.store(record.durationNanos, std::memory_order_relaxed);
+    slot.arg.store(record.arg, std::memory_order_relaxed);
+    slot.info.store(packInfo(record), std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+  }
+
+  void instant(TraceThread thread, TraceEvent event, int64_t arg = 0) noexcept
+  {
+    write(makeRecord(thread, event, TracePhase::Instant, now(), 0, arg));
+  }
+
+  void begin(TraceThread thread, TraceEvent event, int64_t arg = 0) noexcept
+  {
+    write(makeRecord(thread, event, TracePhase::Begin, now(), 0, arg));
+  }
+
+  void end(TraceThread thread, TraceEvent event) noexcept
+  {
+    write(makeRecord(thread, event, TracePhase::End, now(), 0, 0));
+  }
+
+  // An event that started at startNanos (from now()) and ends now
+  void complete(TraceThread thread, TraceEvent event, uint64_t startNanos, int64_t arg = 0) noexcept
+  {
+    uint64_t t = now();
+    write(makeRecord(thread, event, TracePhase::Complete, startNanos, t - startNanos, arg));
+  }
+
+  // Events written so far, including overwritten ones
+  uint64_t getWriteCount() const noexcept { return head_.load(std::memory_order_acquire); }
+
+  //--------------------------------------------------------------------------
+  // Readers (not the audio thread: allocates)
+  //--------------------------------------------------------------------------
+
+  // The retained events in time order
+  std::vector<TraceRecord> snapshot() const
+  {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t first = (head > kCapacity) ? head - kCapacity : 0;
+
+    std::vector<TraceRecord> records;
+    records.reserve(static_cast<size_t>(head - first));
+    for (uint64_t index = first; index < head; index++)
+    {
+      const Slot &slot = slots_[index & (kCapacity - 1)];
+      uint64_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before != 2 * index + 2)
+        continue;  // Not published yet, or already overwritten
+
+      TraceRecord record;
+      record.timeNanos = slot.timeNanos.load(std::memory_order_relaxed);
+      record.durationNanos = slot.durationNanos.load(std::memory_order_relaxed);
+      record.arg = slot.arg.load(std::memory_order_relaxed);
+      unpackInfo(slot.info.load(std::memory_order_relaxed), record);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != before)
+        continue;  // Rewritten while we read it
+      records.push_back(record);
+    }
+
+    // Threads publish slightly out of order
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord &a, const TraceRecord &b) {
+      return a.timeNanos < b.timeNanos;
+    });
+    return records;
+  }
+
+  // Chrome trace_event JSON of the retained events; timestamps in
+  // microseconds since the ring was created
+  std::string toChromeJson() const
+  {
+    std::vector<TraceRecord> records = snapshot();
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char line[256];
+    for (int t = 0; t < static_cast<int>(TraceThread::NUM_THREADS); t++)
+    {
+      std::snprintf(line, sizeof(line),
+                    "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+                    t, threadName(static_cast<TraceThread>(t)));
+      json += line;
+    }
+
+    for (size_t i = 0; i < records.size(); i++)
+    {
+      const TraceRecord &r = records[i];
+      static const char kPhases[] = {'i', 'B', 'E', 'X'};
+      double ts = (r.timeNanos >= originNanos_) ? static_cast<double>(r.timeNanos - originNanos_) * 1e-3 : 0.0;
+      int n = std::snprintf(line, sizeof(line),
+                            "{\"name\":\"%s\",\"cat\":\"tapestry\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+                            eventName(r.event), kPhases[static_cast<int>(r.phase)], ts,
+                            static_cast<int>(r.thread));
+      json.append(line, static_cast<size_t>(n));
+      if (r.phase == TracePhase::Instant)
+        json += ",\"s\":\"t\"";
+      if (r.phase == TracePhase::Complete)
+      {
+        n = std::snprintf(line, sizeof(line), ",\"dur\":%.3f", static_cast<double>(r.durationNanos) * 1e-3);
+        json.append(line, static_cast<size_t>(n));
+      }
+      if (r.phase != TracePhase::End)
+      {
+        n = std::snprintf(line, sizeof(line), ",\"args\":{\"value\":%lld}", static_cast<long long>(r.arg));
+        json.append(line, static_cast<size_t>(n));
+      }
+      json += "},\n";
+    }
+
+    // Drop the trailing comma
+    json.erase(json.size() - 2, 1);
+    json += "]}\n";
+    return json;
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> timeNanos;
+    std::atomic<uint64_t> durationNanos;
+    std::atomic<int64_t> arg;
+    std::atomic<uint32_t> info;  // Event, phase and thread
+  };
+
+  static TraceRecord makeRecord(TraceThread thread, TraceEvent event, TracePhase phase,
+                                uint64_t timeNanos, uint64_t durationNanos, int64_t arg) noexcept
+  {
+    TraceRecord record;
+    record.timeNanos = timeNanos;
+    record.durationNanos = durationNanos;
+    record.arg = arg;
+    record.event = event;
+    record.phase = phase;
+    record.thread = thread;
+    return record;
+  }
+
+  static uint32_t packInfo(const TraceRecord &record) noexcept
+  {
+    return static_cast<uint32_t>(record.event) | (static_cast<uint32_t>(record.phase) << 8) |
+           (static_cast<uint32_t>(record.thread) << 16);
+  }
+
+  static void unpackInfo(uint32_t info, TraceRecord &record) noexcept
+  {
+    record.event = static_cast<TraceEvent>(info & 0xFF);
+    record.phase = static_cast<TracePhase>((info >> 8) & 0xFF);
+    record.thread = static_cast<TraceThread>((info >> 16) & 0xFF);
+  }
+
+  std::atomic<uint64_t> head_{0};
+  uint64_t originNanos_;
+  Slot slots_[kCapacity];
+};
+
+//------------------------------------------------------------------------------
+// Underrun Detector
+//------------------------------------------------------------------------------
+
+// Tracks how far the wall clock runs ahead of the audio clock. While the
+// audio device paces the engine the lag stays within about one buffer; a
+// stall the device had to cover with silence raises it for good. Slow drift
+// between the two clocks is absorbed by letting the baseline follow the lag
+// upward at up to kDriftTolerance.
+//
+// The host buffer is measured rather than assumed: the engine renders each
+// device buffer in a burst, running ahead of the wall clock by up to one
+// buffer before it waits. The deepest recent run-ahead is added to the
+// tolerance, so a 4096-frame host (about 93 ms per wait) is not read as
+// stalling on every buffer. It decays at kBufferDecay so a smaller buffer
+// tightens detection again.
+class UnderrunDetector
+{
+public:
+  static constexpr double kDefaultToleranceSeconds = 0.05;
+  static constexpr double kDriftTolerance = 1e-3;  // Seconds per second
+  static constexpr double kBufferDecay = 0.01;     // Seconds per second
+
+  explicit UnderrunDetector(double toleranceSeconds = kDefaultToleranceSeconds) noexcept
+      : tolerance_(toleranceSeconds)
+  {
+  }
+
+  void reset() noexcept { started_ = false; }
+
+  // Call after every `frames` processed frames with the current time
+  // (TraceRing::now()). Returns the stall in seconds when the engine fell
+  // behind by more than the tolerance since the last report, else 0.
+  double update(size_t frames, float sampleRate, uint64_t nowNanos) noexcept
+  {
+    if (!started_ || sampleRate <= 0.0f)
+    {
+      started_ = true;
+      startNanos_ = nowNanos;
+      audioSeconds_ = 0.0;
+      baseline_ = 0.0;
+      lastWall_ = 0.0;
+      runAhead_ = 0.0;
+      bufferSeconds_ = 0.0;
+      return 0.0;
+    }
+
+    double audioStep = static_cast<double>(frames) / sampleRate;
+    audioSeconds_ += audioStep;
+    double wall = static_cast<double>(nowNanos - startNanos_) * 1e-9;
+    double wallStep = wall - lastWall_;
+    double lag = wall - audioSeconds_;
+
+    // Run-ahead within the current burst (cleared by the wait that follows)
+    runAhead_ = std::max(0.0, runAhead_ + audioStep - wallStep);
+    bufferSeconds_ = std::max(runAhead_, bufferSeconds_ - wallStep * kBufferDecay);
+
+    // The baseline sits a buffer below the lag's resting level, so it
+    // rises with the decaying buffer estimate as well as with drift
+    baseline_ = std::min(lag, baseline_ + wallStep * (kDriftTolerance + kBufferDecay));
+    lastWall_ = wall;
+
+    double stall = lag - baseline_;
+    if (stall <= tolerance_ + bufferSeconds_)
+      return 0.0;
+    baseline_ = lag;
+    return stall;
+  }
+
+private:
+  double tolerance_;
+  bool started_ = false;
+  uint64_t startNanos_ = 0;
+  double audioSeconds_ = 0.0;
+  double baseline_ = 0.0;  // Lowest recent lag
+  double lastWall_ = 0.0;
+  double runAhead_ = 0.0;       // Audio rendered ahead of the wall clock
+  double bufferSeconds_ = 0.0;  // Deepest recent run-ahead (host buffer)
+};
+
+} // namespace ShortwavDSP
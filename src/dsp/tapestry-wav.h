@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Tapestry WAV I/O
+ *
+ * Minimal RIFF/WAVE reader and writer for headless tools (offline render,
+ * batch render). Not used on the audio thread.
+ *
+ * Features:
+ * - Reads 8/16/24/32-bit PCM and 32/64-bit float, any channel count
+ *   (mono is duplicated, channels past the second are dropped)
+ * - Walks the chunk list, so LIST/cue/fact chunks before "data" are skipped
+ * - Writes stereo 16-bit PCM or 32-bit float
+ * - Explicit little-endian byte handling, independent of the host
+ * - Errors reported as bool + message, no exceptions
+ */
+
+namespace ShortwavDSP
+{
+
+namespace Wav
+{
+
+enum class Format
+{
+  Pcm16,
+  Float32
+};
+
+// Interleaved stereo audio, normalized to +-1
+struct Audio
+{
+  std::vector<float> samples;
+  size_t frames = 0;
+  uint32_t sampleRate = 48000;
+};
+
+namespace detail
+{
+
+inline uint32_t readLE(const uint8_t *p, int bytes) noexcept
+{
+  uint32_t value = 0;
+  for (int i = bytes - 1; i >= 0; i--)
+  {
+    value = (value << 8) | p[i];
+  }
+  return value;
+}
+
+inline void writeLE(std::vector<uint8_t> &out, uint32_t value, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+  {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+inline void writeTag(std::vector<uint8_t> &out, const char *tag)
+{
+  out.insert(out.end(), tag, tag + 4);
+}
+
+// One sample of the given format, normalized to +-1
+inline float decodeSample(const uint8_t *p, int bits, bool isFloat) noexcept
+{
+  if (isFloat)
+  {
+    if (bits == 32)
+    {
+      uint32_t raw = readLE(p, 4);
+      float value;
+      std::memcpy(&value, &raw, sizeof(value));
+      return value;
+    }
+    uint64_t raw = static_cast<uint64_t>(readLE(p, 4)) | (static_cast<uint64_t>(readLE(p + 4, 4)) << 32);
+    double value;
+    std::memcpy(&value, &raw, sizeof(value));
+    return static_cast<float>(value);
+  }
+
+  switch (bits)
+  {
+  case 8:
+    return (static_cast<float>(p[0]) - 128.0f) / 128.0f;  // Unsigned
+  case 16:
+    return static_cast<float>(static_cast<int16_t>(readLE(p, 2))) / 32768.0f;
+  case 24:
+    // Shift into the top of an int32 to sign-extend
+    return static_cast<float>(static_cast<int32_t>(readLE(p, 3) << 8)) / 2147483648.0f;
+  default:
+    return static_cast<float>(static_cast<int32_t>(readLE(p, 4))) / 2147483648.0f;
+  }
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// Reading
+//------------------------------------------------------------------------------
+
+// Decode a complete WAV file image
+inline bool parse(const uint8_t *data, size_t size, Audio &audio, std::string &error)
+{
+  using detail::readLE;
+
+  if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0)
+  {
+    error = "not a RIFF/WAVE file";
+    return false;
+  }
+
+  int channels = 0;
+  int bits = 0;
+  bool isFloat = false;
+  bool haveFormat = false;
+  size_t pos = 12;
+  while (pos + 8 <= size)
+  {
+    const uint8_t *chunk = data + pos;
+    size_t chunkSize = readLE(chunk + 4, 4);
+    const uint8_t *body = chunk + 8;
+    size_t available = size - pos - 8;
+
+    if (std::memcmp(chunk, "fmt ", 4) == 0)
+    {
+      if (chunkSize < 16 || available < 16)
+      {
+        error = "truncated fmt chunk";
+        return false;
+      }
+      uint32_t tag = readLE(body, 2);
+      channels = static_cast<int>(readLE(body + 2, 2));
+      audio.sampleRate = readLE(body + 4, 4);
+      bits = static_cast<int>(readLE(body + 14, 2));
+      if (tag == 0xFFFE && chunkSize >= 26 && available >= 26)
+      {
+        tag = readLE(body + 24, 2);  // WAVE_FORMAT_EXTENSIBLE sub-format
+      }
+      isFloat = (tag == 3);
+      bool supported = (tag == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+                       (isFloat && (bits == 32 || bits == 64));
+      if (!supported || channels < 1 || audio.sampleRate == 0)
+      {
+        error = "unsupported sample format";
+        return false;
+      }
+      haveFormat = true;
+    }
+    else if (std::memcmp(chunk, "data", 4) == 0)
+    {
+      if (!haveFormat)
+      {
+        error = "data chunk before fmt chunk";
+        return false;
+      }
+      size_t bytes = (chunkSize < available) ? chunkSize : available;
+      size_t sampleBytes = static_cast<size_t>(bits / 8);
+      size_t frameBytes = sampleBytes * static_cast<size_t>(channels);
+      audio.frames = bytes / frameBytes;
+      audio.samples.resize(audio.frames * 2);
+      for (size_t f = 0; f < audio.frames; f++)
+      {
+        const uint8_t *frame = body + f * frameBytes;
+        float left = detail::decodeSample(frame, bits, isFloat);
+        float right = (channels > 1) ? detail::decodeSample(frame + sampleBytes, bits, isFloat) : left;
+        audio.samples[f * 2] = left;
+        audio.samples[f * 2 + 1] = right;
+      }
+      return true;
+    }
+
+    // Chunks are padded to an even size
+    pos += 8 + chunkSize + (chunkSize & 1);
+  }
+
+  error = haveFormat ? "no data chunk" : "no fmt chunk";
+  return false;
+}
+
+inline bool read(const std::string &path, Audio &audio, std::string &error)
+{
+  FILE *file = std::fopen(path.c_str(), "rb");
+  if (!file)
+  {
+    error = "cannot open " + path;
+    return false;
+  }
+
+  std::vector<uint8_t> bytes;
+  uint8_t block[65536];
+  size_t count;
+  while ((count = std::fread(block, 1, sizeof(block), file)) > 0)
+  {
+    bytes.insert(bytes.end(), block, block + count);
+  }
+  std::fclose(file);
+
+  if (!parse(bytes.data(), bytes.size(), audio, error))
+  {
+    error = path + ": " + error;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Writing
+//------------------------------------------------------------------------------
+
+// Encode interleaved stereo frames as a complete WAV file image
+inline std::vector<uint8_t> encode(const float *samples, size_t frames, uint32_t sampleRate,
+                                   Format format)
+{
+  using detail::writeLE;
+  using detail::writeTag;
+
+  const uint32_t channels = 2;
+  const uint32_t bits = (format == Format::Pcm16) ? 16 : 32;
+  const uint32_t blockAlign = channels * bits / 8;
+  const uint32_t dataSize = static_cast<uint32_t>(frames) * blockAlign;
+
+  std::vector<uint8_t> out;
+  out.reserve(44 + dataSize);
+  writeTag(out, "RIFF");
+  writeLE(out, 36 + dataSize, 4);
+  writeTag(out, "WAVE");
+
+  writeTag(out, "fmt ");
+  writeLE(out, 16, 4);
+  writeLE(out, (format == Format::Pcm16) ? 1 : 3, 2);
+  writeLE(out, channels, 2);
+  writeLE(out, sampleRate, 4);
+  writeLE(out, sampleRate * blockAlign, 4);
+  writeLE(out, blockAlign, 2);
+  writeLE(out, bits, 2);
+
+  writeTag(out, "data");
+  writeLE(out, dataSize, 4);
+  for (size_t i = 0; i < frames * channels; i++)
+  {
+    if (format == Format::Pcm16)
+    {
+      float clamped = (samples[i] < -1.0f) ? -1.0f : (samples[i] > 1.0f ? 1.0f : samples[i]);
+      writeLE(out, static_cast<uint16_t>(static_cast<int16_t>(clamped * 32767.0f)), 2);
+    }
+    else
+    {
+      uint32_t raw;
+      std::memcpy(&raw, &samples[i], sizeof(raw));
+      writeLE(out, raw, 4);
+    }
+  }
+  return out;
+}
+
+inline bool write(const std::string &path, const float *samples, size_t frames,
+                  uint32_t sampleRate, Format format, std::string &error)
+{
+  std::vector<uint8_t> bytes = encode(samples, frames, sampleRate, format);
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (!file)
+  {
+    error = "cannot create " + path;
+    return false;
+  }
+  bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+  ok = (std::fclose(file) == 0) && ok;
+  if (!ok)
+    error = "write failed: " + path;
+  return ok;
+}
+
+} // namespace Wav
+
+} // namespace ShortwavDSP
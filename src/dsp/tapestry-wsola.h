@@ -0,0 +1,283 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include "tapestry-simd.h"
+#include <array>
+#include <cmath>
+
+/*
+ * Tapestry WSOLA Stream
+ *
+ * Waveform-similarity overlap-add playback: the splice is read in Hann
+ * windowed frames at unity pitch while the frame positions advance at the
+ * Vari-Speed rate, so speed changes tempo without changing pitch.
+ *
+ * Features:
+ * - 1024-sample frames with 50% overlap (Hann windows sum to one)
+ * - Each new frame is aligned to the natural continuation of the previous
+ *   one by normalized cross-correlation over a +-8ms tolerance window
+ * - Coarse-to-fine search (every 4th lag, then +-3 around the best)
+ * - The search for the next frame is spread across the current hop, so
+ *   each sample costs at most one 256-point SIMD correlation
+ * - Fixed-size state, no allocation
+ *
+ * Positions are relative to the splice start plus an origin offset (Slide)
+ * and wrap within the splice, matching GrainVoice::position.
+ */
+
+namespace ShortwavDSP
+{
+
+class WsolaStream
+{
+public:
+  static constexpr int kFrameSize = 1024;       // Synthesis frame (output samples)
+  static constexpr int kHop = kFrameSize / 2;   // Synthesis hop
+  static constexpr int kCorrLength = 256;       // Frames compared per candidate
+  static constexpr int kTolerance = 384;        // Search +-frames around the target
+  static constexpr int kCoarseStep = 4;
+  static constexpr int kFineRadius = 3;
+  static constexpr int kCandidatesPerSample = 1;
+  static constexpr int kRegionLength = kCorrLength + 2 * kTolerance;
+
+  WsolaStream()
+  {
+    // Periodic Hann: overlapping halves sum to exactly one
+    for (int i = 0; i < kFrameSize; i++)
+    {
+      window_[i] = 0.5f - 0.5f * std::cos(2.0f * 3.14159265358979f * i / kFrameSize);
+    }
+    reset(0.0);
+  }
+
+  // Restart playback at a position (fades in from silence)
+  void reset(double position) noexcept
+  {
+    analysisPos_ = position;
+    curStart_ = position;
+    prevStart_ = position;
+    nextStart_ = position;
+    hasPrev_ = false;
+    hopIndex_ = 0;
+    needsSearch_ = true;
+    searchPhase_ = SearchPhase::Done;
+  }
+
+  // Read position of the newest frame (relative, unwrapped within a hop)
+  double getPosition() const noexcept
+  {
+    return curStart_ + hopIndex_ * lastReadRate_;
+  }
+
+  // Render one output sample.
+  // speed: signed analysis advance in buffer frames per output sample
+  // readRate: buffer frames per output sample at unity pitch
+  // Returns true when the analysis position wrapped around the splice.
+  bool process(const TapestryBuffer &buffer, size_t spliceStart, size_t spliceLength,
+               double origin, float speed, float readRate,
+               float &outL, float &outR) noexcept
+  {
+    outL = outR = 0.0f;
+    if (spliceLength == 0)
+      return false;
+
+    lastReadRate_ = readRate;
+    size_t spliceEnd = spliceStart + spliceLength;
+    bool wrapped = false;
+
+    if (needsSearch_)
+    {
+      wrapped = beginSearch(buffer, spliceStart, spliceLength, origin, speed, readRate);
+      needsSearch_ = false;
+    }
+
+    // Newest frame in its first half, previous frame in its second half
+    float l, r;
+    double pos = static_cast<double>(spliceStart) + origin + curStart_ +
+                 static_cast<double>(hopIndex_) * readRate;
+    buffer.readStereoInterpolatedBounded(pos, spliceStart, spliceEnd, l, r);
+    float w = window_[hopIndex_];
+    outL = l * w;
+    outR = r * w;
+
+    if (hasPrev_)
+    {
+      pos = static_cast<double>(spliceStart) + origin + prevStart_ +
+            static_cast<double>(hopIndex_ + kHop) * readRate;
+      buffer.readStereoInterpolatedBounded(pos, spliceStart, spliceEnd, l, r);
+      w = window_[hopIndex_ + kHop];
+      outL += l * w;
+      outR += r * w;
+    }
+
+    // Amortized search for the next frame
+    stepSearch(kCandidatesPerSample);
+
+    if (++hopIndex_ == kHop)
+    {
+      stepSearch(kRegionLength);  // Finish whatever the budget didn't cover
+      prevStart_ = curStart_;
+      curStart_ = nextStart_;
+      hasPrev_ = true;
+      hopIndex_ = 0;
+      needsSearch_ = true;
+    }
+
+    return wrapped;
+  }
+
+private:
+  enum class SearchPhase
+  {
+    Coarse,
+    Fine,
+    Done
+  };
+
+  //--------------------------------------------------------------------------
+  // Internal Methods
+  //--------------------------------------------------------------------------
+
+  static double wrap(double pos, double length) noexcept
+  {
+    pos = std::fmod(pos, length);
+    return (pos < 0.0) ? pos + length : pos;
+  }
+
+  // Mono samples at consecutive integer frames, wrapped within the splice
+  static void gatherMono(const TapestryBuffer &buffer, size_t spliceStart, size_t spliceLength,
+                         double relStart, float *dest, int count) noexcept
+  {
+    const float *data = buffer.data();
+    size_t used = buffer.getUsedFrames();
+    double length = static_cast<double>(spliceLength);
+    size_t idx = static_cast<size_t>(wrap(std::floor(relStart), length));
+    for (int i = 0; i < count; i++)
+    {
+      size_t frame = spliceStart + idx;
+      dest[i] = (frame < used) ? 0.5f * (data[frame * 2] + data[frame * 2 + 1]) : 0.0f;
+      if (++idx >= spliceLength)
+        idx = 0;
+    }
+  }
+
+  // Advance the analysis target and prepare the correlation search.
+  // Returns true if the target wrapped around the splice.
+  bool beginSearch(const TapestryBuffer &buffer, size_t spliceStart, size_t spliceLength,
+                   double origin, float speed, float readRate) noexcept
+  {
+    double length = static_cast<double>(spliceLength);
+    double advanced = analysisPos_ + static_cast<double>(speed) * kHop;
+    bool wrapped = advanced >= length || advanced < 0.0;
+    analysisPos_ = wrap(advanced, length);
+    nextStart_ = analysisPos_;
+    searchLength_ = length;
+
+    // Splices shorter than the search span play without alignment
+    if (spliceLength < static_cast<size_t>(kRegionLength + kFrameSize))
+    {
+      searchPhase_ = SearchPhase::Done;
+      return wrapped;
+    }
+
+    // Reference: what the newest frame would play next
+    double refStart = origin + curStart_ + static_cast<double>(kHop) * readRate;
+    gatherMono(buffer, spliceStart, spliceLength, refStart, ref_.data(), kCorrLength);
+
+    // Candidates: target +- tolerance
+    regionStart_ = std::floor(analysisPos_) - kTolerance;
+    gatherMono(buffer, spliceStart, spliceLength, origin + regionStart_, region_.data(),
+               kRegionLength);
+
+    prefixEnergy_[0] = 0.0;
+    for (int i = 0; i < kRegionLength; i++)
+    {
+      prefixEnergy_[i + 1] = prefixEnergy_[i] + static_cast<double>(region_[i]) * region_[i];
+    }
+
+    searchPhase_ = SearchPhase::Coarse;
+    searchCursor_ = 0;
+    bestScore_ = -1e30f;
+    bestOffset_ = kTolerance;
+    return wrapped;
+  }
+
+  float score(int offset) const noexcept
+  {
+    float corr = Simd::dot(ref_.data(), region_.data() + offset, kCorrLength);
+    double energy = prefixEnergy_[offset + kCorrLength] - prefixEnergy_[offset];
+    return corr / static_cast<float>(std::sqrt(energy + 1e-9));
+  }
+
+  void consider(int offset) noexcept
+  {
+    float s = score(offset);
+    if (s > bestScore_)
+    {
+      bestScore_ = s;
+      bestOffset_ = offset;
+    }
+  }
+
+  // Evaluate up to budget candidates
+  void stepSearch(int budget) noexcept
+  {
+    const int kMaxOffset = 2 * kTolerance;
+    while (budget > 0 && searchPhase_ != SearchPhase::Done)
+    {
+      if (searchPhase_ == SearchPhase::Coarse)
+      {
+        consider(searchCursor_);
+        searchCursor_ += kCoarseStep;
+        if (searchCursor_ > kMaxOffset)
+        {
+          searchPhase_ = SearchPhase::Fine;
+          fineCenter_ = bestOffset_;
+          searchCursor_ = -kFineRadius;
+        }
+      }
+      else
+      {
+        int offset = fineCenter_ + searchCursor_;
+        if (searchCursor_ != 0 && offset >= 0 && offset <= kMaxOffset)
+          consider(offset);
+        if (++searchCursor_ > kFineRadius)
+        {
+          searchPhase_ = SearchPhase::Done;
+          nextStart_ = wrap(regionStart_ + bestOffset_, searchLength_);
+        }
+      }
+      budget--;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // State
+  //--------------------------------------------------------------------------
+
+  std::array<float, kFrameSize> window_;
+
+  double analysisPos_ = 0.0;  // Ideal start of the next frame (tempo-scaled)
+  double curStart_ = 0.0;     // Newest frame start
+  double prevStart_ = 0.0;    // Previous frame start
+  double nextStart_ = 0.0;    // Aligned start for the next frame
+  float lastReadRate_ = 1.0f;
+  int hopIndex_ = 0;
+  bool hasPrev_ = false;
+  bool needsSearch_ = true;
+
+  // Correlation search
+  std::array<float, kCorrLength> ref_;
+  std::array<float, kRegionLength> region_;
+  std::array<double, kRegionLength + 1> prefixEnergy_;
+  double regionStart_ = 0.0;
+  double searchLength_ = 1.0;
+  SearchPhase searchPhase_ = SearchPhase::Done;
+  int searchCursor_ = 0;
+  int fineCenter_ = 0;
+  int bestOffset_ = 0;
+  float bestScore_ = 0.0f;
+};
+
+} // namespace ShortwavDSP
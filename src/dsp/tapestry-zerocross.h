@@ -0,0 +1,326 @@
+#pragma once
+
+#include "tapestry-core.h"
+#include "tapestry-buffer.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Tapestry Zero-Crossing Index
+ *
+ * Compact index of the zero crossings in a reel, used to snap new splice
+ * markers to a nearby crossing so splice boundaries don't click.
+ *
+ * Features:
+ * - One bit per frame, summarized by two coarser bitmap levels
+ * - O(1) incremental updates as frames are recorded
+ * - O(log n) nearest-crossing search (three 64-way levels)
+ * - Pre-allocated for the maximum reel length (~1 MB)
+ *
+ * A crossing at frame f means the mono sum (L + R) changes sign between
+ * frames f - 1 and f. Snapping to f places the marker on the first sample
+ * of the new polarity.
+ */
+
+namespace ShortwavDSP
+{
+
+class ZeroCrossingIndex
+{
+public:
+  static constexpr size_t kMaxFrames = TapestryConfig::kMaxReelFrames;
+
+  ZeroCrossingIndex()
+  {
+    // Pre-allocate all levels for the maximum reel length
+    level0_.resize(wordsFor(kMaxFrames), 0);
+    level1_.resize(wordsFor(level0_.size()), 0);
+    level2_.resize(wordsFor(level1_.size()), 0);
+  }
+
+  //--------------------------------------------------------------------------
+  // Index Maintenance
+  //--------------------------------------------------------------------------
+
+  void clear() noexcept
+  {
+    // Only the words that can hold set bits need to be cleared
+    size_t words = wordsFor(highWater_);
+    std::fill(level0_.begin(), level0_.begin() + words, 0);
+    std::fill(level1_.begin(), level1_.begin() + wordsFor(words), 0);
+    std::fill(level2_.begin(), level2_.end(), 0);
+    highWater_ = 0;
+    count_ = 0;
+  }
+
+  // Re-scan the whole buffer (after loading a reel)
+  void rebuild(const TapestryBuffer &buffer) noexcept
+  {
+    clear();
+    updateRange(buffer, 0, buffer.getUsedFrames());
+  }
+
+  // Refresh after a single frame was written.
+  // Writing frame f affects the crossings at f and f + 1.
+  void update(const TapestryBuffer &buffer, size_t frame) noexcept
+  {
+    refreshBit(buffer, frame);
+    refreshBit(buffer, frame + 1);
+  }
+
+  // Refresh after frames [startFrame, endFrame) were written or cleared
+  void updateRange(const TapestryBuffer &buffer, size_t startFrame, size_t endFrame) noexcept
+  {
+    endFrame = std::min(endFrame, kMaxFrames - 1);
+    for (size_t f = startFrame; f <= endFrame; f++)
+    {
+      refreshBit(buffer, f);
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // Queries
+  //--------------------------------------------------------------------------
+
+  size_t getNumCrossings() const noexcept { return count_; }
+
+  bool isCrossing(size_t frame) const noexcept
+  {
+    if (frame >= kMaxFrames)
+      return false;
+    return (level0_[frame >> 6] >> (frame & 63)) & 1u;
+  }
+
+  // Smallest crossing >= frame, or kNone
+  size_t findNext(size_t frame) const noexcept
+  {
+    if (frame >= kMaxFrames)
+      return kNone;
+
+    // Search the remainder of the current level-0 word
+    size_t w0 = frame >> 6;
+    uint64_t bits = level0_[w0] & (~uint64_t(0) << (frame & 63));
+    if (bits)
+      return (w0 << 6) + ctz(bits);
+
+    // Next non-empty level-0 word, via level 1
+    size_t w1 = nextSet(level1_, level2_, w0 + 1);
+    if (w1 == kNone)
+      return kNone;
+    return (w1 << 6) + ctz(level0_[w1]);
+  }
+
+  // Largest crossing <= frame, or kNone
+  size_t findPrev(size_t frame) const noexcept
+  {
+    if (frame >= kMaxFrames)
+      frame = kMaxFrames - 1;
+
+    size_t w0 = frame >> 6;
+    unsigned shift = 63u - static_cast<unsigned>(frame & 63);
+    uint64_t bits = level0_[w0] & (~uint64_t(0) >> shift);
+    if (bits)
+      return (w0 << 6) + 63u - clz(bits);
+
+    if (w0 == 0)
+      return kNone;
+    size_t w1 = prevSet(level1_, level2_, w0 - 1);
+    if (w1 == kNone)
+      return kNone;
+    return (w1 << 6) + 63u - clz(level0_[w1]);
+  }
+
+  // Nearest crossing within maxDistance frames of frame.
+  // Returns frame unchanged when there is none.
+  size_t snap(size_t frame, size_t maxDistance) const noexcept
+  {
+    if (maxDistance == 0)
+      return frame;
+
+    size_t prev = findPrev(frame);
+    size_t next = findNext(frame);
+    size_t prevDist = (prev != kNone) ? frame - prev : kNone;
+    size_t nextDist = (next != kNone) ? next - frame : kNone;
+
+    if (prevDist <= nextDist && prevDist <= maxDistance)
+      return prev;
+    if (nextDist <= maxDistance)
+      return next;
+    return frame;
+  }
+
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+private:
+  //--------------------------------------------------------------------------
+  // Internal Methods
+  //--------------------------------------------------------------------------
+
+  static constexpr size_t wordsFor(size_t bits) noexcept
+  {
+    return (bits + 63) / 64;
+  }
+
+  static unsigned ctz(uint64_t x) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    while (!(x & 1u))
+    {
+      x >>= 1;
+      n++;
+    }
+    return n;
+#endif
+  }
+
+  static unsigned clz(uint64_t x) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_clzll(x));
+#else
+    unsigned n = 0;
+    while (!(x & (uint64_t(1) << 63)))
+    {
+      x <<= 1;
+      n++;
+    }
+    return n;
+#endif
+  }
+
+  // Sign of the mono sum, with zero counted as positive
+  static bool isNegative(const float *data, size_t frame) noexcept
+  {
+    return (data[frame * 2] + data[frame * 2 + 1]) < 0.0f;
+  }
+
+  void refreshBit(const TapestryBuffer &buffer, size_t frame) noexcept
+  {
+    if (frame == 0 || frame >= kMaxFrames)
+      return;
+
+    bool crossing = false;
+    if (frame < buffer.getUsedFrames())
+    {
+      const float *data = buffer.data();
+      crossing = isNegative(data, frame - 1) != isNegative(data, frame);
+    }
+
+    if (crossing)
+      setBit(frame);
+    else
+      clearBit(frame);
+  }
+
+  void setBit(size_t frame) noexcept
+  {
+    size_t w0 = frame >> 6;
+    uint64_t mask = uint64_t(1) << (frame & 63);
+    if (level0_[w0] & mask)
+      return;
+
+    count_++;
+    highWater_ = std::max(highWater_, frame + 1);
+
+    bool wasEmpty = level0_[w0] == 0;
+    level0_[w0] |= mask;
+    if (wasEmpty)
+    {
+      size_t w1 = w0 >> 6;
+      wasEmpty = level1_[w1] == 0;
+      level1_[w1] |= uint64_t(1) << (w0 & 63);
+      if (wasEmpty)
+      {
+        level2_[w1 >> 6] |= uint64_t(1) << (w1 & 63);
+      }
+    }
+  }
+
+  void clearBit(size_t frame) noexcept
+  {
+    size_t w0 = frame >> 6;
+    uint64_t mask = uint64_t(1) << (frame & 63);
+    if (!(level0_[w0] & mask))
+      return;
+
+    count_--;
+    level0_[w0] &= ~mask;
+    if (level0_[w0] == 0)
+    {
+      size_t w1 = w0 >> 6;
+      level1_[w1] &= ~(uint64_t(1) << (w0 & 63));
+      if (level1_[w1] == 0)
+      {
+        level2_[w1 >> 6] &= ~(uint64_t(1) << (w1 & 63));
+      }
+    }
+  }
+
+  // Index of the first set bit >= bit in a two-level bitmap, or kNone
+  static size_t nextSet(const std::vector<uint64_t> &lower,
+                        const std::vector<uint64_t> &upper, size_t bit) noexcept
+  {
+    size_t word = bit >> 6;
+    if (word >= lower.size())
+      return kNone;
+
+    uint64_t bits = lower[word] & (~uint64_t(0) << (bit & 63));
+    if (bits)
+      return (word << 6) + ctz(bits);
+
+    // Scan the top level (at most 32 words for a full reel)
+    size_t top = (word + 1) >> 6;
+    if (top >= upper.size())
+      return kNone;
+    uint64_t topBits = upper[top] & (~uint64_t(0) << ((word + 1) & 63));
+    while (!topBits)
+    {
+      if (++top >= upper.size())
+        return kNone;
+      topBits = upper[top];
+    }
+    size_t nextWord = (top << 6) + ctz(topBits);
+    return (nextWord << 6) + ctz(lower[nextWord]);
+  }
+
+  // Index of the last set bit <= bit in a two-level bitmap, or kNone
+  static size_t prevSet(const std::vector<uint64_t> &lower,
+                        const std::vector<uint64_t> &upper, size_t bit) noexcept
+  {
+    size_t word = bit >> 6;
+    unsigned shift = 63u - static_cast<unsigned>(bit & 63);
+    uint64_t bits = lower[word] & (~uint64_t(0) >> shift);
+    if (bits)
+      return (word << 6) + 63u - clz(bits);
+
+    if (word == 0)
+      return kNone;
+    size_t prevWord = word - 1;
+    size_t top = prevWord >> 6;
+    uint64_t topBits = upper[top] & (~uint64_t(0) >> (63u - static_cast<unsigned>(prevWord & 63)));
+    while (!topBits)
+    {
+      if (top == 0)
+        return kNone;
+      topBits = upper[--top];
+    }
+    size_t foundWord = (top << 6) + 63u - clz(topBits);
+    return (foundWord << 6) + 63u - clz(lower[foundWord]);
+  }
+
+  //--------------------------------------------------------------------------
+  // State
+  //--------------------------------------------------------------------------
+
+  std::vector<uint64_t> level0_;  // One bit per frame
+  std::vector<uint64_t> level1_;  // One bit per non-empty level-0 word
+  std::vector<uint64_t> level2_;  // One bit per non-empty level-1 word
+  size_t highWater_ = 0;          // One past the highest frame ever set
+  size_t count_ = 0;
+};
+
+} // namespace ShortwavDSP
@@ -0,0 +1,971 @@
+// Microbenchmarks for Tapestry DSP hot paths
+//
+// Benchmarks cover:
+// - Lookup tables: Lut::exp2 and Lut::powInt against the std::pow calls
+//   they replace in the parameter mappings
+// - Recording: per-frame mixAndWrite against block writes over a span
+// - Buffer: readStereoInterpolatedBounded at random positions in a splice
+// - Grain engine: GrainEngine::process at every MorphState tier
+// - Full DSP: TapestryDSP::process while playing and while recording
+// - Splices: SpliceManager operations on a reel with 300 splices
+// - Effects: BitCrusherDSP and MoogVCFDSP, with and without the per-sample
+//   setParams call the expander makes
+// - Interpolation: Resample::readStereo for every InterpolationQuality
+// - File I/O: WAV encode/parse and a write/read round trip
+//
+// Design principles:
+// - Use only public APIs
+// - Inputs precomputed outside the timed loop
+// - Results accumulated into a sink so the optimizer keeps the work
+// - Warmup runs are discarded; the median of the timed runs is reported,
+//   with the median absolute deviation (MAD) and min/max to show the spread
+// - `--json <file>` writes every result as JSON for regression tracking
+// - `--baseline <file>` compares against an earlier --json file and exits
+//   with status 1 when a benchmark is slower by more than the threshold
+//   (`--threshold <percent>`, default 10) and by more than the noise
+//   (3 standard deviations of both runs combined). Pass `--baseline` once
+//   per file recorded by separate processes to include the run-to-run
+//   spread; flagged groups are re-measured before failing.
+// - `--filter <group,...>` runs only the named groups
+
+#include <algorithm>
+#include <cstddef>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../dsp/tapestry-core.h"
+#include "../dsp/tapestry-buffer.h"
+#include "../dsp/tapestry-dsp.h"
+#include "../dsp/tapestry-effects.h"
+#include "../dsp/tapestry-grain.h"
+#include "../dsp/tapestry-lut.h"
+#include "../dsp/tapestry-resample.h"
+#include "../dsp/tapestry-splice.h"
+#include "../dsp/tapestry-wav.h"
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Minimal Benchmark Framework
+//------------------------------------------------------------------------------
+
+volatile float gSink = 0.0f;
+
+const int kWarmupRuns = 2;
+const int kTimedRuns = 15;
+
+struct BenchResult
+{
+  std::string name;
+  std::string group;
+  std::string unit;   // What one op is: "op", "sample", "call", ...
+  double nsPerOp;     // Median of the timed runs
+  double madNsPerOp;  // Median absolute deviation from nsPerOp
+  double minNsPerOp;
+  double maxNsPerOp;
+};
+
+std::vector<BenchResult> gResults;
+std::string gGroup;
+
+void beginGroup(const char *group, const char *title)
+{
+  gGroup = group;
+  std::printf("--- %s ---\n", title);
+}
+
+// Times body(), which performs opsPerRun ops and returns a value for the sink
+template <class Body>
+BenchResult measure(const char *name, const char *unit, size_t opsPerRun, Body body)
+{
+  for (int run = 0; run < kWarmupRuns; run++)
+  {
+    gSink = gSink + body();
+  }
+
+  std::vector<double> nsPerOp;
+  for (int run = 0; run < kTimedRuns; run++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    float acc = body();
+    auto end = std::chrono::steady_clock::now();
+    gSink = gSink + acc;
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    nsPerOp.push_back(ns / static_cast<double>(opsPerRun));
+  }
+  std::sort(nsPerOp.begin(), nsPerOp.end());
+  double median = nsPerOp[nsPerOp.size() / 2];
+  std::vector<double> deviations;
+  for (double ns : nsPerOp)
+  {
+    deviations.push_back(std::fabs(ns - median));
+  }
+  std::sort(deviations.begin(), deviations.end());
+
+  BenchResult result;
+  result.name = name;
+  result.group = gGroup;
+  result.unit = unit;
+  result.nsPerOp = median;
+  result.madNsPerOp = deviations[deviations.size() / 2];
+  result.minNsPerOp = nsPerOp.front();
+  result.maxNsPerOp = nsPerOp.back();
+  gResults.push_back(result);
+
+  std::printf("  %-44s %9.3f ns/%-6s %9.2f M%s/s  (MAD %.3f, min %.3f, max %.3f)\n", name,
+              result.nsPerOp, unit, 1e3 / result.nsPerOp, unit, result.madNsPerOp, result.minNsPerOp,
+              result.maxNsPerOp);
+  return result;
+}
+
+// fn(input) once per element of inputs; one op per element
+template <class Fn>
+BenchResult runBench(const char *name, const std::vector<float> &inputs, Fn fn)
+{
+  return measure(name, "op", inputs.size(), [&]() {
+    float acc = 0.0f;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+      acc += fn(inputs[i]);
+    }
+    return acc;
+  });
+}
+
+void printSpeedup(const BenchResult &baseline, const BenchResult &candidate)
+{
+  std::printf("  -> %s is %.2fx faster than %s\n\n", candidate.name.c_str(),
+              baseline.nsPerOp / candidate.nsPerOp, baseline.name.c_str());
+}
+
+// Deterministic inputs spread over [lo, hi)
+std::vector<float> makeInputs(size_t count, float lo, float hi)
+{
+  std::vector<float> inputs(count);
+  ShortwavDSP::TapestryUtil::FastRandom random(0xBE7Cu);
+  for (size_t i = 0; i < count; i++)
+  {
+    inputs[i] = random.nextRange(lo, hi);
+  }
+  return inputs;
+}
+
+//------------------------------------------------------------------------------
+// Lookup Table Benchmarks
+//------------------------------------------------------------------------------
+
+void bench_lut()
+{
+  using namespace ShortwavDSP;
+  const size_t kCount = 1 << 20;
+
+  beginGroup("lut", "Lookup Table Benchmarks");
+
+  // Vari-Speed: semitones to ratio
+  std::vector<float> semitones = makeInputs(kCount, -24.0f, 12.0f);
+  BenchResult powRatio = runBench("std::pow(2, semitones / 12)", semitones,
+                                  [](float s) { return std::pow(2.0f, s / 12.0f); });
+  BenchResult lutRatio = runBench("Lut::semitonesToRatio", semitones,
+                                  [](float s) { return Lut::semitonesToRatio(s); });
+  printSpeedup(powRatio, lutRatio);
+
+  // Gene size curve
+  std::vector<float> normalized = makeInputs(kCount, 0.0f, 1.0f);
+  BenchResult powCurve = runBench("std::pow(x, 4)", normalized,
+                                  [](float x) { return std::pow(x, 4.0f); });
+  BenchResult lutCurve = runBench("Lut::powInt<4>", normalized,
+                                  [](float x) { return Lut::powInt<4>(x); });
+  printSpeedup(powCurve, lutCurve);
+
+  // Moog cutoff: 20Hz * (maxFreq / 20Hz)^cutoff
+  const float ratio = 20000.0f / 20.0f;
+  const float octaves = std::log2(ratio);
+  BenchResult powCutoff = runBench("std::pow(ratio, cutoff)", normalized,
+                                   [ratio](float c) { return 20.0f * std::pow(ratio, c); });
+  BenchResult lutCutoff = runBench("Lut::exp2(cutoff * octaves)", normalized,
+                                   [octaves](float c) { return 20.0f * Lut::exp2(c * octaves); });
+  printSpeedup(powCutoff, lutCutoff);
+}
+
+//------------------------------------------------------------------------------
+// Recording Benchmarks
+//------------------------------------------------------------------------------
+
+void bench_recording()
+{
+  using namespace ShortwavDSP;
+  const size_t kSpan = 32;
+  const size_t kSpans = 1 << 14;
+
+  beginGroup("recording", "Recording Benchmarks (32-frame spans, one op per span)");
+
+  // Each input picks a span start; one op writes kSpan frames
+  std::vector<float> starts = makeInputs(kSpans, 0.0f, 1.0f);
+  std::vector<float> live = makeInputs(kSpan * 2, -1.0f, 1.0f);
+  std::vector<float> sos(kSpan * 2, 0.5f);
+  std::unique_ptr<TapestryBuffer> buffer(new TapestryBuffer());
+  const float range = static_cast<float>(TapestryBuffer::kMaxFrames - kSpan);
+  buffer->setUsedFrames(TapestryBuffer::kMaxFrames);
+
+  TapestryBuffer &reel = *buffer;
+  BenchResult perFrame = runBench("mixAndWrite per frame", starts,
+                                  [&](float u) {
+                                    size_t frame = static_cast<size_t>(u * range);
+                                    for (size_t i = 0; i < kSpan; i++)
+                                      reel.mixAndWrite(frame + i, live[i * 2], live[i * 2 + 1], sos[i * 2]);
+                                    return reel.data()[frame * 2];
+                                  });
+  BenchResult block = runBench("writeBlock (SoundOnSound)", starts,
+                               [&](float u) {
+                                 size_t frame = static_cast<size_t>(u * range);
+                                 reel.writeBlock(frame, live.data(), sos.data(), kSpan,
+                                                 TapestryBuffer::BlockMode::SoundOnSound);
+                                 return reel.data()[frame * 2];
+                               });
+  printSpeedup(perFrame, block);
+}
+
+//------------------------------------------------------------------------------
+// Buffer Benchmarks
+//------------------------------------------------------------------------------
+
+const size_t kReelFrames = 480000;   // 10 s at 48 kHz
+const size_t kBlockFrames = 48000;   // Samples per timed run for per-sample paths
+
+// Reel of deterministic noise
+void fillReel(ShortwavDSP::TapestryBuffer &buffer, size_t frames)
+{
+  std::vector<float> noise = makeInputs(frames * 2, -0.8f, 0.8f);
+  for (size_t i = 0; i < frames; i++)
+  {
+    buffer.writeStereo(i, noise[i * 2], noise[i * 2 + 1]);
+  }
+}
+
+void bench_buffer()
+{
+  using namespace ShortwavDSP;
+  const size_t kCount = 1 << 18;
+  const size_t kSpliceStart = 100000;
+  const size_t kSpliceEnd = 300000;
+
+  beginGroup("buffer", "Buffer Benchmarks");
+
+  std::unique_ptr<TapestryBuffer> buffer(new TapestryBuffer());
+  fillReel(*buffer, kReelFrames);
+  const TapestryBuffer &reel = *buffer;
+
+  std::vector<float> positions = makeInputs(kCount, static_cast<float>(kSpliceStart),
+                                            static_cast<float>(kSpliceEnd));
+  runBench("readStereoInterpolatedBounded", positions, [&](float position) {
+    float l, r;
+    reel.readStereoInterpolatedBounded(position, kSpliceStart, kSpliceEnd, l, r);
+    return l + r;
+  });
+  std::printf("\n");
+}
+
+//------------------------------------------------------------------------------
+// Grain Engine Benchmarks
+//------------------------------------------------------------------------------
+
+void bench_grain()
+{
+  using namespace ShortwavDSP;
+
+  beginGroup("grain", "Grain Engine Benchmarks (per output sample)");
+
+  std::unique_ptr<TapestryBuffer> buffer(new TapestryBuffer());
+  fillReel(*buffer, kReelFrames);
+  const TapestryBuffer &reel = *buffer;
+
+  // One Morph position inside each MorphState tier
+  struct Tier
+  {
+    const char *name;
+    float morph;
+  };
+  const Tier kTiers[] = {
+      {"GrainEngine::process gaps (1 voice)", 0.10f},
+      {"GrainEngine::process seamless (1 voice)", 0.30f},
+      {"GrainEngine::process overlap (2 voices)", 0.40f},
+      {"GrainEngine::process panned (3 voices)", 0.60f},
+      {"GrainEngine::process pitch rand (4 voices)", 0.85f},
+  };
+
+  VariSpeedState speed;
+  speed.speedRatio = 1.0f;
+  for (const Tier &tier : kTiers)
+  {
+    std::unique_ptr<GrainEngine> engine(new GrainEngine());
+    engine->setSampleRate(48000.0f);
+    engine->setGeneSize(4800.0f);
+    engine->setMorphState(TapestryUtil::calculateMorphState(tier.morph));
+    engine->setVariSpeed(speed);
+    engine->retrigger(0.0f);
+
+    GrainEngine &grain = *engine;
+    measure(tier.name, "sample", kBlockFrames, [&]() {
+      float acc = 0.0f;
+      for (size_t i = 0; i < kBlockFrames; i++)
+      {
+        float l, r;
+        bool endOfGene;
+        grain.process(reel, 0, kReelFrames, l, r, endOfGene);
+        acc += l + r;
+      }
+      return acc;
+    });
+  }
+  std::printf("\n");
+}
+
+//------------------------------------------------------------------------------
+// Full DSP Benchmarks
+//------------------------------------------------------------------------------
+
+void bench_dsp()
+{
+  using namespace ShortwavDSP;
+
+  beginGroup("dsp", "TapestryDSP Benchmarks (per output sample)");
+
+  std::vector<float> reel = makeInputs(kReelFrames * 2, -0.8f, 0.8f);
+  std::vector<float> input = makeInputs(kBlockFrames * 2, -0.5f, 0.5f);
+
+  for (int recording = 0; recording < 2; recording++)
+  {
+    std::unique_ptr<TapestryDSP> dsp(new TapestryDSP());
+    dsp->setSampleRate(48000.0f);
+    dsp->loadReel(reel.data(), kReelFrames);
+    dsp->setMorph(0.4f);
+    dsp->setGeneSize(0.5f);
+    dsp->setVariSpeed(0.75f);
+    if (recording)
+      dsp->startRecordingSameSplice();
+
+    TapestryDSP &tapestry = *dsp;
+    measure(recording ? "TapestryDSP::process (record)" : "TapestryDSP::process (play)", "sample",
+            kBlockFrames, [&]() {
+              float acc = 0.0f;
+              for (size_t i = 0; i < kBlockFrames; i++)
+              {
+                TapestryDSP::ProcessResult result = tapestry.process(input[i * 2], input[i * 2 + 1]);
+                acc += result.audioOutL + result.audioOutR;
+              }
+              return acc;
+            });
+  }
+  std::printf("\n");
+}
+
+//------------------------------------------------------------------------------
+// Splice Manager Benchmarks
+//------------------------------------------------------------------------------
+
+void bench_splices()
+{
+  using namespace ShortwavDSP;
+  const size_t kCount = 1 << 16;
+  const size_t kSplices = SpliceManager::kMaxSplices;
+
+  beginGroup("splice", "SpliceManager Benchmarks (300 splices)");
+
+  SpliceManager manager;
+  manager.initialize(kReelFrames);
+  for (size_t s = 1; s < kSplices; s++)
+  {
+    manager.addMarker(kReelFrames * s / kSplices);
+  }
+
+  std::vector<float> organize = makeInputs(kCount, 0.0f, 1.0f);
+  runBench("setOrganize", organize, [&](float param) {
+    manager.setOrganize(param);
+    return static_cast<float>(manager.getCurrentIndex());
+  });
+
+  runBench("shift + onEndOfSplice", organize, [&](float) {
+    manager.shift();
+    manager.onEndOfSplice();
+    return static_cast<float>(manager.getCurrentIndex());
+  });
+
+  // Remove a marker and put it back, so the splice count stays at 300
+  runBench("deleteMarkerAtIndex + addMarker", organize, [&](float u) {
+    int index = 1 + static_cast<int>(u * static_cast<float>(kSplices - 2));
+    size_t frame = manager.getSplice(index)->startFrame;
+    manager.deleteMarkerAtIndex(index);
+    manager.addMarker(frame);
+    return static_cast<float>(manager.getNumSplices());
+  });
+  std::printf("\n");
+}
+
+//------------------------------------------------------------------------------
+// Effects Benchmarks
+//------------------------------------------------------------------------------
+
+void bench_effects()
+{
+  beginGroup("effects", "Effects Benchmarks (per stereo sample)");
+
+  std::vector<float> input = makeInputs(kBlockFrames * 2, -0.9f, 0.9f);
+  std::vector<float> control = makeInputs(kBlockFrames, 0.0f, 1.0f);
+
+  BitCrusherDSP crusher;
+  crusher.setParams(8.0f, 0.25f);
+  measure("BitCrusherDSP::processStereo", "sample", kBlockFrames, [&]() {
+    float acc = 0.0f;
+    for (size_t i = 0; i < kBlockFrames; i++)
+    {
+      float l, r;
+      crusher.processStereo(input[i * 2], input[i * 2 + 1], l, r);
+      acc += l + r;
+    }
+    return acc;
+  });
+  measure("BitCrusherDSP setParams + processStereo", "sample", kBlockFrames, [&]() {
+    float acc = 0.0f;
+    for (size_t i = 0; i < kBlockFrames; i++)
+    {
+      float l, r;
+      crusher.setParams(4.0f + control[i] * 8.0f, control[i] * 0.5f);
+      crusher.processStereo(input[i * 2], input[i * 2 + 1], l, r);
+      acc += l + r;
+    }
+    return acc;
+  });
+
+  MoogVCFDSP filterL;
+  MoogVCFDSP filterR;
+  filterL.setParams(0.5f, 0.7f, 48000.0f);
+  filterR.setParams(0.5f, 0.7f, 48000.0f);
+  measure("MoogVCFDSP::process (L+R)", "sample", kBlockFrames, [&]() {
+    float acc = 0.0f;
+    for (size_t i = 0; i < kBlockFrames; i++)
+    {
+      acc += filterL.process(input[i * 2]) + filterR.process(input[i * 2 + 1]);
+    }
+    return acc;
+  });
+  measure("MoogVCFDSP setParams + process (L+R)", "sample", kBlockFrames, [&]() {
+    float acc = 0.0f;
+    for (size_t i = 0; i < kBlockFrames; i++)
+    {
+      filterL.setParams(control[i], 0.7f, 48000.0f);
+      filterR.setParams(control[i], 0.7f, 48000.0f);
+      acc += filterL.process(input[i * 2]) + filterR.process(input[i * 2 + 1]);
+    }
+    return acc;
+  });
+  std::printf("\n");
+
+  // The whole expander chain, one frame per call (per-sample messaging)
+  // against the 32-frame blocks of the expander transport
+  ExpanderEffectChain::Params params;
+  params.bits = 8.0f;
+  params.rate = 0.25f;
+  params.crushMix = 0.5f;
+  params.cutoff = 0.5f;
+  params.resonance = 0.7f;
+  params.filterMix = 0.8f;
+  ExpanderEffectChain chain;
+  chain.setImmediate(params);
+  std::vector<float> left(kBlockFrames);
+  std::vector<float> right(kBlockFrames);
+  auto runChain = [&](size_t blockFrames) {
+    float acc = 0.0f;
+    for (size_t i = 0; i < kBlockFrames; i++)
+    {
+      left[i] = input[i * 2];
+      right[i] = input[i * 2 + 1];
+    }
+    for (size_t i = 0; i < kBlockFrames; i += blockFrames)
+    {
+      params.cutoff = control[i];
+      chain.setTargets(params);
+      chain.process(&left[i], &right[i], static_cast<int>(blockFrames));
+      acc += left[i] + right[i];
+    }
+    return acc;
+  };
+  BenchResult perSample = measure("ExpanderEffectChain (1-frame blocks)", "sample", kBlockFrames,
+                                  [&]() { return runChain(1); });
+  BenchResult block = measure("ExpanderEffectChain (32-frame blocks)", "sample", kBlockFrames,
+                              [&]() { return runChain(32); });
+  printSpeedup(perSample, block);
+}
+
+//------------------------------------------------------------------------------
+// Interpolation Benchmarks
+//------------------------------------------------------------------------------
+
+// Times one Resample kernel through Resample::dispatch
+struct InterpolationBench
+{
+  const char *name;
+  const ShortwavDSP::TapestryBuffer &reel;
+  const std::vector<float> &positions;
+  size_t spliceStart;
+  size_t spliceEnd;
+
+  template <class Kernel>
+  void run()
+  {
+    Kernel::prepare();
+    runBench(name, positions, [this](float position) {
+      float l, r;
+      ShortwavDSP::Resample::readStereo<Kernel>(reel, position, spliceStart, spliceEnd, 1.5f, l, r);
+      return l + r;
+    });
+  }
+};
+
+void bench_interpolation()
+{
+  using namespace ShortwavDSP;
+  const size_t kCount = 1 << 18;
+  const size_t kSpliceStart = 100000;
+  const size_t kSpliceEnd = 300000;
+
+  beginGroup("interpolation", "Interpolation Benchmarks (1.5x read increment)");
+
+  std::unique_ptr<TapestryBuffer> buffer(new TapestryBuffer());
+  fillReel(*buffer, kReelFrames);
+  std::vector<float> positions = makeInputs(kCount, static_cast<float>(kSpliceStart),
+                                            static_cast<float>(kSpliceEnd));
+
+  const char *const kNames[] = {"Resample::readStereo None", "Resample::readStereo Linear",
+                                "Resample::readStereo Hermite", "Resample::readStereo Lagrange6",
+                                "Resample::readStereo Sinc8", "Resample::readStereo Sinc16",
+                                "Resample::readStereo Sinc32"};
+  static_assert(sizeof(kNames) / sizeof(kNames[0]) ==
+                    static_cast<size_t>(InterpolationQuality::NUM_QUALITIES),
+                "every quality needs a benchmark name");
+  for (int q = 0; q < static_cast<int>(InterpolationQuality::NUM_QUALITIES); q++)
+  {
+    InterpolationBench bench = {kNames[q], *buffer, positions, kSpliceStart, kSpliceEnd};
+    Resample::dispatch(static_cast<InterpolationQuality>(q), bench);
+  }
+  std::printf("\n");
+}
+
+//------------------------------------------------------------------------------
+// File I/O Benchmarks
+//------------------------------------------------------------------------------
+
+void bench_wav()
+{
+  using namespace ShortwavDSP;
+  const size_t kFrames = kReelFrames;
+  const char *kTempPath = "bench_tapestry_tmp.wav";
+
+  beginGroup("wav", "WAV File I/O Benchmarks (10 s stereo, per frame)");
+
+  std::vector<float> audio = makeInputs(kFrames * 2, -0.9f, 0.9f);
+  std::vector<uint8_t> floatImage = Wav::encode(audio.data(), kFrames, 48000, Wav::Format::Float32);
+  std::vector<uint8_t> pcmImage = Wav::encode(audio.data(), kFrames, 48000, Wav::Format::Pcm16);
+
+  measure("Wav::encode Float32", "frame", kFrames, [&]() {
+    return static_cast<float>(Wav::encode(audio.data(), kFrames, 48000, Wav::Format::Float32).size());
+  });
+  measure("Wav::encode Pcm16", "frame", kFrames, [&]() {
+    return static_cast<float>(Wav::encode(audio.data(), kFrames, 48000, Wav::Format::Pcm16).size());
+  });
+
+  Wav::Audio decoded;
+  std::string error;
+  measure("Wav::parse Float32", "frame", kFrames, [&]() {
+    Wav::parse(floatImage.data(), floatImage.size(), decoded, error);
+    return decoded.samples[0];
+  });
+  measure("Wav::parse Pcm16", "frame", kFrames, [&]() {
+    Wav::parse(pcmImage.data(), pcmImage.size(), decoded, error);
+    return decoded.samples[0];
+  });
+
+  measure("Wav::write + Wav::read Float32 file", "frame", kFrames, [&]() {
+    if (!Wav::write(kTempPath, audio.data(), kFrames, 48000, Wav::Format::Float32, error) ||
+        !Wav::read(kTempPath, decoded, error))
+    {
+      std::fprintf(stderr, "error: %s\n", error.c_str());
+      return 0.0f;
+    }
+    return decoded.samples[0];
+  });
+  std::remove(kTempPath);
+  std::printf("\n");
+}
+
+//------------------------------------------------------------------------------
+// JSON Output
+//------------------------------------------------------------------------------
+
+std::string jsonString(const std::string &text)
+{
+  std::string out = "\"";
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+bool writeJson(const char *path)
+{
+  FILE *file = std::fopen(path, "w");
+  if (!file)
+    return false;
+
+  std::fprintf(file, "{\n");
+  std::fprintf(file, "  \"format\": \"tapestry-bench\",\n");
+  std::fprintf(file, "  \"version\": 1,\n");
+  std::fprintf(file, "  \"compiler\": %s,\n", jsonString(__VERSION__).c_str());
+  std::fprintf(file, "  \"warmup_runs\": %d,\n", kWarmupRuns);
+  std::fprintf(file, "  \"timed_runs\": %d,\n", kTimedRuns);
+  std::fprintf(file, "  \"benchmarks\": [\n");
+  for (size_t i = 0; i < gResults.size(); i++)
+  {
+    const BenchResult &r = gResults[i];
+    std::fprintf(file,
+                 "    {\"name\": %s, \"group\": %s, \"unit\": %s, \"ns_per_op\": %.4f, "
+                 "\"mad_ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, \"max_ns_per_op\": %.4f, "
+                 "\"ops_per_second\": %.1f}%s\n",
+                 jsonString(r.name).c_str(), jsonString(r.group).c_str(), jsonString(r.unit).c_str(),
+                 r.nsPerOp, r.madNsPerOp, r.minNsPerOp, r.maxNsPerOp, 1e9 / r.nsPerOp,
+                 (i + 1 < gResults.size()) ? "," : "");
+  }
+  std::fprintf(file, "  ]\n}\n");
+  return std::fclose(file) == 0;
+}
+
+//------------------------------------------------------------------------------
+// Baseline Comparison
+//------------------------------------------------------------------------------
+
+struct BaselineEntry
+{
+  std::string name;
+  std::string group;
+  std::vector<double> nsPerOp;     // Median of each baseline file
+  std::vector<double> madNsPerOp;
+};
+
+// Value of "key": in a line written by writeJson (one benchmark per line)
+bool findJsonString(const std::string &line, const char *key, std::string &value)
+{
+  std::string pattern = std::string("\"") + key + "\": \"";
+  size_t pos = line.find(pattern);
+  if (pos == std::string::npos)
+    return false;
+  value.clear();
+  for (pos += pattern.size(); pos < line.size() && line[pos] != '"'; pos++)
+  {
+    if (line[pos] == '\\' && pos + 1 < line.size())
+      pos++;
+    value += line[pos];
+  }
+  return pos < line.size();
+}
+
+bool findJsonNumber(const std::string &line, const char *key, double &value)
+{
+  std::string pattern = std::string("\"") + key + "\": ";
+  size_t pos = line.find(pattern);
+  if (pos == std::string::npos)
+    return false;
+  value = std::strtod(line.c_str() + pos + pattern.size(), nullptr);
+  return true;
+}
+
+// Adds one baseline file's results to entries (several files are runs of
+// separate processes and are pooled per benchmark)
+bool readBaseline(const char *path, std::vector<BaselineEntry> &entries)
+{
+  FILE *file = std::fopen(path, "r");
+  if (!file)
+    return false;
+
+  bool found = false;
+  std::string line;
+  int c;
+  while ((c = std::fgetc(file)) != EOF)
+  {
+    if (c != '\n')
+    {
+      line += static_cast<char>(c);
+      continue;
+    }
+    std::string name;
+    double nsPerOp = 0.0;
+    if (findJsonString(line, "name", name) && findJsonNumber(line, "ns_per_op", nsPerOp))
+    {
+      double mad = 0.0;
+      findJsonNumber(line, "mad_ns_per_op", mad);
+
+      BaselineEntry *entry = nullptr;
+      for (BaselineEntry &e : entries)
+      {
+        if (e.name == name)
+          entry = &e;
+      }
+      if (!entry)
+      {
+        entries.push_back(BaselineEntry());
+        entry = &entries.back();
+        entry->name = name;
+        findJsonString(line, "group", entry->group);
+      }
+      entry->nsPerOp.push_back(nsPerOp);
+      entry->madNsPerOp.push_back(mad);
+      found = true;
+    }
+    line.clear();
+  }
+  std::fclose(file);
+  return found;
+}
+
+double median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// Sample standard deviation (0 for a single value)
+double standardDeviation(const std::vector<double> &values)
+{
+  if (values.size() < 2)
+    return 0.0;
+  double mean = 0.0;
+  for (double v : values)
+  {
+    mean += v;
+  }
+  mean /= static_cast<double>(values.size());
+  double sumSq = 0.0;
+  for (double v : values)
+  {
+    sumSq += (v - mean) * (v - mean);
+  }
+  return std::sqrt(sumSq / static_cast<double>(values.size() - 1));
+}
+
+const BenchResult *findResult(const std::string &name)
+{
+  for (const BenchResult &result : gResults)
+  {
+    if (result.name == name)
+      return &result;
+  }
+  return nullptr;
+}
+
+// A benchmark regresses when its median is slower than the baseline median
+// by more than thresholdPercent AND by more than 3 standard deviations of
+// the two runs combined. Within a run MAD * 1.4826 estimates the standard
+// deviation without being thrown off by outlier runs; with several baseline
+// files the standard deviation of their medians is used when larger, since
+// whole processes run faster or slower than each other. Returns the
+// regression count and the groups they belong to.
+int compareToBaseline(const std::vector<BaselineEntry> &baseline, double thresholdPercent,
+                      std::vector<std::string> &regressedGroups)
+{
+  const double kMadToSigma = 1.4826;
+  int regressions = 0;
+  regressedGroups.clear();
+  std::printf("--- Baseline Comparison (threshold %.1f%%) ---\n", thresholdPercent);
+  for (const BenchResult &result : gResults)
+  {
+    const BaselineEntry *base = nullptr;
+    for (const BaselineEntry &entry : baseline)
+    {
+      if (entry.name == result.name)
+        base = &entry;
+    }
+    if (!base)
+    {
+      std::printf("  %-44s %9.3f ns   (new, no baseline)\n", result.name.c_str(), result.nsPerOp);
+      continue;
+    }
+
+    double baseNs = median(base->nsPerOp);
+    double baseSigma = std::max(kMadToSigma * median(base->madNsPerOp), standardDeviation(base->nsPerOp));
+    double newSigma = kMadToSigma * result.madNsPerOp;
+    double delta = result.nsPerOp - baseNs;
+    double percent = (baseNs > 0.0) ? 100.0 * delta / baseNs : 0.0;
+    double noise = 3.0 * std::sqrt(baseSigma * baseSigma + newSigma * newSigma);
+    bool significant = std::fabs(delta) > noise;
+    const char *verdict = "ok";
+    if (significant && percent > thresholdPercent)
+    {
+      verdict = "REGRESSION";
+      regressions++;
+      if (std::find(regressedGroups.begin(), regressedGroups.end(), result.group) == regressedGroups.end())
+        regressedGroups.push_back(result.group);
+    }
+    else if (significant && percent < -thresholdPercent)
+    {
+      verdict = "faster";
+    }
+    std::printf("  %-44s %9.3f -> %9.3f ns  %+7.1f%%  (noise %.3f ns)  %s\n", result.name.c_str(),
+                baseNs, result.nsPerOp, percent, noise, verdict);
+  }
+
+  // Baseline benchmarks this run did not produce: renamed or removed when
+  // their group ran, otherwise filtered out
+  int filtered = 0;
+  for (const BaselineEntry &entry : baseline)
+  {
+    if (findResult(entry.name))
+      continue;
+    bool groupRan = false;
+    for (const BenchResult &result : gResults)
+    {
+      if (result.group == entry.group)
+        groupRan = true;
+    }
+    if (groupRan)
+      std::printf("  %-44s %9.3f ns   (missing from this run)\n", entry.name.c_str(), median(entry.nsPerOp));
+    else
+      filtered++;
+  }
+  if (filtered > 0)
+    std::printf("%d baseline benchmark(s) not run (filtered out)\n", filtered);
+
+  std::printf("%d regression(s)\n", regressions);
+  return regressions;
+}
+
+struct BenchGroup
+{
+  const char *name;
+  void (*run)();
+};
+
+// Runs the named groups again and keeps each benchmark's faster median, so
+// a regression has to reproduce to count
+void remeasure(const std::vector<std::string> &names, const BenchGroup *groups, size_t numGroups)
+{
+  size_t first = gResults.size();
+  for (size_t g = 0; g < numGroups; g++)
+  {
+    if (std::find(names.begin(), names.end(), groups[g].name) != names.end())
+      groups[g].run();
+  }
+  for (size_t i = first; i < gResults.size(); i++)
+  {
+    for (size_t j = 0; j < first; j++)
+    {
+      if (gResults[j].name == gResults[i].name && gResults[i].nsPerOp < gResults[j].nsPerOp)
+        gResults[j] = gResults[i];
+    }
+  }
+  gResults.erase(gResults.begin() + static_cast<std::ptrdiff_t>(first), gResults.end());
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+// Main Entry Point
+//------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  const BenchGroup kGroups[] = {
+      {"lut", bench_lut},
+      {"recording", bench_recording},
+      {"buffer", bench_buffer},
+      {"interpolation", bench_interpolation},
+      {"grain", bench_grain},
+      {"dsp", bench_dsp},
+      {"splice", bench_splices},
+      {"effects", bench_effects},
+      {"wav", bench_wav},
+  };
+
+  const char *jsonPath = nullptr;
+  std::vector<const char *> baselinePaths;
+  std::string filter;
+  double thresholdPercent = 10.0;
+  for (int i = 1; i < argc; i++)
+  {
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--json") == 0 && hasValue)
+    {
+      jsonPath = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue)
+    {
+      baselinePaths.push_back(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue)
+    {
+      thresholdPercent = std::atof(argv[++i]);
+    }
+    else if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+    {
+      filter = std::string(",") + argv[++i] + ",";
+    }
+    else
+    {
+      std::fprintf(stderr,
+                   "usage: %s [--json <file>] [--baseline <file>]... [--threshold <percent>]\n"
+                   "       [--filter <group,...>]\n"
+                   "groups: lut recording buffer interpolation grain dsp splice effects wav\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+
+  // Read the baselines first, so a bad path fails before the long run
+  std::vector<BaselineEntry> baseline;
+  for (const char *path : baselinePaths)
+  {
+    if (!readBaseline(path, baseline))
+    {
+      std::fprintf(stderr, "error: cannot read baseline %s\n", path);
+      return 2;
+    }
+  }
+
+  std::printf("Median of %d runs after %d warmup runs\n\n", kTimedRuns, kWarmupRuns);
+  for (const BenchGroup &group : kGroups)
+  {
+    if (filter.empty() || filter.find(std::string(",") + group.name + ",") != std::string::npos)
+      group.run();
+  }
+
+  if (jsonPath)
+  {
+    if (!writeJson(jsonPath))
+    {
+      std::fprintf(stderr, "error: cannot write %s\n", jsonPath);
+      return 2;
+    }
+    std::printf("Wrote %zu results to %s\n", gResults.size(), jsonPath);
+  }
+
+  if (baselinePaths.empty())
+    return 0;
+
+  const int kRemeasureRuns = 3;
+  std::vector<std::string> regressed;
+  int regressions = compareToBaseline(baseline, thresholdPercent, regressed);
+  for (int attempt = 1; attempt <= kRemeasureRuns && regressions > 0; attempt++)
+  {
+    std::printf("\nRe-measuring %zu group(s) with regressions (attempt %d of %d)\n\n", regressed.size(),
+                attempt, kRemeasureRuns);
+    remeasure(regressed, kGroups, sizeof(kGroups) / sizeof(kGroups[0]));
+    regressions = compareToBaseline(baseline, thresholdPercent, regressed);
+  }
+  return (regressions > 0) ? 1 : 0;
+}
@@ -5,22 +5,49 @@
 // - SpliceManager: splice marker creation, deletion, and navigation
 // - GrainEngine: granular synthesis with multiple voices
 // - TapestryDSP: integrated DSP processor
+// - Real-time safety: audio-thread calls run with allocation, lock and time
+//   budget checks armed (see RtCheck)
 //
 // Design principles:
 // - Use only public APIs
 // - Fast, allocation-free hot paths
 // - Simple assertion-style testing
 
+#include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
 #include <cmath>
+#include <ctime>
+#include <new>
 #include <vector>
 #include <limits>
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
 #include "../dsp/tapestry-core.h"
 #include "../dsp/tapestry-buffer.h"
 #include "../dsp/tapestry-splice.h"
 #include "../dsp/tapestry-grain.h"
 #include "../dsp/tapestry-dsp.h"
 #include "../dsp/tapestry-effects.h"
+#include "../dsp/tapestry-zerocross.h"
+#include "../dsp/tapestry-analysis.h"
+#include "../dsp/tapestry-tempo.h"
+#include "../dsp/tapestry-spectral.h"
+#include "../dsp/tapestry-resample.h"
+#include "../dsp/tapestry-poly.h"
+#include "../dsp/tapestry-multitap.h"
+#include "../dsp/tapestry-lut.h"
+#include "../dsp/tapestry-wav.h"
+#include "../dsp/tapestry-render.h"
+#include "../dsp/tapestry-telemetry.h"
+#include "../dsp/tapestry-trace.h"
+#include "../dsp/tapestry-denormal.h"
+#include "../TapestryExpanderMessage.hpp"
+#include "../tools/tapestry-pool.h"
 
 // C++11 requires definitions for static constexpr members that are ODR-used
 namespace ShortwavDSP
@@ -51,8 +78,170 @@ namespace ShortwavDSP
   constexpr size_t SpliceManager::kMaxSplices;
   
   constexpr int GrainEngine::kMaxVoices;
+  constexpr int GrainEngine::kMaxStretchSubdivisions;
+  constexpr float GrainEngine::kMaxSpectralStretch;
+
+  constexpr size_t ZeroCrossingIndex::kMaxFrames;
+
+  constexpr size_t SpliceFeatureCache::kMaxSplices;
+
+  constexpr size_t TempoAnalyzer::kHopFrames;
+  constexpr size_t TempoAnalyzer::kMaxHops;
+  constexpr size_t TempoAnalyzer::kMinBeats;
+
+  constexpr int Telemetry::kNumStages;
+  constexpr int Telemetry::kBlockSamples;
+  constexpr int Telemetry::kHistoryBlocks;
+
+  constexpr size_t TraceRing::kCapacity;
+  constexpr double UnderrunDetector::kDefaultToleranceSeconds;
+  constexpr double UnderrunDetector::kDriftTolerance;
+  constexpr double UnderrunDetector::kBufferDecay;
+}
+
+//------------------------------------------------------------------------------
+// Real-Time Safety Instrumentation
+//------------------------------------------------------------------------------
+//
+// Allocation and lock hooks, armed only while a test runs audio-thread code
+// (see RtProbe). With glibc, malloc/calloc/realloc/free and the aligned
+// variants are interposed and forward to the __libc_* implementations, and
+// pthread_mutex_lock/trylock forward through dlsym(RTLD_NEXT). Elsewhere
+// only the global operator new/delete are replaced and locks are not seen.
+
+namespace RtCheck
+{
+
+std::atomic<bool> gArmed(false);
+std::atomic<int> gAllocations(0);
+std::atomic<int> gFrees(0);
+std::atomic<int> gLocks(0);
+
+inline void count(std::atomic<int> &counter) noexcept
+{
+  if (gArmed.load(std::memory_order_relaxed))
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+// CPU time of the calling thread, so preemption does not count against the
+// time budget
+inline double threadSeconds() noexcept
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+} // namespace RtCheck
+
+#if defined(__GLIBC__)
+
+extern "C"
+{
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+void *__libc_memalign(size_t alignment, size_t size);
+
+void *malloc(size_t size) __THROW
+{
+  RtCheck::count(RtCheck::gAllocations);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) __THROW
+{
+  RtCheck::count(RtCheck::gAllocations);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) __THROW
+{
+  RtCheck::count(RtCheck::gAllocations);
+  return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) __THROW
+{
+  if (ptr)
+    RtCheck::count(RtCheck::gFrees);
+  __libc_free(ptr);
+}
+
+void *memalign(size_t alignment, size_t size) __THROW
+{
+  RtCheck::count(RtCheck::gAllocations);
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) __THROW
+{
+  RtCheck::count(RtCheck::gAllocations);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) __THROW
+{
+  RtCheck::count(RtCheck::gAllocations);
+  void *ptr = __libc_memalign(alignment, size);
+  if (!ptr)
+    return ENOMEM;
+  *out = ptr;
+  return 0;
+}
+
+typedef int (*MutexFn)(pthread_mutex_t *);
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) __THROWNL
+{
+  static MutexFn real = reinterpret_cast<MutexFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+  RtCheck::count(RtCheck::gLocks);
+  return real(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex) __THROWNL
+{
+  static MutexFn real = reinterpret_cast<MutexFn>(dlsym(RTLD_NEXT, "pthread_mutex_trylock"));
+  RtCheck::count(RtCheck::gLocks);
+  return real(mutex);
+}
+} // extern "C"
+
+#else
+
+void *operator new(size_t size)
+{
+  RtCheck::count(RtCheck::gAllocations);
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void *operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (ptr)
+    RtCheck::count(RtCheck::gFrees);
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  operator delete(ptr);
 }
 
+#endif
+
 namespace
 {
 
@@ -1935,120 +2124,4254 @@ void test_splice_count_replacement(TestContext &ctx)
 }
 
 //------------------------------------------------------------------------------
-// Test Runner
+// ZeroCrossingIndex tests
 //------------------------------------------------------------------------------
 
-void run_all_tapestry_tests()
+void test_zerocross_find_and_snap(TestContext &ctx)
 {
-  TestContext ctx;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::ZeroCrossingIndex;
 
-  std::printf("\n=== Tapestry DSP Unit Tests ===\n\n");
+  TapestryBuffer buffer;
+  ZeroCrossingIndex index;
 
-  std::printf("--- TapestryUtil Tests ---\n");
-  test_util_clamp(ctx);
-  test_util_lerp(ctx);
-  test_util_hann_window(ctx);
-  test_util_cubic_interpolate(ctx);
-  test_util_varispeed_calculation(ctx);
-  test_util_fast_random(ctx);
+  // Square wave with a period of 200 frames: crossings every 100 frames
+  for (size_t i = 0; i < 1000; i++)
+  {
+    float v = ((i / 100) % 2 == 0) ? 0.5f : -0.5f;
+    buffer.writeStereo(i, v, v);
+  }
+  index.rebuild(buffer);
 
-  std::printf("--- TapestryBuffer Tests ---\n");
-  test_buffer_basic_operations(ctx);
-  test_buffer_interpolation(ctx);
-  test_buffer_bounded_interpolation(ctx);
-  test_buffer_sound_on_sound(ctx);
-  test_buffer_bulk_operations(ctx);
-  test_buffer_clear_range(ctx);
+  T_ASSERT(ctx, index.getNumCrossings() == 9);
+  T_ASSERT(ctx, index.isCrossing(100));
+  T_ASSERT(ctx, !index.isCrossing(150));
 
-  std::printf("--- SpliceManager Tests ---\n");
-  test_splice_initialization(ctx);
-  test_splice_marker_creation(ctx);
-  test_splice_marker_deletion(ctx);
-  test_splice_navigation_shift(ctx);
-  test_splice_navigation_organize(ctx);
-  test_splice_pending_system(ctx);
-  test_splice_organize_vs_shift_priority(ctx);
-  test_splice_extend_for_recording(ctx);
-  test_splice_delete_all(ctx);
+  T_ASSERT(ctx, index.findNext(101) == 200);
+  T_ASSERT(ctx, index.findPrev(199) == 100);
+  T_ASSERT(ctx, index.findNext(901) == ZeroCrossingIndex::kNone);
+  T_ASSERT(ctx, index.findPrev(99) == ZeroCrossingIndex::kNone);
 
-  std::printf("--- GrainEngine Tests ---\n");
-  test_grain_basic_setup(ctx);
-  test_grain_stopped_mode(ctx);
-  test_grain_retrigger(ctx);
-  test_grain_slide_parameter(ctx);
-  test_grain_reverse_playback(ctx);
-  test_grain_multiple_voices(ctx);
-  test_grain_position_wrapping(ctx);
+  // Snap to the nearer crossing within the window
+  T_ASSERT(ctx, index.snap(130, 50) == 100);
+  T_ASSERT(ctx, index.snap(180, 50) == 200);
 
-  std::printf("--- TapestryDSP Integration Tests ---\n");
-  test_dsp_initialization(ctx);
-  test_dsp_basic_recording(ctx);
-  test_dsp_playback_basic(ctx);
-  test_dsp_varispeed_stopped(ctx);
-  test_dsp_splice_creation(ctx);
-  test_dsp_shift_navigation(ctx);
-  test_dsp_morph_parameter(ctx);
-  test_dsp_sound_on_sound(ctx);
-  test_dsp_organize_parameter(ctx);
-  test_dsp_slide_parameter(ctx);
-  test_dsp_gene_size_parameter(ctx);
-  test_dsp_clear_operations(ctx);
+  // Outside the window the position is left unchanged
+  T_ASSERT(ctx, index.snap(150, 10) == 150);
+  T_ASSERT(ctx, index.snap(150, 0) == 150);
+}
 
-  std::printf("--- Overdub Mode Tests ---\n");
-  test_dsp_overdub_mode_default_off(ctx);
-  test_dsp_overdub_mode_toggle(ctx);
-  test_dsp_overdub_mode_replace_behavior(ctx);
-  test_dsp_overdub_mode_keep_existing(ctx);
-  test_dsp_overdub_mode_reset(ctx);
+void test_zerocross_sparse_long_range(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::ZeroCrossingIndex;
 
-  std::printf("--- Clear Markers Tests ---\n");
-  test_dsp_clear_all_markers(ctx);
-  test_dsp_clear_markers_preserves_audio(ctx);
-  test_dsp_clear_markers_empty_buffer(ctx);
+  TapestryBuffer buffer;
+  ZeroCrossingIndex index;
 
-  std::printf("--- Edge Cases and Stress Tests ---\n");
-  test_edge_empty_splice(ctx);
-  test_edge_max_splices(ctx);
-  test_edge_buffer_boundaries(ctx);
-  test_stress_continuous_playback(ctx);
+  // Two crossings far apart, so the search must go through the upper levels
+  const size_t frames = 600000;
+  buffer.setUsedFrames(frames);
+  buffer.writeStereo(0, 0.25f, 0.25f);
+  for (size_t i = 0; i < frames; i++)
+  {
+    float v = (i >= 5000 && i < 550000) ? -0.25f : 0.25f;
+    buffer.writeStereo(i, v, v);
+    index.update(buffer, i);
+  }
 
-  std::printf("--- BitCrusherDSP Tests ---\n");
-  test_bitcrusher_initialization(ctx);
-  test_bitcrusher_reset(ctx);
-  test_bitcrusher_bit_depth_reduction(ctx);
-  test_bitcrusher_sample_rate_reduction(ctx);
-  test_bitcrusher_stereo_processing(ctx);
-  test_bitcrusher_parameter_limits(ctx);
+  T_ASSERT(ctx, index.getNumCrossings() == 2);
+  T_ASSERT(ctx, index.findNext(5001) == 550000);
+  T_ASSERT(ctx, index.findPrev(549999) == 5000);
+  T_ASSERT(ctx, index.findNext(0) == 5000);
+  T_ASSERT(ctx, index.findPrev(frames - 1) == 550000);
 
-  std::printf("--- MoogVCFDSP Tests ---\n");
-  test_moog_filter_initialization(ctx);
-  test_moog_filter_reset(ctx);
-  test_moog_filter_lowpass_response(ctx);
-  test_moog_filter_cutoff_frequency(ctx);
-  test_moog_filter_resonance(ctx);
-  test_moog_filter_stability(ctx);
-  test_moog_filter_dc_blocking(ctx);
-  test_moog_filter_four_pole_response(ctx);
-  test_moog_filter_sample_rate_adaptation(ctx);
+  // Overwriting the second edge removes it incrementally
+  buffer.writeStereo(550000, -0.25f, -0.25f);
+  index.update(buffer, 550000);
+  T_ASSERT(ctx, index.findNext(5001) == 550001);
 
-  std::printf("--- Splice Count Distribution Tests ---\n");
-  test_splice_count_even_distribution(ctx);
-  test_splice_count_boundary_cases(ctx);
-  test_splice_count_replacement(ctx);
+  index.clear();
+  T_ASSERT(ctx, index.getNumCrossings() == 0);
+  T_ASSERT(ctx, index.findNext(0) == ZeroCrossingIndex::kNone);
+}
 
-  std::printf("\n");
-  ctx.summary();
-  std::printf("\n");
+void test_dsp_marker_snaps_to_zero_crossing(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+
+  TapestryDSP dsp;
+  dsp.setSampleRate(48000.0f);
+
+  // Record a 100Hz square wave (crossings every 240 frames)
+  dsp.clearAndStartRecording(false);
+  for (int i = 0; i < 4800; i++)
+  {
+    float v = ((i / 240) % 2 == 0) ? 0.5f : -0.5f;
+    dsp.process(v, v);
+  }
+  dsp.stopRecordingRequest(false);
+
+  T_ASSERT(ctx, dsp.getZeroCrossingIndex().getNumCrossings() > 0);
+
+  // Marker requested between crossings lands on the nearest one
+  dsp.onSpliceTrigger(1000);
+  const auto *second = dsp.getSpliceManager().getSplice(1);
+  T_ASSERT(ctx, second != nullptr);
+  T_ASSERT(ctx, second && second->startFrame == 960);
+
+  // Snapping disabled: exact placement
+  dsp.setZeroCrossingSnap(0);
+  dsp.onSpliceTrigger(3000);
+  bool foundExact = false;
+  for (const auto &splice : dsp.getSpliceManager().getAllSplices())
+  {
+    foundExact = foundExact || splice.startFrame == 3000;
+  }
+  T_ASSERT(ctx, foundExact);
+
+  // The window is 10ms at any sample rate
+  dsp.setZeroCrossingSnap(TapestryDSP::kDefaultZeroCrossingSnapSeconds);
+  T_ASSERT(ctx, dsp.getZeroCrossingSnap() == 480);
+  dsp.setSampleRate(96000.0f);
+  T_ASSERT(ctx, dsp.getZeroCrossingSnap() == 960);
+  dsp.setSampleRate(192000.0f);
+  T_ASSERT(ctx, dsp.getZeroCrossingSnap() == 1920);
+  dsp.setSampleRate(44100.0f);
+  T_ASSERT(ctx, dsp.getZeroCrossingSnap() == 441);
 }
 
-} // anonymous namespace
+//------------------------------------------------------------------------------
+// Splice Feature Cache Tests
+//------------------------------------------------------------------------------
+
+void test_triple_buffer_latest_wins(TestContext &ctx)
+{
+  using ShortwavDSP::TripleBuffer;
+
+  TripleBuffer<int> tb;
+  T_ASSERT(ctx, tb.front() == nullptr);
+  T_ASSERT(ctx, !tb.update());
+
+  // Consumer only ever sees the most recent publication
+  tb.back() = 1;
+  tb.publish();
+  tb.back() = 2;
+  tb.publish();
+  T_ASSERT(ctx, tb.update());
+  T_ASSERT(ctx, tb.front() && *tb.front() == 2);
+
+  // Nothing new: front stays put
+  T_ASSERT(ctx, !tb.update());
+  T_ASSERT(ctx, tb.front() && *tb.front() == 2);
+
+  tb.back() = 3;
+  tb.publish();
+  T_ASSERT(ctx, tb.update());
+  T_ASSERT(ctx, tb.front() && *tb.front() == 3);
+}
+
+void test_feature_cache_invalidation(TestContext &ctx)
+{
+  using ShortwavDSP::OrganizeSortMode;
+  using ShortwavDSP::SpliceFeatureCache;
+  using ShortwavDSP::SpliceManager;
+  using ShortwavDSP::TapestryBuffer;
+
+  // Three splices: loud/dark, quiet/bright, medium/dark
+  TapestryBuffer buffer;
+  for (size_t i = 0; i < 3000; i++)
+  {
+    float v;
+    if (i < 1000)
+      v = 0.8f;
+    else if (i < 2000)
+      v = (i % 2) ? 0.1f : -0.1f;
+    else
+      v = 0.4f;
+    buffer.writeStereo(i, v, v);
+  }
+
+  SpliceManager splices;
+  splices.initialize(3000);
+  splices.addMarker(1000);
+  splices.addMarker(2000);
+
+  SpliceFeatureCache cache;
+  T_ASSERT(ctx, !cache.update(buffer));  // Nothing published yet
+
+  cache.publishSplices(splices, buffer, false);
+  T_ASSERT(ctx, cache.update(buffer));
+  T_ASSERT(ctx, !cache.update(buffer));  // Cached
+
+  const auto *table = cache.acquire(splices.getVersion());
+  T_ASSERT(ctx, table != nullptr);
+  if (!table)
+    return;
+  T_ASSERT(ctx, table->count == 3);
+  T_ASSERT_NEAR(ctx, table->features[0].rms, 0.8f, 1e-4f);
+  T_ASSERT_NEAR(ctx, table->features[1].peak, 0.1f, 1e-4f);
+  T_ASSERT(ctx, table->features[1].centroidHz > table->features[0].centroidHz);
+
+  const uint16_t *byRms = table->getOrder(OrganizeSortMode::Rms);
+  T_ASSERT(ctx, byRms[0] == 1 && byRms[1] == 2 && byRms[2] == 0);
+  const uint16_t *byBrightness = table->getOrder(OrganizeSortMode::Centroid);
+  T_ASSERT(ctx, byBrightness[2] == 1);
+  T_ASSERT(ctx, table->getOrder(OrganizeSortMode::Position) == nullptr);
+
+  // Buffer writes invalidate the cache once a snapshot is published
+  buffer.writeStereo(10, 0.0f, 0.0f);
+  T_ASSERT(ctx, !cache.update(buffer));
+  cache.publishSplices(splices, buffer, false);
+  T_ASSERT(ctx, cache.update(buffer));
+
+  // Nothing is published while recording
+  buffer.writeStereo(3000, 0.5f, 0.5f);
+  cache.publishSplices(splices, buffer, true);
+  T_ASSERT(ctx, !cache.update(buffer));
+  cache.publishSplices(splices, buffer, false);
+  T_ASSERT(ctx, cache.getLayout()->usedFrames == 3000);  // Not received yet
+  T_ASSERT(ctx, cache.update(buffer));
+  T_ASSERT(ctx, cache.getLayout()->usedFrames == 3001);
+
+  // A pass that overlaps a write is dropped and not retried
+  buffer.writeStereo(20, 0.0f, 0.0f);
+  cache.publishSplices(splices, buffer, false);
+  buffer.writeStereo(21, 0.0f, 0.0f);
+  T_ASSERT(ctx, !cache.update(buffer));
+  T_ASSERT(ctx, !cache.update(buffer));
+
+  // Layout changes invalidate the cache; stale tables are not handed out
+  splices.addMarker(2500);
+  cache.publishSplices(splices, buffer, false);
+  T_ASSERT(ctx, cache.acquire(splices.getVersion()) == nullptr);
+  T_ASSERT(ctx, cache.update(buffer));
+  table = cache.acquire(splices.getVersion());
+  T_ASSERT(ctx, table && table->count == 4);
+}
+
+void test_dsp_organize_by_loudness(TestContext &ctx)
+{
+  using ShortwavDSP::OrganizeSortMode;
+  using ShortwavDSP::TapestryDSP;
+
+  TapestryDSP dsp;
+  dsp.setSampleRate(48000.0f);
+  dsp.setZeroCrossingSnap(0);
+
+  // Record three splices of different levels
+  const float levels[3] = {0.5f, 0.1f, 0.9f};
+  dsp.clearAndStartRecording(false);
+  for (int i = 0; i < 4800; i++)
+  {
+    float v = levels[i / 1600];
+    dsp.process(v, v);
+  }
+  dsp.stopRecordingRequest(false);
+  dsp.process(0.0f, 0.0f);
+
+  auto &splices = dsp.getSpliceManager();
+  splices.addMarker(1600);
+  splices.addMarker(3200);
+  T_ASSERT(ctx, splices.getNumSplices() == 3);
+
+  // Position order until features exist for this layout
+  dsp.setOrganizeSortMode(OrganizeSortMode::Rms);
+  dsp.process(0.0f, 0.0f);
+  dsp.setOrganize(0.0f);
+  T_ASSERT(ctx, splices.getCurrentIndex() == 0);
+
+  // After analysis the knob steps from quietest to loudest
+  T_ASSERT(ctx, dsp.runAnalysis());
+  dsp.process(0.0f, 0.0f);
+  dsp.setOrganize(1.0f);
+  T_ASSERT(ctx, splices.getCurrentIndex() == 2);
+  dsp.setOrganize(0.0f);
+  T_ASSERT(ctx, splices.getCurrentIndex() == 1);
+  dsp.setOrganize(0.5f);
+  T_ASSERT(ctx, splices.getCurrentIndex() == 0);
+
+  // Back to reel order
+  dsp.setOrganizeSortMode(OrganizeSortMode::Position);
+  dsp.process(0.0f, 0.0f);
+  dsp.setOrganize(0.0f);
+  T_ASSERT(ctx, splices.getCurrentIndex() == 0);
+}
 
 //------------------------------------------------------------------------------
-// Main Entry Point
+// Tempo Analysis Tests
 //------------------------------------------------------------------------------
 
-int main()
+// Decaying 2kHz clicks every periodFrames, starting at offsetFrames
+std::vector<float> makeClickTrack(size_t numFrames, size_t periodFrames, size_t offsetFrames)
+{
+  std::vector<float> data(numFrames * 2, 0.0f);
+  for (size_t beat = offsetFrames; beat < numFrames; beat += periodFrames)
+  {
+    for (size_t i = 0; i < 1000 && beat + i < numFrames; i++)
+    {
+      float v = 0.8f * std::exp(-static_cast<float>(i) / 150.0f) *
+                std::sin(2.0f * 3.14159265f * 2000.0f * static_cast<float>(i) / 48000.0f);
+      data[(beat + i) * 2] = v;
+      data[(beat + i) * 2 + 1] = v;
+    }
+  }
+  return data;
+}
+
+void test_tempo_detects_click_track(TestContext &ctx)
+{
+  using ShortwavDSP::BeatGrid;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::TempoAnalyzer;
+
+  TempoAnalyzer analyzer;
+  TapestryBuffer buffer;
+
+  // 120 BPM, first beat at 3000
+  std::vector<float> clicks = makeClickTrack(960000, 24000, 3000);
+  buffer.copyFrom(clicks.data(), 960000);
+  BeatGrid grid = analyzer.analyze(buffer);
+  T_ASSERT(ctx, grid.valid);
+  T_ASSERT_NEAR(ctx, grid.bpm, 120.0f, 0.5f);
+  T_ASSERT_NEAR(ctx, static_cast<float>(grid.periodFrames), 24000.0f, 100.0f);
+  T_ASSERT_NEAR(ctx, static_cast<float>(grid.offsetFrames), 3000.0f, 64.0f);
+  T_ASSERT(ctx, grid.getNumBeats() == 40);
+
+  // 90 BPM
+  clicks = makeClickTrack(960000, 32000, 0);
+  buffer.clear();
+  buffer.copyFrom(clicks.data(), 960000);
+  grid = analyzer.analyze(buffer);
+  T_ASSERT(ctx, grid.valid);
+  T_ASSERT_NEAR(ctx, grid.bpm, 90.0f, 0.5f);
+
+  // Silence and too-short reels have no tempo
+  buffer.clear();
+  buffer.setUsedFrames(960000);
+  T_ASSERT(ctx, !analyzer.analyze(buffer).valid);
+  buffer.clear();
+  buffer.copyFrom(clicks.data(), 48000);
+  T_ASSERT(ctx, !analyzer.analyze(buffer).valid);
+}
+
+void test_tempo_update_follows_snapshots(TestContext &ctx)
+{
+  using ShortwavDSP::BeatGrid;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::TempoAnalyzer;
+
+  TempoAnalyzer analyzer;
+  TapestryBuffer buffer;
+  std::vector<float> clicks = makeClickTrack(480000, 24000, 0);
+  buffer.copyFrom(clicks.data(), 480000);
+
+  BeatGrid grid;
+  T_ASSERT(ctx, !analyzer.fetch(grid));
+  T_ASSERT(ctx, analyzer.update(buffer, buffer.getVersion(), 480000));
+  T_ASSERT(ctx, analyzer.fetch(grid));
+  T_ASSERT(ctx, grid.valid);
+  T_ASSERT(ctx, grid.reelFrames == 480000);
+  T_ASSERT(ctx, !analyzer.fetch(grid));     // Nothing new
+  T_ASSERT(ctx, !analyzer.update(buffer, buffer.getVersion(), 480000));  // Already analyzed
+
+  // Analysis covers the snapshot's used frames only
+  buffer.writeStereo(480000, 0.0f, 0.0f);
+  T_ASSERT(ctx, analyzer.update(buffer, buffer.getVersion(), 480000));
+  T_ASSERT(ctx, analyzer.fetch(grid));
+  T_ASSERT(ctx, grid.reelFrames == 480000);
+
+  // Written during the pass: dropped, not republished
+  uint32_t stale = buffer.getVersion();
+  buffer.writeStereo(0, 0.0f, 0.0f);
+  T_ASSERT(ctx, !analyzer.update(buffer, stale, 480001));
+  T_ASSERT(ctx, !analyzer.fetch(grid));
+  T_ASSERT(ctx, !analyzer.update(buffer, stale, 480001));
+  T_ASSERT(ctx, analyzer.update(buffer, buffer.getVersion(), 480001));
+}
+
+void test_dsp_analysis_deferred_while_recording(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+
+  TapestryDSP dsp;
+  dsp.setSampleRate(48000.0f);
+
+  dsp.clearAndStartRecording(false);
+  for (int block = 0; block < 10; block++)
+  {
+    for (int i = 0; i < 4800; i++)
+    {
+      float v = 0.5f * std::sin(static_cast<float>(i) * 0.05f);
+      dsp.process(v, v);
+    }
+    T_ASSERT(ctx, !dsp.runAnalysis());  // Reel still growing
+  }
+
+  dsp.stopRecordingRequest(false);
+  dsp.process(0.0f, 0.0f);
+  T_ASSERT(ctx, !dsp.isRecording());
+  T_ASSERT(ctx, dsp.runAnalysis());     // One pass over the finished reel
+  T_ASSERT(ctx, !dsp.runAnalysis());
+  for (int i = 0; i < 4800; i++)
+  {
+    dsp.process(0.0f, 0.0f);
+  }
+  T_ASSERT(ctx, !dsp.runAnalysis());   // Playback doesn't invalidate it
+}
+
+void test_splice_from_beat_grid(TestContext &ctx)
 {
+  using ShortwavDSP::BeatGrid;
+  using ShortwavDSP::SpliceManager;
+
+  SpliceManager mgr;
+  mgr.initialize(4500);
+
+  BeatGrid grid;
+  T_ASSERT(ctx, !mgr.setFromBeatGrid(grid, 1, 4500));  // Invalid grid
+  T_ASSERT(ctx, mgr.getNumSplices() == 1);
+
+  grid.valid = true;
+  grid.periodFrames = 1000.0;
+  grid.offsetFrames = 250.0;
+  grid.reelFrames = 4500;
+
+  // Pickup before the first beat, then one splice per beat
+  T_ASSERT(ctx, mgr.setFromBeatGrid(grid, 1, 4500));
+  T_ASSERT(ctx, mgr.getNumSplices() == 6);
+  T_ASSERT(ctx, mgr.getSplice(0)->endFrame == 250);
+  T_ASSERT(ctx, mgr.getSplice(1)->startFrame == 250 && mgr.getSplice(1)->endFrame == 1250);
+  T_ASSERT(ctx, mgr.getSplice(5)->endFrame == 4500);
+
+  T_ASSERT(ctx, mgr.setFromBeatGrid(grid, 2, 4500));
+  T_ASSERT(ctx, mgr.getNumSplices() == 4);
+  T_ASSERT(ctx, mgr.getSplice(2)->startFrame == 2250);
+
+  // Dense grids are thinned to fit the splice limit
+  grid.periodFrames = 10.0;
+  grid.offsetFrames = 0.0;
+  T_ASSERT(ctx, mgr.setFromBeatGrid(grid, 1, 100000));
+  T_ASSERT(ctx, mgr.getNumSplices() <= ShortwavDSP::TapestryConfig::kMaxSplices);
+  T_ASSERT(ctx, mgr.getNumSplices() > ShortwavDSP::TapestryConfig::kMaxSplices / 4);
+}
+
+void test_tempo_lock_ratio(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryUtil::calculateTempoLockRatio;
+
+  T_ASSERT_NEAR(ctx, calculateTempoLockRatio(24000.0, 24000.0f, 1.0f), 1.0f, 1e-6f);
+  T_ASSERT_NEAR(ctx, calculateTempoLockRatio(24000.0, 20000.0f, 1.0f), 1.2f, 1e-5f);
+  T_ASSERT_NEAR(ctx, calculateTempoLockRatio(24000.0, 30000.0f, 1.0f), 0.8f, 1e-5f);
+
+  // Clock at twice the beat rate folds back to unity
+  T_ASSERT_NEAR(ctx, calculateTempoLockRatio(24000.0, 12000.0f, 1.0f), 1.0f, 1e-6f);
+
+  // 96kHz engine: twice as many samples per clock, half the internal rate ratio
+  T_ASSERT_NEAR(ctx, calculateTempoLockRatio(24000.0, 48000.0f, 0.5f), 1.0f, 1e-6f);
+
+  // Missing clock leaves speed alone
+  T_ASSERT_NEAR(ctx, calculateTempoLockRatio(24000.0, 0.0f, 1.0f), 1.0f, 1e-6f);
+}
+
+void test_dsp_beat_grid_and_tempo_lock(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+
+  TapestryDSP dsp;
+  dsp.setSampleRate(48000.0f);
+
+  std::vector<float> clicks = makeClickTrack(960000, 24000, 3000);
+  dsp.loadReel(clicks.data(), 960000);
+  T_ASSERT(ctx, !dsp.spliceToBeatGrid(4));  // Not analyzed yet
+
+  dsp.process(0.0f, 0.0f);  // Publishes the reel snapshot
+  dsp.runAnalysis();
+  T_ASSERT(ctx, !dsp.getPublishedBeatGrid().valid);
+  dsp.process(0.0f, 0.0f);
+  T_ASSERT(ctx, dsp.getBeatGrid().valid);
+
+  // The UI reads its own copy, published by process()
+  T_ASSERT(ctx, dsp.getPublishedBeatGrid().valid);
+  T_ASSERT_NEAR(ctx, dsp.getPublishedBeatGrid().bpm, dsp.getBeatGrid().bpm, 1e-6f);
+
+  // 40 beats, one marker every 4 beats plus the pickup
+  T_ASSERT(ctx, dsp.spliceToBeatGrid(4));
+  T_ASSERT(ctx, dsp.getSpliceManager().getNumSplices() == 11);
+
+  // Clock at 144 BPM: reel speeds up by 144/120
+  dsp.setTempoLock(true);
+  dsp.setVariSpeed(0.75f);
+  for (int i = 0; i < 60000; i++)
+  {
+    if (i % 20000 == 0)
+      dsp.onClockRising();
+    dsp.process(0.0f, 0.0f);
+  }
+  T_ASSERT_NEAR(ctx, dsp.getVariSpeedState().speedRatio, 1.2f, 0.01f);
+
+  // Reverse keeps the knob's direction
+  dsp.setVariSpeed(0.25f);
+  dsp.process(0.0f, 0.0f);
+  T_ASSERT_NEAR(ctx, dsp.getVariSpeedState().speedRatio, -1.2f, 0.01f);
+
+  // Unlocked: knob speed again
+  dsp.setTempoLock(false);
+  dsp.setVariSpeed(0.5f);
+  dsp.process(0.0f, 0.0f);
+  T_ASSERT(ctx, dsp.getVariSpeedState().isStopped);
+
+  // Clearing the reel withdraws the UI copy too
+  dsp.clearReel();
+  T_ASSERT(ctx, dsp.getPublishedBeatGrid().valid);  // Until the next tick
+  dsp.process(0.0f, 0.0f);
+  T_ASSERT(ctx, !dsp.getPublishedBeatGrid().valid);
+}
+
+//------------------------------------------------------------------------------
+// Time Stretch Tests
+//------------------------------------------------------------------------------
+
+// Runs clocked playback and records the grain start after each clock edge
+void runClockedStretch(ShortwavDSP::GrainEngine &engine, const ShortwavDSP::TapestryBuffer &buffer,
+                       size_t spliceLength, int clockPeriod, int numClocks,
+                       std::vector<double> &startsAfterEdge)
+{
+  float outL, outR;
+  bool endOfGene;
+  for (int c = 0; c < numClocks; c++)
+  {
+    engine.onClockRising();
+    engine.process(buffer, 0, spliceLength, outL, outR, endOfGene);
+    startsAfterEdge.push_back(engine.getPlayheadPositionRelative());
+    for (int i = 1; i < clockPeriod; i++)
+    {
+      engine.process(buffer, 0, spliceLength, outL, outR, endOfGene);
+    }
+  }
+}
+
+void test_time_stretch_clock_layout(TestContext &ctx)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::MorphState;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::VariSpeedState;
+
+  TapestryBuffer buffer;
+  for (size_t i = 0; i < 48000; i++)
+  {
+    buffer.writeStereo(i, 0.25f, 0.25f);
+  }
+
+  MorphState morph;
+  morph.overlap = 3.0f;
+  morph.activeVoices = 3;
+
+  GrainEngine engine;
+  engine.setSampleRate(48000.0f);
+  engine.setGeneSize(2400.0f);
+  engine.setMorphState(morph);
+  engine.retrigger(0.0f);
+
+  // 1s splice, 250ms clock: the splice spans 4 clocks
+  std::vector<double> starts;
+  runClockedStretch(engine, buffer, 48000, 12000, 6, starts);
+  T_ASSERT(ctx, engine.isTimeStretchMode());
+  T_ASSERT(ctx, engine.getStretchClocksPerSplice() == 4);
+
+  // Grain hop is a whole subdivision of the clock near gene / overlap
+  double hop = engine.getStretchGrainHop();
+  T_ASSERT_NEAR(ctx, static_cast<float>(hop), 800.0f, 1e-3f);
+
+  // Each clock after the first lands on a fixed quarter of the splice
+  T_ASSERT(ctx, starts.size() == 6);
+  T_ASSERT_NEAR(ctx, static_cast<float>(starts[1]), 0.0f, 1e-3f);
+  T_ASSERT_NEAR(ctx, static_cast<float>(starts[2]), 12000.0f, 1e-3f);
+  T_ASSERT_NEAR(ctx, static_cast<float>(starts[3]), 24000.0f, 1e-3f);
+  T_ASSERT_NEAR(ctx, static_cast<float>(starts[4]), 36000.0f, 1e-3f);
+  T_ASSERT_NEAR(ctx, static_cast<float>(starts[5]), 0.0f, 1e-3f);
+}
+
+void test_time_stretch_independent_of_pitch(TestContext &ctx)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::MorphState;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::VariSpeedState;
+
+  TapestryBuffer buffer;
+  for (size_t i = 0; i < 48000; i++)
+  {
+    buffer.writeStereo(i, 0.25f, 0.25f);
+  }
+
+  MorphState morph;
+  morph.overlap = 3.0f;
+  morph.activeVoices = 3;
+
+  VariSpeedState octaveUp;
+  octaveUp.speedRatio = 2.0f;
+
+  GrainEngine engine;
+  engine.setSampleRate(48000.0f);
+  engine.setGeneSize(2400.0f);
+  engine.setMorphState(morph);
+  engine.setVariSpeed(octaveUp);
+  engine.retrigger(0.0f);
+
+  // Same splice/clock layout as at unity speed
+  std::vector<double> starts;
+  runClockedStretch(engine, buffer, 48000, 12000, 4, starts);
+  T_ASSERT(ctx, engine.getStretchClocksPerSplice() == 4);
+  T_ASSERT_NEAR(ctx, static_cast<float>(starts[2]), 12000.0f, 1e-3f);
+  T_ASSERT_NEAR(ctx, static_cast<float>(starts[3]), 24000.0f, 1e-3f);
+
+  // 96kHz engine: twice the samples per clock for the same layout
+  GrainEngine hiRate;
+  hiRate.setSampleRate(96000.0f);
+  hiRate.setGeneSize(2400.0f);
+  hiRate.setMorphState(morph);
+  hiRate.retrigger(0.0f);
+  starts.clear();
+  runClockedStretch(hiRate, buffer, 48000, 24000, 3, starts);
+  T_ASSERT(ctx, hiRate.getStretchClocksPerSplice() == 4);
+
+  // Below the Time Stretch threshold a clock shifts genes instead
+  morph.overlap = 1.0f;
+  morph.activeVoices = 1;
+  GrainEngine geneShift;
+  geneShift.setMorphState(morph);
+  geneShift.retrigger(0.0f);
+  starts.clear();
+  runClockedStretch(geneShift, buffer, 48000, 1000, 2, starts);
+  T_ASSERT(ctx, !geneShift.isTimeStretchMode());
+}
+
+//------------------------------------------------------------------------------
+// WSOLA Tests
+//------------------------------------------------------------------------------
+
+void test_simd_dot_matches_scalar(TestContext &ctx)
+{
+  std::vector<float> a(64), b(64);
+  for (size_t i = 0; i < a.size(); i++)
+  {
+    a[i] = std::sin(0.37f * static_cast<float>(i));
+    b[i] = std::cos(0.11f * static_cast<float>(i)) - 0.25f;
+  }
+
+  // Odd lengths and unaligned starts exercise the scalar tail
+  for (size_t offset = 0; offset < 3; offset++)
+  {
+    for (size_t n = 0; n + offset <= 61; n += 7)
+    {
+      float expected = 0.0f;
+      for (size_t i = 0; i < n; i++)
+      {
+        expected += a[offset + i] * b[offset + i];
+      }
+      T_ASSERT_NEAR(ctx, ShortwavDSP::Simd::dot(a.data() + offset, b.data() + offset, n),
+                    expected, 1e-4f);
+    }
+  }
+  T_ASSERT_NEAR(ctx, ShortwavDSP::Simd::sumSquares(a.data(), 0), 0.0f, kEpsilon);
+}
+
+struct WsolaRun
+{
+  int risingCrossings = 0;
+  int endOfGeneCount = 0;
+  float rms = 0.0f;
+  float maxStep = 0.0f;
+};
+
+// Render a 500Hz sine reel in WSOLA mode and measure the output
+WsolaRun renderWsola(float speedRatio, int numSamples)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::MorphState;
+  using ShortwavDSP::PlaybackMode;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::VariSpeedState;
+
+  static TapestryBuffer buffer;
+  for (size_t i = 0; i < 96000; i++)
+  {
+    float v = 0.5f * std::sin(2.0f * 3.14159265f * 500.0f * static_cast<float>(i) / 48000.0f);
+    buffer.writeStereo(i, v, v);
+  }
+
+  VariSpeedState speed;
+  speed.speedRatio = speedRatio;
+  speed.isForward = speedRatio > 0.0f;
+
+  GrainEngine engine;
+  engine.setSampleRate(48000.0f);
+  engine.setMorphState(MorphState());
+  engine.setVariSpeed(speed);
+  engine.setPlaybackMode(PlaybackMode::Wsola);
+  engine.retrigger(0.0f);
+
+  WsolaRun run;
+  float outL, outR;
+  bool endOfGene;
+  float prev = 0.0f;
+  double sumSq = 0.0;
+  const int kWarmup = 2048;
+  for (int i = 0; i < kWarmup + numSamples; i++)
+  {
+    engine.process(buffer, 0, 96000, outL, outR, endOfGene);
+    if (endOfGene)
+      run.endOfGeneCount++;
+    if (i >= kWarmup)
+    {
+      if (prev < 0.0f && outL >= 0.0f)
+        run.risingCrossings++;
+      run.maxStep = std::max(run.maxStep, std::fabs(outL - prev));
+      sumSq += static_cast<double>(outL) * outL;
+    }
+    prev = outL;
+  }
+  run.rms = static_cast<float>(std::sqrt(sumSq / numSamples));
+  return run;
+}
+
+void test_wsola_preserves_pitch(TestContext &ctx)
+{
+  // One second of output holds 500 cycles at any speed
+  const float speeds[] = {0.5f, 1.0f, 1.5f, -0.75f};
+  for (float speed : speeds)
+  {
+    WsolaRun run = renderWsola(speed, 48000);
+    T_ASSERT(ctx, run.risingCrossings >= 495 && run.risingCrossings <= 505);
+    T_ASSERT_NEAR(ctx, run.rms, 0.3536f, 0.02f);
+
+    // Aligned splice points: no steps beyond the sine's own slope (~0.033)
+    T_ASSERT(ctx, run.maxStep < 0.05f);
+  }
+}
+
+void test_wsola_speed_sets_tempo(TestContext &ctx)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::PlaybackMode;
+
+  // 2s splice at 1.5x: wraps once after ~1.33s
+  WsolaRun run = renderWsola(1.5f, 70000);
+  T_ASSERT(ctx, run.endOfGeneCount == 1);
+
+  // At 0.5x it takes 4s, so no wrap in 2s
+  run = renderWsola(0.5f, 94000);
+  T_ASSERT(ctx, run.endOfGeneCount == 0);
+
+  // Mode switch is reflected by the engine
+  GrainEngine engine;
+  T_ASSERT(ctx, engine.getPlaybackMode() == PlaybackMode::Granular);
+  engine.setPlaybackMode(PlaybackMode::Wsola);
+  T_ASSERT(ctx, engine.getPlaybackMode() == PlaybackMode::Wsola);
+}
+
+//------------------------------------------------------------------------------
+// Spectral Tests
+//------------------------------------------------------------------------------
+
+void test_real_fft_roundtrip(TestContext &ctx)
+{
+  using ShortwavDSP::RealFft;
+
+  RealFft fft;
+  std::vector<float> x(RealFft::kSize), y(RealFft::kSize), z(RealFft::kHalf * 2);
+  std::vector<float> re(RealFft::kBins), im(RealFft::kBins);
+
+  // Bin-centered cosine: all energy in one bin, N/2 * amplitude
+  for (int i = 0; i < RealFft::kSize; i++)
+  {
+    x[i] = 0.5f * std::cos(2.0f * 3.14159265f * 64.0f * static_cast<float>(i) / RealFft::kSize);
+  }
+  fft.forward(x.data(), z.data(), re.data(), im.data());
+  T_ASSERT_NEAR(ctx, re[64], 512.0f, 0.05f);
+  T_ASSERT_NEAR(ctx, im[64], 0.0f, 0.05f);
+  T_ASSERT_NEAR(ctx, std::sqrt(re[63] * re[63] + im[63] * im[63]), 0.0f, 0.05f);
+
+  // DC and Nyquist are real
+  for (int i = 0; i < RealFft::kSize; i++)
+  {
+    x[i] = 0.25f + ((i & 1) ? -0.5f : 0.5f);
+  }
+  fft.forward(x.data(), z.data(), re.data(), im.data());
+  T_ASSERT_NEAR(ctx, re[0], 512.0f, 0.05f);
+  T_ASSERT_NEAR(ctx, re[RealFft::kBins - 1], 1024.0f, 0.05f);
+  T_ASSERT_NEAR(ctx, im[RealFft::kBins - 1], 0.0f, 0.05f);
+
+  // Arbitrary signal survives forward + inverse
+  ShortwavDSP::TapestryUtil::FastRandom random(12345);
+  for (int i = 0; i < RealFft::kSize; i++)
+  {
+    x[i] = random.nextBipolar();
+  }
+  fft.forward(x.data(), z.data(), re.data(), im.data());
+  fft.inverse(re.data(), im.data(), z.data(), y.data());
+  float maxError = 0.0f;
+  for (int i = 0; i < RealFft::kSize; i++)
+  {
+    maxError = std::max(maxError, std::fabs(x[i] - y[i]));
+  }
+  T_ASSERT(ctx, maxError < 1e-4f);
+}
+
+struct SpectralRun
+{
+  int risingCrossings = 0;
+  int endOfGeneCount = 0;
+  float rms = 0.0f;
+  double position = 0.0;
+};
+
+// Render a 500Hz sine reel through the spectral path and measure the output
+SpectralRun renderSpectral(ShortwavDSP::PlaybackMode mode, float speedRatio, bool stopped,
+                           float stretch, bool freezeOnStop, int numSamples)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::MorphState;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::VariSpeedState;
+
+  static TapestryBuffer buffer;
+  for (size_t i = 0; i < 96000; i++)
+  {
+    float v = 0.5f * std::sin(2.0f * 3.14159265f * 500.0f * static_cast<float>(i) / 48000.0f);
+    buffer.writeStereo(i, v, v);
+  }
+
+  VariSpeedState speed;
+  speed.speedRatio = speedRatio;
+  speed.isForward = speedRatio > 0.0f;
+  speed.isStopped = stopped;
+
+  GrainEngine engine;
+  engine.setSampleRate(48000.0f);
+  engine.setMorphState(MorphState());
+  engine.setVariSpeed(speed);
+  engine.setPlaybackMode(mode);
+  engine.setSpectralStretch(stretch);
+  engine.setFreezeOnStop(freezeOnStop);
+  engine.retrigger(0.0f);
+
+  SpectralRun run;
+  float outL, outR;
+  bool endOfGene;
+  float prev = 0.0f;
+  double sumSq = 0.0;
+  const int kWarmup = 4096;
+  for (int i = 0; i < kWarmup + numSamples; i++)
+  {
+    engine.process(buffer, 0, 96000, outL, outR, endOfGene);
+    if (endOfGene)
+      run.endOfGeneCount++;
+    if (i >= kWarmup)
+    {
+      if (prev < 0.0f && outL >= 0.0f)
+        run.risingCrossings++;
+      sumSq += static_cast<double>(outL) * outL;
+    }
+    prev = outL;
+  }
+  run.rms = static_cast<float>(std::sqrt(sumSq / numSamples));
+  run.position = engine.getPlayheadPositionRelative();
+  return run;
+}
+
+void test_spectral_freeze(TestContext &ctx)
+{
+  using ShortwavDSP::PlaybackMode;
+
+  // Stopped in Spectral mode: a steady 500Hz tone instead of silence
+  SpectralRun run = renderSpectral(PlaybackMode::Spectral, 1.0f, true, 1.0f, false, 96000);
+  T_ASSERT(ctx, run.risingCrossings >= 995 && run.risingCrossings <= 1005);
+  T_ASSERT_NEAR(ctx, run.rms, 0.3536f, 0.03f);
+  T_ASSERT_NEAR(ctx, run.position, 0.0, 1e-9);
+  T_ASSERT(ctx, run.endOfGeneCount == 0);
+
+  // Granular mode stays silent when stopped unless freeze is enabled
+  run = renderSpectral(PlaybackMode::Granular, 1.0f, true, 1.0f, false, 8192);
+  T_ASSERT_NEAR(ctx, run.rms, 0.0f, kEpsilon);
+  run = renderSpectral(PlaybackMode::Granular, 1.0f, true, 1.0f, true, 48000);
+  T_ASSERT(ctx, run.risingCrossings >= 495 && run.risingCrossings <= 505);
+  T_ASSERT_NEAR(ctx, run.rms, 0.3536f, 0.03f);
+}
+
+void test_spectral_stretch(TestContext &ctx)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::PlaybackMode;
+
+  // Unity stretch: pitch kept, 2s splice wraps once in ~2.1s
+  SpectralRun run = renderSpectral(PlaybackMode::Spectral, 1.0f, false, 1.0f, false, 98000);
+  T_ASSERT(ctx, run.risingCrossings >= 1015 && run.risingCrossings <= 1030);
+  T_ASSERT_NEAR(ctx, run.rms, 0.3536f, 0.03f);
+  T_ASSERT(ctx, run.endOfGeneCount == 1);
+
+  // 100x: same pitch, analysis moves 1/100th as far
+  run = renderSpectral(PlaybackMode::Spectral, 1.0f, false, 100.0f, false, 48000);
+  T_ASSERT(ctx, run.risingCrossings >= 495 && run.risingCrossings <= 505);
+  T_ASSERT_NEAR(ctx, run.rms, 0.3536f, 0.03f);
+  T_ASSERT_NEAR(ctx, run.position, (4096.0 + 48000.0) / 100.0, 8.0);
+
+  // Reverse at 0.5x still plays at pitch
+  run = renderSpectral(PlaybackMode::Spectral, -0.5f, false, 1.0f, false, 48000);
+  T_ASSERT(ctx, run.risingCrossings >= 495 && run.risingCrossings <= 505);
+
+  // Stretch is clamped to 1-100
+  GrainEngine engine;
+  engine.setSpectralStretch(1000.0f);
+  T_ASSERT_NEAR(ctx, engine.getSpectralStretch(), GrainEngine::kMaxSpectralStretch, kEpsilon);
+  engine.setSpectralStretch(0.1f);
+  T_ASSERT_NEAR(ctx, engine.getSpectralStretch(), 1.0f, kEpsilon);
+}
+
+//------------------------------------------------------------------------------
+// Resampling Tests
+//------------------------------------------------------------------------------
+
+void test_sinc_table_bands(TestContext &ctx)
+{
+  using ShortwavDSP::SincTable;
+  typedef SincTable<16> Table;
+
+  T_ASSERT(ctx, Table::bandForIncrement(0.5f) == 0);
+  T_ASSERT(ctx, Table::bandForIncrement(1.0f) == 0);
+  T_ASSERT(ctx, Table::bandForIncrement(1.1f) == 1);
+  T_ASSERT(ctx, Table::bandForIncrement(2.0f) == 4);
+  T_ASSERT(ctx, Table::bandForIncrement(3.0f) == 7);
+  T_ASSERT(ctx, Table::bandForIncrement(100.0f) == Table::kBands - 1);
+
+  T_ASSERT(ctx, Table::bandForIncrement(8.0f) == 12);
+  T_ASSERT(ctx, Table::bandForIncrement(16.0f) == 16);
+
+  // Kernels lengthen with the band: kTaps at unity, kTaps x 16 at 16x
+  const Table &table = Table::instance();
+  T_ASSERT(ctx, table.taps(0) == Table::kTaps);
+  T_ASSERT(ctx, table.taps(Table::kBands - 1) == Table::kMaxTaps);
+
+  // Every phase has unity DC gain and phase 0 peaks on the current frame
+  for (int band = 0; band < Table::kBands; band++)
+  {
+    const int taps = table.taps(band);
+    T_ASSERT(ctx, taps % 4 == 0);
+    T_ASSERT(ctx, taps >= Table::kTaps * std::pow(2.0f, band / 4.0f) - 1e-3f);
+    for (int phase = 0; phase <= Table::kPhases; phase += 16)
+    {
+      const float *c = table.coefficients(band, phase);
+      float sum = 0.0f;
+      for (int j = 0; j < taps; j++)
+        sum += c[j];
+      T_ASSERT_NEAR(ctx, sum, 1.0f, 1e-4f);
+    }
+    const float *c = table.coefficients(band, 0);
+    for (int j = 0; j < taps; j++)
+    {
+      if (j != taps / 2 - 1)
+        T_ASSERT(ctx, c[j] < c[taps / 2 - 1]);
+    }
+  }
+}
+
+// RMS of a buffer sine (cycles per frame) read at an increment
+float resampledRms(float cyclesPerFrame, float increment, ShortwavDSP::InterpolationQuality quality)
+{
+  using ShortwavDSP::TapestryBuffer;
+
+  static TapestryBuffer buffer;
+  buffer.clear();
+  const size_t kFrames = 48000;
+  for (size_t i = 0; i < kFrames; i++)
+  {
+    float v = 0.5f * std::sin(2.0f * 3.14159265f * cyclesPerFrame * static_cast<float>(i));
+    buffer.writeStereo(i, v, v);
+  }
+
+  double sumSq = 0.0;
+  const int kSamples = 8000;
+  double pos = 100.25;
+  for (int i = 0; i < kSamples; i++)
+  {
+    float l, r;
+    ShortwavDSP::Resample::readStereo(buffer, pos, 0, kFrames, increment, quality, l, r);
+    sumSq += static_cast<double>(l) * l;
+    pos += increment;
+  }
+  return static_cast<float>(std::sqrt(sumSq / kSamples));
+}
+
+void test_sinc_read_passband(TestContext &ctx)
+{
+  using ShortwavDSP::InterpolationQuality;
+  using ShortwavDSP::TapestryBuffer;
+
+  // Low frequencies pass at every quality and increment
+  const InterpolationQuality qualities[] = {InterpolationQuality::Sinc8, InterpolationQuality::Sinc16,
+                                            InterpolationQuality::Sinc32};
+  for (InterpolationQuality quality : qualities)
+  {
+    T_ASSERT_NEAR(ctx, resampledRms(0.01f, 0.73f, quality), 0.3536f, 0.01f);
+    T_ASSERT_NEAR(ctx, resampledRms(0.01f, 3.0f, quality), 0.3536f, 0.01f);
+  }
+
+  // Fractional reads of a slow sine match the signal closely
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 4096; i++)
+  {
+    float v = std::sin(2.0f * 3.14159265f * 0.02f * static_cast<float>(i));
+    buffer.writeStereo(i, v, -v);
+  }
+  for (double pos = 1000.0; pos < 1010.0; pos += 0.37)
+  {
+    float l, r;
+    ShortwavDSP::Resample::readStereo(buffer, pos, 0, 4096, 1.0f, InterpolationQuality::Sinc32, l, r);
+    float expected = std::sin(2.0f * 3.14159265f * 0.02f * static_cast<float>(pos));
+    T_ASSERT_NEAR(ctx, l, expected, 2e-3f);
+    T_ASSERT_NEAR(ctx, r, -expected, 2e-3f);
+  }
+
+  // Reads wrap within the splice like the Hermite read
+  float l, r, wl, wr;
+  ShortwavDSP::Resample::readStereo(buffer, 3000.5, 1000, 3000, 1.0f, InterpolationQuality::Sinc16, l, r);
+  ShortwavDSP::Resample::readStereo(buffer, 1000.5, 1000, 3000, 1.0f, InterpolationQuality::Sinc16, wl, wr);
+  T_ASSERT_NEAR(ctx, l, wl, kEpsilon);
+  T_ASSERT_NEAR(ctx, r, wr, kEpsilon);
+}
+
+void test_sinc_read_rejects_aliases(TestContext &ctx)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::InterpolationQuality;
+
+  // 0.3 cycles/frame read at 3x would alias to 0.1 cycles/sample
+  float hermite = resampledRms(0.3f, 3.0f, InterpolationQuality::Hermite);
+  T_ASSERT(ctx, hermite > 0.1f);
+  T_ASSERT(ctx, resampledRms(0.3f, 3.0f, InterpolationQuality::Sinc8) < 0.1f * hermite);
+  T_ASSERT(ctx, resampledRms(0.3f, 3.0f, InterpolationQuality::Sinc16) < 0.01f * hermite);
+  T_ASSERT(ctx, resampledRms(0.3f, 3.0f, InterpolationQuality::Sinc32) < 0.005f * hermite);
+
+  // Kernels lengthen with the ratio, so rejection holds at 4x and beyond:
+  // 0.2 cycles/frame at 4x and 0.1 cycles/frame at 8x both fold to 0.2
+  // cycles/sample, and 0.05 cycles/frame at 16x folds to 0.2 as well
+  const float highRatios[] = {4.0f, 5.3f, 8.0f, 16.0f};
+  for (float ratio : highRatios)
+  {
+    float freq = 0.8f / ratio;
+    float aliased = resampledRms(freq, ratio, InterpolationQuality::Hermite);
+    T_ASSERT(ctx, aliased > 0.05f);
+    T_ASSERT(ctx, resampledRms(freq, ratio, InterpolationQuality::Sinc8) < 0.1f * aliased);
+    T_ASSERT(ctx, resampledRms(freq, ratio, InterpolationQuality::Sinc16) < 0.01f * aliased);
+    T_ASSERT(ctx, resampledRms(freq, ratio, InterpolationQuality::Sinc32) < 0.005f * aliased);
+
+    // Passband still intact: 0.2 cycles/sample after the speed-up
+    T_ASSERT_NEAR(ctx, resampledRms(0.2f / ratio, ratio, InterpolationQuality::Sinc32), 0.3536f, 0.01f);
+  }
+
+  // Quality is stored per engine
+  GrainEngine engine;
+  T_ASSERT(ctx, engine.getInterpolationQuality() == InterpolationQuality::Hermite);
+  engine.setInterpolationQuality(InterpolationQuality::Sinc32);
+  T_ASSERT(ctx, engine.getInterpolationQuality() == InterpolationQuality::Sinc32);
+}
+
+void test_interpolation_tiers(TestContext &ctx)
+{
+  using ShortwavDSP::InterpolationQuality;
+  using ShortwavDSP::TapestryBuffer;
+  namespace Resample = ShortwavDSP::Resample;
+
+  // Cubic ramp: exact for Lagrange6, close for Hermite
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 64; i++)
+  {
+    float x = static_cast<float>(i) / 64.0f;
+    buffer.writeStereo(i, x * x * x, static_cast<float>(i));
+  }
+
+  float l, r;
+  Resample::readStereo<Resample::DropKernel>(buffer, 10.75, 0, 64, 1.0f, l, r);
+  T_ASSERT_NEAR(ctx, r, 10.0f, kEpsilon);
+  Resample::readStereo<Resample::LinearKernel>(buffer, 10.25, 0, 64, 1.0f, l, r);
+  T_ASSERT_NEAR(ctx, r, 10.25f, 1e-4f);
+
+  float x = 20.4f / 64.0f;
+  Resample::readStereo<Resample::Lagrange6Kernel>(buffer, 20.4, 0, 64, 1.0f, l, r);
+  T_ASSERT_NEAR(ctx, l, x * x * x, 1e-5f);
+  T_ASSERT_NEAR(ctx, r, 20.4f, 1e-4f);
+
+  // Hermite kernel matches the buffer's own cubic read, including wrap
+  const double positions[] = {0.3, 5.5, 31.9, 63.7};
+  for (double pos : positions)
+  {
+    float bl, br;
+    buffer.readStereoInterpolatedBounded(pos, 0, 64, bl, br);
+    Resample::readStereo(buffer, pos, 0, 64, 1.0f, InterpolationQuality::Hermite, l, r);
+    T_ASSERT_NEAR(ctx, l, bl, 1e-6f);
+    T_ASSERT_NEAR(ctx, r, br, 1e-4f);
+  }
+
+  // Error on a sine falls as the tier rises
+  buffer.clear();
+  for (size_t i = 0; i < 1024; i++)
+  {
+    float v = std::sin(2.0f * 3.14159265f * 0.1f * static_cast<float>(i));
+    buffer.writeStereo(i, v, v);
+  }
+  const InterpolationQuality tiers[] = {InterpolationQuality::None, InterpolationQuality::Linear,
+                                        InterpolationQuality::Hermite, InterpolationQuality::Lagrange6};
+  float lastError = 1e9f;
+  for (InterpolationQuality quality : tiers)
+  {
+    float maxError = 0.0f;
+    for (double pos = 500.0; pos < 520.0; pos += 0.13)
+    {
+      Resample::readStereo(buffer, pos, 0, 1024, 1.0f, quality, l, r);
+      float expected = std::sin(2.0f * 3.14159265f * 0.1f * static_cast<float>(pos));
+      maxError = std::max(maxError, std::fabs(l - expected));
+    }
+    T_ASSERT(ctx, maxError < lastError);
+    lastError = maxError;
+  }
+}
+
+void test_grain_interpolation_dispatch(TestContext &ctx)
+{
+  using ShortwavDSP::GrainEngine;
+  using ShortwavDSP::InterpolationQuality;
+  using ShortwavDSP::MorphState;
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::VariSpeedState;
+
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 4800; i++)
+  {
+    float v = std::sin(2.0f * 3.14159265f * 0.01f * static_cast<float>(i));
+    buffer.writeStereo(i, v, v);
+  }
+
+  // Every tier plays the same slow sine through the voice loop
+  VariSpeedState speed;
+  speed.speedRatio = 1.5f;
+  for (int q = 0; q < static_cast<int>(InterpolationQuality::NUM_QUALITIES); q++)
+  {
+    GrainEngine engine;
+    engine.setSampleRate(48000.0f);
+    engine.setMorphState(MorphState());
+    engine.setVariSpeed(speed);
+    engine.setGeneSize(4800.0f);
+    engine.setInterpolationQuality(static_cast<InterpolationQuality>(q));
+    engine.retrigger(0.0f);
+
+    GrainEngine reference;
+    reference.setSampleRate(48000.0f);
+    reference.setMorphState(MorphState());
+    reference.setVariSpeed(speed);
+    reference.setGeneSize(4800.0f);
+    reference.setInterpolationQuality(InterpolationQuality::Sinc32);
+    reference.retrigger(0.0f);
+
+    float maxDiff = 0.0f;
+    float peak = 0.0f;
+    for (int i = 0; i < 2000; i++)
+    {
+      float l, r, rl, rr;
+      bool eog;
+      engine.process(buffer, 0, 4800, l, r, eog);
+      reference.process(buffer, 0, 4800, rl, rr, eog);
+      maxDiff = std::max(maxDiff, std::fabs(l - rl));
+      peak = std::max(peak, std::fabs(rl));
+    }
+    T_ASSERT(ctx, peak > 0.1f);
+    T_ASSERT(ctx, maxDiff < 0.06f);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Polyphony Tests
+//------------------------------------------------------------------------------
+
+void test_vec4_floor_abs(TestContext &ctx)
+{
+  using ShortwavDSP::Simd::Vec4;
+
+  alignas(16) float in[4] = {-1.5f, -0.25f, 0.75f, 2.0f};
+  alignas(16) float out[4];
+  Vec4::floor(Vec4::load(in)).store(out);
+  for (int i = 0; i < 4; i++)
+  {
+    T_ASSERT_NEAR(ctx, out[i], std::floor(in[i]), 1e-6f);
+  }
+  Vec4::abs(Vec4::load(in)).store(out);
+  for (int i = 0; i < 4; i++)
+  {
+    T_ASSERT_NEAR(ctx, out[i], std::fabs(in[i]), 1e-6f);
+  }
+}
+
+void test_poly_playheads_pitch_per_channel(TestContext &ctx)
+{
+  using ShortwavDSP::PolyPlayheads;
+  using ShortwavDSP::TapestryBuffer;
+
+  // 100-frame period sine
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 48000; i++)
+  {
+    float v = std::sin(2.0f * 3.14159265f * static_cast<float>(i) / 100.0f);
+    buffer.writeStereo(i, v, v);
+  }
+
+  // Six channels so the second group is only partly used
+  const float volts[6] = {0.0f, 1.0f, -1.0f, 0.5f, 0.0f, -0.5f};
+  static PolyPlayheads poly;
+  poly.reset();
+  poly.setChannels(6);
+  for (int ch = 0; ch < 6; ch++)
+  {
+    poly.setPitch(ch, volts[ch]);
+    poly.setSlide(ch, 0.0f);
+    poly.setGate(ch, true);
+  }
+
+  int crossings[6] = {};
+  float prev[6] = {};
+  float outL[PolyPlayheads::kMaxChannels];
+  float outR[PolyPlayheads::kMaxChannels];
+  for (int i = 0; i < 24000; i++)
+  {
+    poly.process(buffer, 0, 48000, 4800.0f, 1.0f, outL, outR);
+    for (int ch = 0; ch < 6; ch++)
+    {
+      if (i > 2400 && prev[ch] < 0.0f && outL[ch] >= 0.0f)
+        crossings[ch]++;
+      prev[ch] = outL[ch];
+    }
+  }
+
+  // Rising zero crossings scale with 2^volts (21600 samples / 100)
+  for (int ch = 0; ch < 6; ch++)
+  {
+    float expected = 216.0f * std::exp2(volts[ch]);
+    T_ASSERT_NEAR(ctx, static_cast<float>(crossings[ch]), expected, expected * 0.05f + 2.0f);
+  }
+}
+
+void test_poly_playheads_seamless_window(TestContext &ctx)
+{
+  using ShortwavDSP::PolyPlayheads;
+  using ShortwavDSP::TapestryBuffer;
+
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 9600; i++)
+  {
+    buffer.writeStereo(i, 0.5f, -0.25f);
+  }
+
+  static PolyPlayheads poly;
+  poly.reset();
+  poly.setChannels(4);
+  for (int ch = 0; ch < 4; ch++)
+  {
+    poly.setPitch(ch, 0.25f * ch);
+    poly.setGate(ch, true);
+  }
+
+  // After the first half gene the two grain windows sum to one
+  float outL[PolyPlayheads::kMaxChannels];
+  float outR[PolyPlayheads::kMaxChannels];
+  float maxErr = 0.0f;
+  bool ended = false;
+  for (int i = 0; i < 10000; i++)
+  {
+    ended = poly.process(buffer, 0, 9600, 1000.0f, 1.0f, outL, outR) || ended;
+    if (i < 600)
+      continue;
+    for (int ch = 0; ch < 4; ch++)
+    {
+      maxErr = std::max(maxErr, std::fabs(outL[ch] - 0.5f));
+      maxErr = std::max(maxErr, std::fabs(outR[ch] + 0.25f));
+    }
+  }
+  T_ASSERT(ctx, maxErr < 1e-4f);
+  T_ASSERT(ctx, ended);
+}
+
+void test_poly_playheads_gates(TestContext &ctx)
+{
+  using ShortwavDSP::PolyPlayheads;
+  using ShortwavDSP::TapestryBuffer;
+
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 9600; i++)
+  {
+    buffer.writeStereo(i, 0.5f, 0.5f);
+  }
+
+  static PolyPlayheads poly;
+  poly.reset();
+  poly.setChannels(2);
+  poly.setGate(0, true);
+  poly.setGate(1, true);
+
+  float outL[PolyPlayheads::kMaxChannels];
+  float outR[PolyPlayheads::kMaxChannels];
+  for (int i = 0; i < 3000; i++)
+  {
+    poly.process(buffer, 0, 9600, 1000.0f, 1.0f, outL, outR);
+  }
+  T_ASSERT(ctx, poly.isPlaying(1));
+
+  // Channel 1 finishes its grains within one gene and falls silent
+  poly.setGate(1, false);
+  for (int i = 0; i < 1100; i++)
+  {
+    poly.process(buffer, 0, 9600, 1000.0f, 1.0f, outL, outR);
+  }
+  T_ASSERT(ctx, !poly.isPlaying(1));
+  T_ASSERT_NEAR(ctx, outL[1], 0.0f, 1e-6f);
+  T_ASSERT_NEAR(ctx, outL[0], 0.5f, 1e-4f);
+
+  // A rising gate restarts the channel from the Slide position
+  T_ASSERT(ctx, poly.getPosition(0) > 1000.0);
+  poly.setGate(0, false);
+  poly.setGate(0, true);
+  T_ASSERT(ctx, poly.getPosition(0) < 1.0);
+  poly.setGate(1, true);
+  T_ASSERT(ctx, poly.isPlaying(1));
+}
+
+void test_poly_playheads_gene_end_per_channel(TestContext &ctx)
+{
+  using ShortwavDSP::PolyPlayheads;
+  using ShortwavDSP::TapestryBuffer;
+
+  // Two splices with different levels
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 9600; i++)
+  {
+    float v = (i < 4800) ? 0.5f : -0.5f;
+    buffer.writeStereo(i, v, v);
+  }
+
+  static PolyPlayheads poly;
+  poly.reset();
+  poly.setChannels(2);
+  poly.setPitch(1, 1.0f);
+  poly.setGate(0, true);
+  poly.setGate(1, true);
+
+  // Channel 1 runs an octave up, so its genes end twice as often; only
+  // channel 1 moves to the second splice when its first gene ends
+  float outL[PolyPlayheads::kMaxChannels];
+  float outR[PolyPlayheads::kMaxChannels];
+  int ends[2] = {};
+  int firstEnd[2] = {-1, -1};
+  for (int i = 0; i < 6000; i++)
+  {
+    uint32_t ended = poly.process(buffer, 0, 4800, 1000.0f, 1.0f, outL, outR);
+    for (int ch = 0; ch < 2; ch++)
+    {
+      if (ended & (1u << ch))
+      {
+        ends[ch]++;
+        if (firstEnd[ch] < 0)
+          firstEnd[ch] = i;
+      }
+    }
+    if ((ended & 2u) && ends[1] == 1)
+      poly.beginGene(1, 4800, 9600);
+    if (i == 900)
+    {
+      T_ASSERT(ctx, poly.getSpliceStart(0) == 0);
+      T_ASSERT(ctx, poly.getSpliceStart(1) == 4800);
+      T_ASSERT_NEAR(ctx, outL[0], 0.5f, 1e-4f);
+      T_ASSERT_NEAR(ctx, outL[1], -0.5f, 1e-4f);
+    }
+  }
+  T_ASSERT(ctx, firstEnd[1] >= 0 && firstEnd[1] < firstEnd[0]);
+  T_ASSERT(ctx, ends[0] >= 5 && ends[0] <= 6);
+  T_ASSERT(ctx, ends[1] >= 11 && ends[1] <= 12);
+}
+
+void test_dsp_poly_slide_ramps_and_gene_ends(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+
+  static TapestryDSP dsp;
+  dsp.reset();
+  dsp.setSampleRate(48000.0f);
+
+  dsp.clearAndStartRecording(false);
+  for (int i = 0; i < 9600; i++)
+  {
+    float v = 0.5f * std::sin(2.0f * 3.14159265f * static_cast<float>(i) / 100.0f);
+    dsp.process(v, v);
+  }
+  dsp.stopRecordingRequest(false);
+  dsp.setVariSpeed(0.75f);
+  dsp.setControlRate(32);
+
+  dsp.setSlideCv(0.0f, 1.0f);
+  dsp.setPolyChannels(2);
+  dsp.setPolyVoice(0, true, 0.0f, 0.0f);
+  dsp.setPolyVoice(1, true, 1.0f, 0.0f);
+  for (int i = 0; i < 256; i++)
+  {
+    dsp.process(0.0f, 0.0f);
+  }
+  T_ASSERT_NEAR(ctx, dsp.getPolyPlayheads().getSlide(0), 0.0f, 1e-6f);
+
+  // A full-scale Slide CV jump on voice 0 ramps across the control period
+  // like the main Slide instead of stepping
+  dsp.setPolyVoice(0, true, 0.0f, 8.0f);
+  float previous = 0.0f;
+  float maxStep = 0.0f;
+  int ends[2] = {};
+  for (int i = 0; i < 48000; i++)
+  {
+    auto result = dsp.process(0.0f, 0.0f);
+    float slide = dsp.getPolyPlayheads().getSlide(0);
+    maxStep = std::max(maxStep, std::fabs(slide - previous));
+    previous = slide;
+    for (int ch = 0; ch < 2; ch++)
+    {
+      if (result.polyEndOfGene & (1u << ch))
+        ends[ch]++;
+    }
+    T_ASSERT(ctx, (result.polyEndOfGene != 0) == result.endOfSpliceGene);
+  }
+  T_ASSERT(ctx, maxStep < 1.5f / 32.0f);
+  T_ASSERT_NEAR(ctx, previous, 1.0f, 1e-4f);
+  T_ASSERT_NEAR(ctx, dsp.getPolyPlayheads().getSlide(1), 0.0f, 1e-6f);
+
+  // Each voice reports its own end of gene
+  T_ASSERT(ctx, ends[0] > 0);
+  T_ASSERT(ctx, ends[1] > ends[0]);
+}
+
+void test_dsp_poly_outputs(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+
+  static TapestryDSP dsp;
+  dsp.reset();
+  dsp.setSampleRate(48000.0f);
+
+  dsp.clearAndStartRecording(false);
+  for (int i = 0; i < 9600; i++)
+  {
+    float v = 0.5f * std::sin(2.0f * 3.14159265f * static_cast<float>(i) / 100.0f);
+    dsp.process(v, v);
+  }
+  dsp.stopRecordingRequest(false);
+  dsp.setVariSpeed(0.75f);
+
+  // Channels 0 and 2 play; channel 1 stays gated off
+  dsp.setPolyChannels(3);
+  T_ASSERT(ctx, dsp.getPolyChannels() == 3);
+  dsp.setPolyVoice(0, true, 0.0f, 0.0f);
+  dsp.setPolyVoice(1, false, 0.0f, 0.0f);
+  dsp.setPolyVoice(2, true, 1.0f, 0.0f);
+
+  float energy[3] = {};
+  float mixEnergy = 0.0f;
+  for (int i = 0; i < 4800; i++)
+  {
+    auto result = dsp.process(0.0f, 0.0f);
+    T_ASSERT(ctx, result.polyChannels == 3);
+    for (int ch = 0; ch < 3; ch++)
+    {
+      energy[ch] += result.polyOutL[ch] * result.polyOutL[ch];
+    }
+    mixEnergy += result.audioOutL * result.audioOutL;
+  }
+  T_ASSERT(ctx, energy[0] > 10.0f);
+  T_ASSERT(ctx, energy[1] < 1e-6f);
+  T_ASSERT(ctx, energy[2] > 10.0f);
+  T_ASSERT(ctx, mixEnergy > 10.0f);
+
+  // Back to one channel: the main playhead returns
+  dsp.setPolyChannels(1);
+  auto result = dsp.process(0.0f, 0.0f);
+  T_ASSERT(ctx, result.polyChannels == 1);
+}
+
+//------------------------------------------------------------------------------
+// Multi-Tap Tests
+//------------------------------------------------------------------------------
+
+void test_multitap_heads_own_splice_and_gain(TestContext &ctx)
+{
+  using ShortwavDSP::InterpolationQuality;
+  using ShortwavDSP::MultiTapHeads;
+  using ShortwavDSP::ReadHeadSettings;
+  using ShortwavDSP::SpliceManager;
+  using ShortwavDSP::TapestryBuffer;
+
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 4800; i++)
+  {
+    float v = (i < 2400) ? 0.2f : 0.6f;
+    buffer.writeStereo(i, v, -v);
+  }
+  SpliceManager splices;
+  splices.initialize(4800);
+  splices.addMarker(2400);
+
+  static MultiTapHeads heads;
+  heads.reset();
+  heads.setHeadCount(3);
+  T_ASSERT(ctx, heads.getHeadCount() == 3);
+
+  ReadHeadSettings first;
+  first.splice = 0;
+  first.slide = 0.5f;
+  heads.setHead(0, first);
+  ReadHeadSettings second;
+  second.splice = 1;
+  second.gain = 0.5f;
+  second.speed = -1.0f;
+  heads.setHead(1, second);
+  ReadHeadSettings follow;  // Follows the current splice (1 below)
+  follow.speed = 2.0f;
+  heads.setHead(2, follow);
+
+  float outL[MultiTapHeads::kMaxHeads];
+  float outR[MultiTapHeads::kMaxHeads];
+  float maxErr = 0.0f;
+  for (int i = 0; i < 6000; i++)
+  {
+    heads.process(buffer, splices, 2400, 4800, 1.0f, InterpolationQuality::Hermite, outL, outR);
+    maxErr = std::max(maxErr, std::fabs(outL[1] - 0.3f));
+    maxErr = std::max(maxErr, std::fabs(outR[1] + 0.3f));
+    maxErr = std::max(maxErr, std::fabs(outL[2] - 0.6f));
+  }
+  T_ASSERT(ctx, maxErr < 1e-4f);
+
+  // Fixed splice 0: taps wrap within the splice, never reading splice 1
+  int inSplice = 0;
+  for (int i = 0; i < 2000; i++)
+  {
+    heads.process(buffer, splices, 2400, 4800, 1.0f, InterpolationQuality::Linear, outL, outR);
+    if (std::fabs(outL[0] - 0.2f) < 1e-4f)
+      inSplice++;
+  }
+  T_ASSERT(ctx, inSplice == 2000);
+
+  // Phase stays within the loop
+  T_ASSERT(ctx, heads.getPhase(2) >= 0.0 && heads.getPhase(2) < 2400.0);
+
+  // Out-of-range counts: below 2 disables, above 8 clamps
+  heads.setHeadCount(1);
+  T_ASSERT(ctx, heads.getHeadCount() == 0);
+  heads.setHeadCount(12);
+  T_ASSERT(ctx, heads.getHeadCount() == MultiTapHeads::kMaxHeads);
+}
+
+void test_multitap_speed_ratio_sets_pitch(TestContext &ctx)
+{
+  using ShortwavDSP::InterpolationQuality;
+  using ShortwavDSP::MultiTapHeads;
+  using ShortwavDSP::ReadHeadSettings;
+  using ShortwavDSP::SpliceManager;
+  using ShortwavDSP::TapestryBuffer;
+
+  // 100-frame period sine
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 24000; i++)
+  {
+    float v = std::sin(2.0f * 3.14159265f * static_cast<float>(i) / 100.0f);
+    buffer.writeStereo(i, v, v);
+  }
+  SpliceManager splices;
+  splices.initialize(24000);
+
+  const float speeds[4] = {1.0f, 2.0f, 0.5f, -1.0f};
+  static MultiTapHeads heads;
+  heads.reset();
+  heads.setHeadCount(4);
+  for (int k = 0; k < 4; k++)
+  {
+    ReadHeadSettings settings;
+    settings.speed = speeds[k];
+    settings.slide = 0.25f * k;
+    heads.setHead(k, settings);
+  }
+
+  int crossings[4] = {};
+  float prev[4] = {};
+  float outL[MultiTapHeads::kMaxHeads];
+  float outR[MultiTapHeads::kMaxHeads];
+  for (int i = 0; i < 20000; i++)
+  {
+    heads.process(buffer, splices, 0, 24000, 1.0f, InterpolationQuality::Sinc8, outL, outR);
+    for (int k = 0; k < 4; k++)
+    {
+      if (i > 0 && ((prev[k] < 0.0f) != (outL[k] < 0.0f)))
+        crossings[k]++;
+      prev[k] = outL[k];
+    }
+  }
+
+  // Two crossings per cycle: 20000 samples x |speed| / 100 frames
+  for (int k = 0; k < 4; k++)
+  {
+    float expected = 400.0f * std::fabs(speeds[k]);
+    T_ASSERT_NEAR(ctx, static_cast<float>(crossings[k]), expected, expected * 0.02f + 2.0f);
+  }
+}
+
+void test_multitap_loop_is_continuous(TestContext &ctx)
+{
+  using ShortwavDSP::InterpolationQuality;
+  using ShortwavDSP::MultiTapHeads;
+  using ShortwavDSP::ReadHeadSettings;
+  using ShortwavDSP::SpliceManager;
+  using ShortwavDSP::TapestryBuffer;
+
+  // Period does not divide the splice, so a hard loop would click
+  static TapestryBuffer buffer;
+  buffer.clear();
+  for (size_t i = 0; i < 3000; i++)
+  {
+    float v = 0.5f * std::sin(2.0f * 3.14159265f * static_cast<float>(i) / 137.0f);
+    buffer.writeStereo(i, v, v);
+  }
+  SpliceManager splices;
+  splices.initialize(3000);
+
+  static MultiTapHeads heads;
+  heads.reset();
+  heads.setHeadCount(2);
+  ReadHeadSettings forward;
+  heads.setHead(0, forward);
+  ReadHeadSettings reverse;
+  reverse.speed = -1.0f;
+  heads.setHead(1, reverse);
+
+  // Largest sample-to-sample step of a 137-frame sine at 0.5 is ~0.023
+  float outL[MultiTapHeads::kMaxHeads];
+  float outR[MultiTapHeads::kMaxHeads];
+  float prev[2] = {};
+  float maxStep = 0.0f;
+  for (int i = 0; i < 12000; i++)
+  {
+    heads.process(buffer, splices, 0, 3000, 1.0f, InterpolationQuality::Hermite, outL, outR);
+    for (int k = 0; k < 2; k++)
+    {
+      if (i > 0)
+        maxStep = std::max(maxStep, std::fabs(outL[k] - prev[k]));
+      prev[k] = outL[k];
+    }
+  }
+  T_ASSERT(ctx, maxStep < 0.04f);
+}
+
+void test_dsp_read_heads(TestContext &ctx)
+{
+  using ShortwavDSP::ReadHeadSettings;
+  using ShortwavDSP::TapestryDSP;
+
+  static TapestryDSP dsp;
+  dsp.reset();
+  dsp.setSampleRate(48000.0f);
+
+  dsp.clearAndStartRecording(false);
+  for (int i = 0; i < 4800; i++)
+  {
+    dsp.process(0.5f, 0.5f);
+  }
+  dsp.stopRecordingRequest(false);
+  dsp.setVariSpeed(0.75f);
+  dsp.startPlayback();
+
+  dsp.setReadHeadCount(3);
+  ReadHeadSettings muted;
+  muted.gain = 0.0f;
+  dsp.setReadHead(0, ReadHeadSettings());
+  dsp.setReadHead(1, muted);
+  dsp.setReadHead(2, ReadHeadSettings());
+
+  float headEnergy[3] = {};
+  float mainEnergy = 0.0f;
+  for (int i = 0; i < 2400; i++)
+  {
+    auto result = dsp.process(0.0f, 0.0f);
+    T_ASSERT(ctx, result.readHeads == 3);
+    for (int k = 0; k < 3; k++)
+    {
+      headEnergy[k] += result.headOutL[k] * result.headOutL[k];
+    }
+    mainEnergy += result.mainOutL * result.mainOutL;
+  }
+  T_ASSERT(ctx, headEnergy[0] > 100.0f);
+  T_ASSERT(ctx, headEnergy[1] < 1e-6f);
+  T_ASSERT(ctx, headEnergy[2] > 100.0f);
+  T_ASSERT(ctx, mainEnergy > 1.0f);
+
+  // Heads are ignored while polyphonic
+  dsp.setPolyChannels(2);
+  auto result = dsp.process(0.0f, 0.0f);
+  T_ASSERT(ctx, result.readHeads == 0);
+  dsp.setPolyChannels(1);
+  dsp.setReadHeadCount(0);
+  result = dsp.process(0.0f, 0.0f);
+  T_ASSERT(ctx, result.readHeads == 0);
+}
+
+//------------------------------------------------------------------------------
+// Control Rate Tests
+//------------------------------------------------------------------------------
+
+void test_linear_ramp(TestContext &ctx)
+{
+  ShortwavDSP::TapestryUtil::LinearRamp ramp;
+  ramp.snap(1.0f);
+  T_ASSERT_NEAR(ctx, ramp.process(), 1.0f, 1e-6f);
+
+  ramp.setTarget(2.0f, 4);
+  T_ASSERT_NEAR(ctx, ramp.process(), 1.25f, 1e-6f);
+  T_ASSERT_NEAR(ctx, ramp.process(), 1.5f, 1e-6f);
+  T_ASSERT_NEAR(ctx, ramp.process(), 1.75f, 1e-6f);
+  T_ASSERT(ctx, ramp.process() == 2.0f);  // Lands exactly on the target
+  T_ASSERT(ctx, ramp.process() == 2.0f);
+
+  // Retargeting mid-ramp continues from the current value
+  ramp.setTarget(0.0f, 2);
+  T_ASSERT_NEAR(ctx, ramp.process(), 1.0f, 1e-6f);
+  ramp.setTarget(2.0f, 2);
+  T_ASSERT_NEAR(ctx, ramp.process(), 1.5f, 1e-6f);
+  T_ASSERT(ctx, ramp.process() == 2.0f);
+}
+
+void test_dsp_control_rate_ramps(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+
+  // Empty reel: output is the live input scaled by 1 - S.O.S.
+  static TapestryDSP dsp;
+  dsp.reset();
+  dsp.setSampleRate(48000.0f);
+  dsp.setControlRate(32);
+  T_ASSERT(ctx, dsp.getControlRate() == 32);
+  dsp.setSos(1.0f);
+  for (int i = 0; i < 64; i++)
+  {
+    dsp.process(1.0f, 1.0f);
+  }
+  T_ASSERT(ctx, dsp.isControlTick());
+
+  // A change mid-period waits for the next tick, then ramps over one period
+  dsp.process(1.0f, 1.0f);
+  dsp.setSos(0.0f);
+  float prev = 0.0f;
+  float maxStep = 0.0f;
+  int ticks = 0;
+  for (int i = 1; i < 64; i++)
+  {
+    if (dsp.isControlTick())
+      ticks++;
+    auto result = dsp.process(1.0f, 1.0f);
+    if (i < 32)
+      T_ASSERT_NEAR(ctx, result.audioOutL, 0.0f, 1e-6f);
+    maxStep = std::max(maxStep, std::fabs(result.audioOutL - prev));
+    prev = result.audioOutL;
+  }
+  T_ASSERT(ctx, ticks == 1);
+  T_ASSERT_NEAR(ctx, prev, 1.0f, 1e-5f);
+  T_ASSERT(ctx, maxStep < 1.5f / 32.0f);
+
+  // Out-of-range rates clamp
+  dsp.setControlRate(0);
+  T_ASSERT(ctx, dsp.getControlRate() == 1);
+  dsp.setControlRate(1000);
+  T_ASSERT(ctx, dsp.getControlRate() == TapestryDSP::kMaxControlRate);
+}
+
+void test_dsp_audio_rate_cv_opt_in(TestContext &ctx)
+{
+  using ShortwavDSP::ControlParam;
+  using ShortwavDSP::TapestryConfig;
+  using ShortwavDSP::TapestryDSP;
+
+  static TapestryDSP dsp;
+  dsp.reset();
+  dsp.setSampleRate(48000.0f);
+  dsp.setControlRate(64);
+  dsp.setSos(1.0f);
+  dsp.setAudioRateCv(ControlParam::Sos, true);
+  T_ASSERT(ctx, dsp.getAudioRateCv(ControlParam::Sos));
+  T_ASSERT(ctx, !dsp.getAudioRateCv(ControlParam::Slide));
+  for (int i = 0; i < 10; i++)
+  {
+    dsp.process(1.0f, 1.0f);
+  }
+
+  // Audio-rate S.O.S. CV takes effect on the very next sample
+  for (int i = 0; i < 8; i++)
+  {
+    float cv = (i % 2) ? -0.5f * TapestryConfig::kSosCvMax : 0.0f;
+    dsp.setSosCv(cv);
+    auto result = dsp.process(1.0f, 1.0f);
+    T_ASSERT_NEAR(ctx, result.audioOutL, (i % 2) ? 0.5f : 0.0f, 1e-6f);
+  }
+
+  // Back at control rate the same CV is held until the next tick
+  dsp.setAudioRateCv(ControlParam::Sos, false);
+  dsp.setSosCv(0.0f);
+  for (int i = 0; i < 128; i++)
+  {
+    dsp.process(1.0f, 1.0f);
+  }
+  while (!dsp.isControlTick())
+  {
+    dsp.process(1.0f, 1.0f);
+  }
+  dsp.process(1.0f, 1.0f);
+  dsp.setSosCv(-TapestryConfig::kSosCvMax);
+  auto result = dsp.process(1.0f, 1.0f);
+  T_ASSERT_NEAR(ctx, result.audioOutL, 0.0f, 1e-6f);
+}
+
+//------------------------------------------------------------------------------
+// Lookup Table Tests
+//------------------------------------------------------------------------------
+
+void test_lut_exp2_error_bound(TestContext &ctx)
+{
+  using ShortwavDSP::Lut::exp2;
+
+  // Compile-time table endpoints
+  T_ASSERT(ctx, ShortwavDSP::Lut::Exp2Table::kValues[0] == 1.0f);
+  T_ASSERT(ctx, ShortwavDSP::Lut::Exp2Table::kValues[ShortwavDSP::Lut::kExp2Segments] == 2.0f);
+
+  // Documented bound: relative error below 5e-7
+  double maxRelErr = 0.0;
+  for (int i = -400000; i <= 400000; i++)
+  {
+    float x = static_cast<float>(i) * 5e-5f;  // [-20, 20]
+    double ref = std::pow(2.0, static_cast<double>(x));
+    double rel = std::fabs(static_cast<double>(exp2(x)) - ref) / ref;
+    maxRelErr = std::max(maxRelErr, rel);
+  }
+  T_ASSERT(ctx, maxRelErr < 5e-7);
+
+  // Exact at integers, clamped outside the normal float range
+  T_ASSERT(ctx, exp2(0.0f) == 1.0f);
+  T_ASSERT(ctx, exp2(3.0f) == 8.0f);
+  T_ASSERT(ctx, exp2(-2.0f) == 0.25f);
+  T_ASSERT(ctx, exp2(-1000.0f) > 0.0f);
+  T_ASSERT(ctx, std::isfinite(exp2(1000.0f)));
+  T_ASSERT_NEAR(ctx, ShortwavDSP::Lut::semitonesToRatio(12.0f), 2.0f, 1e-6f);
+  T_ASSERT_NEAR(ctx, ShortwavDSP::Lut::semitonesToRatio(-7.0f), std::pow(2.0f, -7.0f / 12.0f), 1e-6f);
+}
+
+void test_lut_parameter_mappings(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryConfig;
+  namespace TapestryUtil = ShortwavDSP::TapestryUtil;
+
+  for (int i = 0; i <= 100; i++)
+  {
+    float x = static_cast<float>(i) / 100.0f;
+    T_ASSERT_NEAR(ctx, ShortwavDSP::Lut::powInt<4>(x), std::pow(x, 4.0f), 1e-6f);
+
+    // Gene size curve matches the std::pow mapping it replaces
+    float splice = 96000.0f;
+    float expected = TapestryConfig::kMinGeneSamples +
+                     std::pow(1.0f - x, 4.0f) * (splice - TapestryConfig::kMinGeneSamples);
+    T_ASSERT_NEAR(ctx, TapestryUtil::calculateGeneSizeSamples(x, splice), expected, expected * 1e-5f);
+
+    // Vari-Speed ratio within the exp2 error bound
+    float bipolar = x * 2.0f - 1.0f;
+    auto state = TapestryUtil::calculateVariSpeed(bipolar, 0.0f, 0.0f);
+    if (!state.isStopped)
+    {
+      float semitones = std::fabs(bipolar) * (state.isForward ? TapestryConfig::kVariSpeedUpSemitones
+                                                              : TapestryConfig::kVariSpeedDownSemitones);
+      float ratio = std::pow(2.0f, semitones / 12.0f);
+      T_ASSERT_NEAR(ctx, std::fabs(state.speedRatio), ratio, ratio * 2e-6f);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Block Recording Tests
+//------------------------------------------------------------------------------
+
+void test_simd_block_mixing(TestContext &ctx)
+{
+  // 11 samples: two vector steps plus a scalar tail
+  const size_t n = 11;
+  float dest[n], expected[n], src[n], amount[n];
+  for (size_t i = 0; i < n; i++)
+  {
+    dest[i] = expected[i] = 0.1f * static_cast<float>(i);
+    src[i] = 1.0f - 0.05f * static_cast<float>(i);
+    amount[i] = static_cast<float>(i) / (n - 1);
+  }
+
+  ShortwavDSP::Simd::feedbackAccumulate(dest, src, 1.0f, false, n);
+  for (size_t i = 0; i < n; i++)
+  {
+    expected[i] += src[i];
+    T_ASSERT_NEAR(ctx, dest[i], expected[i], 1e-6f);
+  }
+
+  ShortwavDSP::Simd::crossfade(dest, src, amount, n);
+  for (size_t i = 0; i < n; i++)
+  {
+    expected[i] = src[i] * (1.0f - amount[i]) + expected[i] * amount[i];
+    T_ASSERT_NEAR(ctx, dest[i], expected[i], 1e-6f);
+  }
+}
+
+void test_buffer_write_block_modes(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryBuffer;
+  typedef TapestryBuffer::BlockMode BlockMode;
+
+  const size_t frames = 9;
+  float live[frames * 2], sos[frames * 2];
+  for (size_t i = 0; i < frames * 2; i++)
+  {
+    live[i] = 0.25f + 0.01f * static_cast<float>(i);
+    sos[i] = static_cast<float>(i / 2) / frames;
+  }
+
+  // Replace: one usedFrames update and one version bump for the span
+  TapestryBuffer buffer;
+  uint32_t version = buffer.getVersion();
+  T_ASSERT(ctx, buffer.writeBlock(10, live, nullptr, frames, BlockMode::Replace) == frames);
+  T_ASSERT(ctx, buffer.getUsedFrames() == 10 + frames);
+  T_ASSERT(ctx, buffer.getVersion() == version + 1);
+  float l, r;
+  buffer.readStereo(14, l, r);
+  T_ASSERT_NEAR(ctx, l, live[8], 1e-7f);
+  T_ASSERT_NEAR(ctx, r, live[9], 1e-7f);
+
+  // Sound-on-Sound matches mixAndWrite frame by frame
+  TapestryBuffer reference;
+  reference.writeBlock(10, live, nullptr, frames, BlockMode::Replace);
+  float live2[frames * 2];
+  for (size_t i = 0; i < frames * 2; i++)
+  {
+    live2[i] = -0.5f + 0.03f * static_cast<float>(i);
+  }
+  buffer.writeBlock(12, live2, sos, frames, BlockMode::SoundOnSound);
+  for (size_t f = 0; f < frames; f++)
+  {
+    reference.mixAndWrite(12 + f, live2[f * 2], live2[f * 2 + 1], sos[f * 2]);
+  }
+  bool sosMatches = true;
+  for (size_t f = 10; f < 12 + frames; f++)
+  {
+    float a, b, c, d;
+    buffer.readStereo(f, a, b);
+    reference.readStereo(f, c, d);
+    sosMatches = sosMatches && std::fabs(a - c) < 1e-6f && std::fabs(b - d) < 1e-6f;
+  }
+  T_ASSERT(ctx, sosMatches);
+  T_ASSERT(ctx, buffer.getUsedFrames() == 12 + frames);
+
+  // Overdub sums with existing content; frames past the used region are
+  // silence even if the raw storage holds stale samples
+  size_t used = buffer.getUsedFrames();
+  buffer.data()[used * 2] = 9.0f;
+  float before;
+  buffer.readStereo(used - 1, before, r);
+  buffer.writeBlock(used - 1, live, nullptr, 2, BlockMode::Overdub);
+  buffer.readStereo(used - 1, l, r);
+  T_ASSERT_NEAR(ctx, l, before + live[0], 1e-6f);
+  buffer.readStereo(used, l, r);
+  T_ASSERT_NEAR(ctx, l, live[2], 1e-7f);
+
+  // Spans are clamped at the end of the reel
+  T_ASSERT(ctx, buffer.writeBlock(TapestryBuffer::kMaxFrames - 4, live, nullptr, frames,
+                                  BlockMode::Replace) == 4);
+  T_ASSERT(ctx, buffer.getUsedFrames() == TapestryBuffer::kMaxFrames);
+  T_ASSERT(ctx, buffer.writeBlock(TapestryBuffer::kMaxFrames, live, nullptr, frames,
+                                  BlockMode::Replace) == 0);
+}
+
+void test_dsp_block_recording_spans(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+  const size_t block = TapestryDSP::kRecordBlockFrames;
+
+  TapestryDSP dsp;
+  dsp.setSampleRate(48000.0f);
+
+  // Initial recording reaches the reel and the splice end one block at a time
+  dsp.clearAndStartRecording(false);
+  for (int i = 0; i < 100; i++)
+  {
+    float x = 0.001f * static_cast<float>(i);
+    dsp.process(x, -x);
+    if (i == static_cast<int>(block) + 7)
+    {
+      T_ASSERT(ctx, dsp.getBuffer().getUsedFrames() == block);
+      T_ASSERT(ctx, dsp.getSpliceManager().getCurrentSplice()->endFrame == block);
+      T_ASSERT(ctx, dsp.getRecordState().recordPosition == block + 8);
+    }
+  }
+  dsp.stopRecordingRequest(false);
+
+  T_ASSERT(ctx, dsp.getBuffer().getUsedFrames() == 100);
+  T_ASSERT(ctx, dsp.getSpliceManager().getCurrentSplice()->endFrame == 100);
+  bool recorded = true;
+  for (size_t f = 0; f < 100; f++)
+  {
+    float l, r;
+    dsp.getBuffer().readStereo(f, l, r);
+    recorded = recorded && l == 0.001f * static_cast<float>(f) && r == -l;
+  }
+  T_ASSERT(ctx, recorded);
+
+  // Sound-on-Sound wraps at the splice end, which also ends the span
+  dsp.setSos(0.5f);
+  dsp.startRecordingSameSplice(false);
+  for (int i = 0; i < 150; i++)
+  {
+    dsp.process(1.0f, 1.0f);
+  }
+  T_ASSERT(ctx, dsp.getRecordState().recordPosition == 50);
+  dsp.stopRecordingRequest(false);
+
+  bool blended = true;
+  for (size_t f = 0; f < 100; f++)
+  {
+    float l, r;
+    dsp.getBuffer().readStereo(f, l, r);
+    float expected = 0.5f + 0.5f * (0.001f * static_cast<float>(f));
+    if (f < 50)
+      expected = 0.5f + 0.5f * expected;  // Second pass
+    blended = blended && std::fabs(l - expected) < 1e-6f;
+  }
+  T_ASSERT(ctx, blended);
+  T_ASSERT(ctx, dsp.getBuffer().getUsedFrames() == 100);
+  T_ASSERT(ctx, dsp.getSpliceManager().getCurrentSplice()->endFrame == 100);
+
+  // Overdub adds the live input on top
+  dsp.setOverdubMode(true);
+  dsp.startRecordingSameSplice(false);
+  for (int i = 0; i < 100; i++)
+  {
+    dsp.process(0.25f, 0.25f);
+  }
+  dsp.stopRecordingRequest(false);
+  float l, r;
+  dsp.getBuffer().readStereo(70, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.5f + 0.5f * 0.07f + 0.25f, 1e-6f);
+}
+
+//------------------------------------------------------------------------------
+// Overdub Feedback Tests
+//------------------------------------------------------------------------------
+
+void test_simd_feedback_accumulate(TestContext &ctx)
+{
+  using ShortwavDSP::Simd::softClip;
+
+  // Soft clip: unity slope at zero, reaches +-1 with zero slope at +-1.5
+  T_ASSERT_NEAR(ctx, softClip(0.0f), 0.0f, 1e-7f);
+  T_ASSERT_NEAR(ctx, softClip(0.01f), 0.01f, 1e-6f);
+  T_ASSERT_NEAR(ctx, softClip(1.5f), 1.0f, 1e-6f);
+  T_ASSERT_NEAR(ctx, softClip(-7.0f), -1.0f, 1e-6f);
+  T_ASSERT(ctx, softClip(1.4f) < 1.0f && softClip(1.4f) > softClip(1.3f));
+
+  // Vector lanes and the scalar tail agree
+  const size_t n = 7;
+  float dest[n], src[n];
+  for (size_t i = 0; i < n; i++)
+  {
+    dest[i] = 0.6f * static_cast<float>(i) - 1.5f;
+    src[i] = 0.4f;
+  }
+  float plain[n], clipped[n];
+  std::copy(dest, dest + n, plain);
+  std::copy(dest, dest + n, clipped);
+  ShortwavDSP::Simd::feedbackAccumulate(plain, src, 0.5f, false, n);
+  ShortwavDSP::Simd::feedbackAccumulate(clipped, src, 0.5f, true, n);
+  for (size_t i = 0; i < n; i++)
+  {
+    float sum = dest[i] * 0.5f + src[i];
+    T_ASSERT_NEAR(ctx, plain[i], sum, 1e-6f);
+    T_ASSERT_NEAR(ctx, clipped[i], softClip(sum), 1e-6f);
+  }
+}
+
+void test_dsp_overdub_feedback_bounds_layers(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+
+  // Record a 100-frame loop, then overdub a constant for many passes
+  TapestryDSP dsp;
+  dsp.setSampleRate(48000.0f);
+  dsp.clearAndStartRecording(false);
+  for (int i = 0; i < 100; i++)
+  {
+    dsp.process(0.2f, 0.2f);
+  }
+  dsp.stopRecordingRequest(false);
+
+  dsp.setOverdubMode(true);
+  dsp.setOverdubFeedback(0.5f);
+  T_ASSERT_NEAR(ctx, dsp.getOverdubFeedback(), 0.5f, 1e-7f);
+  dsp.startRecordingSameSplice(false);
+  for (int i = 0; i < 100 * 40; i++)
+  {
+    dsp.process(0.2f, 0.2f);
+  }
+  dsp.stopRecordingRequest(false);
+
+  // Layers converge to live / (1 - feedback) instead of growing per pass
+  float l, r;
+  dsp.getBuffer().readStereo(37, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.4f, 1e-5f);
+
+  // With saturation, unity feedback stays within +-1 however many layers
+  dsp.setOverdubFeedback(1.0f);
+  dsp.setOverdubSaturation(true);
+  dsp.startRecordingSameSplice(false);
+  for (int i = 0; i < 100 * 40; i++)
+  {
+    dsp.process(0.9f, -0.9f);
+  }
+  dsp.stopRecordingRequest(false);
+  float peak = 0.0f;
+  for (size_t f = 0; f < 100; f++)
+  {
+    dsp.getBuffer().readStereo(f, l, r);
+    peak = std::max(peak, std::max(std::fabs(l), std::fabs(r)));
+  }
+  T_ASSERT(ctx, peak <= 1.0f);
+  T_ASSERT(ctx, peak > 0.99f);
+
+  dsp.reset();
+  T_ASSERT_NEAR(ctx, dsp.getOverdubFeedback(), 1.0f, 1e-7f);
+  T_ASSERT(ctx, !dsp.getOverdubSaturation());
+}
+
+//------------------------------------------------------------------------------
+// Offline Render Tests
+//------------------------------------------------------------------------------
+
+void test_wav_round_trip(TestContext &ctx)
+{
+  namespace Wav = ShortwavDSP::Wav;
+
+  const float samples[] = {0.0f, 0.5f, -0.25f, 1.0f, -1.0f, 0.125f};
+  std::string error;
+
+  // 32-bit float is lossless
+  std::vector<uint8_t> bytes = Wav::encode(samples, 3, 44100, Wav::Format::Float32);
+  Wav::Audio audio;
+  T_ASSERT(ctx, Wav::parse(bytes.data(), bytes.size(), audio, error));
+  T_ASSERT(ctx, audio.frames == 3);
+  T_ASSERT(ctx, audio.sampleRate == 44100);
+  bool exact = true;
+  for (int i = 0; i < 6; i++)
+  {
+    exact = exact && audio.samples[i] == samples[i];
+  }
+  T_ASSERT(ctx, exact);
+
+  // 16-bit PCM within one step
+  bytes = Wav::encode(samples, 3, 48000, Wav::Format::Pcm16);
+  T_ASSERT(ctx, Wav::parse(bytes.data(), bytes.size(), audio, error));
+  T_ASSERT_NEAR(ctx, audio.samples[2], -0.25f, 1.0f / 32767.0f);
+  T_ASSERT_NEAR(ctx, audio.samples[4], -1.0f, 1.0f / 32767.0f);
+
+  // Mono 24-bit with a LIST chunk before the data: duplicated to stereo
+  const uint8_t mono24[] = {
+      'R', 'I', 'F', 'F', 50, 0, 0, 0, 'W', 'A', 'V', 'E',
+      'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 1, 0, 0x80, 0xBB, 0, 0, 0x80, 0x32, 0x02, 0, 3, 0, 24, 0,
+      'L', 'I', 'S', 'T', 1, 0, 0, 0, 0, 0,  // Odd size, padded
+      'd', 'a', 't', 'a', 6, 0, 0, 0, 0x00, 0x00, 0x40, 0x00, 0x00, 0xC0};
+  T_ASSERT(ctx, Wav::parse(mono24, sizeof(mono24), audio, error));
+  T_ASSERT(ctx, audio.frames == 2);
+  T_ASSERT_NEAR(ctx, audio.samples[0], 0.5f, 1e-7f);
+  T_ASSERT_NEAR(ctx, audio.samples[1], 0.5f, 1e-7f);
+  T_ASSERT_NEAR(ctx, audio.samples[3], -0.5f, 1e-7f);
+
+  // Errors are reported, not thrown
+  const uint8_t junk[] = {'R', 'I', 'F', 'X', 0, 0, 0, 0, 'W', 'A', 'V', 'E'};
+  T_ASSERT(ctx, !Wav::parse(junk, sizeof(junk), audio, error));
+  T_ASSERT(ctx, !error.empty());
+}
+
+void test_timeline_parse_csv(TestContext &ctx)
+{
+  using ShortwavDSP::RenderTarget;
+  using ShortwavDSP::Timeline;
+
+  Timeline timeline;
+  std::string error;
+  T_ASSERT(ctx, timeline.parseCsv("time,target,value\n"
+                                  "# comment\n"
+                                  "2.0, morph, 0.7\r\n"
+                                  "\n"
+                                  "0.5,play,1  # gate on\n"
+                                  "2.0,shift,1\n",
+                                  error));
+  const std::vector<ShortwavDSP::TimelineEvent> &events = timeline.getEvents();
+  T_ASSERT(ctx, events.size() == 3);
+  T_ASSERT(ctx, events[0].target == RenderTarget::Play);
+  T_ASSERT(ctx, events[1].target == RenderTarget::Morph);  // Same time: file order
+  T_ASSERT(ctx, events[2].target == RenderTarget::Shift);
+  T_ASSERT_NEAR(ctx, events[1].value, 0.7f, 1e-7f);
+
+  // Every target round-trips through its name
+  bool named = true;
+  for (int t = 0; t < static_cast<int>(RenderTarget::NUM_TARGETS); t++)
+  {
+    RenderTarget target = RenderTarget::Sos;
+    named = named && Timeline::targetFromName(Timeline::targetName(static_cast<RenderTarget>(t)), target) &&
+            static_cast<int>(target) == t;
+  }
+  T_ASSERT(ctx, named);
+
+  T_ASSERT(ctx, !timeline.parseCsv("1.0,morph\n", error));
+  T_ASSERT(ctx, error.find("line 1") != std::string::npos);
+  T_ASSERT(ctx, !timeline.parseCsv("0,morph,0\n1.0,wobble,1\n", error));
+  T_ASSERT(ctx, error.find("line 2") != std::string::npos);
+  T_ASSERT(ctx, !timeline.parseCsv("-1,morph,0\n", error));
+  T_ASSERT(ctx, !timeline.parseCsv("0,morph,abc\n", error));
+}
+
+void test_timeline_renderer_chunked(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryDSP;
+  using ShortwavDSP::Timeline;
+  using ShortwavDSP::TimelineRenderer;
+
+  const size_t reelFrames = 4800;
+  std::vector<float> reel(reelFrames * 2);
+  for (size_t f = 0; f < reelFrames; f++)
+  {
+    reel[f * 2] = std::sin(0.05f * static_cast<float>(f));
+    reel[f * 2 + 1] = std::cos(0.03f * static_cast<float>(f));
+  }
+
+  Timeline timeline;
+  std::string error;
+  T_ASSERT(ctx, timeline.parseCsv("0,morph,0.7\n0,vari_speed,0.6\n0.01,gene_size,0.3\n"
+                                  "0.02,shift,1\n0.03,pitch,1\n",
+                                  error));
+
+  // One pass and uneven chunks produce the same samples
+  const size_t frames = 4000;
+  std::vector<float> whole(frames * 2), chunked(frames * 2);
+  {
+    TapestryDSP dsp;
+    dsp.setSampleRate(48000.0f);
+    dsp.loadReel(reel.data(), reelFrames, {0, 2400});
+    TimelineRenderer renderer(timeline, 48000.0f);
+    renderer.render(dsp, whole.data(), frames);
+    T_ASSERT(ctx, renderer.getPosition() == frames);
+  }
+  {
+    TapestryDSP dsp;
+    dsp.setSampleRate(48000.0f);
+    dsp.loadReel(reel.data(), reelFrames, {0, 2400});
+    TimelineRenderer renderer(timeline, 48000.0f);
+    size_t done = 0;
+    size_t chunk = 1;
+    while (done < frames)
+    {
+      size_t n = std::min(chunk, frames - done);
+      renderer.render(dsp, chunked.data() + done * 2, n);
+      done += n;
+      chunk = chunk * 3 + 1;
+    }
+    // Events were applied: Shift moved to the second splice, V/Oct doubled
+    // the +2.4 semitone Vari-Speed rate
+    T_ASSERT(ctx, dsp.getSpliceManager().getCurrentIndex() == 1);
+    T_ASSERT_NEAR(ctx, dsp.getVariSpeedState().speedRatio, 2.0f * std::pow(2.0f, 0.2f), 1e-3f);
+  }
+
+  bool identical = true;
+  float energy = 0.0f;
+  for (size_t i = 0; i < frames * 2; i++)
+  {
+    identical = identical && whole[i] == chunked[i];
+    energy += whole[i] * whole[i];
+  }
+  T_ASSERT(ctx, identical);
+  T_ASSERT(ctx, energy > 1.0f);
+}
+
+//------------------------------------------------------------------------------
+// Batch Render Tests
+//------------------------------------------------------------------------------
+
+void test_work_stealing_pool_runs_every_job_once(TestContext &ctx)
+{
+  using ShortwavDSP::WorkStealingPool;
+
+  const size_t jobs = 203;
+  std::vector<std::atomic<int>> runs(jobs);
+  for (size_t j = 0; j < jobs; j++)
+  {
+    runs[j] = 0;
+  }
+  std::atomic<int> badWorker(0);
+
+  WorkStealingPool pool(4);
+  T_ASSERT(ctx, pool.getWorkerCount() == 4);
+  pool.run(jobs, [&](size_t job, int worker) {
+    // Uneven job lengths: the first worker's range is much slower
+    volatile float sink = 0.0f;
+    int spin = (job < jobs / 4) ? 20000 : 10;
+    for (int i = 0; i < spin; i++)
+    {
+      sink = sink + 1.0f;
+    }
+    runs[job]++;
+    if (worker < 0 || worker >= 4)
+      badWorker++;
+  });
+
+  bool once = true;
+  for (size_t j = 0; j < jobs; j++)
+  {
+    once = once && runs[j] == 1;
+  }
+  T_ASSERT(ctx, once);
+  T_ASSERT(ctx, badWorker == 0);
+
+  // Zero jobs and a single worker are fine
+  pool.run(0, [&](size_t, int) { badWorker++; });
+  T_ASSERT(ctx, badWorker == 0);
+  WorkStealingPool single(1);
+  size_t count = 0;
+  single.run(10, [&](size_t, int) { count++; });
+  T_ASSERT(ctx, count == 10);
+  T_ASSERT(ctx, single.getLastStealCount() == 0);
+}
+
+void test_buffer_shared_reel_copy_on_write(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryBuffer;
+
+  std::vector<float> source(200);
+  for (size_t i = 0; i < source.size(); i++)
+  {
+    source[i] = 0.01f * static_cast<float>(i);
+  }
+  std::shared_ptr<const std::vector<float>> reel = TapestryBuffer::makeSharedReel(source.data(), 100);
+  T_ASSERT(ctx, reel->size() == TapestryBuffer::kMaxFrames * TapestryBuffer::kChannels);
+
+  TapestryBuffer a;
+  TapestryBuffer b;
+  a.shareReel(reel, 100);
+  b.shareReel(reel, 100);
+  T_ASSERT(ctx, a.isShared() && b.isShared());
+  T_ASSERT(ctx, a.getUsedFrames() == 100);
+
+  const TapestryBuffer &constA = a;
+  const TapestryBuffer &constB = b;
+  T_ASSERT(ctx, constA.data() == constB.data());
+  float l, r;
+  constA.readStereo(42, l, r);
+  T_ASSERT_NEAR(ctx, l, source[84], 1e-7f);
+
+  // A write detaches only the writer, keeping its frames
+  b.writeStereo(42, 5.0f, 5.0f);
+  T_ASSERT(ctx, !b.isShared());
+  T_ASSERT(ctx, (*reel)[84] == source[84]);
+  b.readStereo(41, l, r);
+  T_ASSERT_NEAR(ctx, l, source[82], 1e-7f);
+  b.readStereo(42, l, r);
+  T_ASSERT_NEAR(ctx, l, 5.0f, 1e-7f);
+
+  // Clearing a shared buffer leaves an empty private one
+  a.clear();
+  T_ASSERT(ctx, !a.isShared());
+  T_ASSERT(ctx, a.getUsedFrames() == 0);
+  T_ASSERT(ctx, (*reel)[84] == source[84]);
+}
+
+void test_dsp_shared_reel_matches_private(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryBuffer;
+  using ShortwavDSP::TapestryDSP;
+  using ShortwavDSP::Timeline;
+  using ShortwavDSP::TimelineRenderer;
+
+  const size_t reelFrames = 6000;
+  std::vector<float> source(reelFrames * 2);
+  for (size_t f = 0; f < reelFrames; f++)
+  {
+    source[f * 2] = std::sin(0.02f * static_cast<float>(f));
+    source[f * 2 + 1] = std::sin(0.07f * static_cast<float>(f));
+  }
+  std::shared_ptr<const std::vector<float>> reel = TapestryBuffer::makeSharedReel(source.data(), reelFrames);
+
+  Timeline timeline;
+  timeline.add(0.0, ShortwavDSP::RenderTarget::VariSpeed, 0.6f);
+  timeline.add(0.0, ShortwavDSP::RenderTarget::Morph, 0.8f);
+
+  const size_t frames = 3000;
+  std::vector<float> privateOut(frames * 2), sharedOut(frames * 2), reusedOut(frames * 2);
+  {
+    TapestryDSP dsp;
+    dsp.loadReel(source.data(), reelFrames, {0, 3000});
+    TimelineRenderer(timeline, 48000.0f).render(dsp, privateOut.data(), frames);
+  }
+
+  // A reused instance renders the same after loadSharedReel, whatever it
+  // played before
+  TapestryDSP dsp;
+  dsp.loadSharedReel(reel, reelFrames, {0, 3000});
+  TimelineRenderer(timeline, 48000.0f).render(dsp, sharedOut.data(), frames);
+  dsp.setSosCv(2.0f);
+  dsp.setGeneSize(0.9f);
+  dsp.onShiftTrigger();
+  dsp.loadSharedReel(reel, reelFrames, {0, 3000});
+  TimelineRenderer(timeline, 48000.0f).render(dsp, reusedOut.data(), frames);
+
+  bool identical = true, reused = true;
+  for (size_t i = 0; i < frames * 2; i++)
+  {
+    identical = identical && privateOut[i] == sharedOut[i];
+    reused = reused && privateOut[i] == reusedOut[i];
+  }
+  T_ASSERT(ctx, identical);
+  T_ASSERT(ctx, reused);
+  T_ASSERT(ctx, dsp.getBuffer().isShared());
+  T_ASSERT(ctx, dsp.getSpliceManager().getNumSplices() == 2);
+}
+
+//------------------------------------------------------------------------------
+// Real-Time Safety Tests
+//------------------------------------------------------------------------------
+
+// Runs audio-thread calls with the RtCheck hooks armed. check() fails the
+// scenario on any allocation, free or lock, or on a call whose CPU time
+// exceeds the budget (default 2 ms, far above any single process() call but
+// well below a full-reel fill)
+class RtProbe
+{
+public:
+  explicit RtProbe(const char *scenario, double budgetSeconds = 2e-3)
+      : scenario_(scenario), budget_(budgetSeconds)
+  {
+  }
+
+  template <class Fn>
+  void call(const char *what, Fn fn)
+  {
+    int allocations = RtCheck::gAllocations.load();
+    int frees = RtCheck::gFrees.load();
+    int locks = RtCheck::gLocks.load();
+    double start = RtCheck::threadSeconds();
+    RtCheck::gArmed.store(true);
+    fn();
+    RtCheck::gArmed.store(false);
+    double seconds = RtCheck::threadSeconds() - start;
+
+    note(allocations != RtCheck::gAllocations.load(), what, "allocated");
+    note(frees != RtCheck::gFrees.load(), what, "freed memory");
+    note(locks != RtCheck::gLocks.load(), what, "locked a mutex");
+    note(seconds > budget_, what, "exceeded the time budget");
+    if (seconds > worst_)
+    {
+      worst_ = seconds;
+      worstCall_ = what;
+    }
+  }
+
+  // One call() per process() sample, with input from in(i, l, r)
+  template <class Fn>
+  void process(ShortwavDSP::TapestryDSP &dsp, const char *what, int samples, Fn in)
+  {
+    for (int i = 0; i < samples; i++)
+    {
+      float l, r;
+      in(i, l, r);
+      call(what, [&]() { dsp.process(l, r); });
+    }
+  }
+
+  void check(TestContext &ctx) const
+  {
+    if (violations_ > 0)
+    {
+      std::printf("  [RT] %s: %s %s (%d violations)\n", scenario_, firstCall_, firstProblem_,
+                  violations_);
+    }
+    ctx.assertTrue(violations_ == 0, scenario_, __FILE__, __LINE__);
+    ctx.assertTrue(worst_ <= budget_, worstCall_, __FILE__, __LINE__);
+  }
+
+private:
+  void note(bool violated, const char *what, const char *problem)
+  {
+    if (!violated)
+      return;
+    if (violations_++ == 0)
+    {
+      firstCall_ = what;
+      firstProblem_ = problem;
+    }
+  }
+
+  const char *scenario_;
+  double budget_;
+  double worst_ = 0.0;
+  const char *worstCall_ = "";
+  const char *firstCall_ = "";
+  const char *firstProblem_ = "";
+  int violations_ = 0;
+};
+
+// Tone with a click every half second (120 BPM), so analysis finds a beat grid
+std::unique_ptr<ShortwavDSP::TapestryDSP> makeRtDsp(size_t frames)
+{
+  std::vector<float> reel(frames * 2);
+  for (size_t i = 0; i < frames; i++)
+  {
+    float tone = 0.3f * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / 48000.0f);
+    float click = (i % 24000 < 64) ? 0.9f : 0.0f;
+    reel[i * 2] = tone + click;
+    reel[i * 2 + 1] = tone - click;
+  }
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp(new ShortwavDSP::TapestryDSP());
+  dsp->setSampleRate(48000.0f);
+  dsp->loadReel(reel.data(), frames);
+  dsp->runAnalysis();  // Analysis thread
+  return dsp;
+}
+
+void rtSilence(int, float &l, float &r)
+{
+  l = r = 0.0f;
+}
+
+void rtTone(int i, float &l, float &r)
+{
+  l = r = 0.5f * std::sin(static_cast<float>(i) * 0.05f);
+}
+
+void test_rt_playback_modes(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TapestryDSP> dsp = makeRtDsp(96000);
+  RtProbe probe("playback modes are real-time safe");
+  const int kSamples = 2400;
+
+  // Every Morph tier, forward and reverse
+  const float kMorphs[] = {0.1f, 0.3f, 0.4f, 0.6f, 0.85f};
+  for (float morph : kMorphs)
+  {
+    dsp->setMorph(morph);
+    dsp->setVariSpeed(0.75f);
+    probe.process(*dsp, "process (morph tier, forward)", kSamples, rtSilence);
+    dsp->setVariSpeed(0.2f);
+    probe.process(*dsp, "process (morph tier, reverse)", kSamples, rtSilence);
+  }
+  dsp->setVariSpeed(0.5f);
+  probe.process(*dsp, "process (stopped)", kSamples, rtSilence);
+  dsp->setVariSpeed(0.75f);
+
+  for (int mode = 0; mode < static_cast<int>(PlaybackMode::NUM_MODES); mode++)
+  {
+    dsp->setPlaybackMode(static_cast<PlaybackMode>(mode));
+    probe.process(*dsp, "process (playback mode)", kSamples, rtSilence);
+  }
+  dsp->setPlaybackMode(PlaybackMode::Granular);
+
+  for (int q = 0; q < static_cast<int>(InterpolationQuality::NUM_QUALITIES); q++)
+  {
+    dsp->setInterpolationQuality(static_cast<InterpolationQuality>(q));
+    probe.process(*dsp, "process (interpolation quality)", kSamples, rtSilence);
+  }
+
+  dsp->setPolyChannels(4);
+  for (int ch = 0; ch < 4; ch++)
+  {
+    dsp->setPolyVoice(ch, true, 0.25f * static_cast<float>(ch), 0.0f);
+  }
+  probe.process(*dsp, "process (4 poly playheads)", kSamples, rtSilence);
+  dsp->setPolyChannels(1);
+
+  dsp->setReadHeadCount(4);
+  probe.process(*dsp, "process (4 read heads)", kSamples, rtSilence);
+  dsp->setReadHeadCount(0);
+
+  dsp->setControlRate(64);
+  dsp->setAudioRateCv(ControlParam::Pitch, true);
+  dsp->setPitchCv(1.0f);
+  probe.process(*dsp, "process (control rate, audio-rate pitch)", kSamples, rtSilence);
+
+  dsp->setTempoLock(true);
+  probe.call("onClockRising", [&]() { dsp->onClockRising(); });
+  probe.process(*dsp, "process (clock period)", 12000, rtSilence);
+  probe.call("onClockRising", [&]() { dsp->onClockRising(); });
+  probe.process(*dsp, "process (tempo lock)", kSamples, rtSilence);
+  probe.call("onClockDisconnected", [&]() { dsp->onClockDisconnected(); });
+  probe.process(*dsp, "process (clock disconnected)", kSamples, rtSilence);
+
+  probe.check(ctx);
+}
+
+void test_rt_gates_and_triggers(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TapestryDSP> dsp = makeRtDsp(96000);
+  RtProbe probe("gates and triggers are real-time safe");
+  const int kSamples = 2400;
+  dsp->setVariSpeed(0.75f);
+
+  probe.call("onPlayGate(false)", [&]() { dsp->onPlayGate(false); });
+  probe.process(*dsp, "process (gate low)", kSamples, rtSilence);
+  probe.call("onPlayGate(true)", [&]() { dsp->onPlayGate(true); });
+  probe.process(*dsp, "process (gate high)", kSamples, rtSilence);
+  probe.call("stopPlayback", [&]() { dsp->stopPlayback(); });
+  probe.call("startPlayback", [&]() { dsp->startPlayback(); });
+
+  for (int i = 0; i < 4; i++)
+  {
+    probe.call("onSpliceTrigger", [&]() { dsp->onSpliceTrigger(10000 + 15000 * static_cast<size_t>(i)); });
+    probe.call("onShiftTrigger", [&]() { dsp->onShiftTrigger(); });
+    probe.process(*dsp, "process (after shift)", kSamples, rtSilence);
+  }
+  for (int i = 0; i <= 10; i++)
+  {
+    probe.call("setOrganize", [&]() { dsp->setOrganize(0.1f * static_cast<float>(i)); });
+    probe.process(*dsp, "process (organize)", 240, rtSilence);
+  }
+  for (int mode = 0; mode < static_cast<int>(OrganizeSortMode::NUM_MODES); mode++)
+  {
+    probe.call("setOrganizeSortMode", [&]() { dsp->setOrganizeSortMode(static_cast<OrganizeSortMode>(mode)); });
+    probe.call("setOrganize", [&]() { dsp->setOrganize(mode % 2 ? 0.9f : 0.1f); });
+    probe.process(*dsp, "process (sorted organize)", kSamples, rtSilence);
+  }
+
+  probe.check(ctx);
+}
+
+void test_rt_record_modes(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TapestryDSP> dsp = makeRtDsp(96000);
+  RtProbe probe("record modes are real-time safe");
+  const int kSamples = 4800;
+  dsp->setVariSpeed(0.75f);
+
+  for (int sync = 0; sync < 2; sync++)
+  {
+    bool clockSync = sync == 1;
+    probe.call("startRecordingSameSplice", [&]() { dsp->startRecordingSameSplice(clockSync); });
+    if (clockSync)
+      probe.call("onClockRising (start)", [&]() { dsp->onClockRising(); });
+    probe.process(*dsp, "process (record same splice)", kSamples, rtTone);
+    probe.call("stopRecordingRequest", [&]() { dsp->stopRecordingRequest(clockSync); });
+    if (clockSync)
+      probe.call("onClockRising (stop)", [&]() { dsp->onClockRising(); });
+    probe.process(*dsp, "process (after record)", kSamples, rtSilence);
+
+    probe.call("startRecordingNewSplice", [&]() { dsp->startRecordingNewSplice(clockSync); });
+    if (clockSync)
+      probe.call("onClockRising (start)", [&]() { dsp->onClockRising(); });
+    probe.process(*dsp, "process (record new splice)", kSamples, rtTone);
+    probe.call("stopRecordingRequest", [&]() { dsp->stopRecordingRequest(clockSync); });
+    if (clockSync)
+      probe.call("onClockRising (stop)", [&]() { dsp->onClockRising(); });
+  }
+
+  // Overdub with feedback and saturation
+  dsp->setOverdubMode(true);
+  dsp->setOverdubFeedback(0.8f);
+  dsp->setOverdubSaturation(true);
+  probe.call("startRecordingSameSplice (overdub)", [&]() { dsp->startRecordingSameSplice(); });
+  probe.process(*dsp, "process (overdub)", kSamples, rtTone);
+  probe.call("stopRecordingRequest", [&]() { dsp->stopRecordingRequest(); });
+  dsp->setOverdubMode(false);
+
+  // Sound-on-Sound blend moving during a pass
+  dsp->setSos(0.5f);
+  probe.call("startRecordingSameSplice (SOS)", [&]() { dsp->startRecordingSameSplice(); });
+  probe.call("setSosCv", [&]() { dsp->setSosCv(2.0f); });
+  probe.process(*dsp, "process (sound on sound)", kSamples, rtTone);
+  probe.call("stopRecordingRequest", [&]() { dsp->stopRecordingRequest(); });
+
+  probe.call("startAutoLevel", [&]() { dsp->startAutoLevel(); });
+  probe.process(*dsp, "process (auto level)", kSamples, rtTone);
+  probe.call("stopAutoLevel", [&]() { dsp->stopAutoLevel(); });
+
+  // Clearing a reel and recording over it from the start
+  probe.call("clearAndStartRecording", [&]() { dsp->clearAndStartRecording(); });
+  probe.process(*dsp, "process (record into cleared reel)", kSamples, rtTone);
+  probe.call("stopRecordingRequest", [&]() { dsp->stopRecordingRequest(); });
+  probe.call("clearAndStartRecording (clock)", [&]() { dsp->clearAndStartRecording(true); });
+  probe.call("onClockRising (start)", [&]() { dsp->onClockRising(); });
+  probe.process(*dsp, "process (clocked record)", kSamples, rtTone);
+  probe.call("onPlayGate (stop)", [&]() { dsp->onPlayGate(false); });
+  probe.process(*dsp, "process (after stop)", kSamples, rtSilence);
+
+  T_ASSERT(ctx, dsp->getBuffer().getUsedFrames() > 0);
+  probe.check(ctx);
+}
+
+void test_rt_splice_operations(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TapestryDSP> dsp = makeRtDsp(96000);
+  RtProbe probe("splice operations are real-time safe");
+  dsp->setVariSpeed(0.75f);
+
+  // Fill the reel to the splice limit, one marker per trigger
+  for (size_t m = 1; m < SpliceManager::kMaxSplices + 5; m++)
+  {
+    probe.call("onSpliceTrigger", [&]() { dsp->onSpliceTrigger(m * 300 + 7); });
+  }
+  T_ASSERT(ctx, dsp->getSpliceManager().getNumSplices() == SpliceManager::kMaxSplices);
+  probe.process(*dsp, "process (300 splices)", 2400, rtSilence);
+  probe.call("setOrganize", [&]() { dsp->setOrganize(0.77f); });
+  probe.call("onShiftTrigger", [&]() { dsp->onShiftTrigger(); });
+  probe.call("deleteCurrentMarker", [&]() { dsp->deleteCurrentMarker(); });
+  probe.call("onSpliceTrigger (refill)", [&]() { dsp->onSpliceTrigger(50007); });
+  probe.call("deleteCurrentSpliceAudio", [&]() { dsp->deleteCurrentSpliceAudio(); });
+  probe.process(*dsp, "process (after delete)", 2400, rtSilence);
+  probe.call("deleteAllMarkers", [&]() { dsp->deleteAllMarkers(); });
+  probe.call("spliceToBeatGrid", [&]() { dsp->spliceToBeatGrid(1); });
+  probe.process(*dsp, "process (beat grid)", 2400, rtSilence);
+
+  // Restoring saved markers, as the module does after a patch load
+  std::vector<size_t> saved;
+  for (size_t m = 0; m < 400; m++)
+  {
+    saved.push_back((m * 7919) % 96000);
+  }
+  probe.call("setFromMarkerPositions", [&]() {
+    dsp->getSpliceManager().setFromMarkerPositions(saved, dsp->getBuffer().getUsedFrames());
+  });
+  T_ASSERT(ctx, dsp->getSpliceManager().getNumSplices() == SpliceManager::kMaxSplices);
+  probe.process(*dsp, "process (restored markers)", 2400, rtSilence);
+
+  probe.call("clearReel", [&]() { dsp->clearReel(); });
+  probe.process(*dsp, "process (empty reel)", 2400, rtSilence);
+
+  probe.check(ctx);
+}
+
+void test_splice_markers_unsorted_restore(TestContext &ctx)
+{
+  using ShortwavDSP::SpliceManager;
+
+  SpliceManager manager;
+  std::vector<size_t> positions = {700, 200, 200, 0, 5000, 450};
+  manager.setFromMarkerPositions(positions, 1000);
+
+  // Sorted, deduplicated, 0 kept once and 5000 (past the end) dropped
+  T_ASSERT(ctx, manager.getNumSplices() == 4);
+  T_ASSERT(ctx, manager.getSplice(0)->startFrame == 0 && manager.getSplice(0)->endFrame == 200);
+  T_ASSERT(ctx, manager.getSplice(1)->startFrame == 200 && manager.getSplice(1)->endFrame == 450);
+  T_ASSERT(ctx, manager.getSplice(2)->startFrame == 450 && manager.getSplice(2)->endFrame == 700);
+  T_ASSERT(ctx, manager.getSplice(3)->startFrame == 700 && manager.getSplice(3)->endFrame == 1000);
+
+  manager.setFromMarkerPositions(std::vector<size_t>(), 1000);
+  T_ASSERT(ctx, manager.getNumSplices() == 1);
+  manager.setFromMarkerPositions(positions, 0);
+  T_ASSERT(ctx, manager.getNumSplices() == 0);
+}
+
+void test_buffer_clear_reclaims_stale_frames(TestContext &ctx)
+{
+  using ShortwavDSP::TapestryBuffer;
+
+  std::unique_ptr<TapestryBuffer> buffer(new TapestryBuffer());
+  for (size_t i = 0; i < 1000; i++)
+  {
+    buffer->writeStereo(i, 1.0f, -1.0f);
+  }
+  buffer->clear();
+  T_ASSERT(ctx, buffer->getUsedFrames() == 0);
+
+  // A write past the start exposes a gap, which must read as silence
+  buffer->writeStereo(500, 0.25f, 0.25f);
+  float l, r;
+  buffer->readStereo(100, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.0f, kEpsilon);
+  buffer->readStereo(499, l, r);
+  T_ASSERT_NEAR(ctx, r, 0.0f, kEpsilon);
+  buffer->readStereo(500, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.25f, kEpsilon);
+
+  // Sound-on-Sound past the used region mixes with silence, not old audio
+  buffer->mixAndWrite(700, 0.5f, 0.5f, 0.5f);
+  buffer->readStereo(700, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.25f, kEpsilon);
+  buffer->readStereo(600, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.0f, kEpsilon);
+
+  // Growing the used length directly exposes zeros too
+  buffer->setUsedFrames(1000);
+  buffer->readStereo(900, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.0f, kEpsilon);
+  T_ASSERT_NEAR(ctx, r, 0.0f, kEpsilon);
+
+  // Shrinking and growing again does not resurrect frames either
+  buffer->setUsedFrames(600);
+  buffer->setUsedFrames(800);
+  buffer->readStereo(700, l, r);
+  T_ASSERT_NEAR(ctx, l, 0.0f, kEpsilon);
+}
+
+//------------------------------------------------------------------------------
+// Telemetry Tests
+//------------------------------------------------------------------------------
+
+// Publish one block in which the stage took `ticks`
+void addTelemetryBlock(ShortwavDSP::Telemetry &telemetry, ShortwavDSP::TelemetryStage stage, uint32_t ticks)
+{
+  telemetry.add(stage, ticks);
+  for (int i = 0; i < ShortwavDSP::Telemetry::kBlockSamples; i++)
+  {
+    telemetry.endSample();
+  }
+}
+
+void test_telemetry_block_stats(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<Telemetry> telemetry(new Telemetry());
+
+  // Nothing is published before a block completes
+  telemetry->add(TelemetryStage::Grain, 10);
+  for (int i = 0; i < Telemetry::kBlockSamples - 1; i++)
+  {
+    telemetry->endSample();
+  }
+  T_ASSERT(ctx, telemetry->getBlockCount() == 0u);
+  T_ASSERT(ctx, telemetry->getStats(TelemetryStage::Grain, 1e6).blocks == 0);
+  telemetry->endSample();
+  T_ASSERT(ctx, telemetry->getBlockCount() == 1u);
+
+  // Blocks of 1..100 ticks at 1 MHz are 1..100 us
+  telemetry->reset();
+  for (uint32_t b = 1; b <= 100; b++)
+  {
+    addTelemetryBlock(*telemetry, TelemetryStage::Grain, b);
+  }
+  Telemetry::Stats grain = telemetry->getStats(TelemetryStage::Grain, 1e6);
+  T_ASSERT(ctx, grain.blocks == 100);
+  T_ASSERT_NEAR(ctx, grain.meanMicros, 50.5, 1e-9);
+  T_ASSERT_NEAR(ctx, grain.p99Micros, 99.0, 1e-9);
+  T_ASSERT_NEAR(ctx, grain.maxMicros, 100.0, 1e-9);
+
+  // Stages are independent; 2 MHz halves the times
+  Telemetry::Stats record = telemetry->getStats(TelemetryStage::Record, 1e6);
+  T_ASSERT(ctx, record.blocks == 100);
+  T_ASSERT_NEAR(ctx, record.maxMicros, 0.0, 1e-12);
+  T_ASSERT_NEAR(ctx, telemetry->getStats(TelemetryStage::Grain, 2e6).maxMicros, 50.0, 1e-9);
+
+  // No rate, no stats
+  T_ASSERT(ctx, telemetry->getStats(TelemetryStage::Grain, 0.0).blocks == 0);
+  T_ASSERT_NEAR(ctx, Telemetry::blockMicros(48000.0f), 256.0 * 1e6 / 48000.0, 1e-9);
+}
+
+void test_telemetry_history_wraps(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<Telemetry> telemetry(new Telemetry());
+
+  // Early expensive blocks fall out of the history
+  const int kBlocks = Telemetry::kHistoryBlocks + 88;
+  for (int b = 0; b < kBlocks; b++)
+  {
+    addTelemetryBlock(*telemetry, TelemetryStage::Lights, b < 88 ? 1000u : 5u);
+  }
+  T_ASSERT(ctx, telemetry->getBlockCount() == static_cast<uint32_t>(kBlocks));
+  Telemetry::Stats lights = telemetry->getStats(TelemetryStage::Lights, 1e6);
+  T_ASSERT(ctx, lights.blocks == Telemetry::kHistoryBlocks);
+  T_ASSERT_NEAR(ctx, lights.maxMicros, 5.0, 1e-9);
+  T_ASSERT_NEAR(ctx, lights.meanMicros, 5.0, 1e-9);
+
+  telemetry->reset();
+  T_ASSERT(ctx, telemetry->getBlockCount() == 0u);
+  T_ASSERT(ctx, telemetry->getStats(TelemetryStage::Lights, 1e6).blocks == 0);
+
+  // Null probes do nothing
+  T_ASSERT(ctx, Telemetry::begin(nullptr) == 0u);
+  Telemetry::end(nullptr, TelemetryStage::Total, 0);
+}
+
+void test_telemetry_dsp_stages(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TapestryDSP> dsp = makeRtDsp(48000);
+  std::unique_ptr<Telemetry> telemetry(new Telemetry());
+  const int kSamples = Telemetry::kBlockSamples * 4;
+
+  // Playback only: the grain stage is timed, recording is not
+  dsp->setTelemetry(telemetry.get());
+  dsp->onPlayGate(true);
+  for (int i = 0; i < kSamples; i++)
+  {
+    dsp->process(0.0f, 0.0f);
+    telemetry->endSample();
+  }
+  T_ASSERT(ctx, telemetry->getBlockCount() == 4u);
+  T_ASSERT(ctx, telemetry->getStats(TelemetryStage::Grain, 1e6).maxMicros > 0.0);
+  T_ASSERT_NEAR(ctx, telemetry->getStats(TelemetryStage::Record, 1e6).maxMicros, 0.0, 1e-12);
+
+  // Recording adds the record stage
+  telemetry->reset();
+  dsp->startRecordingSameSplice();
+  for (int i = 0; i < kSamples; i++)
+  {
+    dsp->process(0.3f, -0.3f);
+    telemetry->endSample();
+  }
+  dsp->stopRecordingRequest();
+  T_ASSERT(ctx, telemetry->getStats(TelemetryStage::Record, 1e6).maxMicros > 0.0);
+
+  // Detached: the DSP no longer adds to the stages
+  dsp->setTelemetry(nullptr);
+  telemetry->reset();
+  for (int i = 0; i < kSamples; i++)
+  {
+    dsp->process(0.0f, 0.0f);
+    telemetry->endSample();
+  }
+  T_ASSERT_NEAR(ctx, telemetry->getStats(TelemetryStage::Grain, 1e6).maxMicros, 0.0, 1e-12);
+}
+
+//------------------------------------------------------------------------------
+// Event Trace Tests
+//------------------------------------------------------------------------------
+
+void test_trace_ring_records_in_order(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TraceRing> trace(new TraceRing());
+  T_ASSERT(ctx, trace->snapshot().empty());
+
+  uint64_t start = TraceRing::now();
+  trace->begin(TraceThread::FileIO, TraceEvent::FileLoad);
+  trace->instant(TraceThread::Audio, TraceEvent::SpliceChange, 3);
+  trace->end(TraceThread::FileIO, TraceEvent::FileLoad);
+  trace->complete(TraceThread::Analysis, TraceEvent::Analysis, start, 1);
+
+  std::vector<TraceRecord> records = trace->snapshot();
+  T_ASSERT(ctx, records.size() == 4u);
+  T_ASSERT(ctx, trace->getWriteCount() == 4u);
+
+  // Sorted by start time: the complete event started first
+  T_ASSERT(ctx, records[0].event == TraceEvent::Analysis);
+  T_ASSERT(ctx, records[0].phase == TracePhase::Complete);
+  T_ASSERT(ctx, records[0].thread == TraceThread::Analysis);
+  T_ASSERT(ctx, records[0].arg == 1);
+  T_ASSERT(ctx, records[0].timeNanos + records[0].durationNanos >= records[3].timeNanos);
+  T_ASSERT(ctx, records[1].phase == TracePhase::Begin);
+  T_ASSERT(ctx, records[2].event == TraceEvent::SpliceChange);
+  T_ASSERT(ctx, records[2].arg == 3);
+  T_ASSERT(ctx, records[3].phase == TracePhase::End);
+  for (size_t i = 1; i < records.size(); i++)
+  {
+    T_ASSERT(ctx, records[i].timeNanos >= records[i - 1].timeNanos);
+  }
+
+  // A full ring keeps the newest events (the first four and kExtra clock
+  // edges are overwritten)
+  const int kExtra = 100;
+  for (int i = 0; i < static_cast<int>(TraceRing::kCapacity) + kExtra; i++)
+  {
+    trace->instant(TraceThread::Audio, TraceEvent::ClockRising, i);
+  }
+  records = trace->snapshot();
+  T_ASSERT(ctx, records.size() == TraceRing::kCapacity);
+  T_ASSERT(ctx, records.front().arg == kExtra);
+  T_ASSERT(ctx, records.back().arg == static_cast<int64_t>(TraceRing::kCapacity) + kExtra - 1);
+}
+
+void test_trace_concurrent_writers(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TraceRing> trace(new TraceRing());
+  const int kWriters = 4;
+  const int kEventsPerWriter = 5000;
+  std::atomic<bool> done(false);
+  std::atomic<int> badRecords(0);
+
+  // The event and arg are written as separate atomics; a torn read would
+  // show a mismatch
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; w++)
+  {
+    writers.emplace_back([&trace, w]() {
+      for (int i = 0; i < kEventsPerWriter; i++)
+      {
+        int64_t arg = w * 1000000 + i;
+        trace->instant(static_cast<TraceThread>(w % 3), static_cast<TraceEvent>(arg % 5), arg);
+      }
+    });
+  }
+  std::thread reader([&]() {
+    while (!done.load())
+    {
+      std::vector<TraceRecord> records = trace->snapshot();
+      for (size_t i = 0; i < records.size(); i++)
+      {
+        int64_t arg = records[i].arg;
+        int w = static_cast<int>(arg / 1000000);
+        if (records[i].event != static_cast<TraceEvent>(arg % 5) ||
+            records[i].thread != static_cast<TraceThread>(w % 3))
+          badRecords++;
+      }
+    }
+  });
+  for (size_t w = 0; w < writers.size(); w++)
+  {
+    writers[w].join();
+  }
+  done.store(true);
+  reader.join();
+
+  T_ASSERT(ctx, badRecords.load() == 0);
+  T_ASSERT(ctx, trace->getWriteCount() == static_cast<uint64_t>(kWriters * kEventsPerWriter));
+  T_ASSERT(ctx, trace->snapshot().size() == TraceRing::kCapacity);
+}
+
+void test_trace_chrome_json(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::unique_ptr<TraceRing> trace(new TraceRing());
+
+  // Empty trace is still valid JSON with the thread names
+  std::string json = trace->toChromeJson();
+  T_ASSERT(ctx, json.find("\"traceEvents\":[") != std::string::npos);
+  T_ASSERT(ctx, json.find("\"args\":{\"name\":\"Audio\"}") != std::string::npos);
+  T_ASSERT(ctx, json.find(",\n]") == std::string::npos);
+
+  uint64_t start = TraceRing::now();
+  trace->instant(TraceThread::Audio, TraceEvent::EndOfGene, 2);
+  trace->begin(TraceThread::Audio, TraceEvent::Recording, 1);
+  trace->end(TraceThread::Audio, TraceEvent::Recording);
+  trace->complete(TraceThread::Analysis, TraceEvent::Analysis, start, 1);
+  json = trace->toChromeJson();
+
+  T_ASSERT(ctx, json.find("\"name\":\"EndOfGene\",\"cat\":\"tapestry\",\"ph\":\"i\"") != std::string::npos);
+  T_ASSERT(ctx, json.find("\"s\":\"t\",\"args\":{\"value\":2}") != std::string::npos);
+  T_ASSERT(ctx, json.find("\"name\":\"Recording\",\"cat\":\"tapestry\",\"ph\":\"B\"") != std::string::npos);
+  T_ASSERT(ctx, json.find("\"ph\":\"E\"") != std::string::npos);
+  T_ASSERT(ctx, json.find("\"ph\":\"X\"") != std::string::npos);
+  T_ASSERT(ctx, json.find("\"dur\":") != std::string::npos);
+  T_ASSERT(ctx, json.find(",\n]") == std::string::npos);
+  T_ASSERT(ctx, json.compare(json.size() - 3, 3, "]}\n") == 0);
+
+  int depth = 0;
+  bool balanced = true;
+  for (size_t i = 0; i < json.size(); i++)
+  {
+    depth += (json[i] == '{' || json[i] == '[') ? 1 : 0;
+    depth -= (json[i] == '}' || json[i] == ']') ? 1 : 0;
+    balanced = balanced && depth >= 0;
+  }
+  T_ASSERT(ctx, balanced && depth == 0);
+}
+
+void test_trace_dsp_events(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  std::vector<float> reel(48000 * 2, 0.1f);
+  std::unique_ptr<TapestryDSP> dsp(new TapestryDSP());
+  std::unique_ptr<TraceRing> trace(new TraceRing());
+  dsp->setSampleRate(48000.0f);
+  dsp->loadReel(reel.data(), 48000, std::vector<size_t>{24000});
+  dsp->setTrace(trace.get());
+
+  dsp->onClockRising();
+  dsp->onShiftTrigger();
+  dsp->setGeneSize(0.0f);
+  dsp->setVariSpeed(0.75f);
+  dsp->onPlayGate(true);
+  for (int i = 0; i < 48000; i++)
+  {
+    dsp->process(0.0f, 0.0f);
+  }
+  dsp->startRecordingSameSplice();
+  dsp->process(0.2f, 0.2f);
+  dsp->stopRecordingRequest();
+  dsp->stopRecordingRequest();  // Already stopped: no second End
+
+  int clocks = 0, spliceChanges = 0, endOfGenes = 0, begins = 0, ends = 0;
+  std::vector<TraceRecord> records = trace->snapshot();
+  for (size_t i = 0; i < records.size(); i++)
+  {
+    const TraceRecord &r = records[i];
+    T_ASSERT(ctx, r.thread == TraceThread::Audio);
+    clocks += (r.event == TraceEvent::ClockRising) ? 1 : 0;
+    spliceChanges += (r.event == TraceEvent::SpliceChange) ? 1 : 0;
+    endOfGenes += (r.event == TraceEvent::EndOfGene) ? 1 : 0;
+    begins += (r.event == TraceEvent::Recording && r.phase == TracePhase::Begin) ? 1 : 0;
+    ends += (r.event == TraceEvent::Recording && r.phase == TracePhase::End) ? 1 : 0;
+  }
+  T_ASSERT(ctx, clocks == 1);
+  T_ASSERT(ctx, spliceChanges >= 1);
+  T_ASSERT(ctx, endOfGenes >= 1);
+  T_ASSERT(ctx, begins == 1);
+  T_ASSERT(ctx, ends == 1);
+  T_ASSERT(ctx, records.front().event == TraceEvent::ClockRising);
+  T_ASSERT(ctx, records[1].event == TraceEvent::SpliceChange && records[1].arg == 1);
+}
+
+void test_underrun_detector(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  UnderrunDetector detector;
+  const size_t kFrames = 256;
+  const float kRate = 48000.0f;
+  const double kPeriod = kFrames / 48000.0;
+  uint64_t t = 1000000000ull;
+  int reports = 0;
+
+  // Bursty pacing within a 1024-frame buffer: several blocks back to back,
+  // then a wait
+  T_ASSERT_NEAR(ctx, detector.update(kFrames, kRate, t), 0.0, 1e-12);
+  double wall = 0.0;
+  for (int i = 1; i <= 4000; i++)
+  {
+    if (i % 4 == 0)
+      wall = i * kPeriod;
+    reports += detector.update(kFrames, kRate, t + static_cast<uint64_t>(wall * 1e9)) > 0.0 ? 1 : 0;
+  }
+  T_ASSERT(ctx, reports == 0);
+
+  // A 120 ms stall is reported once (plus the buffer the engine had run
+  // ahead by)
+  double audio = 4000 * kPeriod;
+  double stall = detector.update(kFrames, kRate, t + static_cast<uint64_t>((audio + kPeriod + 0.12) * 1e9));
+  T_ASSERT(ctx, stall >= 0.12 && stall < 0.12 + 4 * kPeriod);
+  double offset = 0.12;
+  reports = 0;
+  for (int i = 4002; i < 8000; i++)
+  {
+    reports += detector.update(kFrames, kRate, t + static_cast<uint64_t>((i * kPeriod + offset) * 1e9)) > 0.0 ? 1 : 0;
+  }
+  T_ASSERT(ctx, reports == 0);
+
+  // Clock drift of 500 ppm over ten minutes is not an underrun
+  UnderrunDetector drifting;
+  reports = 0;
+  for (int i = 0; i < static_cast<int>(600.0 / kPeriod); i++)
+  {
+    double w = i * kPeriod * 1.0005;
+    reports += drifting.update(kFrames, kRate, t + static_cast<uint64_t>(w * 1e9)) > 0.0 ? 1 : 0;
+  }
+  T_ASSERT(ctx, reports == 0);
+}
+
+void test_underrun_detector_large_host_buffer(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+
+  // 4096-frame host buffer at 44.1 kHz, checked every 256 frames: each
+  // buffer is rendered in a 2 ms burst, then the engine waits ~91 ms
+  UnderrunDetector detector;
+  const size_t kFrames = 256;
+  const float kRate = 44100.0f;
+  const int kChecksPerBuffer = 16;
+  const double kBufferPeriod = 4096 / 44100.0;
+  const double kCheckCost = 0.002 / kChecksPerBuffer;
+  const uint64_t t = 1000000000ull;
+  int reports = 0;
+  int check = 0;
+  double offset = 0.0;
+  double stall = 0.0;
+  for (int buffer = 0; buffer < 1200; buffer++)
+  {
+    // A 150 ms stall on buffer 1000 delays that burst and all that follow
+    if (buffer == 1000)
+      offset = 0.15;
+    for (int i = 0; i < kChecksPerBuffer; i++, check++)
+    {
+      double wall = buffer * kBufferPeriod + offset + i * kCheckCost;
+      double s = detector.update(kFrames, kRate, t + static_cast<uint64_t>(wall * 1e9));
+      if (s > 0.0)
+      {
+        reports++;
+        stall = s;
+      }
+    }
+  }
+  T_ASSERT(ctx, check == 1200 * kChecksPerBuffer);
+  T_ASSERT(ctx, reports == 1);
+  T_ASSERT(ctx, stall >= 0.15 && stall < 0.15 + 2 * kBufferPeriod);
+
+  // The same detector on a small buffer again catches a 60 ms stall once
+  // the large buffer has decayed out of the tolerance
+  UnderrunDetector shrinking;
+  const double kSmallPeriod = 256 / 44100.0;
+  reports = 0;
+  offset = 0.0;
+  double wall = 0.0;
+  for (int buffer = 0; buffer < 100; buffer++)
+  {
+    for (int i = 0; i < kChecksPerBuffer; i++)
+    {
+      wall = buffer * kBufferPeriod + i * kCheckCost;
+      shrinking.update(kFrames, kRate, t + static_cast<uint64_t>(wall * 1e9));
+    }
+  }
+  double base = 100 * kBufferPeriod;
+  int smallChecks = static_cast<int>(30.0 / kSmallPeriod);
+  for (int i = 0; i < smallChecks; i++)
+  {
+    if (i == smallChecks - 100)
+      offset = 0.06;
+    wall = base + i * kSmallPeriod + offset;
+    reports += shrinking.update(kFrames, kRate, t + static_cast<uint64_t>(wall * 1e9)) > 0.0 ? 1 : 0;
+  }
+  T_ASSERT(ctx, reports == 1);
+}
+
+//------------------------------------------------------------------------------
+// Golden Render Tests
+//------------------------------------------------------------------------------
+//
+// Fixed scenarios rendered through TapestryDSP and compared with reference
+// renders in src/tests/golden. By default each render must match within
+// Golden::gToleranceDb (peak error in dBFS); --golden-bit-exact requires
+// identical samples. After an intended change in output, rewrite the
+// references with --update-golden and review the diff of the WAV files.
+
+namespace Golden
+{
+
+bool gUpdate = false;
+bool gBitExact = false;
+double gToleranceDb = -100.0;
+
+const uint32_t kSampleRate = 48000;
+const size_t kReelFrames = 48000;
+const size_t kRenderFrames = 12000;
+
+std::string directory()
+{
+  std::string file = __FILE__;
+  size_t slash = file.find_last_of("/\\");
+  return ((slash == std::string::npos) ? std::string(".") : file.substr(0, slash)) + "/golden";
+}
+
+// Saw and square partials plus seeded noise bursts: integer phase and
+// FastRandom only, so the reel is identical on every platform
+std::vector<float> makeReel()
+{
+  ShortwavDSP::TapestryUtil::FastRandom random(0xC0FFEEu);
+  std::vector<float> reel(kReelFrames * 2);
+  for (size_t i = 0; i < kReelFrames; i++)
+  {
+    float saw = static_cast<float>(i % 218) / 109.0f - 1.0f;
+    float square = ((i / 91) % 2 == 0) ? 0.5f : -0.5f;
+    float burst = ((i / 6000) % 2 == 0) ? random.nextBipolar() * 0.3f : 0.0f;
+    reel[i * 2] = 0.4f * saw + burst;
+    reel[i * 2 + 1] = 0.4f * square + burst;
+  }
+  return reel;
+}
+
+std::unique_ptr<ShortwavDSP::TapestryDSP> makeDsp(const std::vector<size_t> &markers)
+{
+  std::vector<float> reel = makeReel();
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp(new ShortwavDSP::TapestryDSP());
+  dsp->setSampleRate(static_cast<float>(kSampleRate));
+  dsp->loadReel(reel.data(), kReelFrames, markers);
+  dsp->runAnalysis();
+  return dsp;
+}
+
+void renderTimeline(ShortwavDSP::TapestryDSP &dsp, const char *csv, std::vector<float> &out)
+{
+  ShortwavDSP::Timeline timeline;
+  std::string error;
+  if (!timeline.parseCsv(csv, error))
+    std::printf("  bad scenario timeline: %s\n", error.c_str());
+  out.assign(kRenderFrames * 2, 0.0f);
+  ShortwavDSP::TimelineRenderer renderer(timeline, static_cast<float>(kSampleRate));
+  renderer.render(dsp, out.data(), kRenderFrames);
+}
+
+void renderGranularMorph(std::vector<float> &out)
+{
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp = makeDsp({});
+  renderTimeline(*dsp,
+                 "0,gene_size,0.35\n0,vari_speed,0.8\n0,morph,0.3\n0,play,1\n"
+                 "0.06,morph,0.5\n0.12,morph,0.7\n0.18,morph,0.9\n",
+                 out);
+}
+
+void renderReverseVariSpeed(std::vector<float> &out)
+{
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp = makeDsp({});
+  renderTimeline(*dsp,
+                 "0,gene_size,0.5\n0,vari_speed,0.15\n0,morph,0.4\n0,slide,0.5\n0,play,1\n"
+                 "0.1,vari_speed_cv,2.5\n0.15,pitch,0.5\n",
+                 out);
+}
+
+void renderSplicesAndClock(std::vector<float> &out)
+{
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp = makeDsp({12000, 24000, 36000});
+  renderTimeline(*dsp,
+                 "0,gene_size,0.2\n0,vari_speed,0.75\n0,play,1\n"
+                 "0.02,clock,1\n0.04,clock,0\n0.06,shift,1\n0.07,shift,0\n"
+                 "0.1,organize,1\n0.12,clock,1\n0.14,clock,0\n0.2,splice,1\n",
+                 out);
+}
+
+void renderSpectral(std::vector<float> &out)
+{
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp = makeDsp({});
+  dsp->setPlaybackMode(ShortwavDSP::PlaybackMode::Spectral);
+  dsp->setSpectralStretch(2.0f);
+  renderTimeline(*dsp, "0,gene_size,0.6\n0,vari_speed,0.75\n0,play,1\n", out);
+}
+
+void renderSincReadHeads(std::vector<float> &out)
+{
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp = makeDsp({24000});
+  dsp->setInterpolationQuality(ShortwavDSP::InterpolationQuality::Sinc16);
+  dsp->setReadHeadCount(3);
+  for (int k = 0; k < 3; k++)
+  {
+    ShortwavDSP::ReadHeadSettings head;
+    head.slide = 0.25f * k;
+    head.speed = (k == 1) ? -0.5f : 1.0f + 0.5f * k;
+    head.gain = 0.8f;
+    dsp->setReadHead(k, head);
+  }
+  renderTimeline(*dsp, "0,gene_size,0.4\n0,vari_speed,0.9\n0,play,1\n", out);
+}
+
+// Overdub with feedback and saturation over a live input
+void renderOverdub(std::vector<float> &out)
+{
+  std::unique_ptr<ShortwavDSP::TapestryDSP> dsp = makeDsp({});
+  ShortwavDSP::TapestryUtil::FastRandom random(0xBEEFu);
+  dsp->setVariSpeed(0.75f);
+  dsp->setGeneSize(0.3f);
+  dsp->setOverdubMode(true);
+  dsp->setOverdubFeedback(0.8f);
+  dsp->setOverdubSaturation(true);
+  dsp->setSos(0.6f);
+  dsp->onPlayGate(true);
+  out.assign(kRenderFrames * 2, 0.0f);
+  for (size_t i = 0; i < kRenderFrames; i++)
+  {
+    if (i == 2000)
+      dsp->clearAndStartRecording(false, 1000);
+    if (i == 9000)
+      dsp->stopRecordingRequest();
+    float in = (i % 64 < 32) ? 0.3f : -0.3f;
+    ShortwavDSP::TapestryDSP::ProcessResult result = dsp->process(in, in * 0.5f + random.nextBipolar() * 0.05f);
+    out[i * 2] = result.audioOutL;
+    out[i * 2 + 1] = result.audioOutR;
+  }
+}
+
+struct Scenario
+{
+  const char *name;
+  void (*render)(std::vector<float> &out);
+};
+
+const Scenario kScenarios[] = {
+    {"granular_morph", renderGranularMorph},
+    {"reverse_vari_speed", renderReverseVariSpeed},
+    {"splices_and_clock", renderSplicesAndClock},
+    {"spectral", renderSpectral},
+    {"sinc_read_heads", renderSincReadHeads},
+    {"overdub", renderOverdub},
+};
+
+// Peak difference in dBFS (-inf when identical)
+double peakErrorDb(const std::vector<float> &a, const std::vector<float> &b, size_t &firstDiff)
+{
+  double peak = 0.0;
+  firstDiff = a.size();
+  for (size_t i = 0; i < a.size(); i++)
+  {
+    double diff = std::fabs(static_cast<double>(a[i]) - b[i]);
+    if (diff > 0.0 && firstDiff == a.size())
+      firstDiff = i;
+    peak = std::max(peak, diff);
+  }
+  return (peak > 0.0) ? 20.0 * std::log10(peak) : -std::numeric_limits<double>::infinity();
+}
+
+} // namespace Golden
+
+void test_golden_renders(TestContext &ctx)
+{
+  for (const Golden::Scenario &scenario : Golden::kScenarios)
+  {
+    std::vector<float> out;
+    scenario.render(out);
+    std::string path = Golden::directory() + "/" + scenario.name + ".wav";
+    std::string error;
+
+    if (Golden::gUpdate)
+    {
+      bool written = ShortwavDSP::Wav::write(path, out.data(), out.size() / 2, Golden::kSampleRate,
+                                             ShortwavDSP::Wav::Format::Float32, error);
+      std::printf("  %s %s\n", written ? "updated" : error.c_str(), path.c_str());
+      T_ASSERT(ctx, written);
+      continue;
+    }
+
+    ShortwavDSP::Wav::Audio reference;
+    bool loaded = ShortwavDSP::Wav::read(path, reference, error);
+    if (!loaded)
+      std::printf("  %s (run with --update-golden to create it)\n", error.c_str());
+    T_ASSERT(ctx, loaded);
+    if (!loaded)
+      continue;
+    T_ASSERT(ctx, reference.samples.size() == out.size());
+    if (reference.samples.size() != out.size())
+      continue;
+
+    // All renders must produce sound, or the comparison proves nothing
+    float peak = 0.0f;
+    for (float s : out)
+    {
+      peak = std::max(peak, std::fabs(s));
+    }
+    T_ASSERT(ctx, peak > 0.01f);
+
+    size_t firstDiff = 0;
+    double errorDb = Golden::peakErrorDb(out, reference.samples, firstDiff);
+    bool matchesReference = Golden::gBitExact ? firstDiff == out.size() : errorDb <= Golden::gToleranceDb;
+    if (!matchesReference)
+    {
+      char limit[32];
+      std::snprintf(limit, sizeof(limit), Golden::gBitExact ? "bit-exact" : "%.1f dBFS", Golden::gToleranceDb);
+      std::printf("  %s: peak error %.1f dBFS (limit %s), first difference at frame %zu\n", scenario.name,
+                  errorDb, limit, firstDiff / 2);
+    }
+    T_ASSERT(ctx, matchesReference);
+  }
+}
+
+// The scenarios themselves must be deterministic for the suite to mean
+// anything
+void test_golden_renders_repeatable(TestContext &ctx)
+{
+  for (const Golden::Scenario &scenario : Golden::kScenarios)
+  {
+    std::vector<float> first;
+    std::vector<float> second;
+    scenario.render(first);
+    scenario.render(second);
+    T_ASSERT(ctx, first == second);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Denormal Tests
+//------------------------------------------------------------------------------
+
+bool isSubnormal(float x)
+{
+  return std::fpclassify(x) == FP_SUBNORMAL;
+}
+
+void test_denormal_guard_scoping(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  volatile float tiny = std::numeric_limits<float>::min();
+  float before = tiny * 0.5f;
+  {
+    ScopedFlushDenormals flushDenormals;
+    float flushed = tiny * 0.5f;
+    T_ASSERT(ctx, !ScopedFlushDenormals::kHardware || flushed == 0.0f);
+    {
+      ScopedFlushDenormals nested;  // Already flushing: nothing to change
+      T_ASSERT(ctx, !ScopedFlushDenormals::kHardware || tiny * 0.5f == 0.0f);
+    }
+    T_ASSERT(ctx, !ScopedFlushDenormals::kHardware || tiny * 0.5f == 0.0f);
+  }
+
+  // The previous mode is restored on exit
+  float after = tiny * 0.5f;
+  T_ASSERT(ctx, after == before);
+
+  // The software fallback only zeroes values the hardware would
+  T_ASSERT(ctx, flushDenormal(0.25f) == 0.25f);
+  T_ASSERT(ctx, flushDenormal(-1e-20f) == -1e-20f);
+  T_ASSERT(ctx, flushDenormal(0.0f) == 0.0f);
+}
+
+// Seconds for one pass of a Moog filter over `samples` samples of input
+template <class Input>
+double timeMoog(MoogVCFDSP &filter, int samples, Input input, float &sink)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < samples; i++)
+  {
+    sink += filter.process(input(i));
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void test_denormal_moog_decay(TestContext &ctx)
+{
+  ShortwavDSP::ScopedFlushDenormals flushDenormals;
+  MoogVCFDSP filter;
+  filter.setParams(0.0f, 0.0f, 48000.0f);  // Slowest decay: 20 Hz
+
+  // Decay from an impulse all the way through the subnormal range
+  filter.process(1.0f);
+  int subnormals = 0;
+  float out = 1.0f;
+  for (int i = 0; i < 400000; i++)
+  {
+    out = filter.process(0.0f);
+    subnormals += isSubnormal(out) ? 1 : 0;
+  }
+  T_ASSERT(ctx, subnormals == 0);
+  T_ASSERT(ctx, std::fabs(out) < 1e-30f);
+
+  // A silent tail costs no more than a busy signal (best of several passes;
+  // without flushing the tail is ~10x slower on x86)
+  const int kSamples = 50000;
+  float sink = 0.0f;
+  double tail = 1e9;
+  double busy = 1e9;
+  for (int pass = 0; pass < 5; pass++)
+  {
+    filter.reset();
+    filter.process(1.0f);
+    timeMoog(filter, 300000, [](int) { return 0.0f; }, sink);
+    tail = std::min(tail, timeMoog(filter, kSamples, [](int) { return 0.0f; }, sink));
+    busy = std::min(busy, timeMoog(filter, kSamples, [](int i) { return (i % 7) * 0.1f - 0.3f; }, sink));
+  }
+  T_ASSERT(ctx, std::isfinite(sink));
+  T_ASSERT(ctx, tail < busy * 2.0);
+}
+
+void test_denormal_dsp_followers_decay(TestContext &ctx)
+{
+  using namespace ShortwavDSP;
+  ScopedFlushDenormals flushDenormals;
+  std::unique_ptr<TapestryDSP> dsp(new TapestryDSP());
+  dsp->setSampleRate(48000.0f);
+  dsp->setSos(0.0f);  // Output follows the input
+  dsp->startAutoLevel();
+
+  for (int i = 0; i < 4800; i++)
+  {
+    dsp->process(0.5f, -0.5f);
+  }
+
+  // The 100 ms release passes 1e-38 after ~9 s of silence
+  int subnormals = 0;
+  TapestryDSP::ProcessResult result;
+  for (int i = 0; i < 48000 * 12; i++)
+  {
+    result = dsp->process(0.0f, 0.0f);
+    subnormals += isSubnormal(result.cvOut) ? 1 : 0;
+  }
+  dsp->stopAutoLevel();
+  T_ASSERT(ctx, subnormals == 0);
+  T_ASSERT(ctx, std::fabs(result.cvOut) < 1e-30f);
+}
+
+// The Moog loop no longer checks every stage every sample: a NaN input is
+// detected once per block and the chain recovers
+void test_denormal_nan_recovery(TestContext &ctx)
+{
+  MoogVCFDSP filter;
+  filter.setParams(0.5f, 0.5f, 48000.0f);
+  filter.process(std::numeric_limits<float>::quiet_NaN());
+  T_ASSERT(ctx, !filter.isFinite());
+  filter.reset();
+  T_ASSERT(ctx, filter.isFinite() && std::isfinite(filter.process(0.5f)));
+
+  ExpanderEffectChain::Params params;
+  params.crushMix = 0.5f;
+  params.filterMix = 1.0f;
+  params.cutoff = 0.5f;
+  ExpanderEffectChain chain;
+  chain.setImmediate(params);
+  float left[32];
+  float right[32];
+  bool recovered = true;
+  for (int block = 0; block < 8; block++)
+  {
+    for (int i = 0; i < 32; i++)
+    {
+      left[i] = right[i] = 0.3f * std::sin(0.1f * (block * 32 + i));
+    }
+    if (block == 2)
+      left[5] = std::numeric_limits<float>::quiet_NaN();
+    chain.process(left, right, 32);
+    for (int i = 0; i < 32; i++)
+    {
+      recovered = recovered && std::isfinite(left[i]) && std::isfinite(right[i]);
+    }
+  }
+  T_ASSERT(ctx, recovered);
+  T_ASSERT(ctx, std::fabs(left[31]) > 1e-3f);  // Still passing audio
+}
+
+//------------------------------------------------------------------------------
+// Expander Block Transport Tests
+//------------------------------------------------------------------------------
+
+// Per-sample reference for the expander chain (the chain before block processing)
+struct ExpanderReference
+{
+  BitCrusherDSP crusher;
+  MoogVCFDSP filterL, filterR;
+  float dcInL = 0.0f, dcInR = 0.0f, dcOutL = 0.0f, dcOutR = 0.0f;
+  float dcCoeff = std::exp(-2.0f * static_cast<float>(M_PI) * 20.0f / 48000.0f);
+
+  void process(const ExpanderEffectChain::Params &p, float &l, float &r)
+  {
+    crusher.setParams(p.bits, p.rate);
+    filterL.setParams(p.cutoff, p.resonance, 48000.0f);
+    filterR.setParams(p.cutoff, p.resonance, 48000.0f);
+    float blockedL = l - dcInL + dcCoeff * dcOutL;
+    float blockedR = r - dcInR + dcCoeff * dcOutR;
+    dcInL = l;
+    dcInR = r;
+    dcOutL = blockedL;
+    dcOutR = blockedR;
+    float crushedL, crushedR;
+    crusher.processStereo(blockedL, blockedR, crushedL, crushedR);
+    float stage1L = blockedL * (1.0f - p.crushMix) + crushedL * p.crushMix;
+    float stage1R = blockedR * (1.0f - p.crushMix) + crushedR * p.crushMix;
+    float outL = stage1L * (1.0f - p.filterMix) + filterL.process(stage1L) * p.filterMix;
+    float outR = stage1R * (1.0f - p.filterMix) + filterR.process(stage1R) * p.filterMix;
+    l = std::max(-1.5f, std::min(1.5f, std::tanh(outL * p.outputLevel * 0.5f) * 2.0f));
+    r = std::max(-1.5f, std::min(1.5f, std::tanh(outR * p.outputLevel * 0.5f) * 2.0f));
+  }
+};
+
+void test_expander_chain_block_matches_per_sample(TestContext &ctx)
+{
+  ExpanderEffectChain::Params params;
+  params.bits = 6.0f;
+  params.rate = 0.1f;
+  params.crushMix = 0.6f;
+  params.cutoff = 0.55f;
+  params.resonance = 0.7f;
+  params.filterMix = 0.8f;
+  params.outputLevel = 1.3f;
+
+  ExpanderEffectChain chain;
+  chain.setSampleRate(48000.0f);
+  chain.setImmediate(params);
+  ExpanderReference reference;
+
+  const int kFrames = 4096;
+  std::vector<float> left(kFrames), right(kFrames);
+  ShortwavDSP::TapestryUtil::FastRandom random(0xE49u);
+  for (int i = 0; i < kFrames; i++)
+  {
+    left[i] = random.nextRange(-0.8f, 0.8f);
+    right[i] = random.nextRange(-0.8f, 0.8f);
+  }
+  std::vector<float> expectL = left, expectR = right;
+  for (int i = 0; i < kFrames; i++)
+  {
+    reference.process(params, expectL[i], expectR[i]);
+  }
+
+  // Uneven block sizes, including ones longer than kMaxBlockFrames
+  const int kSizes[] = {32, 1, 7, 100, 32, 3};
+  int pos = 0;
+  for (int b = 0; pos < kFrames; b++)
+  {
+    int n = std::min(kSizes[b % 6], kFrames - pos);
+    chain.process(&left[pos], &right[pos], n);
+    pos += n;
+  }
+
+  float maxError = 0.0f;
+  for (int i = 0; i < kFrames; i++)
+  {
+    maxError = std::max(maxError, std::fabs(left[i] - expectL[i]));
+    maxError = std::max(maxError, std::fabs(right[i] - expectR[i]));
+  }
+  T_ASSERT(ctx, maxError < 1e-5f);
+}
+
+void test_expander_chain_smoothing_reaches_targets(TestContext &ctx)
+{
+  ExpanderEffectChain chain;
+  chain.setSampleRate(48000.0f);
+  chain.setImmediate(ExpanderEffectChain::Params());
+
+  // Output level to zero: after 100 ms of 5 ms smoothing the output is silent
+  ExpanderEffectChain::Params muted;
+  muted.outputLevel = 0.0f;
+  chain.setTargets(muted);
+  float left[ExpanderEffectChain::kMaxBlockFrames];
+  float right[ExpanderEffectChain::kMaxBlockFrames];
+  float first = 0.0f;
+  float last = 1.0f;
+  for (int block = 0; block < 75; block++)
+  {
+    for (int i = 0; i < ExpanderEffectChain::kMaxBlockFrames; i++)
+    {
+      left[i] = right[i] = (i % 2) ? 0.5f : -0.5f;
+    }
+    chain.process(left, right, ExpanderEffectChain::kMaxBlockFrames);
+    if (block == 0)
+      first = std::fabs(left[1]);
+    last = std::fabs(left[ExpanderEffectChain::kMaxBlockFrames - 1]);
+  }
+  T_ASSERT(ctx, first > 0.1f);
+  T_ASSERT(ctx, last < 1e-6f);
+}
+
+// Tapestry and the expander exchanging blocks through Rack-style
+// double-buffered messages, flipped at the end of each engine step
+struct ExpanderTransportSim
+{
+  TapestryExpanderMessage tapestryMessages[2];  // Tapestry's rightExpander
+  TapestryExpanderMessage expanderMessages[2];  // The expander's leftExpander
+  TapestryExpanderMessage *tapestryProducer = &tapestryMessages[0];
+  TapestryExpanderMessage *tapestryConsumer = &tapestryMessages[1];
+  TapestryExpanderMessage *expanderProducer = &expanderMessages[0];
+  TapestryExpanderMessage *expanderConsumer = &expanderMessages[1];
+  TapestryExpanderLink link;
+  uint32_t lastSequence = 0;
+  float gain = 0.5f;
+  int blocksProcessed = 0;
+
+  // One engine step; returns whether a processed frame was played
+  bool step(float in, float &out)
+  {
+    bool tapestryFlip = false;
+    bool expanderFlip = false;
+
+    // Tapestry
+    link.receive(tapestryConsumer);
+    float outR = 0.0f;
+    bool processed = link.pull(out, outR);
+    if (link.send(expanderProducer, in, -in, 48000.0f))
+      expanderFlip = true;
+
+    // Expander
+    if (expanderConsumer->sequence != 0 && expanderConsumer->sequence != lastSequence)
+    {
+      lastSequence = expanderConsumer->sequence;
+      for (int i = 0; i < TapestryExpanderMessage::kBlockFrames; i++)
+      {
+        tapestryProducer->processedL[i] = expanderConsumer->audioL[i] * gain;
+        tapestryProducer->processedR[i] = expanderConsumer->audioR[i] * gain;
+      }
+      tapestryProducer->sequence = expanderConsumer->sequence;
+      tapestryProducer->expanderConnected = true;
+      tapestryFlip = true;
+      blocksProcessed++;
+    }
+
+    // Engine
+    if (expanderFlip)
+      std::swap(expanderProducer, expanderConsumer);
+    if (tapestryFlip)
+      std::swap(tapestryProducer, tapestryConsumer);
+    return processed;
+  }
+};
+
+void test_expander_link_fixed_latency(TestContext &ctx)
+{
+  const int kLatency = TapestryExpanderMessage::kLatencyFrames;
+  const int kSteps = TapestryExpanderMessage::kBlockFrames * 20 + 5;
+  ExpanderTransportSim sim;
+
+  int firstProcessed = -1;
+  bool continuous = true;
+  bool aligned = true;
+  for (int t = 0; t < kSteps; t++)
+  {
+    float out = 0.0f;
+    bool processed = sim.step(static_cast<float>(t + 1), out);
+    if (processed && firstProcessed < 0)
+      firstProcessed = t;
+    if (firstProcessed >= 0 && !processed)
+      continuous = false;
+    if (processed && out != 0.5f * static_cast<float>(t + 1 - kLatency))
+      aligned = false;
+  }
+
+  // Silent for exactly the reported latency, then every frame, delayed by it
+  T_ASSERT(ctx, firstProcessed == kLatency);
+  T_ASSERT(ctx, continuous);
+  T_ASSERT(ctx, aligned);
+
+  // One message exchange per block rather than per sample
+  T_ASSERT(ctx, sim.blocksProcessed == kSteps / TapestryExpanderMessage::kBlockFrames);
+}
+
+void test_expander_link_ignores_stale_blocks(TestContext &ctx)
+{
+  const int kLatency = TapestryExpanderMessage::kLatencyFrames;
+  ExpanderTransportSim sim;
+  float out = 0.0f;
+  for (int t = 0; t < 200; t++)
+  {
+    sim.step(1.0f, out);
+  }
+
+  // A different expander attaches: the old processed blocks left in
+  // Tapestry's consumer buffer must not be played again
+  sim.link.reset();
+  sim.lastSequence = 0;
+  sim.gain = 0.25f;
+  int firstProcessed = -1;
+  bool onlyNewGain = true;
+  for (int t = 0; t < 200; t++)
+  {
+    bool processed = sim.step(1.0f, out);
+    if (processed && firstProcessed < 0)
+      firstProcessed = t;
+    if (processed && out != 0.25f)
+      onlyNewGain = false;
+  }
+  T_ASSERT(ctx, firstProcessed == kLatency);
+  T_ASSERT(ctx, onlyNewGain);
+
+  // No answer from the expander: the link falls back after the last block
+  TapestryExpanderLink link;
+  TapestryExpanderMessage toExpander;
+  for (int t = 0; t < TapestryExpanderMessage::kBlockFrames; t++)
+  {
+    link.send(&toExpander, 1.0f, 1.0f, 48000.0f);
+  }
+  TapestryExpanderMessage unanswered;
+  link.receive(&unanswered);
+  float l, r;
+  T_ASSERT(ctx, !link.pull(l, r));
+  T_ASSERT(ctx, toExpander.sequence == 1u);
+}
+
+//------------------------------------------------------------------------------
+// Expander Inline Mode Tests
+//------------------------------------------------------------------------------
+
+void test_expander_inline_zero_latency(TestContext &ctx)
+{
+  ExpanderEffectChain::Params params;
+  params.bits = 5.0f;
+  params.crushMix = 0.5f;
+  params.cutoff = 0.4f;
+  params.resonance = 0.5f;
+  params.filterMix = 1.0f;
+
+  TapestryExpanderInline inlineChain;
+  inlineChain.chain.setSampleRate(48000.0f);
+  inlineChain.chain.setImmediate(params);
+  inlineChain.publish(params);
+  ExpanderEffectChain blockChain;
+  blockChain.setSampleRate(48000.0f);
+  blockChain.setImmediate(params);
+
+  // Frame by frame, as Tapestry calls it, against whole blocks: same output
+  // at the same frame, so nothing is delayed
+  const int kFrames = TapestryExpanderMessage::kBlockFrames * 16;
+  std::vector<float> left(kFrames), right(kFrames);
+  for (int i = 0; i < kFrames; i++)
+  {
+    left[i] = std::sin(0.05f * i) * 0.7f;
+    right[i] = std::cos(0.031f * i) * 0.7f;
+  }
+  std::vector<float> blockL = left, blockR = right;
+  blockChain.process(blockL.data(), blockR.data(), kFrames);
+
+  float maxError = 0.0f;
+  for (int i = 0; i < kFrames; i++)
+  {
+    float l = left[i];
+    float r = right[i];
+    inlineChain.process(l, r);
+    maxError = std::max(maxError, std::max(std::fabs(l - blockL[i]), std::fabs(r - blockR[i])));
+  }
+  T_ASSERT(ctx, maxError < 1e-5f);
+
+  // An impulse comes out on the frame it goes in
+  TapestryExpanderInline impulseChain;
+  impulseChain.chain.setImmediate(ExpanderEffectChain::Params());
+  float l = 1.0f;
+  float r = 1.0f;
+  impulseChain.process(l, r);
+  T_ASSERT(ctx, l > 0.5f && r > 0.5f);
+}
+
+void test_expander_inline_publish_is_lock_free(TestContext &ctx)
+{
+  TapestryExpanderInline inlineChain;
+  ExpanderEffectChain::Params a;
+  ExpanderEffectChain::Params b;
+  b.bits = 3.0f;
+  b.rate = 0.5f;
+  b.crushMix = 1.0f;
+  b.cutoff = 0.25f;
+  b.resonance = 0.9f;
+  b.filterMix = 0.75f;
+  b.outputLevel = 2.0f;
+
+  // The expander thread publishes while Tapestry's thread reads: every
+  // field read is one of the published values, never a torn float
+  std::atomic<bool> stop(false);
+  std::thread publisher([&]() {
+    for (int i = 0; !stop.load(); i++)
+    {
+      inlineChain.publish((i % 2) ? b : a);
+    }
+  });
+  bool valid = true;
+  for (int i = 0; i < 200000; i++)
+  {
+    ExpanderEffectChain::Params p = inlineChain.load();
+    valid = valid && (p.bits == a.bits || p.bits == b.bits);
+    valid = valid && (p.cutoff == a.cutoff || p.cutoff == b.cutoff);
+    valid = valid && (p.outputLevel == a.outputLevel || p.outputLevel == b.outputLevel);
+  }
+  stop.store(true);
+  publisher.join();
+  T_ASSERT(ctx, valid);
+
+  std::atomic<float> probe(0.0f);
+  T_ASSERT(ctx, probe.is_lock_free());
+}
+
+void test_expander_inline_bypass(TestContext &ctx)
+{
+  ExpanderEffectChain::Params params;
+  params.outputLevel = 0.5f;
+  TapestryExpanderInline inlineChain;
+  inlineChain.chain.setImmediate(params);
+  inlineChain.publish(params);
+  TapestryExpanderInlineSlot slot;
+
+  // Tapestry's side of one step, as in Tapestry::process(): run the
+  // published chain, else fall back to messages (unanswered here)
+  TapestryExpanderLink link;
+  TapestryExpanderMessage toExpander;
+  TapestryExpanderMessage fromExpander;
+  auto tapestryStep = [&](float in, float &out) {
+    float right = in;
+    out = in;
+    if (TapestryExpanderInline *chain = slot.get())
+    {
+      chain->process(out, right);
+      link.reset();
+      return true;
+    }
+    link.receive(&fromExpander);
+    bool processed = link.pull(out, right);
+    link.send(&toExpander, in, in, 48000.0f);
+    return processed;
+  };
+
+  // Expander running: its process() publishes the chain
+  bool processedWhileActive = true;
+  float out = 0.0f;
+  for (int t = 0; t < 256; t++)
+  {
+    slot.publish(&inlineChain);
+    processedWhileActive = processedWhileActive && tapestryStep(0.5f, out);
+  }
+  T_ASSERT(ctx, processedWhileActive);
+  T_ASSERT(ctx, std::fabs(out - 0.5f) > 0.1f);
+
+  // Bypassed: processBypass() clears the slot, Tapestry passes dry audio
+  bool dryWhileBypassed = true;
+  for (int t = 0; t < 256; t++)
+  {
+    slot.clear();
+    bool processed = tapestryStep(0.5f, out);
+    dryWhileBypassed = dryWhileBypassed && !processed && out == 0.5f;
+  }
+  T_ASSERT(ctx, dryWhileBypassed);
+
+  // Un-bypassed: processed again from the first step, with no latency
+  slot.publish(&inlineChain);
+  T_ASSERT(ctx, tapestryStep(0.5f, out));
+  T_ASSERT(ctx, std::fabs(out - 0.5f) > 0.1f);
+}
+
+//------------------------------------------------------------------------------
+// Test Runner
+//------------------------------------------------------------------------------
+
+void run_all_tapestry_tests()
+{
+  TestContext ctx;
+
+  std::printf("\n=== Tapestry DSP Unit Tests ===\n\n");
+
+  std::printf("--- TapestryUtil Tests ---\n");
+  test_util_clamp(ctx);
+  test_util_lerp(ctx);
+  test_util_hann_window(ctx);
+  test_util_cubic_interpolate(ctx);
+  test_util_varispeed_calculation(ctx);
+  test_util_fast_random(ctx);
+
+  std::printf("--- TapestryBuffer Tests ---\n");
+  test_buffer_basic_operations(ctx);
+  test_buffer_interpolation(ctx);
+  test_buffer_bounded_interpolation(ctx);
+  test_buffer_sound_on_sound(ctx);
+  test_buffer_bulk_operations(ctx);
+  test_buffer_clear_range(ctx);
+
+  std::printf("--- SpliceManager Tests ---\n");
+  test_splice_initialization(ctx);
+  test_splice_marker_creation(ctx);
+  test_splice_marker_deletion(ctx);
+  test_splice_navigation_shift(ctx);
+  test_splice_navigation_organize(ctx);
+  test_splice_pending_system(ctx);
+  test_splice_organize_vs_shift_priority(ctx);
+  test_splice_extend_for_recording(ctx);
+  test_splice_delete_all(ctx);
+
+  std::printf("--- GrainEngine Tests ---\n");
+  test_grain_basic_setup(ctx);
+  test_grain_stopped_mode(ctx);
+  test_grain_retrigger(ctx);
+  test_grain_slide_parameter(ctx);
+  test_grain_reverse_playback(ctx);
+  test_grain_multiple_voices(ctx);
+  test_grain_position_wrapping(ctx);
+
+  std::printf("--- TapestryDSP Integration Tests ---\n");
+  test_dsp_initialization(ctx);
+  test_dsp_basic_recording(ctx);
+  test_dsp_playback_basic(ctx);
+  test_dsp_varispeed_stopped(ctx);
+  test_dsp_splice_creation(ctx);
+  test_dsp_shift_navigation(ctx);
+  test_dsp_morph_parameter(ctx);
+  test_dsp_sound_on_sound(ctx);
+  test_dsp_organize_parameter(ctx);
+  test_dsp_slide_parameter(ctx);
+  test_dsp_gene_size_parameter(ctx);
+  test_dsp_clear_operations(ctx);
+
+  std::printf("--- Overdub Mode Tests ---\n");
+  test_dsp_overdub_mode_default_off(ctx);
+  test_dsp_overdub_mode_toggle(ctx);
+  test_dsp_overdub_mode_replace_behavior(ctx);
+  test_dsp_overdub_mode_keep_existing(ctx);
+  test_dsp_overdub_mode_reset(ctx);
+
+  std::printf("--- Clear Markers Tests ---\n");
+  test_dsp_clear_all_markers(ctx);
+  test_dsp_clear_markers_preserves_audio(ctx);
+  test_dsp_clear_markers_empty_buffer(ctx);
+
+  std::printf("--- Edge Cases and Stress Tests ---\n");
+  test_edge_empty_splice(ctx);
+  test_edge_max_splices(ctx);
+  test_edge_buffer_boundaries(ctx);
+  test_stress_continuous_playback(ctx);
+
+  std::printf("--- BitCrusherDSP Tests ---\n");
+  test_bitcrusher_initialization(ctx);
+  test_bitcrusher_reset(ctx);
+  test_bitcrusher_bit_depth_reduction(ctx);
+  test_bitcrusher_sample_rate_reduction(ctx);
+  test_bitcrusher_stereo_processing(ctx);
+  test_bitcrusher_parameter_limits(ctx);
+
+  std::printf("--- MoogVCFDSP Tests ---\n");
+  test_moog_filter_initialization(ctx);
+  test_moog_filter_reset(ctx);
+  test_moog_filter_lowpass_response(ctx);
+  test_moog_filter_cutoff_frequency(ctx);
+  test_moog_filter_resonance(ctx);
+  test_moog_filter_stability(ctx);
+  test_moog_filter_dc_blocking(ctx);
+  test_moog_filter_four_pole_response(ctx);
+  test_moog_filter_sample_rate_adaptation(ctx);
+
+  std::printf("--- Splice Count Distribution Tests ---\n");
+  test_splice_count_even_distribution(ctx);
+  test_splice_count_boundary_cases(ctx);
+  test_splice_count_replacement(ctx);
+
+  std::printf("--- ZeroCrossingIndex Tests ---\n");
+  test_zerocross_find_and_snap(ctx);
+  test_zerocross_sparse_long_range(ctx);
+  test_dsp_marker_snaps_to_zero_crossing(ctx);
+
+  std::printf("--- SpliceFeatureCache Tests ---\n");
+  test_triple_buffer_latest_wins(ctx);
+  test_feature_cache_invalidation(ctx);
+  test_dsp_organize_by_loudness(ctx);
+
+  std::printf("--- Tempo Analysis Tests ---\n");
+  test_tempo_detects_click_track(ctx);
+  test_tempo_update_follows_snapshots(ctx);
+  test_dsp_analysis_deferred_while_recording(ctx);
+  test_splice_from_beat_grid(ctx);
+  test_tempo_lock_ratio(ctx);
+  test_dsp_beat_grid_and_tempo_lock(ctx);
+
+  std::printf("--- Time Stretch Tests ---\n");
+  test_time_stretch_clock_layout(ctx);
+  test_time_stretch_independent_of_pitch(ctx);
+
+  std::printf("--- WSOLA Tests ---\n");
+  test_simd_dot_matches_scalar(ctx);
+  test_wsola_preserves_pitch(ctx);
+  test_wsola_speed_sets_tempo(ctx);
+
+  std::printf("--- Spectral Tests ---\n");
+  test_real_fft_roundtrip(ctx);
+  test_spectral_freeze(ctx);
+  test_spectral_stretch(ctx);
+
+  std::printf("--- Resampling Tests ---\n");
+  test_sinc_table_bands(ctx);
+  test_sinc_read_passband(ctx);
+  test_sinc_read_rejects_aliases(ctx);
+
+  std::printf("--- Interpolation Tier Tests ---\n");
+  test_interpolation_tiers(ctx);
+  test_grain_interpolation_dispatch(ctx);
+
+  std::printf("--- Polyphony Tests ---\n");
+  test_vec4_floor_abs(ctx);
+  test_poly_playheads_pitch_per_channel(ctx);
+  test_poly_playheads_seamless_window(ctx);
+  test_poly_playheads_gates(ctx);
+  test_poly_playheads_gene_end_per_channel(ctx);
+  test_dsp_poly_outputs(ctx);
+  test_dsp_poly_slide_ramps_and_gene_ends(ctx);
+
+  std::printf("--- Multi-Tap Tests ---\n");
+  test_multitap_heads_own_splice_and_gain(ctx);
+  test_multitap_speed_ratio_sets_pitch(ctx);
+  test_multitap_loop_is_continuous(ctx);
+  test_dsp_read_heads(ctx);
+
+  std::printf("--- Control Rate Tests ---\n");
+  test_linear_ramp(ctx);
+  test_dsp_control_rate_ramps(ctx);
+  test_dsp_audio_rate_cv_opt_in(ctx);
+
+  std::printf("--- Lookup Table Tests ---\n");
+  test_lut_exp2_error_bound(ctx);
+  test_lut_parameter_mappings(ctx);
+
+  std::printf("--- Block Recording Tests ---\n");
+  test_simd_block_mixing(ctx);
+  test_buffer_write_block_modes(ctx);
+  test_dsp_block_recording_spans(ctx);
+
+  std::printf("--- Overdub Feedback Tests ---\n");
+  test_simd_feedback_accumulate(ctx);
+  test_dsp_overdub_feedback_bounds_layers(ctx);
+
+  std::printf("--- Offline Render Tests ---\n");
+  test_wav_round_trip(ctx);
+  test_timeline_parse_csv(ctx);
+  test_timeline_renderer_chunked(ctx);
+
+  std::printf("--- Batch Render Tests ---\n");
+  test_work_stealing_pool_runs_every_job_once(ctx);
+  test_buffer_shared_reel_copy_on_write(ctx);
+  test_dsp_shared_reel_matches_private(ctx);
+
+  std::printf("--- Real-Time Safety Tests ---\n");
+  test_rt_playback_modes(ctx);
+  test_rt_gates_and_triggers(ctx);
+  test_rt_record_modes(ctx);
+  test_rt_splice_operations(ctx);
+  test_splice_markers_unsorted_restore(ctx);
+  test_buffer_clear_reclaims_stale_frames(ctx);
+
+  std::printf("--- Telemetry Tests ---\n");
+  test_telemetry_block_stats(ctx);
+  test_telemetry_history_wraps(ctx);
+  test_telemetry_dsp_stages(ctx);
+
+  std::printf("--- Event Trace Tests ---\n");
+  test_trace_ring_records_in_order(ctx);
+  test_trace_concurrent_writers(ctx);
+  test_trace_chrome_json(ctx);
+  test_trace_dsp_events(ctx);
+  test_underrun_detector(ctx);
+  test_underrun_detector_large_host_buffer(ctx);
+
+  std::printf("--- Golden Render Tests ---\n");
+  test_golden_renders(ctx);
+  test_golden_renders_repeatable(ctx);
+
+  std::printf("--- Denormal Tests ---\n");
+  test_denormal_guard_scoping(ctx);
+  test_denormal_moog_decay(ctx);
+  test_denormal_dsp_followers_decay(ctx);
+  test_denormal_nan_recovery(ctx);
+
+  std::printf("--- Expander Block Transport Tests ---\n");
+  test_expander_chain_block_matches_per_sample(ctx);
+  test_expander_chain_smoothing_reaches_targets(ctx);
+  test_expander_link_fixed_latency(ctx);
+  test_expander_link_ignores_stale_blocks(ctx);
+
+  std::printf("--- Expander Inline Mode Tests ---\n");
+  test_expander_inline_zero_latency(ctx);
+  test_expander_inline_publish_is_lock_free(ctx);
+  test_expander_inline_bypass(ctx);
+
+  std::printf("\n");
+  ctx.summary();
+  std::printf("\n");
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+// Main Entry Point
+//------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  // Golden render options
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--update-golden")
+      Golden::gUpdate = true;
+    else if (arg == "--golden-bit-exact")
+      Golden::gBitExact = true;
+    else if (arg == "--golden-tolerance-db" && i + 1 < argc)
+      Golden::gToleranceDb = std::atof(argv[++i]);
+    else
+    {
+      std::fprintf(stderr, "usage: %s [--update-golden] [--golden-bit-exact] [--golden-tolerance-db dB]\n", argv[0]);
+      return 2;
+    }
+  }
+
   run_all_tapestry_tests();
   return 0;
 }
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Tapestry Work-Stealing Pool
+ *
+ * Runs a batch of independent jobs across worker threads for the offline
+ * tools. Not used by the plugin.
+ *
+ * Features:
+ * - One job deque per worker, seeded with a contiguous range of jobs
+ * - Workers take their own jobs from the back and steal from the front of
+ *   other deques when they run dry, so uneven job lengths still balance
+ * - The callback receives the worker index, so per-worker state (such as a
+ *   TapestryDSP instance) is reused without locking
+ * - Threads live for one run(); the calling thread is worker 0
+ */
+
+namespace ShortwavDSP
+{
+
+class WorkStealingPool
+{
+public:
+  // threads <= 0 uses the hardware concurrency
+  explicit WorkStealingPool(int threads = 0)
+  {
+    if (threads <= 0)
+      threads = static_cast<int>(std::thread::hardware_concurrency());
+    workers_ = std::max(threads, 1);
+  }
+
+  int getWorkerCount() const noexcept { return workers_; }
+
+  // Calls fn(job, worker) once for every job in [0, jobCount) and returns
+  // when all have finished. fn must not throw.
+  template <class Fn>
+  void run(size_t jobCount, Fn fn)
+  {
+    std::vector<Queue> queues(static_cast<size_t>(workers_));
+    for (size_t w = 0; w < queues.size(); w++)
+    {
+      size_t begin = jobCount * w / queues.size();
+      size_t end = jobCount * (w + 1) / queues.size();
+      for (size_t job = begin; job < end; job++)
+      {
+        queues[w].jobs.push_back(job);
+      }
+    }
+
+    std::atomic<size_t> steals(0);
+    auto work = [&](size_t worker) {
+      size_t job;
+      while (pop(queues[worker], job) || steal(queues, worker, job, steals))
+      {
+        fn(job, static_cast<int>(worker));
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < queues.size(); w++)
+    {
+      threads.emplace_back(work, w);
+    }
+    work(0);
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+      threads[t].join();
+    }
+    lastSteals_ = steals.load();
+  }
+
+  // Jobs taken from another worker's deque during the last run()
+  size_t getLastStealCount() const noexcept { return lastSteals_; }
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<size_t> jobs;
+  };
+
+  static bool pop(Queue &queue, size_t &job)
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty())
+      return false;
+    job = queue.jobs.back();
+    queue.jobs.pop_back();
+    return true;
+  }
+
+  // Jobs are never added during a run, so one empty sweep means all taken
+  static bool steal(std::vector<Queue> &queues, size_t thief, size_t &job,
+                    std::atomic<size_t> &steals)
+  {
+    for (size_t i = 1; i < queues.size(); i++)
+    {
+      Queue &victim = queues[(thief + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.jobs.empty())
+      {
+        job = victim.jobs.front();
+        victim.jobs.pop_front();
+        steals++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int workers_ = 1;
+  size_t lastSteals_ = 0;
+};
+
+} // namespace ShortwavDSP
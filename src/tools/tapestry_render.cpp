@@ -0,0 +1,314 @@
+// Headless offline renderer for the Tapestry DSP
+//
+// Loads a WAV file as the reel, plays a CSV timeline of parameter, CV and
+// gate events through TapestryDSP, and writes the result as fast as the
+// CPU allows, reporting the realtime factor.
+//
+// Batch mode renders every combination of Morph, Gene Size and Slide sweeps
+// on a work-stealing thread pool. Each worker owns a TapestryDSP; all of
+// them read one shared copy of the reel.
+//
+// Usage:
+//   tapestry-render <reel.wav> <out.wav> [options]
+//   tapestry-render <reel.wav> --batch <out-dir> [sweeps] [options]
+//
+// Options:
+//   --timeline <file.csv>  Events as "time,target,value" (see tapestry-render.h)
+//   --duration <seconds>   Output length (default: reel length)
+//   --splices <n>          Split the reel into n equal splices (default 1)
+//   --pcm16                Write 16-bit PCM instead of 32-bit float
+//
+// Batch options:
+//   --morph <from:to:steps>, --gene-size <from:to:steps>, --slide <from:to:steps>
+//                          Knob sweeps applied at time 0, after the timeline's
+//                          own time-0 events (unswept knobs follow the timeline)
+//   --threads <n>          Worker threads (default: all cores)
+//
+// Built by build_tools.sh; not part of the plugin.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../dsp/tapestry-dsp.h"
+#include "../dsp/tapestry-render.h"
+#include "../dsp/tapestry-wav.h"
+#include "tapestry-pool.h"
+
+namespace
+{
+
+using namespace ShortwavDSP;
+
+// Evenly spaced knob values, from and to included
+struct Sweep
+{
+  float from = 0.0f;
+  float to = 0.0f;
+  int steps = 0;  // 0 = not swept
+
+  int count() const { return steps > 0 ? steps : 1; }
+  float value(int i) const
+  {
+    return (steps > 1) ? from + (to - from) * static_cast<float>(i) / static_cast<float>(steps - 1) : from;
+  }
+};
+
+struct Options
+{
+  std::string reelPath;
+  std::string outPath;
+  std::string timelinePath;
+  std::string batchDir;
+  double duration = -1.0;  // Negative = reel length
+  int splices = 1;
+  int threads = 0;
+  Wav::Format format = Wav::Format::Float32;
+  Sweep morph;
+  Sweep geneSize;
+  Sweep slide;
+};
+
+void printUsage()
+{
+  std::fprintf(stderr,
+               "usage: tapestry-render <reel.wav> <out.wav> [--timeline file.csv]\n"
+               "                       [--duration seconds] [--splices n] [--pcm16]\n"
+               "       tapestry-render <reel.wav> --batch <out-dir> [--morph from:to:steps]\n"
+               "                       [--gene-size from:to:steps] [--slide from:to:steps]\n"
+               "                       [--threads n] [options]\n");
+}
+
+bool parseSweep(const char *text, Sweep &sweep)
+{
+  return std::sscanf(text, "%f:%f:%d", &sweep.from, &sweep.to, &sweep.steps) == 3 && sweep.steps >= 1;
+}
+
+bool parseArgs(int argc, char **argv, Options &options)
+{
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--timeline" && hasValue)
+      options.timelinePath = argv[++i];
+    else if (arg == "--duration" && hasValue)
+      options.duration = std::atof(argv[++i]);
+    else if (arg == "--splices" && hasValue)
+      options.splices = std::atoi(argv[++i]);
+    else if (arg == "--pcm16")
+      options.format = Wav::Format::Pcm16;
+    else if (arg == "--batch" && hasValue)
+      options.batchDir = argv[++i];
+    else if (arg == "--threads" && hasValue)
+      options.threads = std::atoi(argv[++i]);
+    else if (arg == "--morph" && hasValue)
+    {
+      if (!parseSweep(argv[++i], options.morph))
+        return false;
+    }
+    else if (arg == "--gene-size" && hasValue)
+    {
+      if (!parseSweep(argv[++i], options.geneSize))
+        return false;
+    }
+    else if (arg == "--slide" && hasValue)
+    {
+      if (!parseSweep(argv[++i], options.slide))
+        return false;
+    }
+    else if (arg.compare(0, 2, "--") == 0)
+      return false;
+    else
+      positional.push_back(arg);
+  }
+
+  bool batch = !options.batchDir.empty();
+  if (positional.size() != (batch ? 1u : 2u) || options.splices < 1)
+    return false;
+  options.reelPath = positional[0];
+  if (!batch)
+    options.outPath = positional[1];
+  return true;
+}
+
+bool readText(const std::string &path, std::string &text)
+{
+  FILE *file = std::fopen(path.c_str(), "rb");
+  if (!file)
+    return false;
+  char block[4096];
+  size_t count;
+  while ((count = std::fread(block, 1, sizeof(block), file)) > 0)
+  {
+    text.append(block, count);
+  }
+  std::fclose(file);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Batch Mode
+//------------------------------------------------------------------------------
+
+int renderBatch(const Options &options, const Wav::Audio &reel, size_t reelFrames,
+                const std::vector<size_t> &markers, const Timeline &baseTimeline, size_t frames)
+{
+  const float sampleRate = static_cast<float>(reel.sampleRate);
+  const double audioSeconds = static_cast<double>(frames) / sampleRate;
+  std::shared_ptr<const std::vector<float>> sharedReel =
+      TapestryBuffer::makeSharedReel(reel.samples.data(), reelFrames);
+
+  const size_t jobCount = static_cast<size_t>(options.morph.count()) * options.geneSize.count() *
+                          options.slide.count();
+  WorkStealingPool pool(options.threads);
+  std::vector<std::unique_ptr<TapestryDSP>> dsps(static_cast<size_t>(pool.getWorkerCount()));
+  std::vector<std::vector<float>> outputs(dsps.size());
+  std::mutex printMutex;
+  std::atomic<size_t> failures(0);
+  std::atomic<size_t> done(0);
+
+  std::printf("Batch: %zu jobs on %d threads, %.2f s each\n", jobCount, pool.getWorkerCount(),
+              audioSeconds);
+  auto batchStart = std::chrono::steady_clock::now();
+
+  pool.run(jobCount, [&](size_t job, int worker) {
+    auto jobStart = std::chrono::steady_clock::now();
+
+    // Job index -> sweep position (slide varies fastest)
+    int s = static_cast<int>(job % options.slide.count());
+    int g = static_cast<int>(job / options.slide.count() % options.geneSize.count());
+    int m = static_cast<int>(job / options.slide.count() / options.geneSize.count());
+    float morph = options.morph.value(m);
+    float geneSize = options.geneSize.value(g);
+    float slide = options.slide.value(s);
+
+    Timeline timeline = baseTimeline;
+    if (options.morph.steps > 0)
+      timeline.add(0.0, RenderTarget::Morph, morph);
+    if (options.geneSize.steps > 0)
+      timeline.add(0.0, RenderTarget::GeneSize, geneSize);
+    if (options.slide.steps > 0)
+      timeline.add(0.0, RenderTarget::Slide, slide);
+
+    std::unique_ptr<TapestryDSP> &dsp = dsps[static_cast<size_t>(worker)];
+    if (!dsp)
+      dsp.reset(new TapestryDSP());
+    dsp->setSampleRate(sampleRate);
+    dsp->loadSharedReel(sharedReel, reelFrames, markers);
+    dsp->runAnalysis();
+
+    std::vector<float> &out = outputs[static_cast<size_t>(worker)];
+    out.resize(frames * 2);
+    TimelineRenderer renderer(timeline, sampleRate);
+    renderer.render(*dsp, out.data(), frames);
+
+    char name[96];
+    std::snprintf(name, sizeof(name), "/job_%04zu_m%.3f_g%.3f_s%.3f.wav", job, morph, geneSize, slide);
+    std::string path = options.batchDir + name;
+    std::string error;
+    bool ok = Wav::write(path, out.data(), frames, reel.sampleRate, options.format, error);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - jobStart).count();
+    size_t finished = ++done;
+    std::lock_guard<std::mutex> lock(printMutex);
+    if (!ok)
+    {
+      failures++;
+      std::fprintf(stderr, "error: %s\n", error.c_str());
+      return;
+    }
+    std::printf("  [%zu/%zu] job %zu (worker %d) morph=%.3f gene=%.3f slide=%.3f: %.3f s, %.1fx realtime\n",
+                finished, jobCount, job, worker, morph, geneSize, slide, seconds,
+                (seconds > 0.0) ? audioSeconds / seconds : 0.0);
+  });
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+  double totalAudio = audioSeconds * static_cast<double>(jobCount);
+  std::printf("Rendered %zu jobs (%.1f s of audio) in %.3f s: %.1fx realtime, %.2f jobs/s, %zu steals\n",
+              jobCount, totalAudio, wall, (wall > 0.0) ? totalAudio / wall : 0.0,
+              (wall > 0.0) ? static_cast<double>(jobCount) / wall : 0.0, pool.getLastStealCount());
+  return failures.load() == 0 ? 0 : 1;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+  Options options;
+  if (!parseArgs(argc, argv, options))
+  {
+    printUsage();
+    return 2;
+  }
+
+  std::string error;
+  Wav::Audio reel;
+  if (!Wav::read(options.reelPath, reel, error))
+  {
+    std::fprintf(stderr, "error: %s\n", error.c_str());
+    return 1;
+  }
+
+  Timeline timeline;
+  if (!options.timelinePath.empty())
+  {
+    std::string text;
+    if (!readText(options.timelinePath, text))
+    {
+      std::fprintf(stderr, "error: cannot open %s\n", options.timelinePath.c_str());
+      return 1;
+    }
+    if (!timeline.parseCsv(text, error))
+    {
+      std::fprintf(stderr, "error: %s: %s\n", options.timelinePath.c_str(), error.c_str());
+      return 1;
+    }
+  }
+
+  // Load the reel, optionally split into equal splices
+  const size_t maxFrames = TapestryBuffer::kMaxFrames;
+  size_t reelFrames = std::min(reel.frames, maxFrames);
+  std::vector<size_t> markers;
+  for (int s = 1; s < options.splices; s++)
+  {
+    markers.push_back(reelFrames * static_cast<size_t>(s) / static_cast<size_t>(options.splices));
+  }
+
+  float sampleRate = static_cast<float>(reel.sampleRate);
+  double duration = (options.duration >= 0.0) ? options.duration
+                                              : static_cast<double>(reelFrames) / sampleRate;
+  size_t frames = static_cast<size_t>(duration * sampleRate);
+
+  if (!options.batchDir.empty())
+  {
+    return renderBatch(options, reel, reelFrames, markers, timeline, frames);
+  }
+
+  std::unique_ptr<TapestryDSP> dsp(new TapestryDSP());
+  dsp->setSampleRate(sampleRate);
+  dsp->loadReel(reel.samples.data(), reelFrames, markers);
+  dsp->runAnalysis();
+
+  std::vector<float> out(frames * 2);
+  auto start = std::chrono::steady_clock::now();
+  TimelineRenderer renderer(timeline, sampleRate);
+  renderer.render(*dsp, out.data(), frames);
+  auto end = std::chrono::steady_clock::now();
+
+  if (!Wav::write(options.outPath, out.data(), frames, reel.sampleRate, options.format, error))
+  {
+    std::fprintf(stderr, "error: %s\n", error.c_str());
+    return 1;
+  }
+
+  double wall = std::chrono::duration<double>(end - start).count();
+  double audio = static_cast<double>(frames) / sampleRate;
+  std::printf("Rendered %.2f s (%zu events) in %.3f s: %.1fx realtime\n", audio,
+              timeline.getEvents().size(), wall, (wall > 0.0) ? audio / wall : 0.0);
+  return 0;
+}